@@ -0,0 +1,97 @@
+
+#include "arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+arena::arena(size_t csize)
+{
+  chunks = 0;
+  spare = 0;
+  top = 0;
+  limit = 0;
+  chunk_size = csize;
+}
+
+arena::~arena()
+{
+  release();
+}
+
+void* arena::grow(size_t bytes)
+{
+  /*
+    Oversized requests get a chunk of their own,
+    linked behind the current one so we keep bumping there.
+  */
+  size_t hdr = (sizeof(chunk) + ALIGN - 1) & ~(ALIGN-1);
+  size_t size = (bytes > chunk_size / 4) ? bytes : chunk_size;
+  chunk* C;
+  if (spare && size == chunk_size) {
+    C = spare;
+    spare = spare->next;
+  } else {
+    C = (chunk*) malloc(hdr + size);
+    if (0==C) abort();
+  }
+  C->size = size;
+  char* data = (char*) C + hdr;
+
+  if (size != chunk_size && chunks) {
+    C->next = chunks->next;
+    chunks->next = C;
+    return data;
+  }
+
+  C->next = chunks;
+  chunks = C;
+  top = data + bytes;
+  limit = data + size;
+  return data;
+}
+
+char* arena::copy(const char* text, size_t len)
+{
+  char* p;
+  if (top && (size_t)(limit - top) >= len + 1) {
+    p = top;
+    top += len + 1;
+  } else {
+    p = (char*) grow(len + 1);
+  }
+  memcpy(p, text, len);
+  p[len] = 0;
+  return p;
+}
+
+void arena::release()
+{
+  while (chunks) {
+    chunk* next = chunks->next;
+    free(chunks);
+    chunks = next;
+  }
+  while (spare) {
+    chunk* next = spare->next;
+    free(spare);
+    spare = next;
+  }
+  top = 0;
+  limit = 0;
+}
+
+void arena::rewind()
+{
+  while (chunks) {
+    chunk* next = chunks->next;
+    if (chunk_size == chunks->size) {
+      chunks->next = spare;
+      spare = chunks;
+    } else {
+      free(chunks);
+    }
+    chunks = next;
+  }
+  top = 0;
+  limit = 0;
+}
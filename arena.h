@@ -0,0 +1,68 @@
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/*
+  Bump allocator.
+
+  Memory comes from large chunks and is handed out in order;
+  nothing is freed individually.  Everything goes back at once
+  with release(), or when the arena is destroyed; or rewind()
+  keeps the chunks, to hand out again.
+*/
+
+class arena {
+    struct chunk {
+        chunk* next;
+        size_t size;    /* usable bytes after the header */
+    };
+
+  private:
+    chunk* chunks;
+    chunk* spare;       /* rewound chunks, of chunk_size */
+    char* top;          /* next free byte in the current chunk */
+    char* limit;        /* end of the current chunk */
+    size_t chunk_size;
+
+  public:
+    arena(size_t csize = 65536);
+    ~arena();
+
+    /*
+      Allocate bytes, suitably aligned for any object.
+    */
+    inline void* alloc(size_t bytes) {
+      size_t pad = (ALIGN - ((size_t) top & (ALIGN-1))) & (ALIGN-1);
+      if (top && (size_t)(limit - top) >= bytes + pad) {
+        char* p = top + pad;
+        top = p + bytes;
+        return p;
+      }
+      return grow(bytes);
+    }
+
+    /*
+      Copy len bytes of text, plus a terminating NUL.
+      No alignment.
+    */
+    char* copy(const char* text, size_t len);
+
+    /*
+      Give back everything allocated so far.
+    */
+    void release();
+
+    /*
+      Forget everything allocated so far, but keep the chunks of the
+      usual size for what comes next; oversized ones are freed.
+    */
+    void rewind();
+
+  private:
+    static const size_t ALIGN = 16;
+    void* grow(size_t bytes);
+};
+
+#endif
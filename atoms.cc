@@ -0,0 +1,93 @@
+
+#include "atoms.h"
+
+#include <string.h>
+
+thread_local atom_table* atom_table::THE_TABLE;
+
+atom_table::atom_table()
+  : storage(65536)
+{
+  entry none;
+  none.text = "";
+  none.length = 0;
+  none.hash = 0;
+  atoms.push_back(none);
+  slots.resize(1024, 0);
+}
+
+void atom_table::clear()
+{
+  atom_table &T = *THE_TABLE;
+  T.storage.rewind();
+  T.atoms.resize(1);
+  T.slots.assign(1024, 0);
+}
+
+unsigned atom_table::hash(const char* text, size_t len)
+{
+  /* FNV-1a */
+  unsigned h = 2166136261u;
+  for (size_t i=0; i<len; i++) {
+    h ^= (unsigned char) text[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+/*
+  Find the slot holding the text, or the empty slot where it belongs.
+*/
+unsigned atom_table::probe(const char* text, size_t len, unsigned h) const
+{
+  unsigned mask = slots.size() - 1;
+  for (unsigned i = h & mask; ; i = (i+1) & mask) {
+    atom_id a = slots[i];
+    if (0==a) return i;
+    const entry &E = atoms[a];
+    if ((E.hash == h) && (E.length == len) && (0==memcmp(E.text, text, len))) {
+      return i;
+    }
+  }
+}
+
+void atom_table::rehash()
+{
+  std::vector<atom_id> old;
+  old.swap(slots);
+  slots.resize(2*old.size(), 0);
+  unsigned mask = slots.size() - 1;
+  for (size_t s=0; s<old.size(); s++) {
+    if (0==old[s]) continue;
+    unsigned i = atoms[old[s]].hash & mask;
+    while (slots[i]) i = (i+1) & mask;
+    slots[i] = old[s];
+  }
+}
+
+atom_id atom_table::intern(const char* text, size_t len)
+{
+  atom_table &T = *THE_TABLE;
+  unsigned h = hash(text, len);
+  unsigned i = T.probe(text, len, h);
+  if (T.slots[i]) return T.slots[i];
+
+  entry E;
+  E.text = T.storage.copy(text, len);
+  E.length = len;
+  E.hash = h;
+  atom_id a = T.atoms.size();
+  T.atoms.push_back(E);
+  T.slots[i] = a;
+
+  /* Keep the load factor under one half */
+  if (2*T.atoms.size() > T.slots.size()) T.rehash();
+  return a;
+}
+
+atom_id atom_table::lookup(const char* text)
+{
+  const atom_table &T = *THE_TABLE;
+  size_t len = strlen(text);
+  return T.slots[T.probe(text, len, hash(text, len))];
+}
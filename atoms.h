@@ -0,0 +1,84 @@
+
+#ifndef ATOMS_H
+#define ATOMS_H
+
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+#include "arena.h"
+
+/*
+  Interned identifiers.
+
+  Every distinct name is stored once, in an arena, and is
+  known from then on by a small integer.  Two names are equal
+  exactly when their atoms are equal.
+  Atom 0 is reserved and means "no name".
+
+  Each compilation has its own table, in its compiler_context;
+  the static methods use the table of the compilation running
+  on the calling thread.
+*/
+
+typedef unsigned atom_id;
+
+class atom_table {
+    static thread_local atom_table* THE_TABLE;
+    friend class compiler_context;
+
+    struct entry {
+        const char* text;
+        unsigned length;
+        unsigned hash;
+    };
+
+  private:
+    arena storage;
+    std::vector<entry> atoms;     /* indexed by atom */
+    std::vector<atom_id> slots;   /* open addressing, 0 is empty */
+    
+  public:
+    atom_table();
+
+    /*
+      Forget every atom but 0, keeping the memory for the next
+      compilation in the same context.
+    */
+    static void clear();
+
+    /*
+      Return the atom for the given text, adding it if needed.
+    */
+    static atom_id intern(const char* text, size_t len);
+
+    static inline atom_id intern(const char* text) {
+      return intern(text, strlen(text));
+    }
+
+    /*
+      Return the atom for the given text, or 0 if it was never interned.
+    */
+    static atom_id lookup(const char* text);
+
+    /*
+      Return the text of an atom.
+    */
+    static inline const char* name(atom_id a) {
+      return THE_TABLE->atoms[a].text;
+    }
+
+    /*
+      Return the length of the text of an atom.
+    */
+    static inline unsigned length(atom_id a) {
+      return THE_TABLE->atoms[a].length;
+    }
+
+  private:
+    static unsigned hash(const char* text, size_t len);
+    unsigned probe(const char* text, size_t len, unsigned h) const;
+    void rehash();
+};
+
+#endif
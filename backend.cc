@@ -0,0 +1,56 @@
+
+#include "backend.h"
+#include "lexer.h"
+#include "jasm.h"
+#include "classfile.h"
+#include "x86.h"
+#include "csource.h"
+
+#include <iostream>
+#include <string.h>
+
+bool parse_target(const char* name, target_kind &target)
+{
+  if (0==strcmp(name, "class")) {
+    target = TARGET_CLASS;
+    return true;
+  }
+  if (0==strcmp(name, "jasm")) {
+    target = TARGET_JASM;
+    return true;
+  }
+  if (0==strcmp(name, "x86")) {
+    target = TARGET_X86;
+    return true;
+  }
+  if (0==strcmp(name, "c")) {
+    target = TARGET_C;
+    return true;
+  }
+  return false;
+}
+
+backend* open_backend(target_kind target, const std::string &classname, const char* srcname)
+{
+  std::string file = classname;
+  switch (target) {
+    case TARGET_JASM:   file += ".j";       break;
+    case TARGET_CLASS:  file += ".class";   break;
+    case TARGET_X86:    file += ".s";       break;
+    case TARGET_C:      file += ".out.c";   break;
+  }
+  sink* S = new sink;
+  if (!S->open(file.c_str())) {
+    diagnostics() << "Error, couldn't create output file " << file << "\n";
+    delete S;
+    return 0;
+  }
+  switch (target) {
+    case TARGET_JASM:   return new jasm_backend(S, classname, srcname);
+    case TARGET_CLASS:  return new class_backend(S, classname, srcname);
+    case TARGET_X86:    return new x86_backend(S, classname, srcname);
+    case TARGET_C:      return new c_backend(S, classname, srcname);
+  }
+  delete S;
+  return 0;
+}
@@ -0,0 +1,75 @@
+
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <string>
+#include <vector>
+
+#include "instr.h"
+#include "frame.h"
+#include "sink.h"
+
+/*
+  Code generation targets.
+
+  The front end hands each finished method to a backend, which
+  writes it out in its own format.  There is one backend object
+  per compilation, created by open_backend().
+*/
+
+enum target_kind {
+    TARGET_CLASS,     /* JVM class file, written directly */
+    TARGET_JASM,      /* Krakatau assembler text, the .j file */
+    TARGET_X86,       /* x86-64 GNU assembler text, the .s file */
+    TARGET_C          /* portable C source, the .out.c file */
+};
+
+class backend {
+  public:
+    virtual ~backend() { }
+
+    /*
+      A static field for a global variable.
+        @param  init    Its initial value, an iconst or fconst,
+                        or 0 if it starts as zero (or is an array)
+    */
+    virtual void field(atom_id name, char type, bool is_array, const instr* init = 0) = 0;
+
+    /*
+      A finished method.  The code has been through the peephole
+      pass, and frame has been computed from it.
+        @param  name    Method name; "<clinit>" for the class initializer
+        @param  desc    Method descriptor, like "(I)I"
+    */
+    virtual void method(const char* name, const char* desc,
+                        const std::vector<instr> &code, const frame_info &frame) = 0;
+
+    /*
+      The Java entry point main(String[]), which calls our main().
+        @param  show_result   Print main()'s return code.
+    */
+    virtual void entry(bool show_result) = 0;
+
+    /*
+      Everything has been given to us; write and close the output.
+      Return false on failure.
+    */
+    virtual bool finish() = 0;
+};
+
+/*
+  Create the backend for the given target.
+    @param  classname   Class to generate; also the output file name,
+                        without the extension
+    @param  srcname     Source file name, for comments and debug info
+  Returns 0, after an error message, if the output can't be created.
+*/
+backend* open_backend(target_kind target, const std::string &classname, const char* srcname);
+
+/*
+  Parse a target name given on the command line.
+  Return false if it is not a target we know.
+*/
+bool parse_target(const char* name, target_kind &target);
+
+#endif
@@ -0,0 +1,214 @@
+
+#include "batch.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdio.h>
+#include <thread>
+
+typedef std::chrono::steady_clock clock_type;
+
+static double millis(clock_type::time_point start, clock_type::time_point end)
+{
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+bool readResponseFile(const char* name, std::vector<std::string> &files)
+{
+  std::ifstream in(name);
+  if (!in) return false;
+  std::string file;
+  while (in >> file) {
+    files.push_back(file);
+  }
+  return true;
+}
+
+/* ====================================================================== */
+
+/*
+  One input file, and what became of it.
+*/
+struct batch_file {
+    const char* name;
+    std::ostringstream out;     /* Output of modes 1 to 3 */
+    std::ostringstream errors;  /* Messages and statistics */
+    int status;
+    double time;                /* Milliseconds spent compiling */
+    unsigned worker;            /* Thread that compiled it */
+    bool done;
+
+  public:
+    batch_file() {
+      name = 0;
+      status = 0;
+      time = 0;
+      worker = 0;
+      done = false;
+    }
+};
+
+/*
+  The files one thread has yet to compile.  The owner works from
+  the front; others steal from the back, so the two mostly stay
+  out of each other's way and the owner keeps to input order.
+*/
+class work_queue {
+    std::mutex lock;
+    std::deque<size_t> files;
+
+  public:
+    void push(size_t f) {
+      std::lock_guard<std::mutex> hold(lock);
+      files.push_back(f);
+    }
+    bool take(size_t &f) {
+      std::lock_guard<std::mutex> hold(lock);
+      if (files.empty()) return false;
+      f = files.front();
+      files.pop_front();
+      return true;
+    }
+    bool steal(size_t &f) {
+      std::lock_guard<std::mutex> hold(lock);
+      if (files.empty()) return false;
+      f = files.back();
+      files.pop_back();
+      return true;
+    }
+};
+
+class batch_run {
+    const compile_options &opts;
+    std::vector<batch_file> files;
+    std::vector<work_queue> queues;
+
+    std::mutex lock;                /* Guards done, and stolen */
+    std::condition_variable finished;
+    unsigned stolen;
+
+  public:
+    batch_run(const std::vector<std::string> &names, const compile_options &o, unsigned jobs);
+
+    int run(std::ostream &fout);
+
+  private:
+    bool next(unsigned w, size_t &f);
+    void work(unsigned w);
+    void showTimes(std::ostream &s, double elapsed) const;
+};
+
+batch_run::batch_run(const std::vector<std::string> &names, const compile_options &o,
+                     unsigned jobs)
+  : opts(o), files(names.size()), queues(jobs)
+{
+  stolen = 0;
+  for (size_t i=0; i<files.size(); i++) {
+    files[i].name = names[i].c_str();
+    queues[i * jobs / files.size()].push(i);
+  }
+}
+
+bool batch_run::next(unsigned w, size_t &f)
+{
+  if (queues[w].take(f)) return true;
+  for (unsigned i=1; i<queues.size(); i++) {
+    if (queues[(w+i) % queues.size()].steal(f)) {
+      std::lock_guard<std::mutex> hold(lock);
+      stolen++;
+      return true;
+    }
+  }
+  return false;
+}
+
+void batch_run::work(unsigned w)
+{
+  compiler_context ctx;
+  compile_options o = opts;
+  size_t f;
+  while (next(w, f)) {
+    batch_file &F = files[f];
+    o.errors = &F.errors;
+    clock_type::time_point start = clock_type::now();
+    F.status = compile(ctx, F.name, 0, 0, o, F.out);
+    F.time = millis(start, clock_type::now());
+    F.worker = w;
+
+    std::lock_guard<std::mutex> hold(lock);
+    F.done = true;
+    finished.notify_all();
+  }
+}
+
+int batch_run::run(std::ostream &fout)
+{
+  clock_type::time_point start = clock_type::now();
+  std::vector<std::thread> threads;
+  for (unsigned w=0; w<queues.size(); w++) {
+    threads.push_back(std::thread(&batch_run::work, this, w));
+  }
+
+  /*
+    Write each file's buffers as soon as it, and every file
+    before it, is done; then let the buffers go.
+  */
+  int status = 0;
+  for (size_t i=0; i<files.size(); i++) {
+    batch_file &F = files[i];
+    {
+      std::unique_lock<std::mutex> hold(lock);
+      while (!F.done) finished.wait(hold);
+    }
+    fout << F.out.str();
+    std::cerr << F.errors.str();
+    /* str("") would keep the capacity; this frees it */
+    std::ostringstream().swap(F.out);
+    std::ostringstream().swap(F.errors);
+    if (0==status) status = F.status;
+  }
+  fout.flush();
+
+  for (size_t w=0; w<threads.size(); w++) {
+    threads[w].join();
+  }
+  showTimes(std::cerr, millis(start, clock_type::now()));
+  return status;
+}
+
+void batch_run::showTimes(std::ostream &s, double elapsed) const
+{
+  char buf[64];
+  double total = 0;
+  s << "Compile times\n";
+  for (size_t i=0; i<files.size(); i++) {
+    const batch_file &F = files[i];
+    snprintf(buf, sizeof(buf), "\t%10.3f ms  thread %u  ", F.time, F.worker);
+    s << buf << F.name;
+    if (F.status) s << "  (failed, status " << F.status << ")";
+    s << "\n";
+    total += F.time;
+  }
+  snprintf(buf, sizeof(buf), "%.3f ms", total);
+  s << "\tfiles: " << files.size() << ", compiling: " << buf << "\n";
+  snprintf(buf, sizeof(buf), "%.3f ms", elapsed);
+  s << "\tthreads: " << queues.size() << ", files stolen: " << stolen;
+  s << ", elapsed: " << buf << "\n";
+}
+
+/* ====================================================================== */
+
+int compileBatch(const std::vector<std::string> &files, const compile_options &opts,
+                 unsigned jobs, std::ostream &fout)
+{
+  if (0==jobs) jobs = std::thread::hardware_concurrency();
+  if (jobs > files.size()) jobs = files.size();
+  if (0==jobs) jobs = 1;
+
+  batch_run B(files, opts, jobs);
+  return B.run(fout);
+}
@@ -0,0 +1,36 @@
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "context.h"
+
+/*
+  Add the input file names listed in a response file, separated
+  by blanks or newlines, to files.
+  Return false on failure (can't open file).
+*/
+bool readResponseFile(const char* name, std::vector<std::string> &files);
+
+/*
+  Compile many inputs on a pool of threads.
+
+  The files are dealt out in order, in one block per thread; each
+  thread takes its next file from the front of its own queue, and
+  when that is empty steals from the back of another's.  A thread
+  keeps one compiler_context, with its own arenas, for all the
+  files it compiles.  The output of modes 1 to 3 and the messages
+  for each file are kept in buffers, and written to fout and
+  std::cerr in the order the files were given, so they do not
+  depend on the threads.  A summary of the time spent on each file
+  goes to std::cerr at the end.
+    @param  jobs    Number of threads; 0 for one per processor
+  Returns the exit status of the first file that failed, or 0.
+*/
+int compileBatch(const std::vector<std::string> &files, const compile_options &opts,
+                 unsigned jobs, std::ostream &fout);
+
+#endif
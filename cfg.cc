@@ -0,0 +1,476 @@
+
+#include "cfg.h"
+
+/*
+  Counts for -s, over all methods compiled on this thread
+  since clearStats().
+*/
+static thread_local long threaded;
+static thread_local long unreachable;
+static thread_local long moved;
+static thread_local long jumps_removed;
+static thread_local long branches_flipped;
+
+static inline bool is_exit(const instr &I)
+{
+  return I.is_branch() || (OP_SWITCH == I.op) || (OP_RETURN == I.op) || (OP_VRETURN == I.op);
+}
+
+/* ====================================================================== */
+
+flowgraph::flowgraph(const std::vector<instr> &code)
+{
+  good = true;
+
+  int maxlabel = -1;
+  for (size_t i=0; i<code.size(); i++) {
+    if (code[i].is_label() && code[i].a > maxlabel) maxlabel = code[i].a;
+  }
+  std::vector<int> label_block(maxlabel+1, -1);
+
+  /*
+    fresh: the current block has nothing in it yet, so a label
+    still belongs to it rather than starting another.
+  */
+  newBlock();
+  bool fresh = true;
+  for (size_t i=0; i<code.size(); i++) {
+    const instr &I = code[i];
+    int b = blocks.size() - 1;
+    if (I.is_label()) {
+      if (!fresh) {
+        blocks[b].next = b+1;
+        newBlock();
+        b++;
+        fresh = true;
+      }
+      label_block[I.a] = b;
+      continue;
+    }
+    fresh = false;
+    if (!is_exit(I)) {
+      blocks[b].code.push_back(I);
+      continue;
+    }
+    blocks[b].exit = I;
+    if (I.is_cond_branch()) blocks[b].next = b+1;
+    for (int k=0; (OP_SWITCH == I.op) && (k < I.b) && (i+1 < code.size()); k++) {
+      blocks[b].table.push_back(code[++i]);
+    }
+    newBlock();
+    fresh = true;
+  }
+
+  for (size_t b=0; b<blocks.size(); b++) {
+    block &B = blocks[b];
+    if (!B.exit.has_target()) continue;
+    for (size_t k=0; k<=B.table.size(); k++) {
+      int L = k ? B.table[k-1].a : B.exit.a;
+      if (L < 0 || L > maxlabel || label_block[L] < 0) {
+        good = false;
+        break;
+      }
+      if (k) B.cases.push_back(label_block[L]);
+      else   B.taken = label_block[L];
+    }
+  }
+}
+
+void flowgraph::newBlock()
+{
+  blocks.resize(blocks.size()+1);
+  block &B = blocks.back();
+  B.exit = make_instr(OP_NOP);
+  B.taken = -1;
+  B.next = -1;
+  B.live = true;
+}
+
+/*
+  True if block b does nothing but go on somewhere else.
+*/
+bool flowgraph::empty(int b) const
+{
+  const block &B = blocks[b];
+  for (size_t i=0; i<B.code.size(); i++) {
+    if ((OP_LINE != B.code[i].op) && (OP_COMMENT != B.code[i].op)) return false;
+  }
+  if (OP_GOTO == B.exit.op) return true;
+  return (OP_NOP == B.exit.op) && (B.next >= 0);
+}
+
+/*
+  Where control ends up after entering block b,
+  skipping over empty blocks (but not around an empty loop).
+*/
+int flowgraph::destination(int b) const
+{
+  for (size_t steps=0; steps<blocks.size(); steps++) {
+    if (!empty(b)) return b;
+    int d = (OP_GOTO == blocks[b].exit.op) ? blocks[b].taken : blocks[b].next;
+    if (d == b) return b;
+    b = d;
+  }
+  return b;
+}
+
+void flowgraph::thread()
+{
+  for (size_t b=0; b<blocks.size(); b++) {
+    block &B = blocks[b];
+    if (!B.live) continue;
+    if (B.taken >= 0) {
+      int d = destination(B.taken);
+      if (d != B.taken) {
+        B.taken = d;
+        threaded++;
+      }
+    }
+    if (B.next >= 0) {
+      int d = destination(B.next);
+      if (d != B.next) {
+        B.next = d;
+        threaded++;
+      }
+    }
+    for (size_t k=0; k<B.cases.size(); k++) {
+      int d = destination(B.cases[k]);
+      if (d != B.cases[k]) {
+        B.cases[k] = d;
+        threaded++;
+      }
+    }
+    /*
+      A conditional branch that goes to the same place either way
+      just has to pop its operands.
+    */
+    if (B.exit.is_cond_branch() && (B.taken == B.next)) {
+      int pops, pushes;
+      stack_effect(B.exit, pops, pushes);
+      while (pops--) B.code.push_back(make_instr(OP_POP));
+      B.exit = make_instr(OP_NOP);
+      B.taken = -1;
+      jumps_removed++;
+    }
+    /* Likewise a switch whose cases all go where its default does */
+    if (OP_SWITCH == B.exit.op) {
+      size_t k = 0;
+      while ((k < B.cases.size()) && (B.cases[k] == B.taken)) k++;
+      if (k < B.cases.size()) continue;
+      B.code.push_back(make_instr(OP_POP));
+      B.exit = make_instr(OP_GOTO);
+      B.table.clear();
+      B.cases.clear();
+      jumps_removed++;
+    }
+  }
+}
+
+void flowgraph::removeUnreachable()
+{
+  std::vector<bool> seen(blocks.size(), false);
+  std::vector<int> work;
+  std::vector<int> succ;
+  work.push_back(0);
+  seen[0] = true;
+  while (!work.empty()) {
+    int b = work.back();
+    work.pop_back();
+    successors(b, succ);
+    for (size_t s=0; s<succ.size(); s++) {
+      if (seen[succ[s]]) continue;
+      seen[succ[s]] = true;
+      work.push_back(succ[s]);
+    }
+  }
+  for (size_t b=0; b<blocks.size(); b++) {
+    if (!blocks[b].live || seen[b]) continue;
+    blocks[b].live = false;
+    /* Don't count the empty block after a final branch or return */
+    if (blocks[b].code.size() || blocks[b].exit.op) unreachable++;
+  }
+
+  /* What's left must not run off the end */
+  for (size_t b=0; b<blocks.size(); b++) {
+    const block &B = blocks[b];
+    if (!B.live) continue;
+    if ((B.next < 0) && ((OP_NOP == B.exit.op) || B.exit.is_cond_branch())) good = false;
+  }
+}
+
+void flowgraph::successors(int b, std::vector<int> &succ) const
+{
+  const block &B = blocks[b];
+  succ.clear();
+  if (B.next >= 0) succ.push_back(B.next);
+  if (B.taken >= 0) succ.push_back(B.taken);
+  succ.insert(succ.end(), B.cases.begin(), B.cases.end());
+}
+
+void flowgraph::countPreds(std::vector<int> &preds) const
+{
+  preds.assign(blocks.size(), 0);
+  std::vector<int> succ;
+  for (size_t b=0; b<blocks.size(); b++) {
+    if (!blocks[b].live) continue;
+    successors(b, succ);
+    for (size_t s=0; s<succ.size(); s++) preds[succ[s]]++;
+  }
+}
+
+void flowgraph::reversePostorder(std::vector<int> &rpo) const
+{
+  int n = blocks.size();
+  std::vector<int> post;
+  std::vector<char> visited(n, 0);
+  std::vector<int> stack;
+  std::vector<int> succ;
+  stack.push_back(0);
+  visited[0] = 1;
+  while (!stack.empty()) {
+    int b = stack.back();
+    successors(b, succ);
+    bool pushed = false;
+    for (size_t s=0; s<succ.size(); s++) {
+      if (visited[succ[s]]) continue;
+      visited[succ[s]] = 1;
+      stack.push_back(succ[s]);
+      pushed = true;
+      break;
+    }
+    if (pushed) continue;
+    post.push_back(b);
+    stack.pop_back();
+  }
+  rpo.assign(post.rbegin(), post.rend());
+}
+
+/*
+  Cooper, Harvey and Kennedy, "A simple, fast dominance algorithm".
+*/
+void flowgraph::dominators(std::vector<int> &idom) const
+{
+  int n = blocks.size();
+  std::vector<int> rpo;
+  reversePostorder(rpo);
+  std::vector<int> pos(n, -1);
+  for (size_t r=0; r<rpo.size(); r++) pos[rpo[r]] = r;
+  std::vector< std::vector<int> > preds(n);
+  std::vector<int> succ;
+  for (size_t r=0; r<rpo.size(); r++) {
+    int b = rpo[r];
+    successors(b, succ);
+    for (size_t s=0; s<succ.size(); s++) preds[succ[s]].push_back(b);
+  }
+  idom.assign(n, -1);
+  idom[0] = 0;
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t r=1; r<rpo.size(); r++) {
+      int b = rpo[r];
+      int d = -1;
+      for (size_t j=0; j<preds[b].size(); j++) {
+        int p = preds[b][j];
+        if (idom[p] < 0) continue;
+        if (d < 0) {
+          d = p;
+          continue;
+        }
+        while (d != p) {
+          while (pos[d] > pos[p]) d = idom[d];
+          while (pos[p] > pos[d]) p = idom[p];
+        }
+      }
+      if (d != idom[b]) {
+        idom[b] = d;
+        changed = true;
+      }
+    }
+  }
+}
+
+void flowgraph::liveness(int nslots)
+{
+  for (size_t b=0; b<blocks.size(); b++) {
+    blocks[b].live_in.assign(nslots, false);
+    blocks[b].live_out.assign(nslots, false);
+  }
+  std::vector<int> rpo;
+  reversePostorder(rpo);
+  std::vector<int> succ;
+  std::vector<bool> live;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t r=rpo.size(); r-- > 0; ) {
+      block &B = blocks[rpo[r]];
+      live.assign(nslots, false);
+      successors(rpo[r], succ);
+      for (size_t s=0; s<succ.size(); s++) {
+        const std::vector<bool> &in = blocks[succ[s]].live_in;
+        for (int k=0; k<nslots; k++) if (in[k]) live[k] = true;
+      }
+      B.live_out = live;
+      for (size_t i=B.code.size(); i-- > 0; ) {
+        const instr &I = B.code[i];
+        if (OP_STORE == I.op) live[I.a] = false;
+        if ((OP_LOAD == I.op) || (OP_IINC == I.op)) live[I.a] = true;
+      }
+      if (live != B.live_in) {
+        B.live_in.swap(live);
+        changed = true;
+      }
+    }
+  }
+}
+
+int flowgraph::addBlock(int to)
+{
+  newBlock();
+  blocks.back().next = to;
+  return blocks.size()-1;
+}
+
+void flowgraph::layout()
+{
+  std::vector<int> preds;
+  countPreds(preds);
+  std::vector<bool> placed(blocks.size(), false);
+  order.clear();
+
+  /*
+    Blocks keep their original order, except that a chain of blocks,
+    each entered only from the one before, is kept together.
+    A loop test with its two ways in stays where it is,
+    so inverted loops are not undone.
+  */
+  for (size_t first=0; first<blocks.size(); first++) {
+    if (!blocks[first].live || placed[first]) continue;
+    int b = first;
+    for (;;) {
+      placed[b] = true;
+      order.push_back(b);
+      const block &B = blocks[b];
+      int s = (OP_GOTO == B.exit.op) ? B.taken : B.next;
+      if (s < 0 || placed[s] || preds[s] != 1) break;
+      if (s != b+1) moved++;
+      b = s;
+    }
+  }
+}
+
+void flowgraph::write(std::vector<instr> &code) const
+{
+  /*
+    First decide the branches, in exits[]: each block gets one or
+    two, with targets as block numbers.  Then number the labels.
+  */
+  std::vector<instr> exits;
+  std::vector<int> first_exit(order.size()+1);
+  std::vector<int> label(blocks.size(), 0);
+  for (size_t i=0; i<order.size(); i++) {
+    first_exit[i] = exits.size();
+    const block &B = blocks[order[i]];
+    int after = (i+1 < order.size()) ? order[i+1] : -1;
+    instr E = B.exit;
+
+    if (OP_NOP == E.op) {
+      if (B.next != after) {
+        exits.push_back(make_instr(OP_GOTO, B.next));
+      }
+      continue;
+    }
+    if (OP_GOTO == E.op) {
+      if (B.taken == after) {
+        jumps_removed++;
+        continue;
+      }
+      E.a = B.taken;
+      exits.push_back(E);
+      continue;
+    }
+    if (OP_SWITCH == E.op) {
+      E.a = B.taken;
+      exits.push_back(E);
+      for (size_t k=0; k<B.table.size(); k++) {
+        instr C = B.table[k];
+        C.a = B.cases[k];
+        exits.push_back(C);
+      }
+      continue;
+    }
+    if (!E.is_cond_branch()) {
+      exits.push_back(E);
+      continue;
+    }
+    if (B.next == after) {
+      E.a = B.taken;
+      exits.push_back(E);
+      continue;
+    }
+    if (B.taken == after) {
+      E.op = negate(E.op);
+      E.a = B.next;
+      exits.push_back(E);
+      branches_flipped++;
+      continue;
+    }
+    E.a = B.taken;
+    exits.push_back(E);
+    exits.push_back(make_instr(OP_GOTO, B.next));
+  }
+  first_exit[order.size()] = exits.size();
+
+  for (size_t e=0; e<exits.size(); e++) {
+    if (exits[e].has_target()) label[exits[e].a] = 1;
+  }
+  int labels = 0;
+  for (size_t i=0; i<order.size(); i++) {
+    if (label[order[i]]) label[order[i]] = ++labels;
+  }
+
+  code.clear();
+  for (size_t i=0; i<order.size(); i++) {
+    const block &B = blocks[order[i]];
+    if (label[order[i]]) code.push_back(make_instr(OP_LABEL, label[order[i]]));
+    code.insert(code.end(), B.code.begin(), B.code.end());
+    for (int e=first_exit[i]; e<first_exit[i+1]; e++) {
+      instr E = exits[e];
+      if (E.has_target()) E.a = label[E.a];
+      code.push_back(E);
+    }
+  }
+}
+
+void flowgraph::optimize(std::vector<instr> &code)
+{
+  flowgraph G(code);
+  if (!G.ok()) return;
+  G.removeUnreachable();
+  if (!G.ok()) return;
+  G.thread();
+  G.removeUnreachable();
+  G.layout();
+  G.write(code);
+}
+
+void flowgraph::showStats(std::ostream &s)
+{
+  s << "Control flow\n";
+  s << "\tjumps threaded: " << threaded << "\n";
+  s << "\tunreachable blocks: " << unreachable << "\n";
+  s << "\tblocks moved: " << moved << "\n";
+  s << "\tjumps removed: " << jumps_removed << "\n";
+  s << "\tbranches flipped: " << branches_flipped << "\n";
+}
+
+void flowgraph::clearStats()
+{
+  threaded = 0;
+  unreachable = 0;
+  moved = 0;
+  jumps_removed = 0;
+  branches_flipped = 0;
+}
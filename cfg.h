@@ -0,0 +1,148 @@
+
+#ifndef CFG_H
+#define CFG_H
+
+#include <iostream>
+#include <vector>
+
+#include "instr.h"
+
+/*
+  Control-flow graph of one method.
+
+  The code is cut into basic blocks: straight-line code that is
+  entered only at the top (where its labels were) and left only at
+  the bottom, by its branch or return, or by falling into the block
+  that followed it.  Successors are kept explicitly, so blocks can
+  be dropped and reordered; write() puts back whatever gotos the
+  new order needs, and drops the ones it no longer needs.
+*/
+
+class flowgraph {
+  public:
+    struct block {
+        /* Everything but the labels and the final branch or return */
+        std::vector<instr> code;
+        /* Branch or return at the end, or OP_NOP to fall through */
+        instr exit;
+        /* Block the branch goes to, or -1 */
+        int taken;
+        /* Block reached by falling through (not after goto or return), or -1 */
+        int next;
+        /* For a switch: its OP_CASEs, and the block each goes to */
+        std::vector<instr> table;
+        std::vector<int> cases;
+        bool live;
+        /* Locals live on entry and at the end, after liveness() */
+        std::vector<bool> live_in;
+        std::vector<bool> live_out;
+    };
+
+    /*
+      Blocks in their original order; block 0 is the entry.
+    */
+    std::vector<block> blocks;
+
+  public:
+    /*
+      Build the graph for code, which must have all its labels.
+      Check ok() before using it.
+    */
+    flowgraph(const std::vector<instr> &code);
+
+    /*
+      False if the code could not be made into a graph: a branch to a
+      missing label, or control that falls off the end.  Such code
+      is best left alone, for compute_frame() to complain about.
+    */
+    inline bool ok() const { return good; }
+
+    /*
+      Retarget branches (and fall-throughs) that lead to an empty
+      block which just goes on somewhere else.
+    */
+    void thread();
+
+    /*
+      Drop the blocks that can't be reached from the entry.
+    */
+    void removeUnreachable();
+
+    /*
+      Choose the order blocks are written in: a block reached only
+      by a goto or a fall-through from one other block goes right
+      after that block, so the jump disappears.
+    */
+    void layout();
+
+    /*
+      Write the live blocks back as code, in layout order.
+      Gotos to the next block are dropped, conditional branches are
+      flipped when that saves a goto, and only labels that are
+      branched to are written (renumbered in order).
+    */
+    void write(std::vector<instr> &code) const;
+
+    /*
+      Blocks that control goes to from block b: where it branches,
+      where it falls through, and the cases of a switch.
+    */
+    void successors(int b, std::vector<int> &succ) const;
+
+    /*
+      Number of live predecessors of each block, counting each edge.
+    */
+    void countPreds(std::vector<int> &preds) const;
+
+    /*
+      Blocks reached from the entry, in reverse postorder
+      (each block before its successors, except along back edges).
+    */
+    void reversePostorder(std::vector<int> &rpo) const;
+
+    /*
+      Immediate dominator of each block reached from the entry
+      (the entry is its own), or -1.
+    */
+    void dominators(std::vector<int> &idom) const;
+
+    /*
+      Find the locals live on entry to and at the end of each block
+      reached from the entry: those whose value may still be loaded.
+      Iterates backwards over the blocks until nothing changes.
+        @param  nslots    Number of local slots the code uses
+    */
+    void liveness(int nslots);
+
+    /*
+      Add an empty block that goes on to block to.  The caller moves
+      the edges that should pass through it.
+        @return   the new block
+    */
+    int addBlock(int to);
+
+    /*
+      All of the above, on one method's code in place.
+    */
+    static void optimize(std::vector<instr> &code);
+
+    /*
+      Show what the passes did, for -s.
+    */
+    static void showStats(std::ostream &s);
+
+    /*
+      Start the counts for showStats() over.
+    */
+    static void clearStats();
+
+  private:
+    bool good;
+    std::vector<int> order;
+
+    void newBlock();
+    bool empty(int b) const;
+    int destination(int b) const;
+};
+
+#endif
@@ -0,0 +1,702 @@
+
+#include "classfile.h"
+#include "lexer.h"
+
+#include <ctype.h>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  Access flags.
+*/
+#define ACC_PUBLIC    0x0001
+#define ACC_STATIC    0x0008
+#define ACC_SUPER     0x0020
+
+/*
+  Constant pool tags.
+*/
+#define CONSTANT_Utf8         1
+#define CONSTANT_Integer      3
+#define CONSTANT_Float        4
+#define CONSTANT_Class        7
+#define CONSTANT_String       8
+#define CONSTANT_Fieldref     9
+#define CONSTANT_Methodref    10
+#define CONSTANT_NameAndType  12
+
+/*
+  The JVM opcodes we write.
+*/
+enum {
+    JVM_ICONST_M1     = 0x02,
+    JVM_ICONST_0      = 0x03,
+    JVM_FCONST_0      = 0x0b,
+    JVM_BIPUSH        = 0x10,
+    JVM_SIPUSH        = 0x11,
+    JVM_LDC           = 0x12,
+    JVM_LDC_W         = 0x13,
+    JVM_ILOAD         = 0x15,
+    JVM_FLOAD         = 0x17,
+    JVM_ILOAD_0       = 0x1a,
+    JVM_FLOAD_0       = 0x22,
+    JVM_ALOAD_0       = 0x2a,
+    JVM_IALOAD        = 0x2e,
+    JVM_FALOAD        = 0x30,
+    JVM_CALOAD        = 0x34,
+    JVM_ISTORE        = 0x36,
+    JVM_FSTORE        = 0x38,
+    JVM_ISTORE_0      = 0x3b,
+    JVM_FSTORE_0      = 0x43,
+    JVM_IASTORE       = 0x4f,
+    JVM_FASTORE       = 0x51,
+    JVM_CASTORE       = 0x55,
+    JVM_POP           = 0x57,
+    JVM_DUP           = 0x59,
+    JVM_IADD          = 0x60,
+    JVM_ISUB          = 0x64,
+    JVM_IMUL          = 0x68,
+    JVM_IDIV          = 0x6c,
+    JVM_IREM          = 0x70,
+    JVM_INEG          = 0x74,
+    JVM_IAND          = 0x7e,
+    JVM_IOR           = 0x80,
+    JVM_IXOR          = 0x82,
+    JVM_IINC          = 0x84,
+    JVM_IFEQ          = 0x99,
+    JVM_GOTO          = 0xa7,
+    JVM_TABLESWITCH   = 0xaa,
+    JVM_LOOKUPSWITCH  = 0xab,
+    JVM_IRETURN       = 0xac,
+    JVM_FRETURN       = 0xae,
+    JVM_RETURN        = 0xb1,
+    JVM_GETSTATIC     = 0xb2,
+    JVM_PUTSTATIC     = 0xb3,
+    JVM_INVOKEVIRTUAL = 0xb6,
+    JVM_INVOKESPECIAL = 0xb7,
+    JVM_INVOKESTATIC  = 0xb8,
+    JVM_NEWARRAY      = 0xbc,
+    JVM_WIDE          = 0xc4,
+    JVM_GOTO_W        = 0xc8
+};
+
+/* ====================================================================== */
+
+static inline void u1(std::vector<unsigned char> &b, unsigned x)
+{
+  b.push_back(x & 0xff);
+}
+
+static inline void u2(std::vector<unsigned char> &b, unsigned x)
+{
+  b.push_back((x >> 8) & 0xff);
+  b.push_back(x & 0xff);
+}
+
+static inline void u4(std::vector<unsigned char> &b, unsigned x)
+{
+  b.push_back((x >> 24) & 0xff);
+  b.push_back((x >> 16) & 0xff);
+  b.push_back((x >> 8) & 0xff);
+  b.push_back(x & 0xff);
+}
+
+static inline void append(std::vector<unsigned char> &b, const std::vector<unsigned char> &more)
+{
+  b.insert(b.end(), more.begin(), more.end());
+}
+
+/*
+  Element type code for newarray.
+*/
+static unsigned atype(char type)
+{
+  switch (type) {
+    case 'C':   return 5;
+    case 'F':   return 6;
+  }
+  return 10;
+}
+
+/* ====================================================================== */
+
+class_backend::class_backend(sink* S, const std::string &classname, const char* src)
+{
+  out = S;
+  owner = classname;
+  srcname = src;
+  failed = false;
+  pool_count = 1;
+
+  this_class = classref(owner);
+  super_class = classref("java/lang/Object");
+
+  /* <init>, which just calls Object's */
+  bytes bc;
+  u1(bc, JVM_ALOAD_0);
+  u1(bc, JVM_INVOKESPECIAL);
+  u2(bc, methodref("java/lang/Object", "<init>", "()V"));
+  u1(bc, JVM_RETURN);
+  bytes attr;
+  codeAttribute(attr, 1, 1, bc, bytes(), 0);
+  addMethod(ACC_PUBLIC, "<init>", "()V", attr);
+}
+
+class_backend::~class_backend()
+{
+  delete out;
+}
+
+/* ====================================================================== */
+
+unsigned class_backend::constant(const std::string &entry, unsigned slots)
+{
+  std::map<std::string, unsigned>::iterator i = pool_index.find(entry);
+  if (i != pool_index.end()) return i->second;
+
+  unsigned index = pool_count;
+  pool.insert(pool.end(), entry.begin(), entry.end());
+  pool_count += slots;
+  pool_index[entry] = index;
+  if (pool_count > 0xffff) failed = true;
+  return index;
+}
+
+unsigned class_backend::utf8(const char* text, size_t len)
+{
+  /* Modified UTF-8: NUL is written as two bytes */
+  std::string enc;
+  for (size_t i=0; i<len; i++) {
+    unsigned char c = text[i];
+    if (0 == c) {
+      enc += (char) 0xc0;
+      enc += (char) 0x80;
+    } else if (c < 0x80) {
+      enc += (char) c;
+    } else {
+      enc += (char) (0xc0 | (c >> 6));
+      enc += (char) (0x80 | (c & 0x3f));
+    }
+  }
+  std::string entry;
+  entry += (char) CONSTANT_Utf8;
+  entry += (char) ((enc.length() >> 8) & 0xff);
+  entry += (char) (enc.length() & 0xff);
+  entry += enc;
+  return constant(entry);
+}
+
+unsigned class_backend::utf8(const std::string &text)
+{
+  return utf8(text.data(), text.length());
+}
+
+/*
+  Tag followed by big-endian 16 or 32 bit values.
+*/
+static std::string tagged(int tag, unsigned x, int bytes)
+{
+  std::string entry;
+  entry += (char) tag;
+  for (int sh = 8*(bytes-1); sh >= 0; sh -= 8) {
+    entry += (char) ((x >> sh) & 0xff);
+  }
+  return entry;
+}
+
+static std::string tagged(int tag, unsigned x, unsigned y)
+{
+  return tagged(tag, (x << 16) | y, 4);
+}
+
+unsigned class_backend::integer(int value)
+{
+  return constant(tagged(CONSTANT_Integer, (unsigned) value, 4));
+}
+
+unsigned class_backend::floating(float value)
+{
+  unsigned bits;
+  memcpy(&bits, &value, 4);
+  return constant(tagged(CONSTANT_Float, bits, 4));
+}
+
+unsigned class_backend::string(const std::string &text)
+{
+  return constant(tagged(CONSTANT_String, utf8(text), 2));
+}
+
+unsigned class_backend::classref(const std::string &name)
+{
+  return constant(tagged(CONSTANT_Class, utf8(name), 2));
+}
+
+unsigned class_backend::name_and_type(const std::string &name, const std::string &desc)
+{
+  return constant(tagged(CONSTANT_NameAndType, utf8(name), utf8(desc)));
+}
+
+unsigned class_backend::fieldref(const std::string &cls, const std::string &name, const std::string &desc)
+{
+  return constant(tagged(CONSTANT_Fieldref, classref(cls), name_and_type(name, desc)));
+}
+
+unsigned class_backend::methodref(const std::string &cls, const std::string &name, const std::string &desc)
+{
+  return constant(tagged(CONSTANT_Methodref, classref(cls), name_and_type(name, desc)));
+}
+
+/* ====================================================================== */
+
+void class_backend::addMethod(unsigned access, const char* name, const char* desc, const bytes &code)
+{
+  member M;
+  M.access = access;
+  M.name = utf8(name, strlen(name));
+  M.desc = utf8(desc, strlen(desc));
+  M.code = code;
+  methods.push_back(M);
+}
+
+void class_backend::codeAttribute(bytes &attr, int max_stack, int max_locals,
+                                  const bytes &code, const bytes &lines, unsigned nlines)
+{
+  bytes body;
+  u2(body, max_stack);
+  u2(body, max_locals);
+  u4(body, code.size());
+  append(body, code);
+  u2(body, 0);                /* no exception table */
+  if (nlines) {
+    u2(body, 1);
+    u2(body, utf8("LineNumberTable"));
+    u4(body, 2 + lines.size());
+    u2(body, nlines);
+    append(body, lines);
+  } else {
+    u2(body, 0);
+  }
+
+  attr.clear();
+  u2(attr, utf8("Code"));
+  u4(attr, body.size());
+  append(attr, body);
+}
+
+/*
+  Local variable instructions, with the one-byte forms for slots 0-3
+  and wide for slots past 255.
+*/
+static void local_op(std::vector<unsigned char> &bc, unsigned general, unsigned short_form, int slot)
+{
+  if (slot <= 3) {
+    u1(bc, short_form + slot);
+  } else if (slot <= 255) {
+    u1(bc, general);
+    u1(bc, slot);
+  } else {
+    u1(bc, JVM_WIDE);
+    u1(bc, general);
+    u2(bc, slot);
+  }
+}
+
+/*
+  Offset of a switch target from the switch at offset at.
+*/
+int class_backend::switchOffset(const std::vector<int> &where, int label, int at)
+{
+  if (((size_t) label >= where.size()) || (where[label] < 0)) {
+    diagnostics() << "Error, branch to a missing label in " << owner << ".class\n";
+    failed = true;
+    return 0;
+  }
+  return where[label] - at;
+}
+
+void class_backend::assemble(const std::vector<instr> &code, bytes &bc, bytes &lines, unsigned &nlines)
+{
+  /*
+    Layout passes find the offset of every label and branch, and
+    a last pass writes the code with the real branch offsets.
+    Branches start out three bytes, with 16-bit offsets.  One that
+    turns out to need more is widened, and the code laid out again:
+    a goto becomes a goto_w, and an if<cond> becomes the opposite
+    if<cond> over a goto_w.  Widening only makes the code longer, so
+    it stops; the offsets found by the last layout hold in the write.
+  */
+  std::vector<int> where;
+  std::vector<int> start(code.size(), 0);
+  std::vector<bool> wide(code.size(), false);
+  for (int pass=0; ; ) {
+    bc.clear();
+    lines.clear();
+    nlines = 0;
+    for (size_t i=0; i<code.size(); i++) {
+      const instr &I = code[i];
+      const char* name = I.sym ? atom_table::name(I.sym) : "";
+      bool is_float = ('F' == I.type);
+
+      switch (I.op) {
+        case OP_NOP:
+        case OP_COMMENT:
+            continue;
+
+        case OP_LABEL:
+            if ((size_t) I.a >= where.size()) where.resize(I.a+1, -1);
+            where[I.a] = bc.size();
+            continue;
+
+        case OP_LINE:
+            u2(lines, bc.size());
+            u2(lines, I.a);
+            nlines++;
+            continue;
+
+        case OP_ICONST:
+            if ((I.a >= -1) && (I.a <= 5)) {
+              u1(bc, JVM_ICONST_0 + I.a);
+            } else if ((I.a >= -128) && (I.a < 128)) {
+              u1(bc, JVM_BIPUSH);
+              u1(bc, I.a);
+            } else if ((I.a >= -32768) && (I.a < 32768)) {
+              u1(bc, JVM_SIPUSH);
+              u2(bc, I.a);
+            } else {
+              unsigned k = integer(I.a);
+              if (k < 256) { u1(bc, JVM_LDC);   u1(bc, k); }
+              else         { u1(bc, JVM_LDC_W); u2(bc, k); }
+            }
+            continue;
+
+        case OP_FCONST: {
+            float f = strtof(name, 0);
+            if ((0.0f == f || 1.0f == f || 2.0f == f) && !(0.0f == f && '-' == name[0])) {
+              u1(bc, JVM_FCONST_0 + (int) f);
+              continue;
+            }
+            unsigned k = floating(f);
+            if (k < 256) { u1(bc, JVM_LDC);   u1(bc, k); }
+            else         { u1(bc, JVM_LDC_W); u2(bc, k); }
+            continue;
+        }
+
+        case OP_SCONST: {
+            unsigned k = string(unquote(name));
+            if (k < 256) { u1(bc, JVM_LDC);   u1(bc, k); }
+            else         { u1(bc, JVM_LDC_W); u2(bc, k); }
+            continue;
+        }
+
+        case OP_LOAD:
+            if (is_float) local_op(bc, JVM_FLOAD, JVM_FLOAD_0, I.a);
+            else          local_op(bc, JVM_ILOAD, JVM_ILOAD_0, I.a);
+            continue;
+
+        case OP_STORE:
+            if (is_float) local_op(bc, JVM_FSTORE, JVM_FSTORE_0, I.a);
+            else          local_op(bc, JVM_ISTORE, JVM_ISTORE_0, I.a);
+            continue;
+
+        case OP_ALOAD:
+            switch (I.type) {
+              case 'C':   u1(bc, JVM_CALOAD);   break;
+              case 'F':   u1(bc, JVM_FALOAD);   break;
+              default:    u1(bc, JVM_IALOAD);
+            }
+            continue;
+
+        case OP_ASTORE:
+            switch (I.type) {
+              case 'C':   u1(bc, JVM_CASTORE);  break;
+              case 'F':   u1(bc, JVM_FASTORE);  break;
+              default:    u1(bc, JVM_IASTORE);
+            }
+            continue;
+
+        case OP_GETSTATIC:
+        case OP_PUTSTATIC: {
+            std::string desc;
+            if (I.flags & FLAG_ARRAY) desc += '[';
+            desc += I.type;
+            u1(bc, (OP_GETSTATIC == I.op) ? JVM_GETSTATIC : JVM_PUTSTATIC);
+            u2(bc, fieldref(owner, name, desc));
+            continue;
+        }
+
+        case OP_NEWARRAY:
+            u1(bc, JVM_NEWARRAY);
+            u1(bc, atype(I.type));
+            continue;
+
+        case OP_IINC:
+            if ((I.a <= 255) && (I.b >= -128) && (I.b < 128)) {
+              u1(bc, JVM_IINC);
+              u1(bc, I.a);
+              u1(bc, I.b);
+            } else {
+              u1(bc, JVM_WIDE);
+              u1(bc, JVM_IINC);
+              u2(bc, I.a);
+              u2(bc, I.b);
+            }
+            continue;
+
+        case OP_IADD:   u1(bc, JVM_IADD);   continue;
+        case OP_ISUB:   u1(bc, JVM_ISUB);   continue;
+        case OP_IMUL:   u1(bc, JVM_IMUL);   continue;
+        case OP_IDIV:   u1(bc, JVM_IDIV);   continue;
+        case OP_IREM:   u1(bc, JVM_IREM);   continue;
+        case OP_IOR:    u1(bc, JVM_IOR);    continue;
+        case OP_IAND:   u1(bc, JVM_IAND);   continue;
+        case OP_IXOR:   u1(bc, JVM_IXOR);   continue;
+        case OP_INEG:   u1(bc, JVM_INEG);   continue;
+        case OP_DUP:    u1(bc, JVM_DUP);    continue;
+        case OP_POP:    u1(bc, JVM_POP);    continue;
+
+        case OP_INVOKESTATIC:
+            u1(bc, JVM_INVOKESTATIC);
+            u2(bc, methodref((I.flags & FLAG_LIBC) ? "libc" : owner,
+                             name, atom_table::name(I.desc)));
+            continue;
+
+        case OP_INVOKEVIRTUAL:
+            u1(bc, JVM_INVOKEVIRTUAL);
+            u2(bc, methodref("java/lang/String", name, atom_table::name(I.desc)));
+            continue;
+
+        case OP_SWITCH: {
+            /*
+              Padded so the table starts on a multiple of 4 from the
+              start of the code; offsets are from the opcode.
+            */
+            int at = bc.size();
+            const instr* cases = &code[i+1];
+            int n = I.b;
+            i += n;
+            bool table = dense_switch(cases, n);
+            u1(bc, table ? JVM_TABLESWITCH : JVM_LOOKUPSWITCH);
+            while (bc.size() % 4) u1(bc, 0);
+            u4(bc, pass ? switchOffset(where, I.a, at) : 0);
+            if (table) {
+              u4(bc, cases[0].b);
+              u4(bc, cases[n-1].b);
+              int k = 0;
+              for (int v = cases[0].b; ; v++) {
+                int L = (v == cases[k].b) ? cases[k++].a : I.a;
+                u4(bc, pass ? switchOffset(where, L, at) : 0);
+                if (v == cases[n-1].b) break;
+              }
+            } else {
+              u4(bc, n);
+              for (int k=0; k<n; k++) {
+                u4(bc, cases[k].b);
+                u4(bc, pass ? switchOffset(where, cases[k].a, at) : 0);
+              }
+            }
+            continue;
+        }
+
+        case OP_CASE:
+            continue;
+
+        case OP_RETURN:
+            u1(bc, JVM_RETURN);
+            continue;
+
+        case OP_VRETURN:
+            u1(bc, is_float ? JVM_FRETURN : JVM_IRETURN);
+            continue;
+      }
+
+      if (I.is_branch()) {
+        int at = bc.size();
+        start[i] = at;
+        int offset = 0;
+        if (pass) {
+          if (((size_t) I.a >= where.size()) || (where[I.a] < 0)) {
+            diagnostics() << "Error, branch to a missing label in " << owner << ".class\n";
+            failed = true;
+          } else {
+            offset = where[I.a] - at;
+          }
+        }
+        if (!wide[i]) {
+          u1(bc, (OP_GOTO == I.op) ? JVM_GOTO : JVM_IFEQ + (I.op - OP_IFEQ));
+          u2(bc, offset);
+        } else if (OP_GOTO == I.op) {
+          u1(bc, JVM_GOTO_W);
+          u4(bc, offset);
+        } else {
+          u1(bc, JVM_IFEQ + (negate(I.op) - OP_IFEQ));
+          u2(bc, 8);
+          u1(bc, JVM_GOTO_W);
+          u4(bc, offset - 3);
+        }
+        continue;
+      }
+
+      diagnostics() << "Error, can't encode instruction " << opname(I.op) << "\n";
+      failed = true;
+    }
+    if (pass) break;
+
+    /* Lay out again if a branch had to be widened */
+    pass = 1;
+    for (size_t i=0; i<code.size(); i++) {
+      const instr &I = code[i];
+      if (!I.is_branch() || wide[i]) continue;
+      if (((size_t) I.a >= where.size()) || (where[I.a] < 0)) continue;
+      int offset = where[I.a] - start[i];
+      if ((offset < -32768) || (offset > 32767)) {
+        wide[i] = true;
+        pass = 0;
+      }
+    }
+  }
+}
+
+/* ====================================================================== */
+
+void class_backend::field(atom_id name, char type, bool is_array, const instr* init)
+{
+  std::string desc;
+  if (is_array) desc += '[';
+  desc += type;
+
+  member F;
+  F.access = ACC_PUBLIC | ACC_STATIC;
+  F.name = utf8(atom_table::name(name), atom_table::length(name));
+  F.desc = utf8(desc);
+  if (init) {
+    unsigned k = (OP_FCONST == init->op)
+      ? floating(strtof(atom_table::name(init->sym), 0))
+      : integer(init->a);
+    u2(F.code, utf8("ConstantValue"));
+    u4(F.code, 2);
+    u2(F.code, k);
+  }
+  fields.push_back(F);
+}
+
+void class_backend::method(const char* name, const char* desc,
+                           const std::vector<instr> &code, const frame_info &frame)
+{
+  bytes bc, lines, attr;
+  unsigned nlines;
+  assemble(code, bc, lines, nlines);
+  if (bc.size() > 65535) {
+    diagnostics() << "Error, method " << name << " is too large for a class file\n";
+    failed = true;
+  }
+  codeAttribute(attr, frame.max_stack, frame.max_locals, bc, lines, nlines);
+
+  bool clinit = (0==strcmp(name, "<clinit>"));
+  addMethod(clinit ? ACC_STATIC : (ACC_PUBLIC | ACC_STATIC), name, desc, attr);
+}
+
+void class_backend::entry(bool show_result)
+{
+  bytes bc;
+  u1(bc, JVM_INVOKESTATIC);
+  u2(bc, methodref(owner, "main", "()I"));
+  if (show_result) {
+    unsigned out = fieldref("java/lang/System", "out", "Ljava/io/PrintStream;");
+    u1(bc, JVM_ISTORE_0 + 1);
+    u1(bc, JVM_GETSTATIC);
+    u2(bc, out);
+    unsigned k = string("Return code: ");
+    if (k < 256) { u1(bc, JVM_LDC);   u1(bc, k); }
+    else         { u1(bc, JVM_LDC_W); u2(bc, k); }
+    u1(bc, JVM_INVOKEVIRTUAL);
+    u2(bc, methodref("java/io/PrintStream", "print", "(Ljava/lang/String;)V"));
+    u1(bc, JVM_GETSTATIC);
+    u2(bc, out);
+    u1(bc, JVM_ILOAD_0 + 1);
+    u1(bc, JVM_INVOKEVIRTUAL);
+    u2(bc, methodref("java/io/PrintStream", "println", "(I)V"));
+  } else {
+    u1(bc, JVM_POP);
+  }
+  u1(bc, JVM_RETURN);
+
+  bytes attr;
+  if (show_result) codeAttribute(attr, 2, 2, bc, bytes(), 0);
+  else             codeAttribute(attr, 1, 1, bc, bytes(), 0);
+  addMethod(ACC_PUBLIC | ACC_STATIC, "main", "([Ljava/lang/String;)V", attr);
+}
+
+/*
+  Copy a small piece of the class file into the sink.
+*/
+static inline void emit(sink* out, const std::vector<unsigned char> &b)
+{
+  if (!b.empty()) out->put((const char*) &b[0], b.size());
+}
+
+bool class_backend::finish()
+{
+  /* Everything referenced from here on must be in the pool first */
+  const char* base = strrchr(srcname, '/');
+  base = base ? base+1 : srcname;
+  unsigned source_attr = utf8("SourceFile");
+  unsigned source = utf8(base, strlen(base));
+
+  /*
+    The pool and the method bodies are already laid out as they
+    will be in the file, so they go to the sink as blocks, uncopied.
+  */
+  bytes b;
+  u4(b, 0xcafebabe);
+  u2(b, 0);                   /* minor version */
+  u2(b, 49);                  /* major version: Java 5 */
+  u2(b, pool_count);
+  emit(out, b);
+  if (!pool.empty()) out->putBlock(&pool[0], pool.size());
+
+  b.clear();
+  u2(b, ACC_PUBLIC | ACC_SUPER);
+  u2(b, this_class);
+  u2(b, super_class);
+  u2(b, 0);                   /* no interfaces */
+  u2(b, fields.size());
+  emit(out, b);
+  for (size_t i=0; i<fields.size(); i++) {
+    b.clear();
+    u2(b, fields[i].access);
+    u2(b, fields[i].name);
+    u2(b, fields[i].desc);
+    u2(b, fields[i].code.empty() ? 0 : 1);
+    emit(out, b);
+    emit(out, fields[i].code);
+  }
+
+  b.clear();
+  u2(b, methods.size());
+  emit(out, b);
+  for (size_t i=0; i<methods.size(); i++) {
+    b.clear();
+    u2(b, methods[i].access);
+    u2(b, methods[i].name);
+    u2(b, methods[i].desc);
+    u2(b, 1);
+    emit(out, b);
+    out->putBlock(&methods[i].code[0], methods[i].code.size());
+  }
+
+  b.clear();
+  u2(b, 1);
+  u2(b, source_attr);
+  u4(b, 2);
+  u2(b, source);
+  emit(out, b);
+
+  bool ok = !failed;
+  if (pool_count > 0xffff) {
+    diagnostics() << "Error, too many constants for a class file\n";
+    ok = false;
+  }
+  if (!out->close()) ok = false;
+  return ok;
+}
@@ -0,0 +1,75 @@
+
+#ifndef CLASSFILE_H
+#define CLASSFILE_H
+
+#include <map>
+
+#include "backend.h"
+
+/*
+  JVM class files, written directly.
+
+  Version 49 (Java 5) class files are generated, so the verifier
+  infers stack maps itself and none are written.  Everything is
+  kept in memory and written by finish().
+*/
+class class_backend : public backend {
+    typedef std::vector<unsigned char> bytes;
+
+    struct member {
+        unsigned access;
+        unsigned name;      /* constant pool index */
+        unsigned desc;      /* constant pool index */
+        bytes code;         /* the whole Code (or ConstantValue) attribute, or empty */
+    };
+
+  private:
+    sink* out;
+    std::string owner;
+    const char* srcname;
+    bool failed;
+    unsigned this_class;
+    unsigned super_class;
+
+    /*
+      Constant pool, as it will be written, and the index of
+      each entry, keyed by its encoding, so nothing is added twice.
+    */
+    bytes pool;
+    unsigned pool_count;
+    std::map<std::string, unsigned> pool_index;
+
+    std::vector<member> fields;
+    std::vector<member> methods;
+
+  public:
+    /* We own (and delete) the sink */
+    class_backend(sink* S, const std::string &classname, const char* src);
+    virtual ~class_backend();
+
+    virtual void field(atom_id name, char type, bool is_array, const instr* init);
+    virtual void method(const char* name, const char* desc,
+                        const std::vector<instr> &code, const frame_info &frame);
+    virtual void entry(bool show_result);
+    virtual bool finish();
+
+  private:
+    unsigned constant(const std::string &entry, unsigned slots = 1);
+    unsigned utf8(const char* text, size_t len);
+    unsigned utf8(const std::string &text);
+    unsigned integer(int value);
+    unsigned floating(float value);
+    unsigned string(const std::string &text);
+    unsigned classref(const std::string &name);
+    unsigned name_and_type(const std::string &name, const std::string &desc);
+    unsigned fieldref(const std::string &cls, const std::string &name, const std::string &desc);
+    unsigned methodref(const std::string &cls, const std::string &name, const std::string &desc);
+
+    void addMethod(unsigned access, const char* name, const char* desc, const bytes &code);
+    void codeAttribute(bytes &attr, int max_stack, int max_locals,
+                       const bytes &code, const bytes &lines, unsigned nlines);
+    void assemble(const std::vector<instr> &code, bytes &bc, bytes &lines, unsigned &nlines);
+    int switchOffset(const std::vector<int> &where, int label, int at);
+};
+
+#endif
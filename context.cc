@@ -0,0 +1,176 @@
+#include "context.h"
+#include "x86.h"
+#include "grammar.tab.h"    /* Tokens defined here */
+
+#include <string>
+
+thread_local compiler_context* compiler_context::CURRENT;
+
+compiler_context::compiler_context()
+{
+  outer = 0;
+}
+
+void compiler_context::bind()
+{
+  outer = CURRENT;
+  CURRENT = this;
+  atom_table::THE_TABLE = &atoms;
+  parse_data::THE_DATA = &data;
+}
+
+void compiler_context::unbind()
+{
+  CURRENT = outer;
+  atom_table::THE_TABLE = outer ? &outer->atoms : 0;
+  parse_data::THE_DATA = outer ? &outer->data : 0;
+  outer = 0;
+}
+
+/*
+  Keeps a context bound for as long as it is in scope.
+*/
+class binding {
+    compiler_context &ctx;
+  public:
+    binding(compiler_context &C) : ctx(C) { ctx.bind(); }
+    ~binding() { ctx.unbind(); }
+};
+
+/*
+  Ends a compilation however compile() returns: the front end's data,
+  the lexer's input and the atoms are released, so a reused context
+  starts clean, with its arenas' memory ready for the next file.
+  Declared after the binding, so it goes first.
+*/
+class compilation {
+  public:
+    ~compilation() {
+      parse_data::Finalize();
+      closeLexer();
+      atom_table::clear();
+    }
+};
+
+/* ====================================================================== */
+
+static int version(std::ostream &s)
+{
+  s << "My bare-bones C compiler (for COM 440/540)\n";
+  s << "\tWritten by Anju Kumari (ank@iastate.edu)\n";
+  s << "\tVersion 0.1\n";
+  s << "\t5 January, 2021\n";
+  return 0;
+}
+
+static int dump_tokens(std::ostream &s)
+{
+  YYSTYPE value;
+  void* scanner = currentLexer().scanner;
+  for (int tok=yylex(&value, scanner); tok; tok=yylex(&value, scanner)) {
+    printLocation(s);
+    s << " token " << getTokenName(tok) << "\n";
+    s.flush();
+    // for (int  i=1; i<300000000; i++);    // Add delay for testing script :)
+  }
+  return 0;
+}
+
+/*
+  Class to generate for an input file: its name without the ".c".
+*/
+static std::string class_name(const char* infile)
+{
+  std::string name(infile);
+  size_t len = name.length();
+  if ((len > 2) && (0 == name.compare(len-2, 2, ".c"))) {
+    name.erase(len-2);
+  }
+  return name;
+}
+
+int compile(compiler_context &ctx, const char* infile, const char* text, size_t len,
+            const compile_options &opts, std::ostream &fout)
+{
+  std::ostream &err = opts.errors ? *opts.errors : std::cerr;
+  char mode = opts.mode;
+  if (' ' == mode) {
+    err << "No mode specified; run without arguments for usage.\n";
+    return 6;
+  }
+
+  if ('0'==mode) {
+    if (infile) {
+      err << "Warning: ignoring input file\n";
+    }
+    return version(fout);
+  }
+
+  if (0==infile) {
+    err << "Error, no input file(s) specified.  Nothing to do.\n";
+    return 7;
+  }
+
+  binding bound(ctx);
+  compilation done;
+  ctx.lexer.errors = &err;
+
+  if (!initLexer(infile, text, len, '1' == mode, '5' == mode, '4' == mode)) {
+    return 7;
+  }
+
+  if ('1'==mode) {
+    return dump_tokens(fout);
+  }
+
+  backend* out = 0;
+  if ( ('4' == mode) || ('5' == mode) ) {
+    out = open_backend(opts.target, class_name(infile), infile);
+    if (0==out) return 9;
+  }
+
+  parse_data::clearStats();
+  flowgraph::clearStats();
+  loopnest::clearStats();
+  ssa::clearStats();
+  peephole::clearStats();
+  slotalloc::clearStats();
+  x86_backend::clearStats();
+
+  parse_data::Initialize(mode > '2', out);
+  yyparse(currentLexer().scanner);
+  // We could catch the return of yyparse() to know
+  // if a syntax error occurred or not.
+
+  if (opts.stats) {
+    parse_data::showMemory(err);
+    parse_data::showCalls(err);
+    parse_data::showSwitches(err);
+    flowgraph::showStats(err);
+    loopnest::showStats(err);
+    ssa::showStats(err);
+    peephole::showStats(err);
+    slotalloc::showStats(err);
+    if (TARGET_X86 == opts.target) x86_backend::showStats(err);
+  }
+
+  if ( ('2' == mode) || ('3' == mode) ) {
+    parse_data::showGlobals(fout);
+    parse_data::showFunctions(fout);
+    return 0;
+  }
+
+  if ( ('4' == mode) || ('5' == mode) ) {
+    typeinfo T;
+    T.set('I', false);
+    identlist* P = 0;
+    parse_data::startFunction(T, atom_table::intern("getchar"), P);
+    identlist *L = new identlist(T, atom_table::intern("c"), false);
+    parse_data::startFunction(T, atom_table::intern("putchar"), L);
+    bool ok = parse_data::finishOutput();
+    return ok ? 0 : 9;
+  }
+
+  err << "Mode " << mode << " not implemented yet.\n";
+  return 8;
+}
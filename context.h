@@ -0,0 +1,84 @@
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <iostream>
+
+#include "atoms.h"
+#include "lexer.h"
+#include "parsehelp.h"
+#include "backend.h"
+
+/*
+  What to do with one input, as given on the command line.
+*/
+struct compile_options {
+    char mode;              /* '0' to '5' */
+    bool stats;             /* Show compiler statistics on standard error */
+    target_kind target;     /* Output format for modes 4 and 5 */
+    std::ostream* errors;   /* Where messages and statistics go; 0 for std::cerr */
+
+  public:
+    compile_options() {
+      mode = ' ';
+      stats = false;
+      target = TARGET_CLASS;
+      errors = 0;
+    }
+};
+
+/*
+  Everything one compilation works on: its atoms, the lexer with
+  its input and flex scanner, and the front end's data.
+
+  The rest of the compiler keeps no state between calls, except
+  the counts for -s, which are kept per thread; so compilations in
+  different contexts may run on different threads at once.
+  A context may be reused, for one compilation at a time.
+*/
+class compiler_context {
+    static thread_local compiler_context* CURRENT;
+
+  public:
+    atom_table atoms;
+    lexer_state lexer;
+    parse_data data;
+
+  private:
+    compiler_context* outer;    /* Current before bind(), restored by unbind() */
+
+  public:
+    compiler_context();
+
+    /*
+      The context of the compilation running on this thread, or 0.
+    */
+    static inline compiler_context* current() { return CURRENT; }
+
+    /*
+      Make this the context of the calling thread, until unbind().
+      The static methods of atom_table and parse_data, and the lexer
+      functions, work on the current context.
+    */
+    void bind();
+    void unbind();
+
+  private:
+    /* Not copyable */
+    compiler_context(const compiler_context &);
+    compiler_context& operator=(const compiler_context &);
+};
+
+/*
+  Compile one input.  Safe to call from several threads at once,
+  each with its own context.
+    @param  infile  Input file name, for messages; without its ".c",
+                    it names the output files of modes 4 and 5
+    @param  text    The input, len bytes; or 0 to read the file infile
+    @param  fout    Where the output of modes 0 to 3 goes
+  Returns 0 on success, or the exit status for mycc.
+*/
+int compile(compiler_context &ctx, const char* infile, const char* text, size_t len,
+            const compile_options &opts, std::ostream &fout);
+
+#endif
@@ -0,0 +1,451 @@
+#include "csource.h"
+#include "lexer.h"
+
+#include <iostream>
+#include <limits.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  Written before everything else: the value type, which holds
+  whatever a local or stack entry can (an int, a float, or an array
+  or string), and the operations whose JVM meaning differs from C's.
+  Arithmetic goes through unsigned so it wraps instead of overflowing.
+*/
+static const char PRELUDE[] =
+  "#include <stdint.h>\n"
+  "#include <stdio.h>\n"
+  "#include <stdlib.h>\n"
+  "#include <math.h>\n"
+  "\n"
+  "typedef union { int32_t i; float f; void* p; } value;\n"
+  "static const value mycc_zero;\n"
+  "\n"
+  "static inline int32_t mycc_add(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a + (uint32_t) b); }\n"
+  "static inline int32_t mycc_sub(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a - (uint32_t) b); }\n"
+  "static inline int32_t mycc_mul(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a * (uint32_t) b); }\n"
+  "static inline int32_t mycc_neg(int32_t a) { return (int32_t) (0u - (uint32_t) a); }\n"
+  "\n"
+  "static inline void mycc_throw(const char* what)\n"
+  "{\n"
+  "  fprintf(stderr, \"Exception: %s\\n\", what);\n"
+  "  exit(1);\n"
+  "}\n"
+  "\n"
+  "static inline int32_t mycc_div(int32_t a, int32_t b)\n"
+  "{\n"
+  "  if (0 == b) mycc_throw(\"java.lang.ArithmeticException: / by zero\");\n"
+  "  return (-1 == b) ? mycc_neg(a) : a / b;\n"
+  "}\n"
+  "\n"
+  "static inline int32_t mycc_rem(int32_t a, int32_t b)\n"
+  "{\n"
+  "  if (0 == b) mycc_throw(\"java.lang.ArithmeticException: / by zero\");\n"
+  "  return (-1 == b) ? 0 : a % b;\n"
+  "}\n"
+  "\n"
+  "/* Arrays and strings have their length in the word before element 0 */\n"
+  "static inline void* mycc_newarray(int32_t n, size_t size)\n"
+  "{\n"
+  "  if (n < 0) mycc_throw(\"java.lang.NegativeArraySizeException\");\n"
+  "  int32_t* p = calloc(1, sizeof(int32_t) + (size_t) n * size);\n"
+  "  if (0 == p) mycc_throw(\"java.lang.OutOfMemoryError\");\n"
+  "  p[0] = n;\n"
+  "  return p + 1;\n"
+  "}\n"
+  "\n"
+  "static inline int32_t mycc_index(const void* p, int32_t i)\n"
+  "{\n"
+  "  if ((uint32_t) i >= (uint32_t) ((const int32_t*) p)[-1])\n"
+  "    mycc_throw(\"java.lang.ArrayIndexOutOfBoundsException\");\n"
+  "  return i;\n"
+  "}\n";
+
+/*
+  Append printf-style to a string.
+*/
+static void add(std::string &s, const char* fmt, ...)
+#ifdef __GNUC__
+  __attribute__((format(printf, 2, 3)))
+#endif
+  ;
+
+static void add(std::string &s, const char* fmt, ...)
+{
+  char buf[256];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n < 0) return;
+  if ((size_t) n < sizeof(buf)) {
+    s.append(buf, n);
+    return;
+  }
+  std::vector<char> big(n+1);
+  va_start(ap, fmt);
+  vsnprintf(&big[0], n+1, fmt, ap);
+  va_end(ap);
+  s.append(&big[0], n);
+}
+
+static std::string function_name(const char* name)
+{
+  if (0==strcmp(name, "<clinit>")) return "mycc_clinit";
+  return std::string("f_") + name;
+}
+
+/*
+  A float constant, exactly, as C text.
+*/
+static std::string float_literal(const char* text)
+{
+  float f = strtof(text, 0);
+  if (isnan(f)) return "NAN";
+  if (isinf(f)) return (f < 0) ? "(-INFINITY)" : "INFINITY";
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%af", (double) f);
+  return buf;
+}
+
+static std::string int_literal(int x)
+{
+  if (INT_MIN == x) return "(-2147483647-1)";
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%d", x);
+  return buf;
+}
+
+static const char* compare(int op)
+{
+  switch (op) {
+    case OP_IFEQ: case OP_IF_ICMPEQ:    return "==";
+    case OP_IFNE: case OP_IF_ICMPNE:    return "!=";
+    case OP_IFLT: case OP_IF_ICMPLT:    return "<";
+    case OP_IFGE: case OP_IF_ICMPGE:    return ">=";
+    case OP_IFGT: case OP_IF_ICMPGT:    return ">";
+    case OP_IFLE: case OP_IF_ICMPLE:    return "<=";
+  }
+  return "?";
+}
+
+/* ====================================================================== */
+
+c_backend::c_backend(sink* S, const std::string &classname, const char* src)
+{
+  out = S;
+  owner = classname;
+  srcname = src;
+  failed = false;
+  has_clinit = false;
+}
+
+c_backend::~c_backend()
+{
+  delete out;
+}
+
+void c_backend::field(atom_id name, char type, bool is_array, const instr* init)
+{
+  const char* n = atom_table::name(name);
+  if (is_array) {
+    add(decls, "static void* g_%s;\n", n);
+  } else if ('F' == type) {
+    std::string v = (init && (OP_FCONST == init->op)) ? float_literal(atom_table::name(init->sym)) : "0";
+    add(decls, "static float g_%s = %s;\n", n, v.c_str());
+  } else if ('C' == type) {
+    add(decls, "static uint16_t g_%s = %u;\n", n, init ? (unsigned) (init->a & 0xffff) : 0u);
+  } else {
+    add(decls, "static int32_t g_%s = %s;\n", n, int_literal(init ? init->a : 0).c_str());
+  }
+}
+
+void c_backend::method(const char* name, const char* desc,
+                       const std::vector<instr> &code, const frame_info &frame)
+{
+  if (0==strcmp(name, "<clinit>")) has_clinit = true;
+
+  std::string kinds;
+  char result;
+  parse_descriptor(desc, kinds, result);
+  int params = kinds.size();
+  std::string fn = function_name(name);
+
+  /* The parameters are the first locals */
+  std::string head = ('V' == result) ? "void " : "value ";
+  head += fn;
+  head += "(";
+  for (int p=0; p<params; p++) {
+    if (p) head += ", ";
+    add(head, "value l%d", p);
+  }
+  if (0 == params) head += "void";
+  head += ")";
+  decls += head;
+  decls += ";\n";
+
+  defs += "\n";
+  defs += head;
+  defs += "\n{\n";
+
+  /*
+    Still define it, as a stub that stops the program,
+    so the calls to it link.
+  */
+  if (frame.bad >= 0) {
+    diagnostics() << "Error, can't write C code for " << name << ": " << frame.problem << "\n";
+    failed = true;
+    add(defs, "  mycc_throw(\"no code for %s\");\n", name);
+    if ('V' != result) defs += "  return mycc_zero;\n";
+    defs += "}\n";
+    return;
+  }
+
+  for (int x=params; x<frame.max_locals; x++) add(defs, "  value l%d = mycc_zero;\n", x);
+  for (int k=0; k<frame.max_stack; k++) add(defs, "  value s%d;\n", k);
+
+  /* Only labels something goes to, so the C compiler doesn't warn */
+  std::vector<bool> targeted;
+  for (size_t i=0; i<code.size(); i++) {
+    if (!code[i].has_target()) continue;
+    if ((size_t) code[i].a >= targeted.size()) targeted.resize(code[i].a+1, false);
+    targeted[code[i].a] = true;
+  }
+
+  for (size_t i=0; i<code.size(); i++) {
+    const instr &I = code[i];
+    if (I.is_label()) {
+      if ((size_t) I.a < targeted.size() && targeted[I.a]) add(defs, " L%d:;\n", I.a);
+      continue;
+    }
+    instruction(code, i, frame.height[i], 'V' != result);
+    if (OP_SWITCH == I.op) i += I.b;
+  }
+  defs += "}\n";
+}
+
+/*
+  One instruction, with h entries on the operand stack before it.
+*/
+void c_backend::instruction(const std::vector<instr> &code, size_t i, int h, bool returns)
+{
+  const instr &I = code[i];
+  const char* name = I.sym ? atom_table::name(I.sym) : "";
+
+  if (OP_LINE == I.op) {
+    add(defs, "#line %d \"%s\"\n", I.a, srcname);
+    return;
+  }
+  if (OP_COMMENT == I.op) {
+    if (!strstr(name, "*/")) add(defs, "  /* %s */\n", name);
+    return;
+  }
+  /* Not reached */
+  if (h < 0) return;
+  if (((OP_LOAD == I.op) || (OP_STORE == I.op) || (OP_IINC == I.op)) && (I.a < 0)) {
+    diagnostics() << "Error, can't write C code for local " << I.a << " (" << name << ")\n";
+    failed = true;
+    return;
+  }
+
+  switch (I.op) {
+    case OP_NOP:
+    case OP_CASE:
+    case OP_POP:
+        return;
+
+    case OP_ICONST:
+        add(defs, "  s%d.i = %s;\n", h, int_literal(I.a).c_str());
+        return;
+
+    case OP_FCONST:
+        add(defs, "  s%d.f = %s;\n", h, float_literal(name).c_str());
+        return;
+
+    case OP_SCONST: {
+        /* As a Java string: 16-bit chars, after the length */
+        std::string text = unquote(name);
+        add(defs, "  {\n    static const struct { int32_t n; uint16_t c[%d]; } str = { %d, { ",
+            (int) text.size() + 1, (int) text.size());
+        for (size_t c=0; c<text.size(); c++) add(defs, "%u, ", (unsigned char) text[c]);
+        add(defs, "0 } };\n    s%d.p = (void*) str.c;\n  }\n", h);
+        return;
+    }
+
+    case OP_LOAD:
+        add(defs, "  s%d = l%d;\n", h, I.a);
+        return;
+
+    case OP_STORE:
+        add(defs, "  l%d = s%d;\n", I.a, h-1);
+        return;
+
+    case OP_IINC:
+        add(defs, "  l%d.i = mycc_add(l%d.i, %s);\n", I.a, I.a, int_literal(I.b).c_str());
+        return;
+
+    case OP_GETSTATIC:
+        if (I.flags & FLAG_ARRAY) add(defs, "  s%d.p = g_%s;\n", h, name);
+        else if ('F' == I.type)   add(defs, "  s%d.f = g_%s;\n", h, name);
+        else                      add(defs, "  s%d.i = g_%s;\n", h, name);
+        return;
+
+    case OP_PUTSTATIC:
+        if (I.flags & FLAG_ARRAY) add(defs, "  g_%s = s%d.p;\n", name, h-1);
+        else if ('F' == I.type)   add(defs, "  g_%s = s%d.f;\n", name, h-1);
+        else if ('C' == I.type)   add(defs, "  g_%s = (uint16_t) s%d.i;\n", name, h-1);
+        else                      add(defs, "  g_%s = s%d.i;\n", name, h-1);
+        return;
+
+    case OP_NEWARRAY:
+        add(defs, "  s%d.p = mycc_newarray(s%d.i, %s);\n", h-1, h-1,
+            ('C' == I.type) ? "sizeof(uint16_t)" : "sizeof(int32_t)");
+        return;
+
+    case OP_ALOAD:
+    case OP_INVOKEVIRTUAL:
+        /* array (or string), index */
+        if (OP_INVOKEVIRTUAL == I.op && strcmp(name, "charAt")) {
+          diagnostics() << "Error, no C code for String." << name << "\n";
+          failed = true;
+          return;
+        }
+        add(defs, "  s%d.i = ((%s*) s%d.p)[mycc_index(s%d.p, s%d.i)];\n", h-2,
+            ((OP_INVOKEVIRTUAL == I.op) || ('C' == I.type)) ? "uint16_t" : "int32_t",
+            h-2, h-2, h-1);
+        return;
+
+    case OP_ASTORE:
+        /* array, index, value */
+        if ('C' == I.type) {
+          add(defs, "  ((uint16_t*) s%d.p)[mycc_index(s%d.p, s%d.i)] = (uint16_t) s%d.i;\n",
+              h-3, h-3, h-2, h-1);
+        } else {
+          add(defs, "  ((int32_t*) s%d.p)[mycc_index(s%d.p, s%d.i)] = s%d.i;\n", h-3, h-3, h-2, h-1);
+        }
+        return;
+
+    case OP_IADD:
+    case OP_ISUB:
+    case OP_IMUL:
+    case OP_IDIV:
+    case OP_IREM: {
+        const char* f = "mycc_add";
+        switch (I.op) {
+          case OP_ISUB:   f = "mycc_sub";   break;
+          case OP_IMUL:   f = "mycc_mul";   break;
+          case OP_IDIV:   f = "mycc_div";   break;
+          case OP_IREM:   f = "mycc_rem";   break;
+        }
+        add(defs, "  s%d.i = %s(s%d.i, s%d.i);\n", h-2, f, h-2, h-1);
+        return;
+    }
+
+    case OP_IOR:
+    case OP_IAND:
+    case OP_IXOR: {
+        const char* op = (OP_IOR == I.op) ? "|" : (OP_IAND == I.op) ? "&" : "^";
+        add(defs, "  s%d.i = s%d.i %s s%d.i;\n", h-2, h-2, op, h-1);
+        return;
+    }
+
+    case OP_INEG:
+        add(defs, "  s%d.i = mycc_neg(s%d.i);\n", h-1, h-1);
+        return;
+
+    case OP_DUP:
+        add(defs, "  s%d = s%d;\n", h, h-1);
+        return;
+
+    case OP_GOTO:
+        add(defs, "  goto L%d;\n", I.a);
+        return;
+
+    case OP_SWITCH: {
+        const instr* cases = &code[i+1];
+        add(defs, "  switch (s%d.i) {\n", h-1);
+        for (int c=0; c<I.b; c++) {
+          add(defs, "    case %s: goto L%d;\n", int_literal(cases[c].b).c_str(), cases[c].a);
+        }
+        add(defs, "    default: goto L%d;\n  }\n", I.a);
+        return;
+    }
+
+    case OP_INVOKESTATIC:
+        call(I, h);
+        return;
+
+    case OP_RETURN:
+        /* The verifier would reject this in a method with a result */
+        defs += returns ? "  return mycc_zero;\n" : "  return;\n";
+        return;
+
+    case OP_VRETURN:
+        if (returns) add(defs, "  return s%d;\n", h-1);
+        else         defs += "  return;\n";
+        return;
+  }
+
+  if (I.is_cond_branch() && (I.op < OP_IF_ICMPEQ)) {
+    add(defs, "  if (s%d.i %s 0) goto L%d;\n", h-1, compare(I.op), I.a);
+    return;
+  }
+  if (I.is_cond_branch()) {
+    add(defs, "  if (s%d.i %s s%d.i) goto L%d;\n", h-2, compare(I.op), h-1, I.a);
+    return;
+  }
+
+  diagnostics() << "Error, can't write C code for instruction " << opname(I.op) << "\n";
+  failed = true;
+}
+
+/*
+  A call, with its arguments on top of the h operand stack entries;
+  the result replaces them.  The C library is called directly.
+*/
+void c_backend::call(const instr &I, int h)
+{
+  const char* name = atom_table::name(I.sym);
+  std::string kinds;
+  char result;
+  parse_descriptor(I.desc ? atom_table::name(I.desc) : "()V", kinds, result);
+  int params = kinds.size();
+  int base = h - params;
+  bool libc = I.flags & FLAG_LIBC;
+
+  defs += "  ";
+  if ('V' != result) add(defs, libc ? "s%d.i = " : "s%d = ", base);
+  if (libc) defs += name;
+  else      defs += function_name(name);
+  defs += "(";
+  for (int p=0; p<params; p++) {
+    add(defs, libc ? "%ss%d.i" : "%ss%d", p ? ", " : "", base + p);
+  }
+  defs += ");\n";
+}
+
+/* ====================================================================== */
+
+void c_backend::entry(bool show_result)
+{
+  defs += "\nint main(void)\n{\n";
+  if (has_clinit) defs += "  mycc_clinit();\n";
+  defs += "  value r = f_main();\n";
+  if (show_result) defs += "  printf(\"Return code: %d\\n\", (int) r.i);\n";
+  else             defs += "  (void) r;\n";
+  defs += "  return 0;\n}\n";
+}
+
+bool c_backend::finish()
+{
+  out->format("/* C code for %s, from mycc */\n\n", srcname);
+  out->put(PRELUDE, sizeof(PRELUDE)-1);
+  out->put('\n');
+  out->put(decls.data(), decls.size());
+  out->putBlock(defs.data(), defs.size());
+  bool ok = out->close();
+  return ok && !failed;
+}
@@ -0,0 +1,46 @@
+
+#ifndef CSOURCE_H
+#define CSOURCE_H
+
+#include "backend.h"
+
+/*
+  Portable C source, for the system C compiler:  cc -O2 -o prog prog.out.c
+
+  Each method becomes a C function, with a variable for each local
+  and for each operand stack height, and gotos between its labels;
+  the C compiler turns that back into expressions and registers.
+  Values keep their JVM meaning: ints are 32 bits and wrap around,
+  chars (and char arrays, like Java's) are 16 bits, and dividing by
+  zero or an array index out of bounds stops the program; arrays and
+  strings carry their length for that.  Functions must be declared before they
+  are called, so the text is kept in memory and written by finish().
+*/
+class c_backend : public backend {
+  private:
+    sink* out;
+    std::string owner;
+    const char* srcname;
+    bool failed;
+    bool has_clinit;
+
+    std::string decls;    /* globals and function prototypes */
+    std::string defs;     /* function bodies */
+
+  public:
+    /* We own (and delete) the sink */
+    c_backend(sink* S, const std::string &classname, const char* src);
+    virtual ~c_backend();
+
+    virtual void field(atom_id name, char type, bool is_array, const instr* init);
+    virtual void method(const char* name, const char* desc,
+                        const std::vector<instr> &code, const frame_info &frame);
+    virtual void entry(bool show_result);
+    virtual bool finish();
+
+  private:
+    void instruction(const std::vector<instr> &code, size_t i, int h, bool returns);
+    void call(const instr &I, int h);
+};
+
+#endif
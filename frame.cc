@@ -0,0 +1,123 @@
+
+#include "frame.h"
+
+static bool fail(frame_info &F, int index, const char* problem)
+{
+  F.bad = index;
+  F.problem = problem;
+  return false;
+}
+
+bool compute_frame(const std::vector<instr> &code, int params, frame_info &F)
+{
+  F.max_stack = 0;
+  F.max_locals = params;
+  F.bad = -1;
+  F.problem = 0;
+
+  /*
+    Where each label is.
+  */
+  std::vector<int> where;
+  for (size_t i=0; i<code.size(); i++) {
+    const instr &I = code[i];
+    if (I.is_label()) {
+      if ((size_t) I.a >= where.size()) where.resize(I.a+1, -1);
+      where[I.a] = i;
+    }
+    if ((OP_LOAD == I.op) || (OP_STORE == I.op) || (OP_IINC == I.op)) {
+      if (I.a + 1 > F.max_locals) F.max_locals = I.a + 1;
+    }
+  }
+
+  /*
+    Height on entry to each instruction, -1 until reached.
+    Each reached instruction goes on the work list once.
+  */
+  std::vector<int> &height = F.height;
+  height.assign(code.size(), -1);
+  std::vector<int> work;
+  if (code.empty()) return true;
+  height[0] = 0;
+  work.push_back(0);
+
+  while (!work.empty()) {
+    int i = work.back();
+    work.pop_back();
+
+    /* Follow the straight-line code from i */
+    for (;;) {
+      const instr &I = code[i];
+      int pops, pushes;
+      stack_effect(I, pops, pushes);
+      if (height[i] < pops) return fail(F, i, "operand stack underflow");
+      int h = height[i] - pops + pushes;
+      if (h > F.max_stack) F.max_stack = h;
+
+      /* A switch goes to its default and to each of its cases */
+      int targets = 0;
+      if (I.is_branch() && I.a) targets = 1;
+      if (OP_SWITCH == I.op) {
+        targets = 1 + I.b;
+        if ((size_t) (i + I.b) >= code.size()) return fail(F, i, "switch without its cases");
+      }
+      for (int k=0; k<targets; k++) {
+        int L = k ? code[i+k].a : I.a;
+        if (((size_t) L >= where.size()) || (where[L] < 0)) {
+          return fail(F, i, "branch to a missing label");
+        }
+        int t = where[L];
+        if (height[t] < 0) {
+          height[t] = h;
+          work.push_back(t);
+        } else if (height[t] != h) {
+          return fail(F, i, "stack heights differ where paths meet");
+        }
+      }
+
+      if ((OP_GOTO == I.op) || (OP_SWITCH == I.op) || (OP_RETURN == I.op) || (OP_VRETURN == I.op)) break;
+
+      i++;
+      if ((size_t) i >= code.size()) return fail(F, i-1, "control falls off the end");
+      if (height[i] < 0) {
+        height[i] = h;
+        continue;
+      }
+      if (height[i] != h) return fail(F, i, "stack heights differ where paths meet");
+      break;
+    }
+  }
+  return true;
+}
+
+int stack_height(const std::vector<instr> &code)
+{
+  /* Height at each label, from the branches seen so far */
+  std::vector<int> at;
+  int h = 0;
+  bool live = true;
+  for (size_t i=0; i<code.size(); i++) {
+    const instr &I = code[i];
+    if (I.is_label()) {
+      if ((size_t) I.a < at.size() && at[I.a] >= 0) {
+        h = at[I.a];
+        live = true;
+      }
+      continue;
+    }
+    if (!live) continue;
+    int pops, pushes;
+    stack_effect(I, pops, pushes);
+    h -= pops;
+    if (h < 0) h = 0;
+    h += pushes;
+    int targets = I.is_branch() ? 1 : (OP_SWITCH == I.op) ? 1 + I.b : 0;
+    for (int k=0; (k < targets) && (i+k < code.size()); k++) {
+      int L = code[i+k].a;
+      if ((size_t) L >= at.size()) at.resize(L+1, -1);
+      at[L] = h;
+    }
+    if ((OP_GOTO == I.op) || (OP_SWITCH == I.op) || (OP_RETURN == I.op) || (OP_VRETURN == I.op)) live = false;
+  }
+  return live ? h : 0;
+}
@@ -0,0 +1,47 @@
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <vector>
+
+#include "instr.h"
+
+/*
+  Frame size of one method, from its finished code.
+
+  The operand stack height is tracked along every path: straight
+  through, and from each branch to its label.  All paths that reach
+  an instruction must agree on the height there.
+*/
+
+struct frame_info {
+    int max_stack;
+    int max_locals;
+    /*
+      Index of the first instruction found to be inconsistent,
+      or -1 if the code checks out; then problem says what's wrong.
+    */
+    int bad;
+    const char* problem;
+    /*
+      Operand stack height on entry to each instruction,
+      or -1 for instructions that can't be reached.
+    */
+    std::vector<int> height;
+};
+
+/*
+  Compute the frame for code.
+    @param  params    Number of parameter slots
+  Return true if the stack heights are consistent.
+*/
+bool compute_frame(const std::vector<instr> &code, int params, frame_info &F);
+
+/*
+  Operand stack height at the end of a piece of code, such as one
+  statement, that starts with an empty stack.  Forward branches
+  within the piece carry their height to their labels.
+*/
+int stack_height(const std::vector<instr> &code);
+
+#endif
@@ -4,32 +4,29 @@
 #include "lexer.h"
 #include "parsehelp.h"
 
-void yyerror(const char* s)
+void yyerror(void*, const char* s)
 {
   startError();
-  fputs(s, stderr);
-  fputc('\n', stderr);
+  diagnostics() << s << "\n";
 }
 
-extern int yylineno;
-extern const char* filename;
-extern const char* jvm_file;
-extern std::string classname;
-extern FILE* jF;
-extern char last_mode;
-extern char second_last_mode;
-extern int loop;
-extern int if_flag;
-
 %}
 
+/*
+  Reentrant: the parser keeps its state on the stack, and
+  gets its tokens from the scanner of this compilation.
+*/
+%define api.pure full
+%param {void* scanner}
+
 %union {
   typeinfo type;
-  char* name;
+  atom_id name;
   identlist* idlist;
   function* func;
   typelist* plist;
   int lineno;
+  int count;
 }
 
 
@@ -47,9 +44,12 @@ PLUS MINUS STAR SLASH MOD COLON QUEST TILDE PIPE AMP BANG DPIPE DAMP
 
 %type <idlist> ideclist idec vardecl formal fplist
 %type <func> funcdecl
-%type <type> literal expression exprorempty lvalue
+%type <type> literal expression exprorempty lvalue initvalue
+%type <count> arraysize initlist
+%type <type> condition loopcondition loophead forcondition
 %type <plist> paramlist
-%type <lineno> getlineno marker ifmarker ifnomarker turnloopOff getlinenoloop turnIfOff
+%type <lineno> getlineno marker ifmarker getlinenoloop
+%type <name> arrayname
 
 %nonassoc WITHOUT_ELSE
 %nonassoc ELSE
@@ -77,32 +77,7 @@ PLUS MINUS STAR SLASH MOD COLON QUEST TILDE PIPE AMP BANG DPIPE DAMP
 prog
     : program
       {
-        if (last_mode) {
-          fprintf(jF, ".method public static main : ([Ljava/lang/String;)V\n");
-          fprintf(jF, "\t.code stack 1 locals 1\n");
-          fprintf(jF, "\t\tinvokestatic Method %s main ()I\n", classname.c_str());
-          fprintf(jF, "\t\tpop\n");
-          fprintf(jF, "\t\treturn\n");
-          fprintf(jF, "\t.end code\n");
-          fprintf(jF, ".end method\n");
-        }
-        if (second_last_mode) {
-          fprintf(jF, ".method public static main : ([Ljava/lang/String;)V\n");
-          fprintf(jF, "\t.code stack 2 locals 2\n");
-          fprintf(jF, "\t\tinvokestatic Method %s main ()I\n", classname.c_str());
-          fprintf(jF, "\t\tistore_1\n");
-          fprintf(jF, "\t\tgetstatic Field java/lang/System out Ljava/io/PrintStream;\n");
-          fprintf(jF, "\t\tldc 'Return code: '\n");
-          fprintf(jF, "\t\tinvokevirtual Method java/io/PrintStream print (Ljava/lang/String;)V\n");
-          fprintf(jF, "\t\tgetstatic Field java/lang/System out Ljava/io/PrintStream;\n");
-          fprintf(jF, "\t\tiload_1\n");
-          fprintf(jF, "\t\tinvokevirtual Method java/io/PrintStream println (I)V\n");
-          fprintf(jF, "\t\treturn\n");
-          fprintf(jF, "\t.end code\n");
-          fprintf(jF, ".end method\n");
-        }
-        
-        fclose(jF);
+        parse_data::doneProgram();
       }
     ;
 
@@ -115,7 +90,6 @@ progitem
     : vardecl
       {
         parse_data::declareGlobals($1);
-        parse_data::initGlobal();
       }
     | prototype
     | funcdef
@@ -144,9 +118,50 @@ idec
       {
         $$ = new identlist($1, 0);
       }
-    | IDENT LBRACKET literal RBRACKET
+    | IDENT arraysize
+      {
+        $$ = parse_data::buildIdec($1, true, $2, 0);
+      }
+    | IDENT ASSIGN initvalue
+      {
+        $$ = parse_data::buildIdec($1, false, 0, 1);
+      }
+    | IDENT arraysize ASSIGN LBRACE initlist RBRACE
+      {
+        $$ = parse_data::buildIdec($1, true, $2, $5);
+      }
+    | IDENT LBRACKET RBRACKET ASSIGN LBRACE initlist RBRACE
+      {
+        $$ = parse_data::buildIdec($1, true, 0, $6);
+      }
+    ;
+
+arraysize
+    : LBRACKET literal RBRACKET
+      {
+        $$ = parse_data::arraySize($2);
+      }
+    ;
+
+initlist
+    : initvalue
+      {
+        $$ = 1;
+      }
+    | initlist COMMA initvalue
       {
-        $$ = new identlist($1, 1);
+        $$ = $1 + 1;
+      }
+    ;
+
+initvalue
+    : literal
+      {
+        $$ = parse_data::buildInitValue($1, false);
+      }
+    | MINUS literal
+      {
+        $$ = parse_data::buildInitValue($2, true);
       }
     ;
 
@@ -194,8 +209,6 @@ funcdef
     : funcdecl startfuncdef LBRACE vardeclist statements RBRACE
       {  
         parse_data::doneFunction($1, false);
-        fprintf(jF, "\t.end code\n");
-        fprintf(jF, ".end method\n\n");
       }
     ;
 
@@ -225,7 +238,7 @@ stmtblock
 
 stmtorblock
     : statement 
-    | stmtblock  { loop = 0;}
+    | stmtblock
     ;
 
 exprorempty
@@ -245,7 +258,21 @@ statement
         parse_data::addExprStmt($1);
       }
     | BREAK SEMI
+      {
+        parse_data::buildBreak();
+      }
     | CONTINUE SEMI
+      {
+        parse_data::buildContinue();
+      }
+    | SWITCH LPAR expression getlineno RPAR
+        {
+          parse_data::startSwitch($3, $4);
+        }
+      LBRACE cases RBRACE
+      {
+        parse_data::endSwitch();
+      }
     | RETURN SEMI
       {
         parse_data::checkEmptyReturn();
@@ -254,82 +281,114 @@ statement
       {
         parse_data::checkReturn($2);
       }
-    | IF LPAR expression getlineno turnIfOff RPAR stmtorblock ifnomarker %prec WITHOUT_ELSE
+    | IF LPAR condition getlineno RPAR stmtorblock %prec WITHOUT_ELSE
       {
+        parse_data::ifnomarker();
         parse_data::checkCondition(false, "if statement", $3, $4, "if");
       }
-    | IF LPAR expression getlineno turnIfOff RPAR stmtorblock ifmarker ELSE stmtorblock ifnomarker
+    | IF LPAR condition getlineno RPAR stmtorblock ELSE ifmarker stmtorblock
       {
+        parse_data::ifnomarker();
         parse_data::checkCondition(false, "if statement", $3, $4, "ifelse");
       }
-    | FOR LPAR exprorempty SEMI exprorempty getlineno SEMI exprorempty RPAR stmtorblock
+    | FOR LPAR exprorempty SEMI
+        {
+          parse_data::forInit($3);
+        }
+      forcondition getlineno SEMI exprorempty RPAR
+        {
+          parse_data::forStep($9);
+        }
+      stmtorblock
       {
-        parse_data::checkCondition(true, "for loop", $5, $6, "for");
+        parse_data::forEnd();
+        parse_data::checkCondition(true, "for loop", $6, $7, "for");
       }
-    | WHILE LPAR getlinenoloop expression turnloopOff RPAR stmtorblock marker
+    | WHILE LPAR getlineno loophead RPAR stmtorblock marker
       {
         parse_data::checkCondition(false, "while loop", $4, $3, "while");
       }
-    | DO stmtorblock WHILE LPAR expression getlineno RPAR
+    | DO getlinenoloop stmtorblock WHILE LPAR loopcondition getlineno RPAR
       {
-        parse_data::checkCondition(false, "do while loop", $5, $6, "dowhile");
+        parse_data::checkCondition(false, "do while loop", $6, $7, "dowhile");
       }
     ;
 
-turnIfOff
-    :
+cases
+    : /* empty */
+    | cases CASE expression COLON
       {
-        $$ = yylineno;
-        if_flag = 0;
-        parse_data::if_cond_exp();
+        parse_data::caseLabel($3);
       }
+    | cases DEFAULT COLON
+      {
+        parse_data::defaultLabel();
+      }
+    | cases statement
     ;
 
-getlineno
-    : /* empty but allows us to grab the line number at a specific point */
+condition
+    : expression
       {
-        $$ = yylineno;
+        $$ = parse_data::buildCondition($1);
       }
     ;
 
-getlinenoloop
+loophead
+    : expression
+      {
+        $$ = parse_data::startLoop($1);
+      }
+    ;
+
+forcondition
+    : /* empty: always true */
+      {
+        $$.set(' ', false);
+        $$ = parse_data::startLoop($$);
+      }
+    | loophead
+      {
+        $$ = $1;
+      }
+    ;
+
+loopcondition
+    : expression
+      {
+        $$ = parse_data::buildLoopCondition($1);
+      }
+    ;
+
+getlineno
     : /* empty but allows us to grab the line number at a specific point */
       {
-        $$ = yylineno;
-        parse_data::push_label();
+        $$ = lineNumber();
       }
     ;
 
-turnloopOff
+getlinenoloop
     : /* empty but allows us to grab the line number at a specific point */
       {
-        $$ = yylineno;
-        loop = 0;
-        parse_data::loop_exp_marker();
+        $$ = lineNumber();
+        parse_data::push_label();
       }
     ;
 
 marker
     : /* empty but allows us to grab the line number at a specific point */
       {
-        $$ = yylineno;
+        $$ = lineNumber();
         parse_data::loop_end_label();
       }
     ;
 ifmarker
     : /* empty but allows us to grab the line number at a specific point */
       {
-        $$ = yylineno;
+        $$ = lineNumber();
         parse_data::ifmarker();
       }
     ;
-ifnomarker
-    : /* empty but allows us to grab the line number at a specific point */
-      {
-        $$ = yylineno;
-        parse_data::ifnomarker();
-      }
-    ;
 
 
 expression
@@ -338,9 +397,9 @@ expression
       { 
         $$ = parse_data::buildLval($1, true);
       }
-    | IDENT LBRACKET expression RBRACKET
+    | arrayname expression RBRACKET
       { 
-        $$ = parse_data::buildLvalBracket($1, $3, true);
+        $$ = parse_data::buildLvalBracket($1, $2, true);
       }
     | IDENT LPAR RPAR
       { 
@@ -450,13 +509,21 @@ expression
       {
         $$ = parse_data::buildArith($1, '&', $3);
       }
-    | expression DPIPE expression
+    | expression DPIPE
+        {
+          $<type>$ = parse_data::startLogic($1, "||");
+        }
+      expression
       {
-        $$ = parse_data::buildLogic($1, "||", $3);
+        $$ = parse_data::buildLogic($<type>3, "||", $4);
       }
-    | expression DAMP expression
+    | expression DAMP
+        {
+          $<type>$ = parse_data::startLogic($1, "&&");
+        }
+      expression
       {
-        $$ = parse_data::buildLogic($1, "&&", $3);
+        $$ = parse_data::buildLogic($<type>3, "&&", $4);
       }
     | expression QUEST expression COLON expression
       {
@@ -486,23 +553,19 @@ paramlist
 literal
     : INTCONST    
       {
-        //$$.set('I', false);
-        parse_data::load_stack($$.bytecode, false);
+        $$ = parse_data::buildLiteral($$, false);
       }
     | REALCONST   
       {
-        //$$.set('F', false);
-        parse_data::load_stack($$.bytecode, false);
+        $$ = parse_data::buildLiteral($$, false);
       }
     | STRCONST    
       {
-        //$$.set('C', true);
-        parse_data::load_stack($$.bytecode, true);
+        $$ = parse_data::buildLiteral($$, true);
       }
     | CHARCONST   
       {
-        //$$.set('C', false);
-        parse_data::load_stack($$.bytecode, false);
+        $$ = parse_data::buildLiteral($$, false);
       }
     ;
 
@@ -511,9 +574,17 @@ lvalue
       { 
         $$ = parse_data::buildLval($1, false);
       }
-    | IDENT LBRACKET expression RBRACKET
+    | arrayname expression RBRACKET
       { 
-        $$ = parse_data::buildLvalBracket($1, $3, false);
+        $$ = parse_data::buildLvalBracket($1, $2, false);
+      }
+    ;
+
+arrayname
+    : IDENT LBRACKET
+      {
+        $$ = $1;
+        parse_data::buildArrayRef($1);
       }
     ;
 
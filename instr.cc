@@ -0,0 +1,367 @@
+
+#include "instr.h"
+
+#include <ctype.h>
+#include <string.h>
+
+static const char* NAMES[OP_COUNT] = {
+  "nop", "label", "line", "comment",
+  "iconst", "fconst", "sconst",
+  "load", "store", "aload", "astore", "getstatic", "putstatic", "newarray", "iinc",
+  "iadd", "isub", "imul", "idiv", "irem", "ior", "iand", "ixor", "ineg",
+  "dup", "pop",
+  "ifeq", "ifne", "iflt", "ifge", "ifgt", "ifle",
+  "if_icmpeq", "if_icmpne", "if_icmplt", "if_icmpge", "if_icmpgt", "if_icmple",
+  "goto", "switch", "case",
+  "invokestatic", "invokevirtual", "return", "vreturn"
+};
+
+const char* opname(int op)
+{
+  if ((op < 0) || (op >= OP_COUNT)) return "?";
+  return NAMES[op];
+}
+
+/*
+  Kind of the type that starts at p, which is moved past it.
+*/
+static char parse_type(const char* &p)
+{
+  char kind = ('F' == *p) ? 'F' : ('V' == *p) ? 'V' : 'I';
+  if (('[' == *p) || ('L' == *p)) kind = 'A';
+  while ('[' == *p) p++;
+  if ('L' == *p) {
+    while (*p && (';' != *p)) p++;
+  }
+  if (*p) p++;
+  return kind;
+}
+
+void parse_descriptor(const char* desc, std::string &params, char &result)
+{
+  params.clear();
+  const char* p = desc;
+  if ('(' == *p) p++;
+  while (*p && (')' != *p)) params += parse_type(p);
+  if (')' == *p) p++;
+  result = *p ? parse_type(p) : 'V';
+}
+
+bool dense_switch(const instr* cases, int n)
+{
+  if (0 == n) return false;
+  long long range = (long long) cases[n-1].b - cases[0].b + 1;
+  long long table_space = 4 + range;
+  long long table_time = 3;
+  long long lookup_space = 3 + 2 * (long long) n;
+  long long lookup_time = n;
+  return table_space + 3 * table_time <= lookup_space + 3 * lookup_time;
+}
+
+std::string unquote(const char* lit)
+{
+  std::string s;
+  size_t len = strlen(lit);
+  if (len < 2) return s;
+  for (size_t i=1; i+1<len; i++) {
+    if ('\\' != lit[i]) {
+      s += lit[i];
+      continue;
+    }
+    i++;
+    switch (lit[i]) {
+      case 'x': {
+        /* Up to two hex digits, so any byte can be written */
+        unsigned c = 0;
+        for (int d=0; (d < 2) && (i+2 < len) && isxdigit((unsigned char) lit[i+1]); d++) {
+          i++;
+          c = 16*c + (isdigit((unsigned char) lit[i]) ? lit[i]-'0' : (tolower(lit[i])-'a'+10));
+        }
+        s += (char) c;
+        break;
+      }
+      case 'n':   s += '\n';  break;
+      case 't':   s += '\t';  break;
+      case 'r':   s += '\r';  break;
+      case '0':   s += '\0';  break;
+      case 'a':   s += '\a';  break;
+      case 'b':   s += '\b';  break;
+      case 'f':   s += '\f';  break;
+      case 'v':   s += '\v';  break;
+      default:    s += lit[i];
+    }
+  }
+  return s;
+}
+
+void stack_effect(const instr &I, int &pops, int &pushes)
+{
+  pops = 0;
+  pushes = 0;
+  switch (I.op) {
+    case OP_ICONST:
+    case OP_FCONST:
+    case OP_SCONST:
+    case OP_LOAD:
+    case OP_GETSTATIC:
+        pushes = 1;
+        return;
+
+    case OP_STORE:
+    case OP_PUTSTATIC:
+    case OP_POP:
+    case OP_VRETURN:
+    case OP_SWITCH:
+        pops = 1;
+        return;
+
+    case OP_ALOAD:        /* array, index */
+        pops = 2;
+        pushes = 1;
+        return;
+
+    case OP_ASTORE:       /* array, index, value */
+        pops = 3;
+        return;
+
+    case OP_NEWARRAY:
+    case OP_INEG:
+        pops = 1;
+        pushes = 1;
+        return;
+
+    case OP_IADD:
+    case OP_ISUB:
+    case OP_IMUL:
+    case OP_IDIV:
+    case OP_IREM:
+    case OP_IOR:
+    case OP_IAND:
+    case OP_IXOR:
+        pops = 2;
+        pushes = 1;
+        return;
+
+    case OP_DUP:
+        pops = 1;
+        pushes = 2;
+        return;
+
+    case OP_INVOKESTATIC:
+    case OP_INVOKEVIRTUAL: {
+        std::string params;
+        char result;
+        parse_descriptor(I.desc ? atom_table::name(I.desc) : "()V", params, result);
+        pops = params.size();
+        pushes = ('V' == result) ? 0 : 1;
+        /* and the object */
+        if (OP_INVOKEVIRTUAL == I.op) pops++;
+        return;
+    }
+  }
+
+  if (I.is_cond_branch()) {
+    pops = (I.op >= OP_IF_ICMPEQ) ? 2 : 1;
+  }
+}
+
+/*
+  Prefix letter for typed loads and stores.
+*/
+static char prefix(char type)
+{
+  switch (type) {
+    case 'C':   return 'c';
+    case 'F':   return 'f';
+  }
+  return 'i';
+}
+
+/*
+  Local variables of type char are ints; there is no cload.
+*/
+static char local_prefix(char type)
+{
+  return ('F' == type) ? 'f' : 'i';
+}
+
+static const char* arraytype(char type)
+{
+  switch (type) {
+    case 'C':   return "char";
+    case 'F':   return "float";
+  }
+  return "int";
+}
+
+void render(sink &out, const instr &I, const char* owner, const char* srcname)
+{
+  const char* name = I.sym ? atom_table::name(I.sym) : "";
+
+  switch (I.op) {
+    case OP_NOP:
+        return;
+
+    case OP_LABEL:
+        out.put("\tL", 2);
+        out.putInt(I.a);
+        out.put(":\n", 2);
+        return;
+
+    case OP_LINE:
+        out.put("\t\t;; ", 5);
+        out.put(srcname);
+        out.put(' ');
+        out.putInt(I.a);
+        out.put(' ');
+        out.put(name, atom_table::length(I.sym));
+        out.put('\n');
+        return;
+
+    case OP_COMMENT:
+        out.put("\t\t; ", 4);
+        out.put(name, atom_table::length(I.sym));
+        out.put('\n');
+        return;
+
+    case OP_ICONST:
+        if (-1 == I.a)                              out.put("\t\ticonst_m1");
+        else if ((I.a >= 0) && (I.a <= 5))          out.put("\t\ticonst_");
+        else if ((I.a >= -128) && (I.a < 128))      out.put("\t\tbipush ");
+        else if ((I.a >= -32768) && (I.a < 32768))  out.put("\t\tsipush ");
+        else                                        out.put("\t\tldc ");
+        if (-1 != I.a) out.putInt(I.a);
+        out.put('\n');
+        return;
+
+    case OP_FCONST:
+        out.put("\t\tldc ", 6);
+        out.put(name, atom_table::length(I.sym));
+        out.put("f\n", 2);
+        return;
+
+    case OP_SCONST:
+        out.put("\t\tldc ", 6);
+        out.put(name, atom_table::length(I.sym));
+        out.put('\n');
+        return;
+
+    case OP_LOAD:
+    case OP_STORE:
+        out.put("\t\t", 2);
+        out.put(local_prefix(I.type));
+        out.put((OP_LOAD == I.op) ? "load" : "store");
+        out.put((I.a <= 3) ? '_' : ' ');
+        out.putInt(I.a);
+        out.put((OP_LOAD == I.op) ? " ; load from " : " ; store to ");
+        out.put(name, atom_table::length(I.sym));
+        out.put('\n');
+        return;
+
+    case OP_ALOAD:
+    case OP_ASTORE:
+        out.put("\t\t", 2);
+        out.put(prefix(I.type));
+        out.put((OP_ALOAD == I.op) ? "aload ; load from " : "astore ; store to ");
+        out.put(name, atom_table::length(I.sym));
+        out.put('\n');
+        return;
+
+    case OP_GETSTATIC:
+    case OP_PUTSTATIC:
+        out.put((OP_GETSTATIC == I.op) ? "\t\tgetstatic Field " : "\t\tputstatic Field ");
+        out.put(owner);
+        out.put(' ');
+        out.put(name, atom_table::length(I.sym));
+        out.put(' ');
+        if (I.flags & FLAG_ARRAY) out.put('[');
+        out.put(I.type);
+        out.put('\n');
+        return;
+
+    case OP_NEWARRAY:
+        out.put("\t\tnewarray ");
+        out.put(arraytype(I.type));
+        out.put('\n');
+        return;
+
+    case OP_IINC:
+        out.put("\t\tiinc ", 7);
+        out.putInt(I.a);
+        out.put(' ');
+        if (I.b >= 0) out.put('+');
+        out.putInt(I.b);
+        out.put('\n');
+        return;
+
+    case OP_INVOKESTATIC:
+        out.put("\t\tinvokestatic Method ");
+        out.put((I.flags & FLAG_LIBC) ? "libc" : owner);
+        out.put(' ');
+        out.put(name, atom_table::length(I.sym));
+        out.put(' ');
+        out.put(atom_table::name(I.desc), atom_table::length(I.desc));
+        out.put('\n');
+        return;
+
+    case OP_INVOKEVIRTUAL:
+        out.put("\t\tinvokevirtual Method java/lang/String ");
+        out.put(name, atom_table::length(I.sym));
+        out.put(' ');
+        out.put(atom_table::name(I.desc), atom_table::length(I.desc));
+        out.put('\n');
+        return;
+
+    case OP_SWITCH: {
+        /* The cases follow it */
+        const instr* cases = &I + 1;
+        if (dense_switch(cases, I.b)) {
+          out.put("\t\ttableswitch ");
+          out.putInt(cases[0].b);
+          out.put('\n');
+          int k = 0;
+          for (int v = cases[0].b; ; v++) {
+            out.put("\t\t\tL", 4);
+            out.putInt((v == cases[k].b) ? cases[k++].a : I.a);
+            out.put('\n');
+            if (v == cases[I.b-1].b) break;
+          }
+        } else {
+          out.put("\t\tlookupswitch\n");
+          for (int k=0; k<I.b; k++) {
+            out.put("\t\t\t", 3);
+            out.putInt(cases[k].b);
+            out.put(" : L", 4);
+            out.putInt(cases[k].a);
+            out.put('\n');
+          }
+        }
+        out.put("\t\t\tdefault : L");
+        out.putInt(I.a);
+        out.put('\n');
+        return;
+    }
+
+    case OP_CASE:
+        return;
+
+    case OP_RETURN:
+        if (I.flags & FLAG_IMPLICIT)  out.put("\t\treturn ; implicit return\n");
+        else                          out.put("\t\treturn\n");
+        return;
+
+    case OP_VRETURN:
+        out.put("\t\t", 2);
+        out.put(local_prefix(I.type));
+        out.put("return\n");
+        return;
+  }
+
+  out.put("\t\t", 2);
+  out.put(NAMES[I.op]);
+  if (I.is_branch() && I.a) {
+    out.put(" L", 2);
+    out.putInt(I.a);
+  }
+  out.put('\n');
+}
@@ -0,0 +1,182 @@
+
+#ifndef INSTR_H
+#define INSTR_H
+
+#include <string>
+
+#include "atoms.h"
+#include "sink.h"
+
+/*
+  Stack machine instructions.
+
+  Code is kept as an array of these, one per instruction, and is
+  turned into assembler text only when it is written out.
+  Branch targets are label numbers; a label is itself an instruction.
+*/
+
+enum opcode {
+    OP_NOP,
+    OP_LABEL,       /* a: label number */
+    OP_LINE,        /* ";; file line what"  a: line number, sym: what */
+    OP_COMMENT,     /* "; text"  sym: text */
+
+    OP_ICONST,      /* a: value */
+    OP_FCONST,      /* sym: literal text */
+    OP_SCONST,      /* sym: literal text, with quotes */
+
+    OP_LOAD,        /* type, a: slot, sym: variable */
+    OP_STORE,       /* type, a: slot, sym: variable */
+    OP_ALOAD,       /* type, sym: array (for the comment) */
+    OP_ASTORE,      /* type, sym: array (for the comment) */
+    OP_GETSTATIC,   /* type, sym: field, FLAG_ARRAY */
+    OP_PUTSTATIC,   /* type, sym: field, FLAG_ARRAY */
+    OP_NEWARRAY,    /* type */
+    OP_IINC,        /* a: slot, b: delta */
+
+    OP_IADD,
+    OP_ISUB,
+    OP_IMUL,
+    OP_IDIV,
+    OP_IREM,
+    OP_IOR,
+    OP_IAND,
+    OP_IXOR,
+    OP_INEG,
+
+    OP_DUP,
+    OP_POP,
+
+    /*
+      Branches; a: target label.
+      Each group is in JVM order, so pairs that negate each other
+      differ only in the low bit (see negate()).
+    */
+    OP_IFEQ,
+    OP_IFNE,
+    OP_IFLT,
+    OP_IFGE,
+    OP_IFGT,
+    OP_IFLE,
+    OP_IF_ICMPEQ,
+    OP_IF_ICMPNE,
+    OP_IF_ICMPLT,
+    OP_IF_ICMPGE,
+    OP_IF_ICMPGT,
+    OP_IF_ICMPLE,
+    OP_GOTO,
+
+    /*
+      A switch is an OP_SWITCH followed by its b OP_CASEs, in
+      increasing order of value; the value is popped, and control
+      goes to the label of the case with that value, or to the
+      default label.  Nothing falls through it.
+    */
+    OP_SWITCH,      /* a: default label, b: number of cases */
+    OP_CASE,        /* a: label, b: value */
+
+    OP_INVOKESTATIC,  /* sym: method, desc: descriptor, FLAG_LIBC */
+    OP_INVOKEVIRTUAL, /* sym: method of java/lang/String, desc: descriptor */
+    OP_RETURN,        /* FLAG_IMPLICIT */
+    OP_VRETURN,       /* type: ireturn, freturn, ... */
+
+    OP_COUNT
+};
+
+enum instr_flags {
+    FLAG_ARRAY    = 1,    /* field is an array */
+    FLAG_LIBC     = 2,    /* method lives in class libc */
+    FLAG_IMPLICIT = 4     /* return added by the compiler */
+};
+
+struct instr {
+    unsigned char op;
+    char type;          /* 'I', 'C', 'F' where it matters, else 0 */
+    unsigned short flags;
+    int a;
+    int b;
+    atom_id sym;
+    atom_id desc;
+
+  public:
+    inline bool is_branch() const {
+      return (op >= OP_IFEQ) && (op <= OP_GOTO);
+    }
+    inline bool is_cond_branch() const {
+      return (op >= OP_IFEQ) && (op < OP_GOTO);
+    }
+    inline bool is_label() const {
+      return OP_LABEL == op;
+    }
+    /* Has a label to go to in a: a branch, switch or case */
+    inline bool has_target() const {
+      return is_branch() || (OP_SWITCH == op) || (OP_CASE == op);
+    }
+};
+
+/*
+  Fill in an instruction.
+*/
+inline instr make_instr(int op, int a = 0, char type = 0, atom_id sym = 0)
+{
+  instr I;
+  I.op = op;
+  I.type = type;
+  I.flags = 0;
+  I.a = a;
+  I.b = 0;
+  I.sym = sym;
+  I.desc = 0;
+  return I;
+}
+
+/*
+  The branch taken exactly when op (a conditional branch) is not.
+*/
+inline int negate(int op)
+{
+  return OP_IFEQ + ((op - OP_IFEQ) ^ 1);
+}
+
+/*
+  True if a switch with these cases (the n OP_CASEs after an
+  OP_SWITCH) is best written as a tableswitch, which is indexed by
+  the value, and false for a lookupswitch, which is searched.
+  The tableswitch is chosen when its cases are dense enough that
+  it is not much larger, using the same costs as javac.
+*/
+bool dense_switch(const instr* cases, int n);
+
+/*
+  Text of a string literal (the sym of an OP_SCONST),
+  quotes removed and escapes replaced.
+*/
+std::string unquote(const char* lit);
+
+/*
+  Parameters and result of a method descriptor like "(I[C)I",
+  one kind letter each: 'I' for int or char, 'F' for float, 'A'
+  for an array or object reference, and 'V' for a void result.
+*/
+void parse_descriptor(const char* desc, std::string &params, char &result);
+
+/*
+  How many operand stack entries I pops, and how many it then pushes.
+*/
+void stack_effect(const instr &I, int &pops, int &pushes);
+
+/*
+  Mnemonic, for statistics and debugging.
+*/
+const char* opname(int op);
+
+/*
+  Write one instruction as Krakatau assembler text.
+  A switch is written with its cases, which must follow it;
+  the cases themselves write nothing.
+    @param  owner     Class name to use for fields and methods
+    @param  srcname   Source file name, for ;; line comments
+*/
+void render(sink &out, const instr &I, const char* owner, const char* srcname);
+
+#endif
@@ -0,0 +1,82 @@
+
+#include "jasm.h"
+
+#include <string.h>
+
+jasm_backend::jasm_backend(sink* S, const std::string &classname, const char* src)
+{
+  out = S;
+  owner = classname;
+  srcname = src;
+
+  out->put("\n; Java assembly code\n\n");
+  out->format(".class public %s\n", owner.c_str());
+  out->put(".super java/lang/Object\n\n");
+  out->put("; Global vars\n");
+  out->put("\n.method <init> : ()V\n");
+  out->put("\t.code stack 1 locals 1\n");
+  out->put("\t\taload_0\n");
+  out->put("\t\tinvokespecial Method java/lang/Object <init> ()V\n");
+  out->put("\t\treturn\n");
+  out->put("\t.end code\n");
+  out->put(".end method\n\n");
+}
+
+jasm_backend::~jasm_backend()
+{
+  delete out;
+}
+
+void jasm_backend::field(atom_id name, char type, bool is_array, const instr* init)
+{
+  out->format(".field public static %s %s%c",
+    atom_table::name(name), is_array ? "[" : "", type);
+  if (!init)                      out->put("\n");
+  else if (OP_FCONST == init->op) out->format(" = %sf\n", atom_table::name(init->sym));
+  else                            out->format(" = %d\n", init->a);
+}
+
+void jasm_backend::method(const char* name, const char* desc,
+                          const std::vector<instr> &code, const frame_info &frame)
+{
+  if (0==strcmp(name, "<clinit>")) {
+    out->format(".method <clinit> : %s\n", desc);
+  } else {
+    out->format(".method public static %s : %s\n", name, desc);
+  }
+  out->format("\t.code stack %d locals %d\n", frame.max_stack, frame.max_locals);
+  for (size_t i=0; i<code.size(); i++) {
+    render(*out, code[i], owner.c_str(), srcname);
+  }
+  out->put("\t.end code\n");
+  out->put(".end method\n\n");
+  out->boundary();
+}
+
+void jasm_backend::entry(bool show_result)
+{
+  out->put(".method public static main : ([Ljava/lang/String;)V\n");
+  if (!show_result) {
+    out->put("\t.code stack 1 locals 1\n");
+    out->format("\t\tinvokestatic Method %s main ()I\n", owner.c_str());
+    out->put("\t\tpop\n");
+  } else {
+    out->put("\t.code stack 2 locals 2\n");
+    out->format("\t\tinvokestatic Method %s main ()I\n", owner.c_str());
+    out->put("\t\tistore_1\n");
+    out->put("\t\tgetstatic Field java/lang/System out Ljava/io/PrintStream;\n");
+    out->put("\t\tldc 'Return code: '\n");
+    out->put("\t\tinvokevirtual Method java/io/PrintStream print (Ljava/lang/String;)V\n");
+    out->put("\t\tgetstatic Field java/lang/System out Ljava/io/PrintStream;\n");
+    out->put("\t\tiload_1\n");
+    out->put("\t\tinvokevirtual Method java/io/PrintStream println (I)V\n");
+  }
+  out->put("\t\treturn\n");
+  out->put("\t.end code\n");
+  out->put(".end method\n");
+}
+
+bool jasm_backend::finish()
+{
+  return out->close();
+}
@@ -0,0 +1,28 @@
+
+#ifndef JASM_H
+#define JASM_H
+
+#include "backend.h"
+
+/*
+  Krakatau assembler text, for the .j file.
+  Text is built up in the sink's buffer and written out between methods.
+*/
+class jasm_backend : public backend {
+    sink* out;
+    std::string owner;
+    const char* srcname;
+
+  public:
+    /* We own (and delete) the sink */
+    jasm_backend(sink* S, const std::string &classname, const char* src);
+    virtual ~jasm_backend();
+
+    virtual void field(atom_id name, char type, bool is_array, const instr* init);
+    virtual void method(const char* name, const char* desc,
+                        const std::vector<instr> &code, const frame_info &frame);
+    virtual void entry(bool show_result);
+    virtual bool finish();
+};
+
+#endif
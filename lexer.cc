@@ -1,121 +1,147 @@
 
 #include "lexer.h"
 #include "parsehelp.h"
+#include "context.h"
 #include "grammar.tab.h"    /* Tokens defined here */
 
-/* 
-  Global variables, sorry
+/*
+  From flex, for the reentrant scanner.
 */
+struct yy_buffer_state;
+yy_buffer_state* yy_scan_buffer(char* base, size_t size, void* scanner);
+int yylex_init_extra(lexer_state* extra, void** scanner);
+int yylex_destroy(void* scanner);
+int yyget_lineno(void* scanner);
+void yyset_lineno(int line, void* scanner);
+char* yyget_text(void* scanner);
 
-const char* filename;
-const char* jvm_file;
-std::string classname;
-FILE * jF;
-char tokens_only;
-extern int yylineno;          /* flex manages this */
-extern const char* yytext;    /* flex also manages this */
-char last_mode;
-char second_last_mode;
-int loop;
-int if_flag;
+// #define STOP_ERRORS 25
 
-void yyset_in(FILE*);         /* flex gives this */
+lexer_state::lexer_state()
+{
+  filename = 0;
+  tokens_only = 0;
+  last_mode = 0;
+  second_last_mode = 0;
+  scanner = 0;
+  start_comment = 0;
+  total_errors = 0;
+  errors = 0;
+}
 
-// #define STOP_ERRORS 25
+lexer_state::~lexer_state()
+{
+  if (scanner) yylex_destroy(scanner);
+}
 
-#ifdef STOP_ERRORS
-unsigned total_errors;
-#endif
+lexer_state& currentLexer()
+{
+  return compiler_context::current()->lexer;
+}
 
+std::ostream& diagnostics()
+{
+  const compiler_context* C = compiler_context::current();
+  return (C && C->lexer.errors) ? *C->lexer.errors : std::cerr;
+}
 
-int  initLexer(const char* infile, char _tok_only, char _last_mode, char _second_last_mode)
+int  initLexer(const char* infile, const char* text, size_t len,
+               char _tok_only, char _last_mode, char _second_last_mode)
 {
-#ifdef STOP_ERRORS
-  total_errors = 0;
-#endif
-  last_mode = _last_mode;
-  second_last_mode = _second_last_mode;
-  loop = 0;
-  if_flag = 0;
-  filename = infile;
-  std::string jvm_code(infile);
-  classname = jvm_code.replace(jvm_code.find(".c"), sizeof(".c") - 1, "");
-  jvm_file = jvm_code.append(".j").c_str();
-  jF = fopen(jvm_file, "w" );
-  fprintf(jF, "\n; Java assembly code\n\n");
-  fprintf(jF, ".class public %s\n", classname.c_str());
-  fprintf(jF, ".super java/lang/Object\n\n");
-  fprintf(jF, "; Global vars\n");
-  fprintf(jF, "\n.method <init> : ()V\n");
-  fprintf(jF, "\t.code stack 1 locals 1\n");
-  fprintf(jF, "\t\taload_0\n");
-  fprintf(jF, "\t\tinvokespecial Method java/lang/Object <init> ()V\n");
-  fprintf(jF, "\t\treturn\n");
-  fprintf(jF, "\t.end code\n");
-  fprintf(jF, ".end method\n\n");
-  tokens_only = _tok_only;
-  yylineno = 1;
-  FILE* fin = fopen(infile, "r");
-  if (0==fin) {
-    std::cerr << "Error, couldn't open input file " << infile << "\n";
+  lexer_state &L = currentLexer();
+  L.total_errors = 0;
+  L.last_mode = _last_mode;
+  L.second_last_mode = _second_last_mode;
+  L.filename = infile;
+  L.tokens_only = _tok_only;
+  L.start_comment = 0;
+  if (L.scanner) yylex_destroy(L.scanner);
+  L.scanner = 0;
+  if (text) {
+    L.source.load(text, len);
+  } else if (!L.source.open(infile)) {
+    diagnostics() << "Error, couldn't open input file " << infile << "\n";
+    return 0;
+  }
+  if (yylex_init_extra(&L, &L.scanner)) {
+    diagnostics() << "Error, couldn't start the lexer for " << infile << "\n";
+    L.scanner = 0;
+    return 0;
+  }
+  /*
+    Scan in place; yytext points into the mapping from here on.
+  */
+  if (0==yy_scan_buffer(L.source.text(), L.source.scan_size(), L.scanner)) {
+    diagnostics() << "Error, couldn't scan input file " << infile << "\n";
     return 0;
   }
-  yyset_in(fin);
+  yyset_lineno(1, L.scanner);
   return 1;
 }
 
+void closeLexer()
+{
+  lexer_state &L = currentLexer();
+  if (L.scanner) yylex_destroy(L.scanner);
+  L.scanner = 0;
+  L.source.close();
+  L.filename = 0;
+  L.errors = 0;
+}
+
+int lineNumber()
+{
+  const lexer_state &L = currentLexer();
+  return L.scanner ? yyget_lineno(L.scanner) : 0;
+}
+
 void printLocation(std::ostream &out)
 {
-  out << filename << " line " << yylineno << " text '" << yytext << "'";
+  const lexer_state &L = currentLexer();
+  out << L.filename << " line " << lineNumber() << " text '" << yyget_text(L.scanner) << "'";
 }
 
 void startError()
 {
 #ifdef STOP_ERRORS
-  if (++total_errors > STOP_ERRORS) {
-    std::cerr << "Too many errors; exiting.\n";
+  if (++currentLexer().total_errors > STOP_ERRORS) {
+    diagnostics() << "Too many errors; exiting.\n";
     exit(1);
   }
 #endif
-  std::cerr << "Error near ";
-  printLocation(std::cerr);
-  std::cerr << "\n\t";
+  diagnostics() << "Error near ";
+  printLocation(diagnostics());
+  diagnostics() << "\n\t";
 }
 
 void startError(int lineno)
 {
 #ifdef STOP_ERRORS
-  if (++total_errors > STOP_ERRORS) {
-    std::cerr << "Too many errors; exiting.\n";
+  if (++currentLexer().total_errors > STOP_ERRORS) {
+    diagnostics() << "Too many errors; exiting.\n";
     exit(1);
   }
 #endif
-  std::cerr << "Error near " << filename << " line " << lineno << "\n\t";
+  diagnostics() << "Error near " << currentLexer().filename << " line " << lineno << "\n\t";
 }
 
 int unclosedComment(int start)
 {
   startError(start);
-  std::cerr << "Unclosed comment\n";
+  diagnostics() << "Unclosed comment\n";
   return 0;
 }
 
 void ignoringDirective(const char* dir)
 {
-  std::cerr << "Warning: ignoring " << dir << " directive in ";
-  std::cerr << filename << " line " << yylineno << "\n";
+  diagnostics() << "Warning: ignoring " << dir << " directive in ";
+  diagnostics() << currentLexer().filename << " line " << lineNumber() << "\n";
 }
 
-void badToken(const char* x)
+void badToken(const char*)
 {
   startError();
-  std::cerr << "unexpected characters; ignoring.\n";
-}
-
-int yywrap()
-{
-  /* Switch to next file.  Return 0 if more files, 1 if not. */
-  return 1;
+  diagnostics() << "unexpected characters; ignoring.\n";
 }
 
 /*
@@ -137,6 +163,9 @@ const char* getTokenName(int tok)
     CASE_RETURN(BREAK);
     CASE_RETURN(CONTINUE);
     CASE_RETURN(RETURN);
+    CASE_RETURN(SWITCH);
+    CASE_RETURN(CASE);
+    CASE_RETURN(DEFAULT);
 
     CASE_RETURN(IDENT);
     CASE_RETURN(INTCONST);
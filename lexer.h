@@ -4,17 +4,65 @@
 
 #include <iostream>
 
+#include "source.h"
+
 /*
   Lexer front-end functions.
 */
 
 /*
-  Initialize the lexer with the given input file.
+  Everything the lexer keeps for one compilation.
+  Each compiler_context has one; the functions below
+  use that of the compilation running on the calling thread.
+*/
+struct lexer_state {
+    const char* filename;
+    char tokens_only;       /* Just split into tokens (mode 1)? */
+    char last_mode;
+    char second_last_mode;
+    source_file source;     /* The input text */
+    void* scanner;          /* The flex scanner, a yyscan_t */
+    int start_comment;      /* Where the comment being skipped began */
+    unsigned total_errors;
+    std::ostream* errors;   /* Where messages go; 0 for std::cerr */
+
+  public:
+    lexer_state();
+    ~lexer_state();
+};
+
+/*
+  The lexer of the compilation running on this thread.
+*/
+lexer_state& currentLexer();
+
+/*
+  Where error messages and warnings go, for the compilation
+  running on this thread: std::cerr unless it says otherwise.
+*/
+std::ostream& diagnostics();
+
+/*
+  Initialize the lexer with the given input.
     @param  infile        Input file name to use
+    @param  text          The input itself, len bytes (it is copied);
+                          or 0 to read the file infile
     @param  tokens_only   If true, just split into tokens (mode 1).
   Return true on success, 0 on failure (can't open file)
 */
-int initLexer(const char* infile, char tokens_only, char last_mode, char second_last_mode);
+int initLexer(const char* infile, const char* text, size_t len,
+              char tokens_only, char last_mode, char second_last_mode);
+
+/*
+  Release the input and the flex scanner when a compilation is over,
+  so nothing is left for the next one in the same context.
+*/
+void closeLexer();
+
+/*
+  The line the lexer has reached.
+*/
+int lineNumber();
 
 /*
   Display the current 'location' in input:
@@ -50,16 +98,11 @@ void ignoringDirective(const char* dir);
 void badToken(const char* x);
 
 /*
-  Generated by flex
+  Generated by flex; reentrant, so the scanner is passed in,
+  and the token's value goes to lval (the bison bridge).
 */
-int yylex();
-
-/*
-  Needed by flex
-*/
-int yywrap();
-
-#define YY_SKIP_YYWRAP
+union YYSTYPE;
+int yylex(union YYSTYPE* lval, void* scanner);
 
 const char* getTokenName(int tok);
 
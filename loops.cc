@@ -0,0 +1,413 @@
+
+#include "loops.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <set>
+
+/*
+  Counts for -s, over all methods compiled on this thread
+  since clearStats().
+*/
+static thread_local long loops_found;
+static thread_local long expressions_hoisted;
+static thread_local std::vector<std::string> reports;
+
+static inline char kind_of(char type)
+{
+  return ('F' == type) ? 'F' : 'I';
+}
+
+static const char* infix(int op)
+{
+  switch (op) {
+    case OP_IADD:   return " + ";
+    case OP_ISUB:   return " - ";
+    case OP_IMUL:   return " * ";
+    case OP_IDIV:   return " / ";
+    case OP_IREM:   return " % ";
+    case OP_IOR:    return " | ";
+    case OP_IAND:   return " & ";
+    case OP_IXOR:   return " ^ ";
+  }
+  return " ? ";
+}
+
+/*
+  Source text for the pure code C[start..end], for the report.
+  Locals from first on are ones made here, holding moved[slot-first].
+*/
+static std::string expression(const std::vector<instr> &C, int start, int end,
+  int first, const std::vector<std::string> &moved)
+{
+  struct term {
+    std::string text;
+    bool compound;
+  };
+  std::vector<term> stack;
+  for (int i=start; i<=end; i++) {
+    const instr &I = C[i];
+    term t;
+    t.compound = false;
+    switch (I.op) {
+      case OP_ICONST: {
+          char buf[20];
+          snprintf(buf, sizeof(buf), "%d", I.a);
+          t.text = buf;
+          break;
+      }
+      case OP_LOAD:
+          if (I.a >= first) {
+            t.text = moved[I.a - first];
+            t.compound = (t.text.find(' ') != std::string::npos);
+            break;
+          }
+          /* fall through */
+      case OP_FCONST:
+      case OP_GETSTATIC:
+          t.text = atom_table::name(I.sym);
+          break;
+
+      case OP_INEG:
+          t.text = stack.back().compound ? "-(" + stack.back().text + ")"
+                                         : "-" + stack.back().text;
+          stack.pop_back();
+          break;
+
+      default: {
+          term y = stack.back();
+          stack.pop_back();
+          term x = stack.back();
+          stack.pop_back();
+          if (x.compound) x.text = "(" + x.text + ")";
+          if (y.compound) y.text = "(" + y.text + ")";
+          t.text = x.text + infix(I.op) + y.text;
+          t.compound = true;
+      }
+    }
+    stack.push_back(t);
+  }
+  return stack.back().text;
+}
+
+/* ====================================================================== */
+
+loopnest::loopnest(const std::vector<instr> &code, int params) : G(code)
+{
+  good = G.ok();
+  if (!good) return;
+  G.removeUnreachable();
+  good = G.ok();
+  if (!good) return;
+
+  nlocals = params;
+  temps = 0;
+  for (size_t b=0; b<G.blocks.size(); b++) {
+    const std::vector<instr> &C = G.blocks[b].code;
+    for (size_t i=0; i<C.size(); i++) {
+      if ((OP_LOAD == C[i].op) || (OP_STORE == C[i].op) || (OP_IINC == C[i].op)) {
+        if (C[i].a < 0) good = false;
+        if (C[i].a + 1 > nlocals) nlocals = C[i].a + 1;
+      }
+    }
+  }
+  if (!good) return;
+  find(G, loops);
+  loops_found += loops.size();
+}
+
+static bool outer_first(const loopnest::loop &x, const loopnest::loop &y)
+{
+  return x.body.size() > y.body.size();
+}
+
+void loopnest::find(const flowgraph &G, std::vector<loop> &loops)
+{
+  int n = G.blocks.size();
+  std::vector<int> idom;
+  G.dominators(idom);
+  std::vector< std::vector<int> > preds(n);
+  std::vector<int> succ;
+  for (int b=0; b<n; b++) {
+    if (idom[b] < 0) continue;
+    G.successors(b, succ);
+    for (size_t s=0; s<succ.size(); s++) preds[succ[s]].push_back(b);
+  }
+
+  std::vector<int> loop_of(n, -1);
+  for (int b=0; b<n; b++) {
+    if (idom[b] < 0) continue;
+    G.successors(b, succ);
+    for (size_t s=0; s<succ.size(); s++) {
+      int h = succ[s];
+      int d = b;
+      while ((d != h) && (d != 0)) d = idom[d];
+      if (d != h) continue;
+
+      /* b to h is a back edge */
+      if (loop_of[h] < 0) {
+        loop_of[h] = loops.size();
+        loops.resize(loops.size()+1);
+        loops.back().header = h;
+        loops.back().body.push_back(h);
+        loops.back().inside.assign(n, false);
+        loops.back().inside[h] = true;
+      }
+      loop &L = loops[loop_of[h]];
+      std::vector<int> work;
+      if (!L.inside[b]) {
+        L.inside[b] = true;
+        L.body.push_back(b);
+        work.push_back(b);
+      }
+      while (!work.empty()) {
+        int x = work.back();
+        work.pop_back();
+        for (size_t j=0; j<preds[x].size(); j++) {
+          int p = preds[x][j];
+          if (L.inside[p]) continue;
+          L.inside[p] = true;
+          L.body.push_back(p);
+          work.push_back(p);
+        }
+      }
+    }
+  }
+  std::stable_sort(loops.begin(), loops.end(), outer_first);
+}
+
+/*
+  The block that leads into L from outside, made if needed;
+  -1 if L starts the method.
+*/
+int loopnest::preheader(loop &L)
+{
+  int h = L.header;
+  if (0 == h) return -1;
+  std::vector<int> from;
+  for (size_t b=0; b<G.blocks.size(); b++) {
+    const flowgraph::block &B = G.blocks[b];
+    if (!B.live || ((b < L.inside.size()) && L.inside[b])) continue;
+    bool to_h = (B.taken == h) || (B.next == h);
+    for (size_t k=0; k<B.cases.size(); k++) {
+      if (B.cases[k] == h) to_h = true;
+    }
+    if (to_h) from.push_back(b);
+  }
+  if (1 == from.size()) {
+    /* Not one that branches elsewhere too */
+    int op = G.blocks[from[0]].exit.op;
+    if ((OP_NOP == op) || (OP_GOTO == op)) return from[0];
+  }
+
+  int p = G.addBlock(h);
+  for (size_t j=0; j<from.size(); j++) {
+    flowgraph::block &B = G.blocks[from[j]];
+    if (B.taken == h) B.taken = p;
+    if (B.next == h) B.next = p;
+    for (size_t k=0; k<B.cases.size(); k++) {
+      if (B.cases[k] == h) B.cases[k] = p;
+    }
+  }
+  return p;
+}
+
+void loopnest::hoistFrom(loop &L, std::vector<std::string> &hoisted)
+{
+  /*
+    What the loop changes.
+  */
+  std::vector<bool> written(nlocals + temps, false);
+  std::set<atom_id> fields;
+  bool calls = false;
+  for (size_t j=0; j<L.body.size(); j++) {
+    const std::vector<instr> &C = G.blocks[L.body[j]].code;
+    for (size_t i=0; i<C.size(); i++) {
+      if ((OP_STORE == C[i].op) || (OP_IINC == C[i].op)) written[C[i].a] = true;
+      if (OP_PUTSTATIC == C[i].op) fields.insert(C[i].sym);
+      if (OP_INVOKESTATIC == C[i].op) calls = true;
+    }
+  }
+
+  int pre = -2;
+  for (size_t j=0; j<L.body.size(); j++) {
+    int b = L.body[j];
+    const std::vector<instr> &C = G.blocks[b].code;
+
+    /*
+      Follow the operand stack: each entry knows where the code
+      that pushed it starts, and whether that code can be moved.
+      Code that can't be moved is a barrier; a run of code
+      must not have one in the middle.
+    */
+    struct entry {
+      int start;        /* or -1 if before the block */
+      bool movable;
+      bool reads;       /* reads a local or global */
+      bool nonzero;     /* a constant other than 0 */
+      char kind;
+    };
+    std::vector<entry> stack;
+    std::vector<candidate> found;
+    int barrier = -1;
+    for (int i=0; i<(int) C.size(); i++) {
+      const instr &I = C[i];
+      int pops, pushes;
+      stack_effect(I, pops, pushes);
+      while ((int) stack.size() < pops) {
+        entry e = { -1, false, false, false, 'I' };
+        stack.insert(stack.begin(), e);
+      }
+      std::vector<entry> in(stack.end() - pops, stack.end());
+      stack.resize(stack.size() - pops);
+
+      entry e = { pops ? in[0].start : i, false, false, false, 'I' };
+      switch (I.op) {
+        case OP_ICONST:
+            e.movable = true;
+            e.nonzero = (I.a != 0);
+            break;
+        case OP_FCONST:
+            e.movable = true;
+            e.kind = 'F';
+            break;
+        case OP_LOAD:
+            e.movable = !written[I.a];
+            e.reads = true;
+            e.kind = kind_of(I.type);
+            break;
+        case OP_GETSTATIC:
+            e.movable = !(I.flags & FLAG_ARRAY) && !calls && !fields.count(I.sym);
+            e.reads = true;
+            e.kind = kind_of(I.type);
+            break;
+        case OP_IDIV:
+        case OP_IREM:
+            e.movable = in[1].nonzero;
+            break;
+        case OP_IADD:
+        case OP_ISUB:
+        case OP_IMUL:
+        case OP_IOR:
+        case OP_IAND:
+        case OP_IXOR:
+        case OP_INEG:
+            e.movable = true;
+            break;
+      }
+      if (!e.movable) {
+        barrier = i;
+        if (pushes) stack.push_back(e);
+        continue;
+      }
+      if ((e.start < 0) || (e.start <= barrier)) e.movable = false;
+      for (int k=0; k<pops; k++) {
+        if (!in[k].movable) e.movable = false;
+        if (in[k].reads) e.reads = true;
+        if ('F' == in[k].kind) e.kind = 'F';
+      }
+      stack.push_back(e);
+      if (!e.movable || !e.reads) continue;
+      /* A load from a local is as cheap as the load from a new one */
+      if ((OP_LOAD == I.op) && (e.start == i)) continue;
+      candidate c = { e.start, i, e.kind };
+      found.push_back(c);
+    }
+    if (found.empty()) continue;
+
+    /*
+      Keep the outermost; found is in order of where they end,
+      so an enclosing run comes after the ones inside it.
+    */
+    std::vector<candidate> kept;
+    for (size_t f=found.size(); f-- > 0; ) {
+      if (!kept.empty() && (found[f].end >= kept.back().start)) continue;
+      kept.push_back(found[f]);
+    }
+    std::reverse(kept.begin(), kept.end());
+
+    if (-2 == pre) pre = preheader(L);
+    if (pre < 0) return;
+    hoistRuns(b, pre, kept, hoisted);
+  }
+}
+
+/*
+  Replace each run of block b in kept with a load of a new local,
+  and compute it into that local at the end of block pre.
+*/
+void loopnest::hoistRuns(int b, int pre, const std::vector<candidate> &kept,
+  std::vector<std::string> &hoisted)
+{
+  const std::vector<instr> &C = G.blocks[b].code;
+  std::vector<instr> out;
+  size_t k = 0;
+  for (int i=0; i<(int) C.size(); i++) {
+    if ((k < kept.size()) && (kept[k].start == i)) {
+      const candidate &K = kept[k];
+      char name[20];
+      snprintf(name, sizeof(name), "$h%d", temps);
+      atom_id sym = atom_table::intern(name);
+      int slot = nlocals + temps++;
+      std::vector<instr> &P = G.blocks[pre].code;
+      P.insert(P.end(), C.begin() + K.start, C.begin() + K.end + 1);
+      P.push_back(make_instr(OP_STORE, slot, K.kind, sym));
+      out.push_back(make_instr(OP_LOAD, slot, K.kind, sym));
+      moved.push_back(expression(C, K.start, K.end, nlocals, moved));
+      hoisted.push_back(moved.back());
+      expressions_hoisted++;
+      i = K.end;
+      k++;
+      continue;
+    }
+    out.push_back(C[i]);
+  }
+  G.blocks[b].code.swap(out);
+}
+
+void loopnest::hoist(std::vector<instr> &code, std::vector<std::string> &hoisted)
+{
+  size_t before = hoisted.size();
+  for (size_t l=0; l<loops.size(); l++) {
+    hoistFrom(loops[l], hoisted);
+  }
+  if (hoisted.size() == before) return;
+  G.layout();
+  G.write(code);
+}
+
+/* ====================================================================== */
+
+void loopnest::optimize(std::vector<instr> &code, int params, const char* name)
+{
+  loopnest N(code, params);
+  if (!N.ok() || N.loops.empty()) return;
+  std::vector<std::string> hoisted;
+  N.hoist(code, hoisted);
+  if (hoisted.empty()) return;
+
+  std::string line = name;
+  line += ": ";
+  for (size_t h=0; h<hoisted.size(); h++) {
+    if (h) line += ", ";
+    line += hoisted[h];
+  }
+  reports.push_back(line);
+}
+
+void loopnest::showStats(std::ostream &s)
+{
+  s << "Loops\n";
+  s << "\tloops found: " << loops_found << "\n";
+  s << "\texpressions hoisted: " << expressions_hoisted << "\n";
+  for (size_t r=0; r<reports.size(); r++) {
+    s << "\t  " << reports[r] << "\n";
+  }
+}
+
+void loopnest::clearStats()
+{
+  loops_found = 0;
+  expressions_hoisted = 0;
+  reports.clear();
+}
@@ -0,0 +1,107 @@
+
+#ifndef LOOPS_H
+#define LOOPS_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "instr.h"
+#include "cfg.h"
+
+/*
+  Loops of one method, and loop-invariant code motion.
+
+  A loop is found from its back edges: a branch (or fall-through)
+  to a block that dominates it.  The target is the loop header,
+  and the body is every block that reaches the back edge without
+  going through the header; loops with the same header are one loop.
+  For the while and for loops the front end writes, the header is
+  the test at the bottom, and the block with the goto to it is the
+  preheader, the one way into the loop from outside.
+
+  Code that computes the same value on every trip around a loop is
+  computed once in the preheader instead, into a new local, and the
+  loop loads that.  Only code that can't throw or have side effects
+  is moved (no division by a variable, array elements or calls),
+  and it is invariant if it reads only locals the loop never stores
+  to, and globals the loop never stores to and with no calls in the
+  loop (a call could store to any global).
+*/
+
+class loopnest {
+  public:
+    struct loop {
+        int header;
+        std::vector<int> body;        /* blocks, header first */
+        std::vector<bool> inside;     /* per block */
+    };
+
+    /*
+      Loops, outermost first.
+    */
+    std::vector<loop> loops;
+
+  public:
+    /*
+      Find the loops of code.  Check ok() before using it.
+        @param  params    Number of parameter slots
+    */
+    loopnest(const std::vector<instr> &code, int params);
+
+    /*
+      Find the loops of a graph, outermost first.
+    */
+    static void find(const flowgraph &G, std::vector<loop> &loops);
+
+    /*
+      False if the code could not be made into a graph (see
+      flowgraph::ok), or has a local with no slot.
+    */
+    inline bool ok() const { return good; }
+
+    /*
+      Move invariant code out of each loop and write the code back.
+        @param  hoisted   What was moved, as source expressions
+    */
+    void hoist(std::vector<instr> &code, std::vector<std::string> &hoisted);
+
+    /*
+      All of the above, on one method's code in place.
+        @param  name      Method name, for the report
+    */
+    static void optimize(std::vector<instr> &code, int params, const char* name);
+
+    /*
+      Show what was hoisted, method by method, for -s.
+    */
+    static void showStats(std::ostream &s);
+
+    /*
+      Start the counts for showStats() over.
+    */
+    static void clearStats();
+
+  private:
+    /*
+      Code in one block to move: instructions start..end push a value.
+    */
+    struct candidate {
+        int start;
+        int end;
+        char kind;
+    };
+
+    bool good;
+    flowgraph G;
+    int nlocals;
+    int temps;
+    std::vector<std::string> moved;   /* what each new local holds */
+
+    int preheader(loop &L);
+    void hoistFrom(loop &L, std::vector<std::string> &hoisted);
+    void hoistRuns(int b, int pre, const std::vector<candidate> &kept,
+      std::vector<std::string> &hoisted);
+};
+
+#endif
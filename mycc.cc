@@ -1,9 +1,10 @@
 
 #include <iostream>
 #include <fstream>
+#include <stdlib.h>
 
-#include "lexer.h"
-#include "parsehelp.h"
+#include "context.h"
+#include "batch.h"
 
 using namespace std;
 
@@ -13,7 +14,10 @@ int usage(const char* arg)
     cerr << "Unknown switch: " << arg << "\n\n";
   }
   cerr << "Usage:\n";
-  cerr << "\tmycc -mode [options] infile\n";
+  cerr << "\tmycc -mode [options] infile ...\n";
+  cerr << "\n";
+  cerr << "An infile of the form @file names a file that lists\n";
+  cerr << "more input files, separated by blanks or newlines.\n";
   cerr << "\n";
   cerr << "Valid modes:\n";
   cerr << "\t -0: Version information\n";
@@ -23,91 +27,18 @@ int usage(const char* arg)
   cerr << "\n";
   cerr << "Valid options:\n";
   cerr << "\t -o outfile: write to outfile instead of standard output\n";
+  cerr << "\t -j threads: compile on this many threads (0, the default: one per processor),\n";
+  cerr << "\t\tand show the time taken for each input file\n";
+  cerr << "\t -s: show compiler statistics on standard error\n";
+  cerr << "\t -t target: code for modes 4 and 5, one of\n";
+  cerr << "\t\tclass: JVM class file, infile.class (default)\n";
+  cerr << "\t\tjasm: Krakatau assembler text, infile.j\n";
+  cerr << "\t\tx86: x86-64 GNU assembler text, infile.s\n";
+  cerr << "\t\tc: portable C source, infile.out.c\n";
   cerr << "\n";
   return arg ? 1 : 0;
 }
 
-int version(ostream &s)
-{
-  s << "My bare-bones C compiler (for COM 440/540)\n";
-  s << "\tWritten by Anju Kumari (ank@iastate.edu)\n";
-  s << "\tVersion 0.1\n";
-  s << "\t5 January, 2021\n";
-  return 0;
-}
-
-int dump_tokens(ostream &s)
-{
-  for (int tok=yylex(); tok; tok=yylex()) {
-    printLocation(s);
-    s << " token " << getTokenName(tok) << "\n";
-    s.flush();
-    // for (int  i=1; i<300000000; i++);    // Add delay for testing script :)
-  }
-  return 0;
-}
-
-int compile(char mode, const char* infile, ostream &fout)
-{
-  if (' ' == mode) {
-    cerr << "No mode specified; run without arguments for usage.\n";
-    return 6;
-  }
-
-  if ('0'==mode) {
-    if (infile) {
-      cerr << "Warning: ignoring input file\n";
-    }
-    return version(fout);
-  }
-
-  if (0==infile) {
-    cerr << "Error, no input file(s) specified.  Nothing to do.\n";
-    return 7;
-  }
-
-
-  initLexer(infile, '1' == mode, '5' == mode, '4' == mode);
-  
-
-  if ('1'==mode) {
-    return dump_tokens(fout);
-  }
-
-  parse_data::Initialize(mode > '2');
-  yyparse();
-  // We could catch the return of yyparse() to know
-  // if a syntax error occurred or not.
-  parse_data::Finalize();
-
-  if ( ('2' == mode) || ('3' == mode) ) {
-    parse_data::showGlobals(fout);
-    parse_data::showFunctions(fout);
-    return 0;
-  }
-  
-   
-   
-   if ( ('4' == mode) || ('5' == mode) ) {
-    typeinfo T;
-    T.set('I', false);
-    identlist* P = 0;
-    char fname[8] = "getchar";
-    char *f_name = fname;
-    parse_data::startFunction(T, f_name, P);
-    char cname[] = "c";
-    f_name = cname;
-    identlist *L = new identlist(T, f_name, false);
-    char pname[8] = "putchar";
-    f_name = pname;
-    parse_data::startFunction(T, f_name, L);
-    return 0;
-  }
-
-  cerr << "Mode " << mode << " not implemented yet.\n";
-  return 8;
-}
-
 int main(int argc, const char** argv)
 {
   /*
@@ -118,19 +49,26 @@ int main(int argc, const char** argv)
     return usage(0);
   }
 
-  char mode = ' ';
+  compile_options opts;
   const char* outfile = 0;
-  const char* infile = 0;
+  std::vector<std::string> infiles;
+  bool batch = false;
+  unsigned jobs = 0;
   for (int i=1; i<argc; i++) {
+    if ('@' == argv[i][0]) {
+      // Response file, listing input files
+
+      if (!readResponseFile(argv[i]+1, infiles)) {
+        cerr << "Error, couldn't open response file " << argv[i]+1 << "\n";
+        return 7;
+      }
+      batch = true;
+      continue;
+    }
     if ('-' != argv[i][0]) {
       // Argument doesn't start with -, assume it is an input file
 
-      if (infile) {
-        cerr << "More than one input file specified\n\t(";
-        cerr << infile << " and " << argv[i] << "), not implemented\n";
-        return 1;
-      }
-      infile = argv[i];
+      infiles.push_back(argv[i]);
       continue;
     }
 
@@ -150,12 +88,12 @@ int main(int argc, const char** argv)
       case '3':
       case '4':
       case '5':
-                if ((mode != ' ') && (mode != argv[i][1])) {
-                  cerr << "More than one mode specified (-" << mode;
+                if ((opts.mode != ' ') && (opts.mode != argv[i][1])) {
+                  cerr << "More than one mode specified (-" << opts.mode;
                   cerr << " and " << argv[i] << ")\n";
                   return 2;
                 }
-                mode = argv[i][1];
+                opts.mode = argv[i][1];
                 continue;
 
       case 'o':
@@ -171,6 +109,40 @@ int main(int argc, const char** argv)
                 outfile = argv[i+1];
                 i++;  // will be incremented again in for loop
                 continue;
+
+      case 'j':
+                if (0==argv[i+1]) {
+                  cerr << "Missing argument for -j\n";
+                  return 3;
+                }
+                {
+                  char* end;
+                  long n = strtol(argv[i+1], &end, 10);
+                  if ((end == argv[i+1]) || *end || (n < 0) || (n > 4096)) {
+                    cerr << "Bad number of threads: " << argv[i+1] << "\n";
+                    return 3;
+                  }
+                  jobs = n;
+                }
+                batch = true;
+                i++;
+                continue;
+
+      case 's':
+                opts.stats = true;
+                continue;
+
+      case 't':
+                if (0==argv[i+1]) {
+                  cerr << "Missing argument for -t\n";
+                  return 3;
+                }
+                if (!parse_target(argv[i+1], opts.target)) {
+                  cerr << "Unknown target: " << argv[i+1] << "\n";
+                  return 3;
+                }
+                i++;
+                continue;
     };
 
     // Still going?  Must be a bogus switch.
@@ -178,18 +150,28 @@ int main(int argc, const char** argv)
   }
 
   /*
-    Do the appropriate thing for the requested mode
+    Do the appropriate thing for the requested mode:
+    on its own for one input file, or as a batch otherwise.
   */
 
+  if (infiles.size() > 1) batch = true;
+  if (infiles.empty() || (' ' == opts.mode) || ('0' == opts.mode)) batch = false;
+  const char* infile = infiles.empty() ? 0 : infiles[0].c_str();
+
+  ofstream file;
   if (outfile) {
-    ofstream fout(outfile);
-    if (!fout) {
+    file.open(outfile);
+    if (!file) {
       cerr << "Couldn't open output file " << outfile << "\n";
       return 5;
     }
-    return compile(mode, infile, fout);
-  } else {
-    return compile(mode, infile, std::cout);
   }
+  std::ostream &fout = outfile ? file : std::cout;
+
+  if (batch) {
+    return compileBatch(infiles, opts, jobs, fout);
+  }
+  compiler_context ctx;
+  return compile(ctx, infile, 0, 0, opts, fout);
 
 }
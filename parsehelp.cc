@@ -12,15 +12,33 @@
 #include <algorithm>
 #include <map>
 
-extern int yylineno;
-extern const char* filename;
-extern const char* jvm_file;
-extern std::string classname;
-extern FILE* jF;
-extern int loop;
-extern char last_mode;
-extern char second_last_mode;
-extern int if_flag;
+/*
+  The lexer's view of this compilation (see lexer_state).
+*/
+static inline const char* filename()    { return currentLexer().filename; }
+static inline char last_mode()          { return currentLexer().last_mode; }
+static inline char second_last_mode()   { return currentLexer().second_last_mode; }
+
+/*
+  Inlining limits.  A function is inlined if its finished code is
+  at most INLINE_SIZE instructions and needs at most INLINE_STACK
+  operand stack entries, which the call adds to the caller's stack;
+  a caller takes at most INLINE_BUDGET inlined instructions, so
+  functions built from inlined calls can't keep growing.
+  The locals of inlined code are numbered from INLINE_BASE until
+  the caller is finished (see function::relocate).
+*/
+#define INLINE_SIZE     24
+#define INLINE_STACK    4
+#define INLINE_BUDGET   256
+#define INLINE_BASE     0x10000
+
+static thread_local long calls_inlined;
+static thread_local long tail_calls;
+static thread_local std::string tail_call_functions;
+static thread_local long table_switches;
+static thread_local long lookup_switches;
+static thread_local std::string switch_lines;
 
 /* ====================================================================== */
 
@@ -33,13 +51,26 @@ class function {
       int lineno;
       typeinfo type;
       stmtnode* next;
+
+      /* Allocated in the arena */
+      static inline void* operator new(size_t bytes) {
+        return allocNode(bytes, NODE_STMTNODE);
+      }
+      static inline void operator delete(void*) { }
     };
 
   private:
     typeinfo type;
-    char* name;
+    atom_id name;
+    /*
+      Interned JVM signatures, e.g. "(I[C)" and "(I[C)I",
+      kept in step with the formals.
+    */
+    atom_id param_sig;
+    atom_id descriptor;
     identlist* formals;
     identlist* locals;
+    identlist* locals_end;
     
     bool prototype_only;
 
@@ -49,8 +80,15 @@ class function {
     int lineno;
     int labelCount;
 
+    /*
+      For jump lists: indexed by label, the next label on the
+      list (0 at the end), and the target once backpatched (or 0).
+    */
+    std::vector<int> hole_next;
+    std::vector<int> hole_target;
+
   public:
-    function(typeinfo T, char* n, identlist* F);
+    function(typeinfo T, atom_id n, identlist* F);
     ~function();
 
     // Print an error message
@@ -62,16 +100,31 @@ class function {
       return prototype_only;
     }
 
-    inline bool name_matches(const char* findname) const {
-      return (0==strcmp(name, findname));
+    inline bool name_matches(atom_id findname) const {
+      return (name == findname);
     };
 
-    bool params_match(const identlist* other) const;
+    inline bool params_match(const identlist* other) const {
+      return param_sig == signature(other);
+    }
     void replace_params(identlist* newformals);
-    bool call_matches(const typelist* actual) const;
+
+    /*
+      actual is the interned signature of the argument types,
+      as built by signature(const typelist*).
+    */
+    inline bool call_matches(atom_id actual) const {
+      return param_sig == actual;
+    }
+
+    /*
+      Parameter signature "(...)" for a list of formals / arguments.
+    */
+    static atom_id signature(const identlist* L);
+    static atom_id signature(const typelist* L);
 
     // Return true on success, false on error because already defined
-    bool addLocals(identlist* L);
+    bool addLocals(identlist* L, symtab* scope);
 
     // Return true on success, false on error because already defined
     bool addStatement(int lineno, typeinfo type);
@@ -79,123 +132,524 @@ class function {
     /* Show information for modes 2 and 3 */
     void display(std::ostream& out, bool show_types) const;
 
-    inline const identlist* find(const char* name) const
-    {
-      const identlist* v = locals ? locals->find(name) : 0;
-      if (v) return v;
-      return formals ? formals->find(name) : 0;
-    }
-
     inline typeinfo getType() const { return type; }
 
-    inline char* getName() const { return name; }
+    inline const char* getName() const { return atom_table::name(name); }
+    inline atom_id getAtom() const { return name; }
+    inline atom_id getDescriptor() const { return descriptor; }
 
     inline identlist* getParams() const { return formals; }
     inline identlist* getLocals() const { return locals; }
-    inline int getlabelCount() { return labelCount; }
-    inline void incrementLabel() { labelCount++; }
-    std::vector<std::string> label_vector;
-    std::string jump_label;
-    std::string while_cond;
-    std::string while_cond_label;
-    std::map<std::string, int> local_pos;
+    inline int newLabel() { return labelCount++; }
+
+    /*
+      Jump lists.  A branch whose target is not known yet jumps to
+      a label of its own, which is never placed (a hole); a list of
+      such branches is the chain of their holes, named by the first
+      one, with 0 for the empty list.  backpatch() gives every branch
+      on a list its target, and resolve() puts the targets in the
+      code once the function is complete.
+    */
+    int newHole();
+    /* Both lists as one; the branches of L1 come first */
+    int merge(int L1, int L2);
+    /* Remove the first branch from a list, and return the rest */
+    int detach(int list);
+    void backpatch(int list, int label);
+    void resolve(std::vector<instr> &code) const;
+
+    /*
+      Labels and jump lists of the control statements being
+      compiled, innermost last.
+    */
+    std::vector<int> label_vector;
+    /*
+      Code compiled ahead of where it goes: the tests of while
+      and for loops, and the steps of for loops; innermost last.
+    */
+    std::vector< std::vector<instr> > moved;
+    /*
+      Jump lists of the break and continue statements of the
+      enclosing loops (and switches, for break); innermost last.
+    */
+    std::vector<int> breaks;
+    std::vector<int> continues;
+    /*
+      The switch statements being compiled, innermost last:
+      where the switch instruction is in stack_mc, and the
+      labels of its cases and default, so far.
+    */
+    struct switch_info {
+        size_t at;
+        int lineno;
+        int deflabel;
+        std::vector<instr> cases;
+    };
+    std::vector<switch_info> switches;
     int return_flag;
-    std::string if_cond;
-    std::string if_cond_label;
+
+    /*
+      Inlining.  keepBody() saves the finished code of a function
+      small enough for calls to it to be replaced by the code;
+      the saved code is empty otherwise.  Calls inlined here share
+      locals numbered from INLINE_BASE, which relocate() moves to
+      after the function's own locals once they are all known.
+    */
+    void keepBody(const std::vector<instr> &code, const frame_info &frame);
+    inline const std::vector<instr>& getBody() const { return body; }
+    void relocate(std::vector<instr> &code) const;
+    /* Instructions inlined here so far */
+    int inlined;
+
+    /*
+      Turn calls to this function whose result is returned right
+      away into stores of the arguments in the parameters and a
+      jump back to the start.  Returns how many there were.
+    */
+    int removeTailCalls(std::vector<instr> &code);
+
+  private:
+    std::vector<instr> body;
 };
 
 /* ====================================================================== */
 
-parse_data parse_data::THE_DATA;
+/*
+  True for the type codes that have typed loads, stores and returns.
+*/
+static inline bool loadable(char typecode)
+{
+  return ('I' == typecode) || ('C' == typecode) || ('F' == typecode);
+}
 
-void parse_data::Initialize(bool typecheck)
+/*
+  Constant folding with Java int semantics: wrap on overflow.
+  Returns false if the operation must be left for run time.
+*/
+static bool fold_arith(char op, int left, int right, int &result)
 {
-  THE_DATA.globals = 0;
-  THE_DATA.functions = 0;
-  THE_DATA.current_function = 0;
-  THE_DATA.jvm = new stack_machine();
-  THE_DATA.typechecking = typecheck;
+  unsigned l = left, r = right;
+  switch (op) {
+    case '+':   result = (int) (l + r);   return true;
+    case '-':   result = (int) (l - r);   return true;
+    case '*':   result = (int) (l * r);   return true;
+    case '|':   result = left | right;    return true;
+    case '&':   result = left & right;    return true;
+    case '/':   
+    case '%':
+                if (0 == right) return false;
+                if (-1 == right) {
+                  /* avoids INT_MIN / -1, which traps in C */
+                  result = ('/' == op) ? (int) (0u - l) : 0;
+                  return true;
+                }
+                result = ('/' == op) ? (left / right) : (left % right);
+                return true;
+  }
+  return false;
+}
+
+thread_local parse_data* parse_data::THE_DATA;
+
+parse_data::parse_data()
+{
+  typechecking = false;
+  globals = 0;
+  globals_end = 0;
+  functions = 0;
+  functions_end = 0;
+  current_function = 0;
+  jvm = 0;
+  out = 0;
+  for (int k=0; k<NODE_KINDS; k++) {
+    node_count[k] = 0;
+    node_bytes[k] = 0;
+  }
+}
+
+void parse_data::Initialize(bool typecheck, backend* out)
+{
+  THE_DATA->globals = 0;
+  THE_DATA->globals_end = 0;
+  THE_DATA->functions = 0;
+  THE_DATA->functions_end = 0;
+  THE_DATA->function_index.clear();
+  THE_DATA->current_function = 0;
+  THE_DATA->jvm = new stack_machine();
+  THE_DATA->out = out;
+  THE_DATA->typechecking = typecheck;
+  for (int k=0; k<NODE_KINDS; k++) {
+    THE_DATA->node_count[k] = 0;
+    THE_DATA->node_bytes[k] = 0;
+  }
 }
 
 void parse_data::Finalize()
 {
-  THE_DATA.functions = funclist::reverseList(THE_DATA.functions);
+  /*
+    Only the functions and the stack machine own anything
+    outside the arena; the rest goes with the arena.
+  */
+  while (THE_DATA->functions) {
+    funclist* next = THE_DATA->functions->next;
+    delete THE_DATA->functions;
+    THE_DATA->functions = next;
+  }
+  THE_DATA->functions_end = 0;
+  THE_DATA->function_index.clear();
+  THE_DATA->current_function = 0;
+  THE_DATA->globals = 0;
+  THE_DATA->globals_end = 0;
+  THE_DATA->symbols = symtab();
+
+  delete THE_DATA->jvm;
+  THE_DATA->jvm = 0;
+  delete THE_DATA->out;
+  THE_DATA->out = 0;
+
+  THE_DATA->nodes.rewind();
+}
+
+bool parse_data::finishOutput()
+{
+  if (0==THE_DATA->out) return true;
+  bool ok = THE_DATA->out->finish();
+  if (!ok) {
+    diagnostics() << "Error writing output for " << filename() << "\n";
+  }
+  delete THE_DATA->out;
+  THE_DATA->out = 0;
+  return ok;
+}
+
+void parse_data::doneProgram()
+{
+  if (THE_DATA->out) buildClassInit();
+  if (THE_DATA->out && (last_mode() || second_last_mode())) {
+    THE_DATA->out->entry(second_last_mode());
+  }
+}
+
+void parse_data::showMemory(std::ostream &s)
+{
+  static const char* kinds[NODE_KINDS] = {
+    "identlist", "typelist", "stmtnode", "funclist", "stack_code", "text",
+    "initializer"
+  };
+  size_t total = 0;
+  s << "Front-end memory\n";
+  for (int k=0; k<NODE_KINDS; k++) {
+    s << '\t' << kinds[k] << ": " << THE_DATA->node_count[k] << " objects, ";
+    s << THE_DATA->node_bytes[k] << " bytes\n";
+    total += THE_DATA->node_bytes[k];
+  }
+  s << "\ttotal: " << total << " bytes\n";
+}
+
+void parse_data::showCalls(std::ostream &s)
+{
+  s << "Calls\n";
+  s << "\tcalls inlined: " << calls_inlined << "\n";
+  s << "\ttail calls removed: " << tail_calls << "\n";
+  if (tail_calls) s << "\t  in " << tail_call_functions << "\n";
+}
+
+void parse_data::showSwitches(std::ostream &s)
+{
+  s << "Switches\n";
+  s << "\ttableswitch: " << table_switches << "\n";
+  s << "\tlookupswitch: " << lookup_switches << "\n";
+  s << switch_lines;
+}
+
+void parse_data::clearStats()
+{
+  calls_inlined = 0;
+  tail_calls = 0;
+  tail_call_functions.clear();
+  table_switches = 0;
+  lookup_switches = 0;
+  switch_lines.clear();
+}
+
+void* allocNode(size_t bytes, node_kind kind)
+{
+  parse_data::THE_DATA->node_count[kind]++;
+  parse_data::THE_DATA->node_bytes[kind] += bytes;
+  return parse_data::THE_DATA->nodes.alloc(bytes);
+}
+
+char* copyText(const char* text, size_t len)
+{
+  parse_data::THE_DATA->node_count[NODE_TEXT]++;
+  parse_data::THE_DATA->node_bytes[NODE_TEXT] += len + 1;
+  return parse_data::THE_DATA->nodes.copy(text, len);
 }
 
 void parse_data::showGlobals(std::ostream &s)
 {
-  if ( (!TypecheckingOn()) && (0==THE_DATA.globals) ) return;
+  if ( (!TypecheckingOn()) && (0==THE_DATA->globals) ) return;
   s << "Global variables\n";
-  THE_DATA.globals->display(s, TypecheckingOn());
+  THE_DATA->globals->display(s, TypecheckingOn());
   s << "\n";
 }
 
 void parse_data::showFunctions(std::ostream &s)
 {
-  for (funclist* curr = THE_DATA.functions; curr; curr=curr->next) {
+  for (funclist* curr = THE_DATA->functions; curr; curr=curr->next) {
     curr->F->display(s, TypecheckingOn());
   }
 }
 
 void parse_data::declareGlobals(identlist* L)
 {
-  THE_DATA.globals = identlist::Append(
-    THE_DATA.globals,
+  for (identlist* curr = L; curr; curr=curr->next) {
+    curr->is_global = true;
+  }
+  identlist* old_end = THE_DATA->globals_end;
+  THE_DATA->globals = identlist::Append(
+    THE_DATA->globals,
+    THE_DATA->globals_end,
     identlist::reverseList(L), 
-    TypecheckingOn() ? "Global variable" : 0
+    TypecheckingOn() ? "Global variable" : 0,
+    &THE_DATA->symbols
   );
-  for (const identlist* curr = THE_DATA.globals; curr; curr=curr->next) {
-        if (curr->is_array)
-            fprintf(jF, ".field public static %s [%c\n", curr->name, curr->type.typecode);
-        else
-            fprintf(jF, ".field public static %s %c\n", curr->name, curr->type.typecode);
+  /* Only the ones just declared; the others have their fields */
+  for (identlist* curr = old_end ? old_end->next : THE_DATA->globals; curr; curr=curr->next) {
+    /*
+      Initial values must fit the type: an int becomes a float
+      for a float, but a float can't initialize an int or char.
+    */
+    for (int k=0; k<curr->ninit; k++) {
+      instr &I = curr->init[k];
+      if (('F' == curr->type.typecode) && (OP_ICONST == I.op)) {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%d.0", I.a);
+        I = make_instr(OP_FCONST, 0, 'F', atom_table::intern(buf));
+      }
+      if (('F' != curr->type.typecode) && (OP_FCONST == I.op)) {
+        startError(curr->lineno);
+        diagnostics() << "Float value in initializer for " << curr->type << " " << atom_table::name(curr->name) << "\n";
+        curr->ninit = 0;
+      }
+    }
+    if (curr->is_array && (0 == curr->size)) curr->size = curr->ninit;
+    if (curr->is_array && (curr->ninit > curr->size)) {
+      startError(curr->lineno);
+      diagnostics() << "Too many initializers for array " << atom_table::name(curr->name) << "\n";
+      curr->ninit = curr->size;
+    }
+    /* Scalars start with their value; arrays are filled in <clinit> */
+    const instr* value = (!curr->is_array && curr->ninit) ? curr->init : 0;
+    if (THE_DATA->out) THE_DATA->out->field(curr->name, curr->type.typecode, curr->is_array, value);
   }
 }
 
-void parse_data::initGlobal() {
-    for (const identlist* curr = THE_DATA.globals; curr; curr=curr->next) {
-      char* type;
-      if (curr->type.typecode == 'I') {
-          type = (char*)"int";
-      }
-      if (curr->type.typecode == 'C') {
-          type = (char*)"char";
+int parse_data::arraySize(typeinfo size)
+{
+  int n = size.is_const ? size.value : 0;
+  if ( (n <= 0) || ('F' == size.typecode) || size.is_array ) {
+    startError(lineNumber());
+    diagnostics() << "Array size must be a positive integer\n";
+    n = 1;
+  }
+  THE_DATA->jvm->machine_code.clear();
+  return n;
+}
+
+typeinfo parse_data::buildInitValue(typeinfo val, bool negate)
+{
+  instr &I = THE_DATA->jvm->machine_code.back();
+  if ( val.is_array || ((OP_ICONST != I.op) && (OP_FCONST != I.op)) ) {
+    startError(lineNumber());
+    diagnostics() << "Initializer must be a number\n";
+    I = make_instr(OP_ICONST, 0);
+  }
+  if (negate && (OP_ICONST == I.op)) {
+    I.a = (int) (0u - (unsigned) I.a);
+  }
+  if (negate && (OP_FCONST == I.op)) {
+    const char* text = atom_table::name(I.sym);
+    I.sym = ('-' == text[0]) ? atom_table::intern(text+1)
+                             : atom_table::intern(("-" + std::string(text)).c_str());
+  }
+  return val;
+}
+
+identlist* parse_data::buildIdec(atom_id ident, bool array, int size, int values)
+{
+  identlist* L = new identlist(ident, array);
+  L->size = size;
+  std::vector<instr> &mc = THE_DATA->jvm->machine_code;
+  if (values && (mc.size() >= (size_t) values)) {
+    L->init = (instr*) allocNode(values * sizeof(instr), NODE_INITIAL);
+    std::copy(mc.end() - values, mc.end(), L->init);
+    L->ninit = values;
+  }
+  mc.clear();
+  return L;
+}
+
+/*
+  Tables with at least this many nonzero elements are filled from
+  a string; smaller ones with one store per element.  Each string
+  holds at most TABLE_CHUNK bytes, so it is under the 64K limit
+  on a constant even if every byte takes two in modified UTF-8.
+*/
+#define TABLE_MIN     8
+#define TABLE_CHUNK   30000
+
+void parse_data::fillArray(std::vector<instr> &code, const identlist* A, int &labels)
+{
+  char type = A->type.typecode;
+  int n = A->ninit;
+  while ((n > 0) && (OP_ICONST == A->init[n-1].op) && (0 == A->init[n-1].a)) n--;
+  int nonzero = 0;
+  for (int k=0; k<n; k++) {
+    if ((OP_ICONST != A->init[k].op) || A->init[k].a) nonzero++;
+  }
+  if (0 == nonzero) return;
+
+  code.push_back(make_instr(OP_COMMENT, 0, 0, atom_table::intern(
+    ("Filling array " + std::string(atom_table::name(A->name))).c_str())));
+
+  if (('F' == type) || (nonzero < TABLE_MIN)) {
+    for (int k=0; k<n; k++) {
+      const instr &V = A->init[k];
+      if ((OP_ICONST == V.op) && (0 == V.a)) continue;
+      code.push_back(make_instr(OP_GETSTATIC, 0, type, A->name));
+      code.back().flags = FLAG_ARRAY;
+      code.push_back(make_instr(OP_ICONST, k));
+      code.push_back(V);
+      code.push_back(make_instr(OP_ASTORE, 0, type, A->name));
+    }
+    return;
+  }
+
+  /*
+    Each element is stored as 1, 2 or 4 bytes, big endian, less
+    the smallest element, as few bytes as the range needs.  The
+    loop below reads them back with String.charAt, in locals
+    0 (element) and 1 (byte).
+  */
+  int lo = A->init[0].a, hi = A->init[0].a;
+  for (int k=1; k<n; k++) {
+    lo = std::min(lo, A->init[k].a);
+    hi = std::max(hi, A->init[k].a);
+  }
+  unsigned range = (unsigned) hi - (unsigned) lo;
+  int width = (range < 0x100) ? 1 : (range < 0x10000) ? 2 : 4;
+  if (4 == width) lo = 0;
+
+  atom_id charAt = atom_table::intern("charAt");
+  atom_id charAt_desc = atom_table::intern("(I)C");
+  int per_chunk = TABLE_CHUNK / width;
+  for (int base=0; base<n; base+=per_chunk) {
+    int end = std::min(n, base + per_chunk);
+    std::string lit = "\"";
+    for (int k=base; k<end; k++) {
+      unsigned v = (unsigned) A->init[k].a - (unsigned) lo;
+      for (int b=width-1; b>=0; b--) {
+        unsigned char c = (v >> (8*b)) & 0xff;
+        if ((c >= ' ') && (c < 0x7f) && ('"' != c) && ('\\' != c)) {
+          lit += (char) c;
+        } else {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\x%02x", c);
+          lit += buf;
+        }
       }
-      if (curr->type.typecode == 'F') {
-          type = (char*)"float";
+    }
+    lit += '"';
+    atom_id text = atom_table::intern(lit.c_str());
+
+    int top = ++labels;
+    code.push_back(make_instr(OP_ICONST, base));
+    code.push_back(make_instr(OP_STORE, 0, 'I'));
+    code.push_back(make_instr(OP_ICONST, 0));
+    code.push_back(make_instr(OP_STORE, 1, 'I'));
+    code.push_back(make_instr(OP_LABEL, top));
+    code.push_back(make_instr(OP_GETSTATIC, 0, type, A->name));
+    code.back().flags = FLAG_ARRAY;
+    code.push_back(make_instr(OP_LOAD, 0, 'I'));
+    for (int b=0; b<width; b++) {
+      if (b) {
+        code.push_back(make_instr(OP_ICONST, 256));
+        code.push_back(make_instr(OP_IMUL));
       }
-      if (curr->is_array) {
-        fprintf(jF, ".method <clinit> : ()V\n");
-        fprintf(jF, "\t.code stack 1 locals 0\n");
-        fprintf(jF, "\t\t; Building array %s\n", curr->name);
-        std::vector<std::string>::iterator it;
-        for (it = THE_DATA.jvm->machine_code.begin(); it != THE_DATA.jvm->machine_code.end(); ++it) {
-            fprintf(jF, "%s", (*it).c_str());
-        }
-        fprintf(jF, "\t\tnewarray %s\n", type);
-        fprintf(jF, "\t\tputstatic Field array %s [%c\n", curr->name, curr->type.typecode);
-        fprintf(jF, "\t\treturn\n");
-        fprintf(jF, "\t.end code\n");
-        fprintf(jF, ".end method\n\n");
+      code.push_back(make_instr(OP_SCONST, 0, 0, text));
+      code.push_back(make_instr(OP_LOAD, 1, 'I'));
+      if (b) {
+        code.push_back(make_instr(OP_ICONST, b));
+        code.push_back(make_instr(OP_IADD));
       }
-      THE_DATA.jvm->machine_code.clear();
+      code.push_back(make_instr(OP_INVOKEVIRTUAL, 0, 0, charAt));
+      code.back().desc = charAt_desc;
+      if (b) code.push_back(make_instr(OP_IOR));
+    }
+    if (lo) {
+      code.push_back(make_instr(OP_ICONST, lo));
+      code.push_back(make_instr(OP_IADD));
     }
+    code.push_back(make_instr(OP_ASTORE, 0, type, A->name));
+    code.push_back(make_instr(OP_IINC, 0));
+    code.back().b = 1;
+    code.push_back(make_instr(OP_IINC, 1));
+    code.back().b = width;
+    code.push_back(make_instr(OP_LOAD, 0, 'I'));
+    code.push_back(make_instr(OP_ICONST, end));
+    code.push_back(make_instr(OP_IF_ICMPLT, top));
+  }
+}
+
+/*
+  The one class initializer: every global array is allocated,
+  then the ones with initial values are filled in.
+*/
+void parse_data::buildClassInit()
+{
+  std::vector<instr> code;
+  for (const identlist* curr = THE_DATA->globals; curr; curr=curr->next) {
+    if (!curr->is_array) continue;
+    code.push_back(make_instr(OP_COMMENT, 0, 0, atom_table::intern(
+      ("Building array " + std::string(atom_table::name(curr->name))).c_str())));
+    code.push_back(make_instr(OP_ICONST, curr->size));
+    code.push_back(make_instr(OP_NEWARRAY, 0, curr->type.typecode));
+    code.push_back(make_instr(OP_PUTSTATIC, 0, curr->type.typecode, curr->name));
+    code.back().flags = FLAG_ARRAY;
+  }
+  int labels = 0;
+  for (const identlist* curr = THE_DATA->globals; curr; curr=curr->next) {
+    if (curr->is_array && curr->ninit) fillArray(code, curr, labels);
+  }
+  if (code.empty()) return;
+  code.push_back(make_instr(OP_RETURN));
+
+  frame_info frame;
+  compute_frame(code, 0, frame);
+  THE_DATA->out->method("<clinit>", "()V", code, frame);
 }
 
 void parse_data::declareLocals(identlist* L)
 {
-  if (THE_DATA.current_function) {
-    if (! THE_DATA.current_function->addLocals(L)) {
-      THE_DATA.current_function = 0;
+  for (identlist* curr = L; curr; curr=curr->next) {
+    if (0 == curr->ninit) continue;
+    startError(curr->lineno);
+    diagnostics() << "Only global variables can have initializers\n";
+    curr->ninit = 0;
+  }
+  if (THE_DATA->current_function) {
+    if (! THE_DATA->current_function->addLocals(L, &THE_DATA->symbols)) {
+      THE_DATA->current_function = 0;
     } 
   } else {
     identlist::deleteList(L);
   }
 } 
 
-function* parse_data::startFunction(typeinfo T, char* n, identlist* P)
+function* parse_data::startFunction(typeinfo T, atom_id n, identlist* P)
 {
-  THE_DATA.current_function = 0;
+  THE_DATA->current_function = 0;
 
   P = identlist::reverseList(P);
 
@@ -204,14 +658,13 @@ function* parse_data::startFunction(typeinfo T, char* n, identlist* P)
   if (TypecheckingOn()) {
       // Check for existing prototypes here
 
-      F = THE_DATA.find(n);
+      F = THE_DATA->find(n);
       if (F) {
         if ( (F->getType() != T) || (! F->params_match(P)) ) {
           // parameters don't match.
-          startError(yylineno);
-          std::cerr << "Conflicting types for function " << n << "\n";
+          startError(lineNumber());
+          diagnostics() << "Conflicting types for function " << atom_table::name(n) << "\n";
 
-          free(n);
           identlist::deleteList(P);
           return 0;
         }
@@ -223,52 +676,43 @@ function* parse_data::startFunction(typeinfo T, char* n, identlist* P)
           F->replace_params(P);
         }
         
-        return (THE_DATA.current_function = F);
+        return (THE_DATA->current_function = F);
       }
   }
 
 
   F = new function(T, n, P);
+  THE_DATA->registerFunction(F);
 
-  if (F) {
-    funclist* L = new funclist(F);
-    if (THE_DATA.functions) {
-      THE_DATA.functions = THE_DATA.functions->Push(L);
-    } else {
-      THE_DATA.functions = L;
-    }
-  }
-
-  identlist*p = P;
-  while(p) {
-      int m = F->local_pos.size();
-      F->local_pos.insert(std::pair<std::string, int>(p->name, m));
-      p = p->next;
-  }
-  return (THE_DATA.current_function = F);
+  return (THE_DATA->current_function = F);
 }
 
 void parse_data::startFunctionDef()
 {
-  if (THE_DATA.current_function) {
-    if (THE_DATA.current_function->is_prototype()) {
-      typeinfo t = THE_DATA.current_function->getType();
-      identlist* i = THE_DATA.current_function->getParams();
-      identlist* l = THE_DATA.current_function->getLocals();
-      std::string params;
-      while ( i != NULL) {
-        if (i->is_array)
-          params += "[";
-        params += i->type.typecode;
-        i = i->next;
-      }
-      fprintf(jF, ".method public static %s : (%s)%c\n", THE_DATA.current_function->getName(), params.c_str(), t.typecode);
+  /*
+    One scope for the parameters, and one inside it for the locals,
+    so that a local may shadow a parameter.
+    Both are closed in doneFunction().
+  */
+  THE_DATA->symbols.enter();
+  if (THE_DATA->current_function && THE_DATA->current_function->is_prototype()) {
+    int slot = 0;
+    for (identlist* p = THE_DATA->current_function->getParams(); p; p=p->next) {
+      p->slot = slot++;
+      THE_DATA->symbols.insert(p);
+    }
+  }
+  THE_DATA->symbols.enter();
+
+  if (THE_DATA->current_function) {
+    if (THE_DATA->current_function->is_prototype()) {
+      typeinfo t = THE_DATA->current_function->getType();
       if (t.typecode == 'V')
-            THE_DATA.current_function->return_flag = 1;
+            THE_DATA->current_function->return_flag = 1;
       return;
     }
-    THE_DATA.current_function->redefinition();
-    THE_DATA.current_function = 0;
+    THE_DATA->current_function->redefinition();
+    THE_DATA->current_function = 0;
   } else {
 
   }
@@ -276,47 +720,284 @@ void parse_data::startFunctionDef()
 
 void parse_data::doneFunction(function* F, bool proto_only)
 {
+  if (!proto_only) {
+    THE_DATA->symbols.leave();
+    THE_DATA->symbols.leave();
+  }
   if (F) {
     F->set_proto(proto_only);
   }
   if (!proto_only && F) {
-    int count = 0;
-    identlist* i = F->getParams();
-    identlist* l = F->getLocals();
-    while ( i != NULL) {
-      count++;
-      i = i->next;
-    }
-    int l_count = 1;
-    while (l != NULL) {
-      count++;
-      l_count++;
-      l = l->next;
-    }
-    fprintf(jF, "\t.code stack %d locals %d\n", THE_DATA.jvm->getStackDepth(), l_count);
-    if (THE_DATA.current_function->return_flag) {
-        if (THE_DATA.jvm->machine_code.size() > 0) {
-          std::string abc = THE_DATA.jvm->machine_code.back();
-          if (abc.find(":") != std::string::npos) {
-              THE_DATA.jvm->stack_mc.push_back(abc);
-          } 
+    int params = 0;
+    for (identlist* i = F->getParams(); i; i = i->next) {
+      params++;
+    }
+    if (THE_DATA->current_function->return_flag) {
+        THE_DATA->jvm->stack_mc.push_back(make_instr(OP_RETURN));
+        THE_DATA->jvm->stack_mc.back().flags = FLAG_IMPLICIT;
+    }
+    F->resolve(THE_DATA->jvm->stack_mc);
+    F->relocate(THE_DATA->jvm->stack_mc);
+    if (F->removeTailCalls(THE_DATA->jvm->stack_mc)) {
+      if (!tail_call_functions.empty()) tail_call_functions += ", ";
+      tail_call_functions += F->getName();
+    }
+    flowgraph::optimize(THE_DATA->jvm->stack_mc);
+    loopnest::optimize(THE_DATA->jvm->stack_mc, params, F->getName());
+    ssa::optimize(THE_DATA->jvm->stack_mc, params);
+    peephole::optimize(THE_DATA->jvm->stack_mc);
+    slotalloc::allocate(THE_DATA->jvm->stack_mc, params);
+
+    frame_info frame;
+    /*
+      Only the final mode reports problems with the code,
+      since that is the mode that writes methods to run.
+    */
+    if (!compute_frame(THE_DATA->jvm->stack_mc, params, frame) && last_mode()) {
+      int line = lineNumber();
+      for (int i = frame.bad; i >= 0; i--) {
+        if (OP_LINE == THE_DATA->jvm->stack_mc[i].op) {
+          line = THE_DATA->jvm->stack_mc[i].a;
+          break;
         }
-        THE_DATA.jvm->stack_mc.push_back("\t\treturn ; implicit return\n");
+      }
+      startError(line);
+      diagnostics() << "Bad code generated for function " << F->getName();
+      diagnostics() << ": " << frame.problem << "\n";
+    } else {
+      F->keepBody(THE_DATA->jvm->stack_mc, frame);
+    }
+    if (THE_DATA->out) {
+      THE_DATA->out->method(F->getName(), atom_table::name(F->getDescriptor()), 
+                           THE_DATA->jvm->stack_mc, frame);
     }
-    THE_DATA.jvm->show_stack();
-    THE_DATA.jvm->stack_mc.clear();
-    THE_DATA.jvm->machine_code.clear();
+    THE_DATA->jvm->stack_mc.clear();
+    THE_DATA->jvm->machine_code.clear();
   }
-  THE_DATA.current_function = 0;
+  THE_DATA->current_function = 0;
 }
 
-typeinfo parse_data::buildUnary(char op, typeinfo opnd)
+/* ====================================================================== */
+
+/*
+  Conditions.
+
+  A comparison, &&, || or ! is compiled as branches: it needs no
+  value when it controls a statement or another condition.  Where a
+  value is wanted after all, toValue() turns the branches into a
+  push of 1 or 0; and a value is turned into a condition with ifeq.
+*/
+
+void parse_data::placeList(int list)
+{
+  function* F = THE_DATA->current_function;
+  if (0==F || 0==list) return;
+  int L = F->newLabel();
+  THE_DATA->jvm->emit(OP_LABEL, L);
+  F->backpatch(list, L);
+}
+
+void parse_data::toJump(typeinfo &T)
+{
+  if (T.is_jump) return;
+  T.is_jump = true;
+  T.falls = true;
+  T.truelist = 0;
+  T.falselist = 0;
+  function* F = THE_DATA->current_function;
+  if (T.is_const && THE_DATA->jvm->dropConstants(1)) {
+    /* Nothing to test; control just goes the one way */
+    T.falls = (0 != T.value);
+    T.is_const = false;
+  } else if (F) {
+    T.falselist = F->newHole();
+    THE_DATA->jvm->emit(OP_IFEQ, T.falselist);
+  }
+  T.end = THE_DATA->jvm->machine_code.size();
+}
+
+void parse_data::fallThrough(typeinfo &T, bool sense)
+{
+  if (T.falls == sense) return;
+  function* F = THE_DATA->current_function;
+  if (0==F) return;
+  std::vector<instr> &code = THE_DATA->jvm->machine_code;
+
+  /*
+    Falling through means !sense now, so the last branch, if there
+    is one, is taken on sense; it is the first on its list.
+  */
+  int &taken = sense ? T.truelist : T.falselist;
+  int &other = sense ? T.falselist : T.truelist;
+  instr* last = 0;
+  if (taken && (size_t) T.end == code.size() && T.end > 0) {
+    last = &code.back();
+    if (!last->is_branch() || last->a != taken) last = 0;
+  }
+
+  if (last && OP_GOTO == last->op) {
+    taken = F->detach(taken);
+    code.pop_back();
+  } else if (last) {
+    int h = taken;
+    taken = F->detach(h);
+    last->op = negate(last->op);
+    other = F->merge(h, other);
+  } else {
+    int h = F->newHole();
+    THE_DATA->jvm->emit(OP_GOTO, h);
+    other = F->merge(h, other);
+  }
+  T.falls = sense;
+  T.end = code.size();
+}
+
+void parse_data::toValue(typeinfo &T)
+{
+  if (!T.is_jump) return;
+  T.is_jump = false;
+  function* F = THE_DATA->current_function;
+  if (0==F) return;
+
+  /* The lists that reach the value falling through, and the rest */
+  int with = T.falls ? T.truelist : T.falselist;
+  int against = T.falls ? T.falselist : T.truelist;
+
+  std::vector<instr> seq;
+  if (with) {
+    int L = F->newLabel();
+    seq.push_back(make_instr(OP_LABEL, L));
+    F->backpatch(with, L);
+  }
+  seq.push_back(make_instr(OP_ICONST, T.falls ? 1 : 0));
+  if (against) {
+    int L = F->newLabel();
+    int done = F->newLabel();
+    seq.push_back(make_instr(OP_GOTO, done));
+    seq.push_back(make_instr(OP_LABEL, L));
+    F->backpatch(against, L);
+    seq.push_back(make_instr(OP_ICONST, T.falls ? 0 : 1));
+    seq.push_back(make_instr(OP_LABEL, done));
+  }
+  std::vector<instr> &code = THE_DATA->jvm->machine_code;
+  code.insert(code.begin() + T.end, seq.begin(), seq.end());
+}
+
+void parse_data::discard(typeinfo &T)
+{
+  if (!T.is_jump) return;
+  T.is_jump = false;
+  function* F = THE_DATA->current_function;
+  if (F) placeList(F->merge(T.truelist, T.falselist));
+}
+
+typeinfo parse_data::buildCondition(typeinfo cond)
+{
+  function* F = THE_DATA->current_function;
+  if (0==F) return cond;
+  toJump(cond);
+  fallThrough(cond, true);
+  placeList(cond.truelist);
+  F->label_vector.push_back(cond.falselist);
+  THE_DATA->jvm->flush();
+  return cond;
+}
+
+typeinfo parse_data::startLoop(typeinfo cond)
 {
-  if (op == '-') {
-    THE_DATA.jvm->machine_code.push_back("\t\tineg\n");
+  function* F = THE_DATA->current_function;
+  if (0==F) return cond;
+  typeinfo test = cond;
+  if (test.non_empty()) {
+    toJump(test);
+  } else {
+    test.is_jump = true;
+    test.falls = true;
+    test.truelist = 0;
+    test.falselist = 0;
+    test.end = THE_DATA->jvm->machine_code.size();
   }
-  if (op == '!') {
-    THE_DATA.jvm->machine_code.push_back("\t\tifne\n");
+  fallThrough(test, false);
+
+  /*
+    Statements leave nothing behind in machine_code,
+    so it holds just the test.
+  */
+  F->moved.push_back(std::vector<instr>());
+  F->moved.back().swap(THE_DATA->jvm->machine_code);
+  const std::vector<instr> &code = F->moved.back();
+
+  /* If the test is just "goto top", go straight in */
+  int enter = 0;
+  if (1 != code.size() || OP_GOTO != code[0].op) {
+    enter = F->newHole();
+    THE_DATA->jvm->emit(OP_GOTO, enter);
+  }
+  int top = F->newLabel();
+  THE_DATA->jvm->emit(OP_LABEL, top);
+  F->backpatch(test.truelist, top);
+  THE_DATA->jvm->flush();
+
+  F->label_vector.push_back(enter);
+  F->label_vector.push_back(test.falselist);
+  F->breaks.push_back(0);
+  F->continues.push_back(0);
+  return cond;
+}
+
+typeinfo parse_data::buildLoopCondition(typeinfo cond)
+{
+  function* F = THE_DATA->current_function;
+  if (0==F) return cond;
+  int top = F->label_vector.back();
+  F->label_vector.pop_back();
+  toJump(cond);
+  fallThrough(cond, false);
+  F->backpatch(cond.truelist, top);
+  placeList(F->merge(cond.falselist, F->breaks.back()));
+  F->breaks.pop_back();
+
+  /* continue goes to the test, which is all of machine_code */
+  if (F->continues.back()) {
+    int L = F->newLabel();
+    std::vector<instr> &code = THE_DATA->jvm->machine_code;
+    code.insert(code.begin(), make_instr(OP_LABEL, L));
+    F->backpatch(F->continues.back(), L);
+  }
+  F->continues.pop_back();
+  THE_DATA->jvm->flush();
+  return cond;
+}
+
+/* ====================================================================== */
+
+typeinfo parse_data::buildUnary(char op, typeinfo opnd)
+{
+  bool folded = false;
+  int v = 0;
+  if ('!' != op) toValue(opnd);
+  if (opnd.is_const && THE_DATA->jvm->dropConstants(1)) {
+    folded = true;
+    switch (op) {
+      case '-':   v = (int) (0u - (unsigned) opnd.value);   break;
+      case '!':   v = (0 == opnd.value);                    break;
+      case '~':   v = ~opnd.value;                          break;
+    }
+    THE_DATA->jvm->emit(OP_ICONST, v);
+  } else {
+    if (op == '-') {
+      THE_DATA->jvm->emit(OP_INEG);
+    }
+    if (op == '!') {
+      /* No code: the branches just swap meanings */
+      toJump(opnd);
+      std::swap(opnd.truelist, opnd.falselist);
+      opnd.falls = !opnd.falls;
+    }
+    if (op == '~') {
+      THE_DATA->jvm->emit(OP_ICONST, -1);
+      THE_DATA->jvm->emit(OP_IXOR);
+    }
   }
   typeinfo answer;
   answer.set('E', 0);
@@ -338,11 +1019,20 @@ typeinfo parse_data::buildUnary(char op, typeinfo opnd)
       }
 
       if ('E' == answer.typecode) {
-        startError(yylineno);
-        std::cerr << "Operation not supported: " << op << ' ' << opnd << "\n";
+        startError(lineNumber());
+        diagnostics() << "Operation not supported: " << op << ' ' << opnd << "\n";
       }
   }
 
+  answer.is_const = false;
+  if (folded) answer.setConst(v);
+  answer.is_jump = opnd.is_jump;
+  if (answer.is_jump) {
+    answer.falls = opnd.falls;
+    answer.truelist = opnd.truelist;
+    answer.falselist = opnd.falselist;
+    answer.end = opnd.end;
+  }
   return answer;
 }
 
@@ -350,14 +1040,15 @@ typeinfo parse_data::buildCast(typeinfo cast, typeinfo opnd)
 {
   typeinfo answer;
   answer.set('E', 0);
+  toValue(opnd);
 
   if (TypecheckingOn()) {
     
     if (opnd.is_number() && cast.is_number()) {
       answer = cast;
     } else {
-      startError(yylineno);
-      std::cerr << "Cannot cast from type " << opnd << " to type " << cast << "\n";
+      startError(lineNumber());
+      diagnostics() << "Cannot cast from type " << opnd << " to type " << cast << "\n";
     }
 
   }
@@ -369,6 +1060,9 @@ typeinfo parse_data::buildArith(typeinfo left, char op, typeinfo right)
 {
     typeinfo answer;
     answer.set('E', 0);
+    /* right first: its code follows the left operand's */
+    toValue(right);
+    toValue(left);
 
     if (TypecheckingOn()) {
 
@@ -387,40 +1081,54 @@ typeinfo parse_data::buildArith(typeinfo left, char op, typeinfo right)
         }
 
         if ('E' == answer.typecode) {
-            startError(yylineno);
-            std::cerr << "Operation not supported: " << left << ' ' << op << ' ' << right << "\n";
+            startError(lineNumber());
+            diagnostics() << "Operation not supported: " << left << ' ' << op << ' ' << right << "\n";
         }
     }
 
-    if (op == '+') {
-        THE_DATA.jvm->machine_code.push_back("\t\tiadd\n");
-    } 
-    if (op == '-') {
-        THE_DATA.jvm->machine_code.push_back("\t\tisub\n");
-    } 
-    if (op == '/') {
-        THE_DATA.jvm->machine_code.push_back("\t\tidiv\n");
-    } 
-    if (op == '*') {
-        THE_DATA.jvm->machine_code.push_back("\t\timul\n");
-    } 
-    if (op == '%') {
-        THE_DATA.jvm->machine_code.push_back("\t\tirem\n");
-    } 
-    if (op == '|') {
-        THE_DATA.jvm->machine_code.push_back("\t\tior\n");
-    } 
-    if (op == '&') {
-        THE_DATA.jvm->machine_code.push_back("\t\tiand\n");
+    answer.is_const = false;
+    int v;
+    if (left.is_const && right.is_const && 
+        fold_arith(op, left.value, right.value, v) && THE_DATA->jvm->dropConstants(2)) 
+    {
+        THE_DATA->jvm->emit(OP_ICONST, v);
+        answer.setConst(v);
+    } else switch (op) {
+      case '+':   THE_DATA->jvm->emit(OP_IADD);  break;
+      case '-':   THE_DATA->jvm->emit(OP_ISUB);  break;
+      case '/':   THE_DATA->jvm->emit(OP_IDIV);  break;
+      case '*':   THE_DATA->jvm->emit(OP_IMUL);  break;
+      case '%':   THE_DATA->jvm->emit(OP_IREM);  break;
+      case '|':   THE_DATA->jvm->emit(OP_IOR);   break;
+      case '&':   THE_DATA->jvm->emit(OP_IAND);  break;
     }
-    THE_DATA.jvm->pop_stack();
-    THE_DATA.jvm->pop_stack();
-    THE_DATA.jvm->decStackDepth();
-    THE_DATA.jvm->decStackDepth();
+    THE_DATA->jvm->pop_stack();
+    THE_DATA->jvm->pop_stack();
+    /* the result has no name */
+    THE_DATA->jvm->push_stack(0);
 
   return answer;
 }
 
+typeinfo parse_data::startLogic(typeinfo left, const char* op)
+{
+  /*
+    Fall into the right operand when it decides the result:
+    on true for &&, on false for ||.
+  */
+  bool both = (0==strcmp(op, "&&"));
+  toJump(left);
+  fallThrough(left, both);
+  if (both) {
+    placeList(left.truelist);
+    left.truelist = 0;
+  } else {
+    placeList(left.falselist);
+    left.falselist = 0;
+  }
+  return left;
+}
+
 typeinfo parse_data::buildLogic(typeinfo left, const char* op, typeinfo right)
 {
   
@@ -437,141 +1145,78 @@ typeinfo parse_data::buildLogic(typeinfo left, const char* op, typeinfo right)
       }
 
       if ('E' == answer.typecode) {
-        startError(yylineno);
-        std::cerr << "Operation not supported: " << left << ' ' << op << ' ' << right << "\n";
+        startError(lineNumber());
+        diagnostics() << "Operation not supported: " << left << ' ' << op << ' ' << right << "\n";
       }
 
   }
 
-  if(THE_DATA.current_function->while_cond != "") {
-    THE_DATA.current_function->while_cond = "";
-    THE_DATA.current_function->while_cond_label = "";
-  }
+  function* F = THE_DATA->current_function;
 
-  if(THE_DATA.current_function->if_cond != "") {
-    THE_DATA.current_function->if_cond = "";
-    THE_DATA.current_function->if_cond_label = "";
+  /* the result has no name; operands with errors pushed none */
+  for (int i=0; i<2; i++) {
+    if (!THE_DATA->jvm->isStackEmpty()) THE_DATA->jvm->pop_stack();
+  }
+  THE_DATA->jvm->push_stack(0);
+
+  if (0==strcmp(op, "&&") || 0==strcmp(op, "||")) {
+    /*
+      The left operand was dealt with by startLogic(); its branches
+      that settle the result join the right operand's.
+    */
+    toJump(right);
+    answer.is_jump = true;
+    answer.falls = right.falls;
+    answer.end = right.end;
+    answer.truelist = right.truelist;
+    answer.falselist = right.falselist;
+    if (F) {
+      if ('&' == op[0]) answer.falselist = F->merge(right.falselist, left.falselist);
+      else              answer.truelist = F->merge(right.truelist, left.truelist);
+    }
+    return answer;
   }
 
-  if (strcmp(op, "==") == 0) {
-    int c = THE_DATA.current_function->getlabelCount();
-    if (loop) {
-        if (THE_DATA.current_function->jump_label == "") {
-            std::string cmd = "\t\tif_icmpne L" + std::to_string(c) + "\n";
-            THE_DATA.current_function->jump_label = "L" + std::to_string(c);
-            THE_DATA.jvm->machine_code.push_back(cmd);
-            THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
-            THE_DATA.current_function->incrementLabel();
-        } else {
-            std::string cmd = "\t\tif_icmpne " + THE_DATA.current_function->jump_label + "\n";
-            THE_DATA.jvm->machine_code.push_back(cmd);
-        }
-    } else {
-        std::string cmd = "\t\tif_icmpne L" + std::to_string(c) + "\n";
-        THE_DATA.jvm->machine_code.push_back(cmd);
-        THE_DATA.current_function->incrementLabel();
-        THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
-    }
-  }
-  if (strcmp(op, "!=") == 0) {
-    int c = THE_DATA.current_function->getlabelCount();
-    if (loop) {
-        if (THE_DATA.current_function->jump_label == "") {
-            std::string cmd = "\t\tif_icmpeq L" + std::to_string(c) + "\n";
-            THE_DATA.current_function->jump_label = "L" + std::to_string(c);
-            THE_DATA.jvm->machine_code.push_back(cmd);
-            THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
-            THE_DATA.current_function->incrementLabel();
-        } else {
-            std::string cmd = "\t\tif_icmpeq " + THE_DATA.current_function->jump_label + "\n";
-            THE_DATA.jvm->machine_code.push_back(cmd);
-        }
-    } else {
-        std::string cmd = "\t\tif_icmpeq L" + std::to_string(c) + "\n";
-        THE_DATA.jvm->machine_code.push_back(cmd);
-        THE_DATA.current_function->incrementLabel();
-        THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
-    }
-  }
-  if (strcmp(op, ">") == 0) {
-    int c = THE_DATA.current_function->getlabelCount();
-    if (loop) {
-        if (THE_DATA.current_function->jump_label == "") {
-            std::string cmd = "\t\tif_icmple L" + std::to_string(c) + "\n";
-            THE_DATA.current_function->jump_label = "L" + std::to_string(c);
-            THE_DATA.jvm->machine_code.push_back(cmd);
-            THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
-            THE_DATA.current_function->incrementLabel();
-        } else {
-            std::string cmd = "\t\tif_icmple " + THE_DATA.current_function->jump_label + "\n";
-            THE_DATA.jvm->machine_code.push_back(cmd);
-        }
-    } else {
-        std::string cmd = "\t\tif_icmple L" + std::to_string(c) + "\n";
-        THE_DATA.jvm->machine_code.push_back(cmd);
-        THE_DATA.current_function->incrementLabel();
-        THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
-    }
-  }
-  if (strcmp(op, ">=") == 0) {
-    int c = THE_DATA.current_function->getlabelCount();
-    if (loop) {
-        if (THE_DATA.current_function->jump_label == "") {
-            std::string cmd = "\t\tif_icmplt L" + std::to_string(c) + "\n";
-            THE_DATA.current_function->jump_label = "L" + std::to_string(c);
-            THE_DATA.jvm->machine_code.push_back(cmd);
-            THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
-            THE_DATA.current_function->incrementLabel();
-        } else {
-            std::string cmd = "\t\tif_icmplt " + THE_DATA.current_function->jump_label + "\n";
-            THE_DATA.jvm->machine_code.push_back(cmd);
-        }
-    } else {
-        std::string cmd = "\t\tif_icmplt L" + std::to_string(c) + "\n";
-        THE_DATA.jvm->machine_code.push_back(cmd);
-        THE_DATA.current_function->incrementLabel();
-        THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
-    }
-  }
-  if (strcmp(op, "<") == 0) {
-    int c = THE_DATA.current_function->getlabelCount();
-    if (loop) {
-        if (THE_DATA.current_function->jump_label == "") {
-            std::string cmd = "\t\tif_icmpge L" + std::to_string(c) + "\n";
-            THE_DATA.current_function->jump_label = "L" + std::to_string(c);
-            THE_DATA.jvm->machine_code.push_back(cmd);
-            THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
-            THE_DATA.current_function->incrementLabel();
-        } else {
-            std::string cmd = "\t\tif_icmpge " + THE_DATA.current_function->jump_label + "\n";
-            THE_DATA.jvm->machine_code.push_back(cmd);
-        }
-    } else {
-        std::string cmd = "\t\tif_icmpge L" + std::to_string(c) + "\n";
-        THE_DATA.jvm->machine_code.push_back(cmd);
-        THE_DATA.current_function->incrementLabel();
-        THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
-    }
-  }
-  if (strcmp(op, "<=") == 0) {
-    int c = THE_DATA.current_function->getlabelCount();
-    if (loop) {
-        if (THE_DATA.current_function->jump_label == "") {
-            std::string cmd = "\t\tif_icmpgt L" + std::to_string(c) + "\n";
-            THE_DATA.current_function->jump_label = "L" + std::to_string(c);
-            THE_DATA.jvm->machine_code.push_back(cmd);
-            THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
-            THE_DATA.current_function->incrementLabel();
-        } else {
-            std::string cmd = "\t\tif_icmpgt " + THE_DATA.current_function->jump_label + "\n";
-            THE_DATA.jvm->machine_code.push_back(cmd);
-        }
-    } else {
-        std::string cmd = "\t\tif_icmpgt L" + std::to_string(c) + "\n";
-        THE_DATA.jvm->machine_code.push_back(cmd);
-        THE_DATA.current_function->incrementLabel();
-        THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
+  toValue(right);
+  toValue(left);
+
+  /*
+    Branch when false, so on the negated comparison,
+    and fall through when true.
+  */
+  int branch = OP_NOP;
+  if (strcmp(op, "==") == 0)  branch = OP_IF_ICMPNE;
+  if (strcmp(op, "!=") == 0)  branch = OP_IF_ICMPEQ;
+  if (strcmp(op, ">") == 0)   branch = OP_IF_ICMPLE;
+  if (strcmp(op, ">=") == 0)  branch = OP_IF_ICMPLT;
+  if (strcmp(op, "<") == 0)   branch = OP_IF_ICMPGE;
+  if (strcmp(op, "<=") == 0)  branch = OP_IF_ICMPGT;
+
+  if (OP_NOP != branch) {
+    answer.is_jump = true;
+    answer.falls = true;
+    answer.truelist = 0;
+    answer.falselist = 0;
+    /*
+      Comparing two constants: no code, just the answer.
+    */
+    if (left.is_const && right.is_const && THE_DATA->jvm->dropConstants(2)) {
+      bool taken = false;
+      int l = left.value, r = right.value;
+      switch (branch) {
+        case OP_IF_ICMPNE:  taken = (l != r);   break;
+        case OP_IF_ICMPEQ:  taken = (l == r);   break;
+        case OP_IF_ICMPLE:  taken = (l <= r);   break;
+        case OP_IF_ICMPLT:  taken = (l < r);    break;
+        case OP_IF_ICMPGE:  taken = (l >= r);   break;
+        case OP_IF_ICMPGT:  taken = (l > r);    break;
+      }
+      answer.falls = !taken;
+    } else if (F) {
+      answer.falselist = F->newHole();
+      THE_DATA->jvm->emit(branch, answer.falselist);
     }
+    answer.end = THE_DATA->jvm->machine_code.size();
   }
 
   return answer;
@@ -588,20 +1233,36 @@ typeinfo parse_data::buildIncDec(bool pre, char op, typeinfo opnd)
       }
 
       if ('E' == answer.typecode) {
-        startError(yylineno);
-        std::cerr << "Cannot ";
-        if ('+' == op) std::cerr << "in"; else std::cerr << "de";
-        std::cerr << "crement lvalue of type " << opnd << "\n";
+        startError(lineNumber());
+        diagnostics() << "Cannot ";
+        if ('+' == op) diagnostics() << "in"; else diagnostics() << "de";
+        diagnostics() << "crement lvalue of type " << opnd << "\n";
       }
   }
-  if (op == '-') {
-    THE_DATA.jvm->machine_code.push_back("\t\tiinc 0 -1\n");
-    THE_DATA.jvm->machine_code.push_back("\t\tiload_0\n");
-  }
-  if (op == '+') {
-    THE_DATA.jvm->machine_code.push_back("\t\tiinc 0 +1\n");
-    THE_DATA.jvm->machine_code.push_back("\t\tiload_0\n");
+  /* The lvalue's name is on the stack (see buildLval) */
+  if (THE_DATA->jvm->isStackEmpty()) return answer;
+  atom_id id = THE_DATA->jvm->peek_stack();
+  const identlist* var = THE_DATA->symbols.find(id);
+  int delta = ('+' == op) ? +1 : -1;
+  if (var && !var->type.is_array && ('F' != var->type.typecode)) {
+    char tc = var->type.typecode;
+    if (var->is_global) {
+      THE_DATA->jvm->emit(OP_GETSTATIC, 0, tc, id);
+      if (!pre) THE_DATA->jvm->emit(OP_DUP);
+      THE_DATA->jvm->emit(OP_ICONST, delta);
+      THE_DATA->jvm->emit(OP_IADD);
+      if (pre) THE_DATA->jvm->emit(OP_DUP);
+      THE_DATA->jvm->emit(OP_PUTSTATIC, 0, tc, id);
+    } else {
+      if (!pre) THE_DATA->jvm->emit(OP_LOAD, var->slot, tc, id);
+      THE_DATA->jvm->emit(OP_IINC, var->slot, 0, id).b = delta;
+      if (pre) THE_DATA->jvm->emit(OP_LOAD, var->slot, tc, id);
+    }
   }
+  /* Not a pending store, and the result has no name */
+  THE_DATA->jvm->store_val = 0;
+  THE_DATA->jvm->pop_stack();
+  THE_DATA->jvm->push_stack(0);
     
   return answer;
 }
@@ -612,6 +1273,8 @@ typeinfo parse_data::buildUpdate(typeinfo lhs, const char* op, typeinfo rhs)
     typeinfo answer;
     answer.set('E', 0);
 
+    toValue(rhs);
+
     if (TypecheckingOn()) {
         if (lhs.typecode == rhs.typecode) {
             answer = lhs;
@@ -621,119 +1284,52 @@ typeinfo parse_data::buildUpdate(typeinfo lhs, const char* op, typeinfo rhs)
         }
 
         if ('E' == answer.typecode) {
-            startError(yylineno);
-            std::cerr << "Operation not supported: " << lhs << ' ' << op << ' ' << rhs << "\n";
+            startError(lineNumber());
+            diagnostics() << "Operation not supported: " << lhs << ' ' << op << ' ' << rhs << "\n";
         }
     }
-    if (last_mode || second_last_mode) {
+    if (last_mode() || second_last_mode()) {
         const identlist* var;
-        int is_global = 0;
-        //THE_DATA.jvm->pop_stack();
-        std::string local_data = THE_DATA.jvm->peek_stack();
-        for (funclist* curr = THE_DATA.functions; curr; curr = curr->next) {
-          if (curr->F->name_matches(local_data.c_str())) {
-            THE_DATA.jvm->pop_stack();
-            local_data = THE_DATA.jvm->peek_stack();
-          }
-        }
-        if(THE_DATA.current_function)
-            var = THE_DATA.current_function->find(local_data.c_str());
-
-        if (!var && THE_DATA.globals) {
-            is_global = 1;
-            var = THE_DATA.globals->find(local_data.c_str());
+        //THE_DATA->jvm->pop_stack();
+        atom_id local_data = THE_DATA->jvm->peek_stack();
+        if (THE_DATA->find(local_data)) {
+            THE_DATA->jvm->pop_stack();
+            local_data = THE_DATA->jvm->peek_stack();
         }
+        var = THE_DATA->symbols.find(local_data);
         if (!var) {
-            THE_DATA.jvm->pop_stack();
-            THE_DATA.jvm->decStackDepth();
-            local_data = THE_DATA.jvm->peek_stack();
-            if(THE_DATA.current_function)
-                var = THE_DATA.current_function->find(local_data.c_str());
-
-            if (!var && THE_DATA.globals) {
-                is_global = 1;
-                var = THE_DATA.globals->find(local_data.c_str());
-            }
+            THE_DATA->jvm->pop_stack();
+            local_data = THE_DATA->jvm->peek_stack();
+            var = THE_DATA->symbols.find(local_data);
         }
-        if (var) {
-            //int dep = THE_DATA.jvm->getStackDepth();
-            int dep = THE_DATA.current_function->local_pos[local_data];
-            if (THE_DATA.jvm->store_val != "") {
-              local_data = THE_DATA.jvm->store_val;
-              dep = THE_DATA.current_function->local_pos[local_data];
-              THE_DATA.jvm->store_val = "";
-            }
-            
-            
-            std::string cmd = "\t\t";
-            
-            if (var && lhs.typecode == 'I') {
-                
-                // if (is_global) {
-                //     if (var->type.is_array) {
-                //         cmd = "\t\tputstatic Field " + classname  + std::string(" ") + local_data +  std::string(" [") + var->type.typecode + "\n";
-                //     } else {
-                //         cmd = "\t\tputstatic Field " + classname  + std::string(" ") + local_data +  std::string(" ") + var->type.typecode + "\n";
-                //     }
-                // } else {
-                    
-                if (var->type.is_array) {
-                    cmd += "iastore ; store to " + local_data + "\n";
-                } else {
-                    THE_DATA.jvm->machine_code.push_back("\t\tdup\n");
-                    cmd += "istore_" + std::to_string(dep) + " ; store to " + local_data + "\n";
-                }
-                //}
-                //THE_DATA.current_function->local_pos[local_data] = dep;
-            }
-            if (var && lhs.typecode == 'C') {
-                // if (is_global) {
-                //     if (var->type.is_array) {
-                //         cmd = "\t\tputstatic Field " + classname  + std::string(" ") + local_data +  std::string(" [") + var->type.typecode + "\n";
-                //     } else {
-                //         cmd = "\t\tputstatic Field " + classname  + std::string(" ") + local_data +  std::string(" ") + var->type.typecode + "\n";
-                //     }
-                // } else {
-                
-                if (var->type.is_array) {
-                    cmd += "castore ; store to " + local_data + "\n";
-                } else {
-                        THE_DATA.jvm->machine_code.push_back("\t\tdup\n");
-                    cmd += "cstore_" + std::to_string(dep) + " ; store to " + local_data + "\n";
-                }
-                //}
-                //THE_DATA.jvm->local_pos[local_data] = dep;
-            }
-            if (var && lhs.typecode == 'F') {
-                /*if (is_global) {
-                    if (var->type.is_array) {
-                        cmd = "\t\tputstatic Field " + classname  + std::string(" ") + local_data +  std::string(" [") + var->type.typecode + "\n";
-                    } else {
-                        cmd = "\t\tputstatic Field " + classname  + std::string(" ") + local_data +  std::string(" ") + var->type.typecode + "\n";
-                    }
-                } else {*/
-            
-                if (var->type.is_array) {
-                    cmd += "fastore ; store to " + local_data + "\n";
+        const identlist* dest = var;
+        bool element = var && var->type.is_array;
+        if (THE_DATA->jvm->store_val) {
+          local_data = THE_DATA->jvm->store_val;
+          dest = THE_DATA->symbols.find(local_data);
+          element = THE_DATA->jvm->store_element;
+          THE_DATA->jvm->store_val = 0;
+        }
+        if (dest) {
+            if (loadable(lhs.typecode)) {
+                if (element) {
+                    THE_DATA->jvm->emit(OP_ASTORE, 0, lhs.typecode, local_data);
+                } else if (dest->is_global) {
+                    THE_DATA->jvm->emit(OP_DUP);
+                    THE_DATA->jvm->emit(OP_PUTSTATIC, 0, lhs.typecode, local_data);
                 } else {
-                        THE_DATA.jvm->machine_code.push_back("\t\tdup\n");
-                    cmd += "fstore_" + std::to_string(dep) + " ; store to " + local_data + "\n";
+                    THE_DATA->jvm->emit(OP_DUP);
+                    THE_DATA->jvm->emit(OP_STORE, dest->slot, lhs.typecode, local_data);
                 }
-                //}
-                //THE_DATA.jvm->local_pos[local_data] = dep;
             }
-            THE_DATA.jvm->machine_code.push_back(cmd);
-            THE_DATA.jvm->push_stack(local_data);
-            THE_DATA.jvm->push_stack(local_data);
-            THE_DATA.jvm->incStackDepth();
-            THE_DATA.jvm->incStackDepth();
-
-            if (var && !var->type.is_array) {
-                THE_DATA.jvm->machine_code.push_back("\t\tpop\n");
+            THE_DATA->jvm->push_stack(local_data);
+            THE_DATA->jvm->push_stack(local_data);
+
+            if (!element) {
+                THE_DATA->jvm->emit(OP_POP);
             }
             if (strcmp(rhs.bytecode, (char*)"none") != 0) {
-                THE_DATA.jvm->pop_stack();
-                THE_DATA.jvm->decStackDepth();
+                THE_DATA->jvm->pop_stack();
             }
         }
     }
@@ -744,225 +1340,118 @@ typeinfo parse_data::buildTernary(typeinfo cond, typeinfo then, typeinfo els)
 {
   typeinfo answer;
   answer.set('E', 0);
+  toValue(els);
+  toValue(then);
+  toValue(cond);
 
   if (TypecheckingOn()) {
       if (then.typecode == els.typecode) {
         answer = then;
+        answer.is_const = false;
       }
       if (! cond.is_number() ) {
         answer.set('E', 0);
       }
 
       if ('E' == answer.typecode) {
-        startError(yylineno);
-        std::cerr << "Operation not supported: " << cond;
-        std::cerr << " ? " << then << " : " << els << "\n";
+        startError(lineNumber());
+        diagnostics() << "Operation not supported: " << cond;
+        diagnostics() << " ? " << then << " : " << els << "\n";
       }
   }
 
   return answer;
 }
 
-typeinfo parse_data::buildLval(char* ident, bool flag)
+typeinfo parse_data::buildLval(atom_id id, bool flag)
 {
+  const char* ident = atom_table::name(id);
   typeinfo error;
   error.set('E', 0);
 
   if (TypecheckingOn()) {
-    const identlist* var = 0;
-    int is_global = 0;
-    var = THE_DATA.current_function->find(ident);
-
-    if (!var && THE_DATA.globals) {
-      is_global = 1;
-      var = THE_DATA.globals->find(ident);
-    }
+    const identlist* var = THE_DATA->symbols.find(id);
     if (!var) {
-      startError(yylineno);
-      std::cerr << "Undeclared identifier: " << ident << "\n";
-      free(ident);
+      startError(lineNumber());
+      diagnostics() << "Undeclared identifier: " << ident << "\n";
       return error;
     }
     if (var && flag) {
-        THE_DATA.jvm->push_stack(ident);
-        THE_DATA.jvm->incStackDepth();
-        int dep = THE_DATA.jvm->getStackDepth();
-        int pos = THE_DATA.current_function->local_pos[std::string(ident)];
-        if (var->type.typecode == 'I') {
-          std::string cmd = "\t\t";
-          if (is_global) {
-              if (var->type.is_array) {
-                  cmd = "\t\tgetstatic Field " + classname  + std::string(" ") + std::string(ident) +  std::string(" [") + var->type.typecode + "\n";
-              } else {
-                  cmd = "\t\tgetstatic Field " + classname  + std::string(" ") + std::string(ident) +  std::string(" ") + var->type.typecode + "\n";
-              }
+        THE_DATA->jvm->push_stack(id);
+        if (loadable(var->type.typecode)) {
+          if (var->is_global) {
+              instr &I = THE_DATA->jvm->emit(OP_GETSTATIC, 0, var->type.typecode, id);
+              if (var->type.is_array) I.flags = FLAG_ARRAY;
+          } else if (var->type.is_array) {
+              THE_DATA->jvm->emit(OP_ALOAD, 0, var->type.typecode, id);
           } else {
-                if (var->type.is_array) {
-                    cmd += "iaload ; load from " + std::string(ident) + "\n";
-                } else {
-                    cmd += "iload_" + std::to_string(pos) + " ; load from " + std::string(ident) + "\n";
-                }
-          }
-            
-          THE_DATA.jvm->machine_code.push_back(cmd);
-        }
-        if (var->type.typecode == 'C') {
-          std::string cmd = "\t\t";
-          if (is_global) {
-              if (var->type.is_array) {
-                  cmd = "\t\tgetstatic Field " + classname  + std::string(" ") + std::string(ident) +  std::string(" [") + var->type.typecode + "\n";
-              } else {
-                  cmd = "\t\tgetstatic Field " + classname  + std::string(" ") + std::string(ident) +  std::string(" ") + var->type.typecode + "\n";
-              }
-          } else {
-                if (var->type.is_array) {
-                    cmd += "caload ; load from " + std::string(ident) + "\n";
-                } else {
-                    cmd += "cload_" + std::to_string(pos) + " ; load from " + std::string(ident) + "\n";
-                }
-          }
-          THE_DATA.jvm->machine_code.push_back(cmd);
-        }
-        if (var->type.typecode == 'F') {
-          std::string cmd = "\t\t";
-          if (var->type.is_array) {
-            cmd += "fa";
-          } else {
-            cmd += "f";
-          }
-          if (is_global) {
-              if (var->type.is_array) {
-                  cmd = "\t\tgetstatic Field " + classname  + std::string(" ") + std::string(ident) +  std::string(" [") + var->type.typecode + "\n";
-              } else {
-                  cmd = "\t\tgetstatic Field " + classname  + std::string(" ") + std::string(ident) +  std::string(" ") + var->type.typecode + "\n";
-              }
-          } else {
-                if (var->type.is_array) {
-                    cmd += "faload ; load from " + std::string(ident) + "\n";
-                } else {
-                    cmd += "fload_" + std::to_string(pos) + " ; load from " + std::string(ident) + "\n";
-                }
+              THE_DATA->jvm->emit(OP_LOAD, var->slot, var->type.typecode, id);
           }
-          THE_DATA.jvm->machine_code.push_back(cmd);
         }
     }
 
     if (var && !flag) {
-        THE_DATA.jvm->store_val = ident;
-        THE_DATA.jvm->push_stack(ident);
-    }
-
-    if (var && loop) {
-      std::string c = std::to_string(THE_DATA.current_function->getlabelCount());
-      std::string label = "\t\tifeq L" + c + "\n";
-      THE_DATA.current_function->while_cond = label;
-      THE_DATA.current_function->while_cond_label = "L" + c;
+        THE_DATA->jvm->store_val = id;
+        THE_DATA->jvm->store_element = false;
+        THE_DATA->jvm->push_stack(id);
     }
 
-    if (var && if_flag) {
-      std::string c = std::to_string(THE_DATA.current_function->getlabelCount());
-      std::string label = "\t\tifeq L" + c + "\n";
-      THE_DATA.current_function->if_cond = label;
-      THE_DATA.current_function->if_cond_label = "L" + c;
-    }
-
-    free(ident);
     return var->type;
   }
 
   return error;
 }
 
-void parse_data::if_cond_exp() {
-  if (THE_DATA.current_function && last_mode) {
-    if (THE_DATA.current_function->if_cond != "") {
-      THE_DATA.current_function->incrementLabel();
-      THE_DATA.current_function->label_vector.push_back(THE_DATA.current_function->if_cond_label);
-      THE_DATA.jvm->machine_code.push_back(THE_DATA.current_function->if_cond);
-    }
+void parse_data::buildArrayRef(atom_id id)
+{
+  if (!TypecheckingOn()) return;
+  if (!last_mode() && !second_last_mode()) return;
+  const identlist* var = THE_DATA->symbols.find(id);
+  if (var && var->is_global && var->type.is_array && loadable(var->type.typecode)) {
+    instr &I = THE_DATA->jvm->emit(OP_GETSTATIC, 0, var->type.typecode, id);
+    I.flags = FLAG_ARRAY;
   }
 }
 
-void parse_data::loop_exp_marker() {
-    if (THE_DATA.current_function && last_mode) {
-      if(THE_DATA.current_function->while_cond != "") {
-        THE_DATA.current_function->incrementLabel();
-        THE_DATA.current_function->label_vector.push_back(THE_DATA.current_function->while_cond_label);
-        //THE_DATA.jvm->machine_code.push_back("\t\tiload_0\n");
-        THE_DATA.jvm->machine_code.push_back(THE_DATA.current_function->while_cond);
-      }
-    }
-    /*if (last_mode && THE_DATA.current_function) {
-      std::string c = std::to_string(THE_DATA.current_function->getlabelCount());
-      std::string label = "\t\tifeq L" + c + "\n";
-      THE_DATA.current_function->while_cond = label;
-      THE_DATA.current_function->while_cond_label = "L" + c;
-      THE_DATA.current_function->incrementLabel();
-      THE_DATA.current_function->label_vector.push_back("L" + c);
-      THE_DATA.jvm->machine_code.push_back("\t\tiload_0\n");
-      THE_DATA.jvm->machine_code.push_back(label);
-    }*/
-
-    //const identlist* var = THE_DATA.current_function->find(ident);
-    //return var->type;
-}
-
-typeinfo parse_data::buildLvalBracket(char* ident, typeinfo index, bool flag)
+typeinfo parse_data::buildLvalBracket(atom_id id, typeinfo index, bool flag)
 {
+  const char* ident = atom_table::name(id);
   typeinfo error;
   error.set('E', 0);
+  toValue(index);
 
   if (TypecheckingOn()) {
-    const identlist* var = 0;
-    if (!var && THE_DATA.globals) {
-      var = THE_DATA.globals->find(ident);
-    }
+    const identlist* var = THE_DATA->symbols.find(id);
     if (!var) {
-      startError(yylineno);
-      std::cerr << "Undeclared identifier: " << ident << "\n";
-      free(ident);
+      startError(lineNumber());
+      diagnostics() << "Undeclared identifier: " << ident << "\n";
       return error;
     }
 
     if (!var->type.is_array) {
-      startError(yylineno);
-      std::cerr << "Identifier " << ident << " is not an array\n";
-      free(ident);
+      startError(lineNumber());
+      diagnostics() << "Identifier " << ident << " is not an array\n";
       return error;
     }
 
     if ( (index.typecode != 'I') || (index.is_array) ) {
-      startError(yylineno);
-      std::cerr << "Array index should be an integer (was: " << index << ")\n";
-      free(ident);
+      startError(lineNumber());
+      diagnostics() << "Array index should be an integer (was: " << index << ")\n";
       return error;
     }
     
-    if (last_mode || second_last_mode) {
+    if (last_mode() || second_last_mode()) {
         if (var && flag) {
-            THE_DATA.jvm->push_stack(ident);
-            THE_DATA.jvm->incStackDepth();
-            int dep = THE_DATA.jvm->getStackDepth();
-            int pos = THE_DATA.jvm->local_pos[std::string(ident)];
-            if (var->type.typecode == 'I') {
-            std::string cmd = "\t\tiaload ; load from " + std::string(ident) + "\n";
-            THE_DATA.jvm->machine_code.push_back(cmd);
-            }
-            if (var->type.typecode == 'C') {
-            std::string cmd = "\t\tcaload ; load from " + std::string(ident) + "\n";
-            THE_DATA.jvm->machine_code.push_back(cmd);
-            }
-            if (var->type.typecode == 'F') {
-            std::string cmd = "\t\tfaload ; load from " + std::string(ident) + "\n";
-            THE_DATA.jvm->machine_code.push_back(cmd);
-            }
+            THE_DATA->jvm->push_stack(id);
+            THE_DATA->jvm->emit(OP_ALOAD, 0, var->type.typecode, id);
         }
         if (var && !flag) {
-            THE_DATA.jvm->push_stack(ident);
+            THE_DATA->jvm->store_val = id;
+            THE_DATA->jvm->store_element = true;
+            THE_DATA->jvm->push_stack(id);
         }
     }
       
-    free(ident);
 
     typeinfo answer = var->type;
     answer.is_array = false;
@@ -972,11 +1461,59 @@ typeinfo parse_data::buildLvalBracket(char* ident, typeinfo index, bool flag)
   return error;
 }
 
-typeinfo parse_data::buildFcall(char* ident, typelist* params)
+/*
+  Code for a call to F, whose arguments are on the stack, that
+  runs F's saved body in place: the arguments are stored in the
+  locals that stand for the parameters, the labels and locals of
+  the body are renumbered for the caller, and a return leaves its
+  value on the stack and goes to the end.
+*/
+void parse_data::inlineCall(function* F)
 {
+  function* C = THE_DATA->current_function;
+  const std::vector<instr> &body = F->getBody();
+  stack_machine* jvm = THE_DATA->jvm;
+
+  std::vector<const identlist*> formals;
+  for (const identlist* p = F->getParams(); p; p=p->next) formals.push_back(p);
+  for (size_t k=formals.size(); k-- > 0; ) {
+    jvm->emit(OP_STORE, INLINE_BASE + k, formals[k]->type.typecode, formals[k]->name);
+  }
+
+  std::vector<int> label;
+  int end = C->newLabel();
+  bool jumps = false;
+  for (size_t i=0; i<body.size(); i++) {
+    instr I = body[i];
+    if ((OP_RETURN == I.op) || (OP_VRETURN == I.op)) {
+      if (i+1 == body.size()) break;
+      I = make_instr(OP_GOTO, end);
+      jumps = true;
+    } else if (I.is_label() || I.has_target()) {
+      if ((size_t) I.a >= label.size()) label.resize(I.a+1, 0);
+      if (!label[I.a]) label[I.a] = C->newLabel();
+      I.a = label[I.a];
+    } else if ((OP_LOAD == I.op) || (OP_STORE == I.op) || (OP_IINC == I.op)) {
+      I.a += INLINE_BASE;
+    }
+    jvm->machine_code.push_back(I);
+  }
+  if (jumps) jvm->emit(OP_LABEL, end);
+  C->inlined += body.size();
+  calls_inlined++;
+}
+
+typeinfo parse_data::buildFcall(atom_id id, typelist* params)
+{
+  const char* ident = atom_table::name(id);
   typeinfo answer;
   answer.set('E', 0);
 
+  /* Still last argument first, so each one's code is after the next */
+  for (typelist* curr = params; curr; curr=curr->next) {
+    toValue(curr->type);
+  }
+
   if (TypecheckingOn()) {
 
     // Reverse params
@@ -991,54 +1528,47 @@ typeinfo parse_data::buildFcall(char* ident, typelist* params)
 
     // Now, make sure there's a function
     function* F = 0;
-    F = THE_DATA.find(ident);
+    F = THE_DATA->find(id);
 
     if (F) {
-      if (F->call_matches(params)) {
+      if (F->call_matches(function::signature(params))) {
         // Good function call
         answer = F->getType();
 
-        typelist* i = params;
-        std::string params_type;
-        while ( i != NULL) {
-          if (i->type.is_array)
-            params_type += "[";
-          params_type += i->type.typecode;
-          i = i->next;
-        }
-        if (last_mode || second_last_mode) {
-            THE_DATA.jvm->push_stack(ident);
-            if (std::string(ident) == "putchar" || std::string(ident) == "getchar") {
-                std::string data = "\t\tinvokestatic Method libc " + std::string(ident) + " (" + params_type +")" + F->getType().typecode + "\n";
-                THE_DATA.jvm->incStackDepth();
-                THE_DATA.jvm->machine_code.push_back(data);
-                if (std::string(ident) == "putchar")
-                    THE_DATA.jvm->machine_code.push_back("\t\tpop\n");
-                THE_DATA.jvm->decStackDepth();
+        if (last_mode() || second_last_mode()) {
+            THE_DATA->jvm->push_stack(id);
+            function* C = THE_DATA->current_function;
+            const std::vector<instr> &body = F->getBody();
+            if (C && (C != F) && !body.empty()
+                && (C->inlined + body.size() <= INLINE_BUDGET)) {
+              inlineCall(F);
             } else {
-                std::string data = "\t\tinvokestatic Method " + classname + " " + std::string(ident) + " (" + params_type +")" + F->getType().typecode + "\n";
-                THE_DATA.jvm->incStackDepth();
-                THE_DATA.jvm->machine_code.push_back(data);
+              instr &call = THE_DATA->jvm->emit(OP_INVOKESTATIC, 0, 0, id);
+              call.desc = F->getDescriptor();
+              if (0==strcmp(ident, "putchar") || 0==strcmp(ident, "getchar")) {
+                  call.flags = FLAG_LIBC;
+                  if (0==strcmp(ident, "putchar"))
+                      THE_DATA->jvm->emit(OP_POP);
+              }
             }
         }
 
       } else {
-        startError(yylineno);
-        std::cerr << "Parameter mismatch in function call\n\t";
-        std::cerr << ident << "(";
+        startError(lineNumber());
+        diagnostics() << "Parameter mismatch in function call\n\t";
+        diagnostics() << ident << "(";
         for (const typelist* curr = params; curr; curr=curr->next) {
-          if (curr != params) std::cerr << ", ";
-          std::cerr << curr->type;
+          if (curr != params) diagnostics() << ", ";
+          diagnostics() << curr->type;
         }
-        std::cerr << ")\n";
+        diagnostics() << ")\n";
       }
     } else {
-      startError(yylineno);
-      std::cerr << "Function " << ident << " has not been declared.\n";
+      startError(lineNumber());
+      diagnostics() << "Function " << ident << " has not been declared.\n";
     }
   }
 
-  free(ident);
   while (params) {
     typelist* next = params->next;
     delete params;
@@ -1048,9 +1578,9 @@ typeinfo parse_data::buildFcall(char* ident, typelist* params)
   return answer; 
 }
 
-void parse_data::checkCondition(bool can_be_empty, const char* stmt, typeinfo cond, int lineno, const char* flag)
+void parse_data::checkCondition(bool can_be_empty, const char* stmt, typeinfo cond, int lineno, const char*)
 {   
-    THE_DATA.jvm->stack_mc.push_back("\t\t;; " + std::string(filename) + std::string(" ") + std::to_string(yylineno) + " expression\n");
+    THE_DATA->jvm->stack_mc.push_back(make_instr(OP_LINE, lineNumber(), 0, atom_table::intern("expression")));
 
     if (!TypecheckingOn()) return;
     if (cond.is_number()) return;
@@ -1059,7 +1589,7 @@ void parse_data::checkCondition(bool can_be_empty, const char* stmt, typeinfo co
     }
 
     startError(lineno);
-    std::cerr << "Condition of " << stmt << " has invalid type: " << cond << "\n";
+    diagnostics() << "Condition of " << stmt << " has invalid type: " << cond << "\n";
 }
 
 void parse_data::checkEmptyReturn() 
@@ -1067,155 +1597,292 @@ void parse_data::checkEmptyReturn()
     typeinfo T;
     T.set('V', 0);
     checkReturn(T);
-    THE_DATA.jvm->stack_mc.push_back("\t\treturn\n");
+    THE_DATA->jvm->stack_mc.push_back(make_instr(OP_RETURN));
 }
 
 void parse_data::checkReturn(typeinfo type)
 {
+  toValue(type);
 
   if (!TypecheckingOn()) return;
 
-  if (THE_DATA.current_function) {
-    typeinfo Ft = THE_DATA.current_function->getType();
-    if (last_mode || second_last_mode) {
-        THE_DATA.jvm->stack_mc.push_back("\t\t;; " + std::string(filename) + std::string(" ") + std::to_string(yylineno) + " return\n");
+  if (THE_DATA->current_function) {
+    typeinfo Ft = THE_DATA->current_function->getType();
+    if (last_mode() || second_last_mode()) {
+        THE_DATA->jvm->stack_mc.push_back(make_instr(OP_LINE, lineNumber(), 0, atom_table::intern("return")));
         
-        const identlist* var;
-        int is_global = 0;
-        std::string local_data = THE_DATA.jvm->peek_stack();
-        if(THE_DATA.current_function)
-            var = THE_DATA.current_function->find(local_data.c_str());
-
-        if (!var && THE_DATA.globals) {
-            is_global = 1;
-            var = THE_DATA.globals->find(local_data.c_str());
-        }
+        atom_id local_data = THE_DATA->jvm->peek_stack();
+        const identlist* var = THE_DATA->symbols.find(local_data);
 
         if (var && var->is_array) {
-            if (is_global)
-                THE_DATA.jvm->stack_mc.push_back("\t\tgetstatic Field array " + local_data + " [" + var->type.typecode + "\n");
+            if (var->is_global) {
+                THE_DATA->jvm->stack_mc.push_back(make_instr(OP_GETSTATIC, 0, var->type.typecode, local_data));
+                THE_DATA->jvm->stack_mc.back().flags = FLAG_ARRAY;
+            }
         }
         
-        THE_DATA.jvm->stack_mc.insert(THE_DATA.jvm->stack_mc.end(), THE_DATA.jvm->machine_code.begin(), THE_DATA.jvm->machine_code.end());
-        if (type.typecode == 'I') {
-        THE_DATA.jvm->stack_mc.push_back("\t\tireturn\n");
-        }
-        if (type.typecode == 'F') {
-        THE_DATA.jvm->stack_mc.push_back("\t\tfreturn\n");
-        }
-        if (type.typecode == 'C') {
-        THE_DATA.jvm->stack_mc.push_back("\t\tcreturn\n");
+        THE_DATA->jvm->stack_mc.insert(THE_DATA->jvm->stack_mc.end(), THE_DATA->jvm->machine_code.begin(), THE_DATA->jvm->machine_code.end());
+        if (loadable(type.typecode)) {
+          THE_DATA->jvm->stack_mc.push_back(make_instr(OP_VRETURN, 0, type.typecode));
         }
         
-        THE_DATA.jvm->machine_code.clear();
+        THE_DATA->jvm->machine_code.clear();
     }
     if (type != Ft) {
-      startError(yylineno);
-      std::cerr << "Returning " << type << " in a function of type " << Ft << "\n";
+      startError(lineNumber());
+      diagnostics() << "Returning " << type << " in a function of type " << Ft << "\n";
     }
   }
 }
 
 void parse_data::push_label() {
-    if (last_mode) {
-        int c = THE_DATA.current_function->getlabelCount();
-        std::string label = "\tL" + std::to_string(c) + ":\n";
-        THE_DATA.jvm->machine_code.push_back(label);
-        THE_DATA.current_function->incrementLabel();
-        THE_DATA.current_function->label_vector.push_back("L"+std::to_string(c));
+    function* F = THE_DATA->current_function;
+    if (F) {
+        int top = F->newLabel();
+        THE_DATA->jvm->emit(OP_LABEL, top);
+        F->label_vector.push_back(top);
+        F->breaks.push_back(0);
+        F->continues.push_back(0);
+        THE_DATA->jvm->flush();
     }
 }
 
 void parse_data::loop_end_label() {
-    if (THE_DATA.current_function->label_vector.size() > 0 && last_mode) {
-        std::string label = THE_DATA.current_function->label_vector.back();
-        THE_DATA.current_function->label_vector.pop_back();
-        std::string cmd = "\t" + label + ":\n";
-
-        std::string label1 = THE_DATA.current_function->label_vector.back();
-        THE_DATA.current_function->label_vector.pop_back();
-        std::string gotocmd = "\t\tgoto " + label1 + "\n";
-
-        THE_DATA.jvm->machine_code.push_back(gotocmd);
-        THE_DATA.jvm->machine_code.push_back(cmd);
+    function* F = THE_DATA->current_function;
+    if (F) {
+        int exit = F->label_vector.back();
+        F->label_vector.pop_back();
+        int enter = F->label_vector.back();
+        F->label_vector.pop_back();
+
+        placeList(F->merge(enter, F->continues.back()));
+        F->continues.pop_back();
+        std::vector<instr> &test = F->moved.back();
+        THE_DATA->jvm->machine_code.insert(THE_DATA->jvm->machine_code.end(), test.begin(), test.end());
+        F->moved.pop_back();
+        placeList(F->merge(exit, F->breaks.back()));
+        F->breaks.pop_back();
+        THE_DATA->jvm->flush();
     }
-    
 }
 
 void parse_data::ifmarker() {
-    int c = THE_DATA.current_function->getlabelCount();
-    std::string label1 = "\t\tgoto L" + std::to_string(c) + "\n";
-    if (THE_DATA.current_function->label_vector.size() > 0 && last_mode) {
-        std::string label = THE_DATA.current_function->label_vector.back();
-        THE_DATA.current_function->label_vector.pop_back();
-        std::string cmd = "\t" + label + ":\n";
-        THE_DATA.current_function->label_vector.push_back("L" + std::to_string(c));
-        THE_DATA.jvm->machine_code.push_back(label1);
-        THE_DATA.jvm->machine_code.push_back(cmd);
-        THE_DATA.current_function->incrementLabel();
+    function* F = THE_DATA->current_function;
+    if (F) {
+        int skip = F->label_vector.back();
+        int done = F->newHole();
+        F->label_vector.back() = done;
+        THE_DATA->jvm->emit(OP_GOTO, done);
+        placeList(skip);
+        THE_DATA->jvm->flush();
     }
 }
 
 void parse_data::ifnomarker() {
-    if (THE_DATA.current_function->label_vector.size() > 0 && last_mode)  {
-        std::string label = THE_DATA.current_function->label_vector.back();
-        THE_DATA.current_function->label_vector.pop_back();
-        std::string cmd = "\t" + label + ":\n";
-        THE_DATA.jvm->machine_code.push_back(cmd);
+    function* F = THE_DATA->current_function;
+    if (F) {
+        placeList(F->label_vector.back());
+        F->label_vector.pop_back();
+        THE_DATA->jvm->flush();
     }
 }
 
-void parse_data::addExprStmt(typeinfo type)
-{   
-    
-    if (THE_DATA.current_function) {
-        THE_DATA.current_function->addStatement(yylineno, type);
+void parse_data::forInit(typeinfo init) {
+    if (init.non_empty()) {
+        discard(init);
+        statementCode(THE_DATA->jvm->stack_mc);
     }
-    if (last_mode || second_last_mode) {
-    
-        THE_DATA.jvm->stack_mc.push_back("\t\t;; " + std::string(filename) + std::string(" ") + std::to_string(yylineno) + " expression\n");
-        const identlist* var;
-        int is_global = 0;
-        std::string local_data = THE_DATA.jvm->peek_stack();
-        
-        if(THE_DATA.current_function)
-            var = THE_DATA.current_function->find(local_data.c_str());
+}
 
-        if (!var && THE_DATA.globals) {
-            is_global = 1;
-            var = THE_DATA.globals->find(local_data.c_str());
+void parse_data::forStep(typeinfo step) {
+    function* F = THE_DATA->current_function;
+    if (F) {
+        /* Compiled here, but it goes at the end of the body */
+        F->moved.push_back(std::vector<instr>());
+        if (step.non_empty()) {
+            discard(step);
+            statementCode(F->moved.back());
         }
+    }
+}
 
-        if (var && var->is_array) {
-            if (is_global)
-                THE_DATA.jvm->stack_mc.push_back("\t\tgetstatic Field array " + local_data + " [" + var->type.typecode + "\n");
+void parse_data::forEnd() {
+    function* F = THE_DATA->current_function;
+    if (F) {
+        /* continue goes to the step */
+        placeList(F->continues.back());
+        F->continues.back() = 0;
+        std::vector<instr> &step = F->moved.back();
+        THE_DATA->jvm->machine_code.insert(THE_DATA->jvm->machine_code.end(), step.begin(), step.end());
+        F->moved.pop_back();
+        loop_end_label();
+    }
+}
+
+void parse_data::buildBreak() {
+    function* F = THE_DATA->current_function;
+    if (0==F) return;
+    if (F->breaks.empty()) {
+        if (TypecheckingOn()) {
+            startError(lineNumber());
+            diagnostics() << "break statement not within a loop or switch\n";
         }
-        THE_DATA.jvm->stack_mc.insert(THE_DATA.jvm->stack_mc.end(), THE_DATA.jvm->machine_code.begin(), THE_DATA.jvm->machine_code.end());
-        THE_DATA.jvm->machine_code.clear();
-        THE_DATA.jvm->decStackDepth();
-        THE_DATA.jvm->pop_stack();
+        return;
     }
+    int h = F->newHole();
+    THE_DATA->jvm->emit(OP_GOTO, h);
+    F->breaks.back() = F->merge(F->breaks.back(), h);
+    THE_DATA->jvm->flush();
+}
+
+void parse_data::buildContinue() {
+    function* F = THE_DATA->current_function;
+    if (0==F) return;
+    if (F->continues.empty()) {
+        if (TypecheckingOn()) {
+            startError(lineNumber());
+            diagnostics() << "continue statement not within a loop\n";
+        }
+        return;
+    }
+    int h = F->newHole();
+    THE_DATA->jvm->emit(OP_GOTO, h);
+    F->continues.back() = F->merge(F->continues.back(), h);
+    THE_DATA->jvm->flush();
+}
+
+void parse_data::startSwitch(typeinfo expr, int lineno) {
+    if (TypecheckingOn() && (expr.is_array || (('I' != expr.typecode) && ('C' != expr.typecode)))) {
+        startError(lineno);
+        diagnostics() << "Switch expression has invalid type: " << expr << "\n";
+    }
+    function* F = THE_DATA->current_function;
+    if (0==F) return;
+    toValue(expr);
+    THE_DATA->jvm->stack_mc.push_back(make_instr(OP_LINE, lineno, 0, atom_table::intern("expression")));
+    THE_DATA->jvm->emit(OP_SWITCH);
+    THE_DATA->jvm->flush();
+
+    function::switch_info S;
+    S.at = THE_DATA->jvm->stack_mc.size() - 1;
+    S.lineno = lineno;
+    S.deflabel = 0;
+    F->switches.push_back(S);
+    F->breaks.push_back(0);
+}
+
+void parse_data::caseLabel(typeinfo value) {
+    THE_DATA->jvm->machine_code.clear();
+    function* F = THE_DATA->current_function;
+    if (0==F || F->switches.empty() || !TypecheckingOn()) return;
+    if (!value.is_const || value.is_array || ('F' == value.typecode)) {
+        startError(lineNumber());
+        diagnostics() << "Case label must be an integer constant\n";
+        return;
+    }
+    function::switch_info &S = F->switches.back();
+    for (size_t k=0; k<S.cases.size(); k++) {
+        if (S.cases[k].b != value.value) continue;
+        startError(lineNumber());
+        diagnostics() << "Duplicate case value " << value.value << " in switch\n";
+        return;
+    }
+    int L = F->newLabel();
+    THE_DATA->jvm->emit(OP_LABEL, L);
+    THE_DATA->jvm->flush();
+    S.cases.push_back(make_instr(OP_CASE, L, 0, 0));
+    S.cases.back().b = value.value;
+}
+
+void parse_data::defaultLabel() {
+    function* F = THE_DATA->current_function;
+    if (0==F || F->switches.empty() || !TypecheckingOn()) return;
+    function::switch_info &S = F->switches.back();
+    if (S.deflabel) {
+        startError(lineNumber());
+        diagnostics() << "Multiple default labels in switch\n";
+        return;
+    }
+    S.deflabel = F->newLabel();
+    THE_DATA->jvm->emit(OP_LABEL, S.deflabel);
+    THE_DATA->jvm->flush();
 }
 
-function* parse_data::find(const char* name) const
+static bool case_less(const instr &x, const instr &y)
 {
-  for (funclist* curr = functions; curr; curr = curr->next) {
-    if (curr->F->name_matches(name)) return curr->F;
-  }
-  return 0;
+  return x.b < y.b;
+}
+
+void parse_data::endSwitch() {
+    function* F = THE_DATA->current_function;
+    if (0==F) return;
+    function::switch_info &S = F->switches.back();
+
+    /* Without a default, a value with no case goes past the switch */
+    int end = F->newLabel();
+    THE_DATA->jvm->emit(OP_LABEL, end);
+    F->backpatch(F->breaks.back(), end);
+    F->breaks.pop_back();
+    THE_DATA->jvm->flush();
+
+    std::sort(S.cases.begin(), S.cases.end(), case_less);
+    std::vector<instr> &code = THE_DATA->jvm->stack_mc;
+    code[S.at].a = S.deflabel ? S.deflabel : end;
+    code[S.at].b = S.cases.size();
+    code.insert(code.begin() + S.at + 1, S.cases.begin(), S.cases.end());
+
+    /* The assembler makes the same choice */
+    bool table = dense_switch(S.cases.empty() ? 0 : &S.cases[0], S.cases.size());
+    if (table) table_switches++;
+    else       lookup_switches++;
+    char line[128];
+    snprintf(line, sizeof(line), "\t  %s line %d: %s, %d cases\n",
+             F->getName(), S.lineno, table ? "tableswitch" : "lookupswitch",
+             (int) S.cases.size());
+    switch_lines += line;
+    F->switches.pop_back();
+}
+
+void parse_data::statementCode(std::vector<instr> &into)
+{
+    size_t start = into.size();
+    into.insert(into.end(), THE_DATA->jvm->machine_code.begin(), THE_DATA->jvm->machine_code.end());
+    THE_DATA->jvm->machine_code.clear();
+    THE_DATA->jvm->pop_stack();
+
+    /* The value of the expression, if it left one, is not wanted */
+    std::vector<instr> stmt(into.begin() + start, into.end());
+    for (int h = stack_height(stmt); h > 0; h--) {
+        into.push_back(make_instr(OP_POP));
+    }
 }
 
-void parse_data::show_machine_code() {
-  FILE* file;
-  std::string f = std::string(filename);
-  const char * ft = f.replace(f.find(".c"), sizeof(".c") - 1, ".j").c_str();
-  if ((file = fopen(ft, "r")) != NULL) {//checking whether the file is open
-    char c;
-    while ((c = getc(file)) != EOF) {
-        printf("%c", c);
+void parse_data::addExprStmt(typeinfo type)
+{   
+    
+    if (THE_DATA->current_function) {
+        THE_DATA->current_function->addStatement(lineNumber(), type);
     }
-    fclose(file);
+    if (last_mode() || second_last_mode()) {
+    
+        THE_DATA->jvm->stack_mc.push_back(make_instr(OP_LINE, lineNumber(), 0, atom_table::intern("expression")));
+        discard(type);
+        statementCode(THE_DATA->jvm->stack_mc);
+    }
+}
+
+void parse_data::registerFunction(function* F)
+{
+  funclist* L = new funclist(F);
+  if (functions_end) functions_end->next = L;
+  else               functions = L;
+  functions_end = L;
+
+  atom_id n = F->getAtom();
+  if (n >= function_index.size()) {
+    function_index.resize(n + 1 + n/2, 0);
   }
+  function_index[n] = F;
 }
 
 /* ====================================================================== */
@@ -1231,43 +1898,46 @@ parse_data::funclist::~funclist()
   delete F;
 }
 
-parse_data::funclist* parse_data::funclist::Push(funclist* item)
-{
-  if (0==item) return this;
-
-  funclist* tail = item;
-  while (tail->next) tail=tail->next;
-  tail->next = this;
-
-  return item;
-}
-
-parse_data::funclist* parse_data::funclist::reverseList(funclist *L)
+/*
+  Value of a character literal such as 'a' or '\n'.
+*/
+static int char_value(const char* lit)
 {
-  funclist* newlist = 0;
-
-  while (L) {
-    funclist* curr = L;
-    L = L->next;
-
-    curr->next = newlist;
-    newlist = curr;
+  if ('\\' != lit[1]) return (unsigned char) lit[1];
+  switch (lit[2]) {
+    case 'n':   return '\n';
+    case 't':   return '\t';
+    case 'r':   return '\r';
+    case '0':   return 0;
+    case 'a':   return '\a';
+    case 'b':   return '\b';
+    case 'f':   return '\f';
+    case 'v':   return '\v';
   }
-
-  return newlist;
+  return (unsigned char) lit[2];
 }
 
 void parse_data::load_stack(char* literal, bool flag) {
-    THE_DATA.jvm->push_stack(std::string(literal));
-    THE_DATA.jvm->incStackDepth();
-    if (std::atoi(literal) < 6) {
-        THE_DATA.jvm->machine_code.push_back("\t\ticonst_" + std::string(literal) + "\n");
+    atom_id text = atom_table::intern(literal);
+    THE_DATA->jvm->push_stack(text);
+    if (flag) {
+        THE_DATA->jvm->emit(OP_SCONST, 0, 0, text);
+    } else if ('\'' == literal[0]) {
+        THE_DATA->jvm->emit(OP_ICONST, char_value(literal));
+    } else if (strpbrk(literal, ".eE")) {
+        THE_DATA->jvm->emit(OP_FCONST, 0, 'F', text);
     } else {
-        THE_DATA.jvm->machine_code.push_back("\t\tbipush " + std::string(literal) + "\n");
+        /* Java int literal semantics: wrap modulo 2^32 */
+        THE_DATA->jvm->emit(OP_ICONST, (int) strtoul(literal, 0, 10));
     }
 }
 
 typeinfo parse_data::buildLiteral(typeinfo val, bool flag) {
+    load_stack(val.bytecode, flag);
+    const instr &last = THE_DATA->jvm->machine_code.back();
+    if (OP_ICONST == last.op) {
+        val.setConst(last.a);
+    }
     return val;
 }
 
@@ -1289,27 +1959,36 @@ std::ostream& operator<<(std::ostream& s, typeinfo T)
 /* ====================================================================== */
 
 
-identlist::identlist(typeinfo T, char* _name, bool array)
+identlist::identlist(typeinfo T, atom_id _name, bool array)
 {
   type.set(T.typecode, array);
   name = _name;
-  lineno = yylineno;
+  lineno = lineNumber();
   is_array = array;
+  is_global = false;
+  slot = -1;
+  size = 0;
+  init = 0;
+  ninit = 0;
   next = 0;
 }
 
-identlist::identlist(char* _name, bool array)
+identlist::identlist(atom_id _name, bool array)
 {
   type.set('E');
   name = _name;
-  lineno = yylineno;
+  lineno = lineNumber();
   is_array = array;
+  is_global = false;
+  slot = -1;
+  size = 0;
+  init = 0;
+  ninit = 0;
   next = 0;
 }
 
 identlist::~identlist()
 {
-  free(name);
 }
 
 identlist* identlist::Push(identlist* item)
@@ -1330,7 +2009,7 @@ void identlist::display(std::ostream& out, bool showtypes) const
     if (showtypes) {
       out << '\t' << curr->type << " ";
     }
-    out << curr->name;
+    out << atom_table::name(curr->name);
     if (showtypes) {
       out << "\n";
     } else {
@@ -1341,14 +2020,6 @@ void identlist::display(std::ostream& out, bool showtypes) const
   if (!showtypes) out << "\n";
 }
 
-const identlist* identlist::find(const char* name) const
-{
-  for (const identlist* curr = this; curr; curr = curr->next) {
-    if (0==strcmp(name, curr->name)) return curr;
-  }
-  return 0;
-}
-
 identlist* identlist::reverseList(identlist* L)
 {
   identlist* newlist = 0;
@@ -1368,15 +2039,15 @@ identlist* identlist::setTypes(typeinfo T, identlist* L)
 {
   if (parse_data::TypecheckingOn() && 'V' == T.typecode) {
     L = reverseList(L);
-    startError(yylineno);
-    std::cerr << "Cannot declare void variable";
-    if (L->next) std::cerr << "s";
-    std::cerr << ": ";
+    startError(lineNumber());
+    diagnostics() << "Cannot declare void variable";
+    if (L->next) diagnostics() << "s";
+    diagnostics() << ": ";
     for (identlist* curr = L; curr; curr=curr->next) {
-      if (curr != L) std::cerr << ", ";
-      std::cerr << curr->name;
+      if (curr != L) diagnostics() << ", ";
+      diagnostics() << atom_table::name(curr->name);
     }
-    std::cerr << "\n";
+    diagnostics() << "\n";
     deleteList(L);
     return 0;
   }
@@ -1395,32 +2066,22 @@ void identlist::deleteList(identlist* L)
   }
 }
 
-identlist* identlist::Append(identlist* M, identlist* items, const char* wh)
+identlist* identlist::Append(identlist* M, identlist* &Mend, identlist* items, 
+                             const char* wh, symtab* scope)
 {
-  /*
-    Again, not the fastest,
-    but it gets the job done.
-  */
-  identlist* Mend = M;
-  if (Mend) {
-    while (Mend->next) Mend = Mend->next;
-  }
-  
   while (items) {
     identlist* nextitem = items->next;
     items->next = 0;
     bool duplicate = false;
 
     if (wh) {
-      // Check M for duplicates
-      for (identlist* curr = M; curr; curr = curr->next) {
-        if (strcmp(curr->name, items->name)) continue;
-
-        std::cerr << "Error near " << filename << " line " << items->lineno;
-        std::cerr << ":\n\t" << wh << " " << items->name << " already declared.";
-        std::cerr << "\n\t(Original is near " << filename << " line " << curr->lineno << ")\n";
+      // Check the scope for duplicates
+      const identlist* curr = scope->findLocal(items->name);
+      if (curr) {
+        diagnostics() << "Error near " << filename() << " line " << items->lineno;
+        diagnostics() << ":\n\t" << wh << " " << atom_table::name(items->name) << " already declared.";
+        diagnostics() << "\n\t(Original is near " << filename() << " line " << curr->lineno << ")\n";
         duplicate = true;
-        break;
       }
     } 
 
@@ -1432,6 +2093,7 @@ identlist* identlist::Append(identlist* M, identlist* items, const char* wh)
       if (Mend) Mend->next = items;
       else      M = items;
       Mend = items;
+      scope->insert(items);
     }
 
     // Advance
@@ -1443,29 +2105,39 @@ identlist* identlist::Append(identlist* M, identlist* items, const char* wh)
 
 /* ====================================================================== */
 
-function::function(typeinfo T, char* n, identlist* F)
+function::function(typeinfo T, atom_id n, identlist* F)
 {
   type = T;
   name = n;
+
+  /* Parameters only need a scope of their own for the duplicate check */
+  symtab params;
+  params.enter();
+  identlist* formals_end = 0;
   formals = identlist::Append(
-    0, F, parse_data::TypecheckingOn() ? "Parameter" : 0
+    0, formals_end, F, parse_data::TypecheckingOn() ? "Parameter" : 0, &params
   );
 
+  param_sig = signature(formals);
+  std::string desc = atom_table::name(param_sig);
+  desc += T.typecode;
+  descriptor = atom_table::intern(desc.c_str(), desc.length());
+
   prototype_only = true;
   locals = 0;
+  locals_end = 0;
 
   stmtList = 0;
   stmtEnd = 0;
 
-  lineno = yylineno;
+  lineno = lineNumber();
   labelCount = 1;
-  jump_label = "";
   return_flag = 0;
+  inlined = 0;
 }
 
 function::~function()
 {
-  free(name);
   while (formals) {
     identlist* N = formals->next;
     delete formals;
@@ -1481,9 +2153,9 @@ function::~function()
 
 void function::redefinition() const
 {
-  startError(yylineno);
-  std::cerr << "Function " << name << " redefined.\n\t(Original is near ";
-  std::cerr << filename << " line " << lineno << ".)\n";
+  startError(lineNumber());
+  diagnostics() << "Function " << atom_table::name(name) << " redefined.\n\t(Original is near ";
+  diagnostics() << filename() << " line " << lineno << ".)\n";
 }
 
 void function::set_proto(bool po)
@@ -1493,62 +2165,57 @@ void function::set_proto(bool po)
   }
 }
 
-bool function::params_match(const identlist* other) const
+atom_id function::signature(const identlist* L)
 {
-  const identlist* fcurr = formals;
-
-  while (fcurr && other) {
-    if (fcurr->type != other->type) {
-      return false;
-    }
-    fcurr = fcurr->next;
-    other = other->next;
+  std::string sig = "(";
+  for (; L; L=L->next) {
+    if (L->type.is_array) sig += '[';
+    sig += L->type.typecode;
   }
+  sig += ')';
+  return atom_table::intern(sig.c_str(), sig.length());
+}
 
-  if (fcurr) return false;
-  if (other) return false;
-
-  return true;
+atom_id function::signature(const typelist* L)
+{
+  std::string sig = "(";
+  for (; L; L=L->next) {
+    if (L->type.is_array) sig += '[';
+    sig += L->type.typecode;
+  }
+  sig += ')';
+  return atom_table::intern(sig.c_str(), sig.length());
 }
 
 void function::replace_params(identlist* newformals)
 {
   identlist::deleteList(formals);
   formals = newformals;
+  /* Same types, so the signatures still hold */
 }
 
-bool function::call_matches(const typelist* actual) const
+bool function::addLocals(identlist* L, symtab* scope)
 {
-  const identlist* fcurr = formals;
+  assert(prototype_only);
 
-  while (fcurr && actual) {
-    if (fcurr->type != actual->type) {
-      return false;
-    }
-    fcurr = fcurr->next;
-    actual = actual->next;
+  // Locals are numbered after the parameters
+  identlist* old_end = locals_end;
+  int slot = 0;
+  if (old_end) {
+    slot = old_end->slot + 1;
+  } else {
+    for (const identlist* p = formals; p; p=p->next) slot++;
   }
 
-  if (fcurr) return false;
-  if (actual) return false;
-
-  return true;
-}
-
-bool function::addLocals(identlist* L)
-{
-  assert(prototype_only);
-
   locals = identlist::Append(
     locals,
+    locals_end,
     identlist::reverseList(L), 
-    parse_data::TypecheckingOn() ? "Local variable" : 0
+    parse_data::TypecheckingOn() ? "Local variable" : 0,
+    scope
   );
-  identlist*p = locals;
-  while(p) {
-      int m = local_pos.size();
-      local_pos.insert(std::pair<std::string, int>(p->name, m));
-      p = p->next;
+  for (identlist* p = old_end ? old_end->next : locals; p; p=p->next) {
+    p->slot = slot++;
   }
   return true;
 }
@@ -1577,13 +2244,160 @@ bool function::addStatement(int lineno, typeinfo type)
   return true;
 }
 
+int function::newHole()
+{
+  int h = newLabel();
+  if ((size_t) labelCount > hole_next.size()) {
+    hole_next.resize(2*labelCount, 0);
+    hole_target.resize(2*labelCount, 0);
+  }
+  return h;
+}
+
+int function::merge(int L1, int L2)
+{
+  if (0==L1) return L2;
+  if (0==L2) return L1;
+  int last = L1;
+  while (hole_next[last]) last = hole_next[last];
+  hole_next[last] = L2;
+  return L1;
+}
+
+int function::detach(int list)
+{
+  int rest = hole_next[list];
+  hole_next[list] = 0;
+  return rest;
+}
+
+void function::backpatch(int list, int label)
+{
+  while (list) {
+    hole_target[list] = label;
+    list = hole_next[list];
+  }
+}
+
+void function::resolve(std::vector<instr> &code) const
+{
+  for (size_t i=0; i<code.size(); i++) {
+    if (!code[i].has_target()) continue;
+    int &target = code[i].a;
+    while ((size_t) target < hole_target.size() && hole_target[target]) {
+      target = hole_target[target];
+    }
+  }
+}
+
+void function::keepBody(const std::vector<instr> &code, const frame_info &frame)
+{
+  body.clear();
+  if ((frame.bad >= 0) || (frame.max_stack > INLINE_STACK)) return;
+  for (const identlist* p = formals; p; p=p->next) {
+    if (p->is_array) return;
+  }
+  std::vector<instr> keep;
+  for (size_t i=0; i<code.size(); i++) {
+    const instr &I = code[i];
+    if ((OP_LINE == I.op) || (OP_COMMENT == I.op)) continue;
+    /* Recursive: a call would be left inside its own code */
+    if ((OP_INVOKESTATIC == I.op) && (I.sym == name)) return;
+    keep.push_back(I);
+  }
+  if (keep.size() > INLINE_SIZE) return;
+  body.swap(keep);
+}
+
+void function::relocate(std::vector<instr> &code) const
+{
+  int own = 0;
+  if (locals_end) {
+    own = locals_end->slot + 1;
+  } else {
+    for (const identlist* p = formals; p; p=p->next) own++;
+  }
+  for (size_t i=0; i<code.size(); i++) {
+    instr &I = code[i];
+    if ((OP_LOAD != I.op) && (OP_STORE != I.op) && (OP_IINC != I.op)) continue;
+    if (I.a >= INLINE_BASE) I.a += own - INLINE_BASE;
+  }
+}
+
+/*
+  True if the code from index i on returns straight away,
+  perhaps after gotos.
+*/
+static bool returns_at(const std::vector<instr> &code, size_t i,
+  const std::vector<int> &where)
+{
+  for (size_t steps=0; steps<code.size() && i<code.size(); steps++) {
+    const instr &I = code[i];
+    switch (I.op) {
+      case OP_LABEL:
+      case OP_LINE:
+      case OP_COMMENT:
+          i++;
+          continue;
+      case OP_GOTO:
+          if ((size_t) I.a >= where.size() || where[I.a] < 0) return false;
+          i = where[I.a];
+          continue;
+      case OP_RETURN:
+      case OP_VRETURN:
+          return true;
+    }
+    return false;
+  }
+  return false;
+}
+
+int function::removeTailCalls(std::vector<instr> &code)
+{
+  std::vector<const identlist*> params;
+  for (const identlist* p = formals; p; p=p->next) {
+    if (p->is_array) return 0;
+    params.push_back(p);
+  }
+  std::vector<int> where;
+  for (size_t i=0; i<code.size(); i++) {
+    if (!code[i].is_label()) continue;
+    if ((size_t) code[i].a >= where.size()) where.resize(code[i].a+1, -1);
+    where[code[i].a] = i;
+  }
+
+  int start = 0;
+  int count = 0;
+  std::vector<instr> out;
+  for (size_t i=0; i<code.size(); i++) {
+    const instr &I = code[i];
+    if ((OP_INVOKESTATIC != I.op) || (I.sym != name) || (I.flags & FLAG_LIBC)
+        || !returns_at(code, i+1, where)) {
+      out.push_back(I);
+      continue;
+    }
+    if (!start) start = newLabel();
+    for (size_t k=params.size(); k-- > 0; ) {
+      out.push_back(make_instr(OP_STORE, k, params[k]->type.typecode, params[k]->name));
+    }
+    out.push_back(make_instr(OP_GOTO, start));
+    count++;
+  }
+  if (!count) return 0;
+  code.clear();
+  code.push_back(make_instr(OP_LABEL, start));
+  code.insert(code.end(), out.begin(), out.end());
+  tail_calls += count;
+  return count;
+}
+
 void function::display(std::ostream &out, bool show_types) const
 {
   //out << name << " " << show_types << " " << prototype_only << " " << "\n";
   if (show_types && prototype_only) return;
   if (prototype_only) out << "Prototype ";
   else                out << "Function ";
-  out << name;
+  out << atom_table::name(name);
   if (show_types) {
     out << ", returns " << type;
   }
@@ -1613,9 +2427,10 @@ void function::display(std::ostream &out, bool show_types) const
 }
 
 stack_machine::stack_machine() {
-    stack_depth = 0;
     st = NULL;
-    store_val = "";
+    spare = NULL;
+    store_val = 0;
+    store_element = false;
 }
 
 stack_machine::~stack_machine() {
@@ -1624,12 +2439,22 @@ stack_machine::~stack_machine() {
         delete st;
         st = next;
     }
+    while (spare) {
+        stack_code* next = spare->next;
+        delete spare;
+        spare = next;
+    }
 }
 
-void stack_machine::push_stack(std::string data)
+void stack_machine::push_stack(atom_id data)
 {
     struct stack_code* temp;
-    temp = new stack_code;
+    if (spare) {
+        temp = spare;
+        spare = spare->next;
+    } else {
+        temp = new stack_code;
+    }
 
     if (!temp)
     {
@@ -1644,18 +2469,16 @@ void stack_machine::pop_stack()
 {
     struct stack_code* temp;
  
-    if (st == NULL)
-    {
-        printf("stack is empty\n");
-        exit(1);
-    }
-    else
-    {
-        temp = st;
-        st = st->next;
-        temp->next = NULL;
-        //free(temp);
-    }
+    /*
+      Nothing to pop: the expression left no name.  Not fatal,
+      so one input cannot stop the other compilations in a batch.
+    */
+    if (st == NULL) return;
+
+    temp = st;
+    st = st->next;
+    temp->next = spare;
+    spare = temp;
 }
 
 bool stack_machine::isStackEmpty()
@@ -1663,20 +2486,19 @@ bool stack_machine::isStackEmpty()
     return st == NULL;
 }
 
-std::string stack_machine::peek_stack()
+atom_id stack_machine::peek_stack()
 {
-    if (!isStackEmpty())
-        return st->data;
-    else {
-        printf("stack is empty\n");
-        exit(1);
-    }
+    /* No name on the stack: treat it as a value without one */
+    return isStackEmpty() ? 0 : st->data;
 }
 
-void stack_machine::show_stack()
+bool stack_machine::dropConstants(int n)
 {
-  std::vector<std::string>::iterator it;
-  for (it = stack_mc.begin(); it != stack_mc.end(); ++it) {
-    fprintf(jF, "%s", (*it).c_str());
+  if (machine_code.size() < (size_t) n) return false;
+  for (int i=1; i<=n; i++) {
+    if (OP_ICONST != machine_code[machine_code.size()-i].op) return false;
   }
+  machine_code.resize(machine_code.size() - n);
+  return true;
 }
+
@@ -7,6 +7,17 @@
 #include <vector>
 #include <map>
 
+#include "atoms.h"
+#include "symtab.h"
+#include "instr.h"
+#include "cfg.h"
+#include "loops.h"
+#include "ssa.h"
+#include "peephole.h"
+#include "slots.h"
+#include "frame.h"
+#include "backend.h"
+
 #define MAX 1000
 #define YYDEBUG 1
 /* ======================================================================
@@ -19,6 +30,24 @@ struct identlist;
 class function;
 class stack_machine;
 
+/*
+  Kinds of front-end objects that live in the per-compilation arena.
+  Used for the memory report.
+*/
+enum node_kind {
+    NODE_IDENTLIST,
+    NODE_TYPELIST,
+    NODE_STMTNODE,
+    NODE_FUNCLIST,
+    NODE_STACKCODE,
+    NODE_TEXT,
+    NODE_INITIAL,
+    NODE_KINDS
+};
+
+void* allocNode(size_t bytes, node_kind kind);
+char* copyText(const char* text, size_t len);
+
 struct typeinfo {
     /*  
         'E': error
@@ -34,16 +63,51 @@ struct typeinfo {
         Is this an array of the given type?
     */
     bool is_array;
+    /*
+        Is the value known at compile time?  If so, the code for
+        it is a single iconst, the last instruction emitted.
+    */
+    bool is_const;
+    int value;
+    /*
+        Is this a condition, compiled as branches rather than as a
+        value?  Then truelist and falselist are the jump lists (see
+        function::backpatch) of the branches taken when it is true
+        and when it is false; falls is the value that falling off
+        the end of its code means; and its code ends at index end
+        of machine_code.
+    */
+    bool is_jump;
+    bool falls;
+    int truelist;
+    int falselist;
+    int end;
   public:
     inline void set(char tc, bool a=false) {
       typecode = tc; 
       is_array = a;
+      is_const = false;
+      is_jump = false;
       bytecode = (char*)"none";
     }
 
-    inline void setBytecode(std::string bc) {
-      bytecode = new char[bc.length() + 1];
-      strcpy(bytecode, bc.c_str());
+    inline void setConst(int v) {
+      is_const = true;
+      value = v;
+    }
+
+    /*
+      Copies the text, into the arena.
+    */
+    inline void setBytecode(const char* bc, size_t len) {
+      bytecode = copyText(bc, len);
+    }
+
+    /*
+      For string literals only; the text is not copied.
+    */
+    inline void setOpcode(const char* op) {
+      bytecode = (char*) op;
     }
 
     inline bool operator==(const typeinfo T) const {
@@ -75,31 +139,52 @@ struct typelist {
       type = T;
       next = N;
     }
+
+    /* Allocated in the arena; delete is a no-op */
+    static inline void* operator new(size_t bytes) {
+      return allocNode(bytes, NODE_TYPELIST);
+    }
+    static inline void operator delete(void*) { }
 };
 
 struct identlist {
     typeinfo type;
-    char* name;
+    atom_id name;
     bool is_array;
     int lineno;
     identlist* next;
     bool is_global;
+    /*
+      JVM local variable slot, or -1 for globals.
+    */
+    int slot;
+    /*
+      Array length; 0 until known, for "int a[] = { ... }".
+    */
+    int size;
+    /*
+      Initial value(s) given in the declaration, ninit of them,
+      each an iconst or fconst; 0 if none.
+    */
+    instr* init;
+    int ninit;
 
   public:
-    identlist(typeinfo T, char* _name, bool array);
-    identlist(char* _name, bool array);
+    identlist(typeinfo T, atom_id _name, bool array);
+    identlist(atom_id _name, bool array);
     ~identlist(); /* does not delete next pointer */
 
+    /* Allocated in the arena; delete is a no-op */
+    static inline void* operator new(size_t bytes) {
+      return allocNode(bytes, NODE_IDENTLIST);
+    }
+    static inline void operator delete(void*) { }
+
     /* Put all of L in front of us */
     identlist* Push(identlist* L);
 
     void display(std::ostream& out, bool showtypes) const;
 
-    /*
-      Slow but gets the job done
-    */
-    const identlist* find(const char* name) const;
-
   public: 
     /*
       Helper methods
@@ -109,66 +194,135 @@ struct identlist {
     static void deleteList(identlist* L);
 
     /*
-      Append list "items" to the end of list "main".
-      If dup_error is non-null, then we check for duplicates
+      Append list "items" to the end of list "main", whose last
+      item is "main_end" (both updated).
+      Each item is declared in the innermost scope of "scope".
+      If dup_type is non-null, then we check that scope for duplicates
       and give an error of 'dup_type' item already declared.
     */
-    static identlist* Append(identlist* main, identlist* items, const char* dup_type);
+    static identlist* Append(identlist* main, identlist* &main_end, 
+                             identlist* items, const char* dup_type, symtab* scope);
 };
 
 class stack_machine {
     struct stack_code {
-        std::string data;
+        atom_id data;
         int depth;
         stack_code *next;
+
+        /* Allocated in the arena */
+        static inline void* operator new(size_t bytes) {
+          return allocNode(bytes, NODE_STACKCODE);
+        }
+        static inline void operator delete(void*) { }
     };
 
     private:
         stack_code *st;
-        int stack_depth;
+        stack_code *spare;      /* popped nodes, for reuse */
 
     public:
         stack_machine();
         ~stack_machine();
 
-        std::vector<std::string> machine_code;
-        std::vector<std::string> stack_mc;
-        std::map<std::string, int> local_pos;
-        void push_stack(std::string data);
-        void pop_stack();
-        std::string peek_stack();
-        bool isStackEmpty();
-        void show_stack();
-        std::string store_val;
-        inline int getStackDepth() {
-            return stack_depth;
+        std::vector<instr> machine_code;
+        std::vector<instr> stack_mc;
+        /*
+          Append an instruction to machine_code; returns it so the
+          caller can fill in the remaining fields.
+        */
+        inline instr& emit(int op, int a = 0, char type = 0, atom_id sym = 0) {
+            machine_code.push_back(make_instr(op, a, type, sym));
+            return machine_code.back();
         }
-        inline void incStackDepth() {
-            stack_depth++;
-        }
-        inline void decStackDepth() {
-            stack_depth--;
+        /*
+          Move machine_code to the end of stack_mc.
+        */
+        inline void flush() {
+            stack_mc.insert(stack_mc.end(), machine_code.begin(), machine_code.end());
+            machine_code.clear();
         }
+        /*
+          Remove the pushes of the last n operands, which are
+          constants (see typeinfo::is_const), so a folded value 
+          can replace them.  Returns false, changing nothing, if
+          the code does not end with n constant pushes.
+        */
+        bool dropConstants(int n);
+        void push_stack(atom_id data);
+        /* On an empty stack, pop does nothing and peek gives 0 */
+        void pop_stack();
+        atom_id peek_stack();
+        bool isStackEmpty();
+        atom_id store_val;      /* destination of a pending store, or 0 */
+        bool store_element;     /* and it is an element of that array */
 };
 
 
+/*
+  The front end's state for one compilation.  Each compiler_context
+  has one; the static methods work on that of the compilation
+  running on the calling thread.
+*/
 class parse_data {
-    static parse_data THE_DATA;
+    static thread_local parse_data* THE_DATA;
+    friend class compiler_context;
   public:
+    /*
+      Holds nothing until Initialize().
+    */
+    parse_data();
+
     /*
       These methods are called in mycc.cc
     */
 
     /*
       Call this before calling yyparse()
+        @param  out   Where finished code goes, or 0 for no code
+    */
+    static void Initialize(bool typecheck, backend* out);
+
+    /*
+      Write the remaining output and close it.
+      Return false if it could not be written.
     */
-    static void Initialize(bool typecheck);
+    static bool finishOutput();
 
     /*
-      Call this after calling yyparse()
+      Call this after calling yyparse(), once everything is
+      written out.  Frees all front-end objects in one go.
     */
     static void Finalize();
 
+    /*
+      Display the bytes used by each kind of front-end object.
+      Only meaningful before Finalize().
+    */
+    static void showMemory(std::ostream &s);
+
+    /*
+      Display how many calls were inlined, and which
+      functions had their tail calls removed.
+    */
+    static void showCalls(std::ostream &s);
+
+    /*
+      Display how many switches became each instruction, and where.
+    */
+    static void showSwitches(std::ostream &s);
+
+    /*
+      Start the counts for showCalls() and showSwitches() over.
+    */
+    static void clearStats();
+
+    /*
+      Arena for front-end objects.
+    */
+    friend void* allocNode(size_t bytes, node_kind kind);
+    friend char* copyText(const char* text, size_t len);
+
     /*
       Display global variables.
       Used in modes 2 and 3.
@@ -187,9 +341,10 @@ class parse_data {
     */
 
     static void declareGlobals(identlist* L);
+    static void doneProgram();
     static void declareLocals(identlist* L);
 
-    static function* startFunction(typeinfo T, char* n, identlist* F);
+    static function* startFunction(typeinfo T, atom_id n, identlist* F);
     static void startFunctionDef();
     static void doneFunction(function* F, bool proto_only);
 
@@ -197,17 +352,50 @@ class parse_data {
     static typeinfo buildUnary(char op, typeinfo opnd);
     static typeinfo buildCast(typeinfo cast, typeinfo opnd);
     static typeinfo buildArith(typeinfo left, char op, typeinfo right);
+    /*
+      For && and ||: called between the operands, with the left one.
+      Returns the left operand to pass on to buildLogic().
+    */
+    static typeinfo startLogic(typeinfo left, const char* op);
     static typeinfo buildLogic(typeinfo left, const char* op, typeinfo right);
     static typeinfo buildIncDec(bool pre, char op, typeinfo opnd);
     static typeinfo buildUpdate(typeinfo lhs, const char* op, typeinfo rhs);
     static typeinfo buildTernary(typeinfo cond, typeinfo then, typeinfo els);
 
     static typeinfo buildLiteral(typeinfo val, bool flag);
-    static typeinfo buildLval(char* ident, bool flag);
-    static typeinfo buildLvalBracket(char* ident, typeinfo index, bool flag);
-    static typeinfo buildFcall(char* ident, typelist* params);
+    static typeinfo buildLval(atom_id ident, bool flag);
+    /*
+      Called at the [ of an element of array ident, before the index,
+      to load the array: global arrays only, from their static field.
+    */
+    static void buildArrayRef(atom_id ident);
+    static typeinfo buildLvalBracket(atom_id ident, typeinfo index, bool flag);
+    static typeinfo buildFcall(atom_id ident, typelist* params);
     static identlist* getNextIdentVar(std::string local_data);
-    static void initGlobal();
+
+    /*
+      Declarations.  arraySize() takes the size literal of an
+      array; buildIdec() declares one name, with the last 'values'
+      initializers, each from buildInitValue(), as its initial value.
+    */
+    static int arraySize(typeinfo size);
+    static typeinfo buildInitValue(typeinfo val, bool negate);
+    static identlist* buildIdec(atom_id ident, bool array, int size, int values);
+
+    /*
+      Conditions of statements.  buildCondition() (if) falls into
+      the body when the condition holds, and leaves the false list
+      on label_vector for the end of the statement.
+      All loops test at the bottom, with one conditional branch back
+      to the top per iteration.  buildLoopCondition() (do while) is
+      that test, back to the top from push_label().  startLoop()
+      (while, for) moves the test from the top to the bottom: the
+      loop is entered with a goto to the test, and loop_end_label()
+      puts the test after the body.  An empty condition always holds.
+    */
+    static typeinfo buildCondition(typeinfo cond);
+    static typeinfo buildLoopCondition(typeinfo cond);
+    static typeinfo startLoop(typeinfo cond);
 
     static void checkCondition(bool can_be_empty, const char* stmt, typeinfo cond, int lineno, const char* flag);
     static typeinfo checkCondition1(bool can_be_empty, const char* stmt, typeinfo cond, int lineno, const char* flag);
@@ -216,20 +404,34 @@ class parse_data {
     static void loop_end_label();
     static void ifmarker();
     static void ifnomarker();
+    static void forInit(typeinfo init);
+    static void forStep(typeinfo step);
+    static void forEnd();
+
+    /*
+      break and continue jump to the end of the innermost loop or
+      switch, and to the test (or step) of the innermost loop.
+      startSwitch() emits a switch instruction with no cases;
+      caseLabel() and defaultLabel() place labels in its body, and
+      endSwitch() fills in the cases, in order of value.
+    */
+    static void buildBreak();
+    static void buildContinue();
+    static void startSwitch(typeinfo expr, int lineno);
+    static void caseLabel(typeinfo value);
+    static void defaultLabel();
+    static void endSwitch();
     static void checkEmptyReturn();
-    static void loop_exp_marker();
-    static void if_cond_exp();
     /*{
       typeinfo T;
       T.set('V', 0);
       checkReturn(T);
-      THE_DATA.jvm->stack_mc.push_back("\t\treturn\n");
-      THE_DATA.current_function->return_flag = 1;
+      THE_DATA->jvm->stack_mc.push_back("\t\treturn\n");
+      THE_DATA->current_function->return_flag = 1;
     }*/
 
     static void addExprStmt(typeinfo type);
     static void load_stack(char* literal, bool flag);
-    static void show_machine_code();
   
   private:
     struct funclist {
@@ -239,31 +441,62 @@ class parse_data {
         funclist(function *f);
         ~funclist();  /* does not delete next pointer */
 
-        funclist* Push(funclist* L);
-
-      public:
-        static funclist* reverseList(funclist*);
+        /* Allocated in the arena */
+        static inline void* operator new(size_t bytes) {
+          return allocNode(bytes, NODE_FUNCLIST);
+        }
+        static inline void operator delete(void*) { }
     };
 
   private:
     bool typechecking;
     identlist* globals;
-    funclist* functions;
+    identlist* globals_end;
+    symtab symbols;
+    funclist* functions;        /* in declaration order */
+    funclist* functions_end;
+    /*
+      Function registry, indexed directly by the atom of the name.
+      Atoms are small and dense, so this is a hash with a perfect hash.
+    */
+    std::vector<function*> function_index;
     function* current_function;
     stack_machine* jvm;
+    backend* out;
+
+    arena nodes;
+    size_t node_count[NODE_KINDS];
+    size_t node_bytes[NODE_KINDS];
 
   private:
-    function* find(const char* name) const;
+    /*
+      Conversions between values and conditions (see typeinfo).
+      T must be the last code emitted, except for toValue().
+    */
+    static void toJump(typeinfo &T);
+    static void toValue(typeinfo &T);
+    static void fallThrough(typeinfo &T, bool sense);
+    static void placeList(int list);
+    static void discard(typeinfo &T);
+    static void statementCode(std::vector<instr> &into);
+    static void inlineCall(function* F);
+    static void buildClassInit();
+    static void fillArray(std::vector<instr> &code, const identlist* A, int &labels);
+
+    inline function* find(atom_id name) const {
+      return (name < function_index.size()) ? function_index[name] : 0;
+    }
+    void registerFunction(function* F);
 
   public:
-    inline static bool TypecheckingOn() { return THE_DATA.typechecking; }
+    inline static bool TypecheckingOn() { return THE_DATA->typechecking; }
 };
 
 /*
-  Generated by bison.
+  Generated by bison; scanner is the flex scanner to read from.
 */
 
-int yyparse();
+int yyparse(void* scanner);
 
 
 
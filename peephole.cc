@@ -0,0 +1,248 @@
+
+#include "peephole.h"
+
+/*
+  Pattern entries that match a class of opcodes.
+*/
+enum {
+    ANY_COND = OP_COUNT,    /* any conditional branch */
+    ANY_EXIT,               /* goto or return: the next instruction is unreachable */
+    ANY_CODE                /* anything but a label or a comment */
+};
+
+#define MAXWINDOW 4
+
+struct rule {
+    const char* name;
+    int length;
+    int ops[MAXWINDOW];
+    /*
+      Operand checks, once the opcodes match; 0 for none.
+    */
+    bool (*fits)(const instr* w);
+    /*
+      Write the replacement into out, return its length.
+    */
+    int (*rewrite)(const instr* w, instr* out);
+};
+
+/* ====================================================================== */
+
+static inline bool small(int k)
+{
+  return (k >= -128) && (k < 128);
+}
+
+static bool same_slot(const instr* w)
+{
+  return (w[0].a == w[1].a) && (w[0].type == w[1].type);
+}
+
+static bool zero(const instr* w)
+{
+  return 0 == w[0].a;
+}
+
+static bool one(const instr* w)
+{
+  return 1 == w[0].a;
+}
+
+/* iload n; iconst k; iadd; istore n */
+static bool inc_fits(const instr* w)
+{
+  return ('I' == w[0].type) && (w[0].a == w[3].a) && (w[3].type == 'I') && small(w[1].a);
+}
+
+/* iconst k; iload n; iadd; istore n */
+static bool inc2_fits(const instr* w)
+{
+  return ('I' == w[1].type) && (w[1].a == w[3].a) && (w[3].type == 'I') && small(w[0].a);
+}
+
+/* iload n; iconst k; isub; istore n; tests small(-k) without negating INT_MIN */
+static bool dec_fits(const instr* w)
+{
+  return ('I' == w[0].type) && (w[0].a == w[3].a) && (w[3].type == 'I')
+    && (w[1].a > -128) && (w[1].a <= 128);
+}
+
+static bool no_change(const instr* w)
+{
+  return 0 == w[0].b;
+}
+
+static bool goto_next(const instr* w)
+{
+  return w[0].a == w[1].a;
+}
+
+/* if L1; goto L2; L1: */
+static bool over_goto(const instr* w)
+{
+  return w[0].a == w[2].a;
+}
+
+/* ====================================================================== */
+
+static int drop_all(const instr*, instr*)
+{
+  return 0;
+}
+
+static int keep_first(const instr* w, instr* out)
+{
+  out[0] = w[0];
+  return 1;
+}
+
+/*
+  Line comments go above a goto or return, so they do not
+  separate it from the code the other rules look at.
+*/
+static int swap(const instr* w, instr* out)
+{
+  out[0] = w[1];
+  out[1] = w[0];
+  return 2;
+}
+
+static int keep_second(const instr* w, instr* out)
+{
+  out[0] = w[1];
+  return 1;
+}
+
+static int dup_store(const instr* w, instr* out)
+{
+  out[0] = make_instr(OP_DUP);
+  out[1] = w[0];
+  return 2;
+}
+
+static int to_iinc(const instr* w, instr* out)
+{
+  out[0] = make_instr(OP_IINC, w[3].a);
+  out[0].b = (OP_IADD == w[2].op)
+    ? (OP_ICONST == w[1].op ? w[1].a : w[0].a)
+    : -w[1].a;
+  return 1;
+}
+
+static int invert(const instr* w, instr* out)
+{
+  out[0] = w[0];
+  out[0].op = negate(w[0].op);
+  out[0].a = w[1].a;
+  out[1] = w[2];
+  return 2;
+}
+
+/* ====================================================================== */
+
+static const rule RULES[] = {
+  { "dup store pop",        3, { OP_DUP, OP_STORE, OP_POP },              0,          keep_second },
+  { "store load",           2, { OP_STORE, OP_LOAD },                     same_slot,  dup_store },
+  { "load store",           2, { OP_LOAD, OP_STORE },                     same_slot,  drop_all },
+  { "load add store",       4, { OP_LOAD, OP_ICONST, OP_IADD, OP_STORE }, inc_fits,   to_iinc },
+  { "const add store",      4, { OP_ICONST, OP_LOAD, OP_IADD, OP_STORE }, inc2_fits,  to_iinc },
+  { "load sub store",       4, { OP_LOAD, OP_ICONST, OP_ISUB, OP_STORE }, dec_fits,   to_iinc },
+  { "iinc zero",            1, { OP_IINC },                               no_change,  drop_all },
+  { "add zero",             2, { OP_ICONST, OP_IADD },                    zero,       drop_all },
+  { "sub zero",             2, { OP_ICONST, OP_ISUB },                    zero,       drop_all },
+  { "or zero",              2, { OP_ICONST, OP_IOR },                     zero,       drop_all },
+  { "mul one",              2, { OP_ICONST, OP_IMUL },                    one,        drop_all },
+  { "div one",              2, { OP_ICONST, OP_IDIV },                    one,        drop_all },
+  { "neg neg",              2, { OP_INEG, OP_INEG },                      0,          drop_all },
+  { "const pop",            2, { OP_ICONST, OP_POP },                     0,          drop_all },
+  { "fconst pop",           2, { OP_FCONST, OP_POP },                     0,          drop_all },
+  { "load pop",             2, { OP_LOAD, OP_POP },                       0,          drop_all },
+  { "load iinc pop",        3, { OP_LOAD, OP_IINC, OP_POP },              0,          keep_second },
+  { "dup pop",              2, { OP_DUP, OP_POP },                        0,          drop_all },
+  { "goto next",            2, { OP_GOTO, OP_LABEL },                     goto_next,  keep_second },
+  { "branch over goto",     3, { ANY_COND, OP_GOTO, OP_LABEL },           over_goto,  invert },
+  { "hoist comment",        2, { ANY_EXIT, OP_LINE },                     0,          swap },
+  { "unreachable",          2, { ANY_EXIT, ANY_CODE },                    0,          keep_first },
+};
+
+static const int NRULES = sizeof(RULES) / sizeof(RULES[0]);
+
+static thread_local unsigned long fired[NRULES];
+
+/* ====================================================================== */
+
+static bool op_matches(int pattern, int op)
+{
+  switch (pattern) {
+    case ANY_COND:
+        return (op >= OP_IFEQ) && (op < OP_GOTO);
+    case ANY_EXIT:
+        return (OP_GOTO == op) || (OP_RETURN == op) || (OP_VRETURN == op);
+    case ANY_CODE:
+        return (OP_LABEL != op) && (OP_LINE != op) && (OP_COMMENT != op);
+  }
+  return pattern == op;
+}
+
+/*
+  Try each rule against the last instructions of out;
+  return the index of the first that matches, or -1.
+*/
+static int match(const std::vector<instr> &out)
+{
+  for (int r=0; r<NRULES; r++) {
+    const rule &R = RULES[r];
+    if (out.size() < (size_t) R.length) continue;
+    const instr* w = &out[out.size() - R.length];
+    int i;
+    for (i=0; i<R.length; i++) {
+      if (!op_matches(R.ops[i], w[i].op)) break;
+    }
+    if (i < R.length) continue;
+    if (R.fits && !R.fits(w)) continue;
+    return r;
+  }
+  return -1;
+}
+
+void peephole::optimize(std::vector<instr> &code)
+{
+  /*
+    Instructions are moved to out one at a time, and the rules
+    are matched against the end of out.  A replacement goes back
+    on the end of out, so it can take part in further matches.
+  */
+  std::vector<instr> out;
+  out.reserve(code.size());
+  for (size_t i=0; i<code.size(); i++) {
+    out.push_back(code[i]);
+    for (;;) {
+      int r = match(out);
+      if (r < 0) break;
+      instr window[MAXWINDOW];
+      instr repl[MAXWINDOW];
+      int len = RULES[r].length;
+      for (int j=0; j<len; j++) {
+        window[j] = out[out.size() - len + j];
+      }
+      out.resize(out.size() - len);
+      int n = RULES[r].rewrite(window, repl);
+      out.insert(out.end(), repl, repl + n);
+      fired[r]++;
+    }
+  }
+  code.swap(out);
+}
+
+void peephole::showStats(std::ostream &s)
+{
+  s << "Peephole rewrites\n";
+  for (int r=0; r<NRULES; r++) {
+    s << '\t' << RULES[r].name << ": " << fired[r] << "\n";
+  }
+}
+
+void peephole::clearStats()
+{
+  for (int r=0; r<NRULES; r++) fired[r] = 0;
+}
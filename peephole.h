@@ -0,0 +1,36 @@
+
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include <iostream>
+#include <vector>
+
+#include "instr.h"
+
+/*
+  Peephole optimizer.
+
+  Rewrites short windows of a method's instruction stream,
+  using a table of patterns, until no pattern matches.
+  Each rule counts how often it fired, for the -s report.
+*/
+
+class peephole {
+  public:
+    /*
+      Optimize one method's code in place.
+    */
+    static void optimize(std::vector<instr> &code);
+
+    /*
+      Show the rewrite counts, one line per rule.
+    */
+    static void showStats(std::ostream &s);
+
+    /*
+      Start the counts for showStats() over.
+    */
+    static void clearStats();
+};
+
+#endif
@@ -0,0 +1,182 @@
+
+#include "sink.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/*
+  Blocks shorter than this are cheaper to copy than to queue.
+*/
+#define MIN_BLOCK 256
+
+sink::sink(size_t bufsize)
+{
+  fd = -1;
+  owned = false;
+  failed = false;
+  cap = bufsize;
+  buf = (char*) malloc(cap);
+  if (0==buf) abort();
+  used = 0;
+  mark = 0;
+}
+
+sink::~sink()
+{
+  close();
+  free(buf);
+}
+
+bool sink::open(const char* fname)
+{
+  close();
+  fd = ::open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  owned = true;
+  failed = (fd < 0);
+  return !failed;
+}
+
+void sink::use(int _fd)
+{
+  close();
+  fd = _fd;
+  owned = false;
+  failed = false;
+}
+
+bool sink::close()
+{
+  if (fd < 0) return !failed;
+  flush();
+  if (owned && ::close(fd)) failed = true;
+  fd = -1;
+  owned = false;
+  return !failed;
+}
+
+void sink::spill()
+{
+  flush();
+}
+
+void sink::putLong(const char* text, size_t len)
+{
+  while (len) {
+    if (used == cap) flush();
+    size_t n = cap - used;
+    if (n > len) n = len;
+    memcpy(buf + used, text, n);
+    used += n;
+    text += n;
+    len -= n;
+  }
+}
+
+void sink::putInt(int x)
+{
+  char digits[12];
+  char* p = digits + sizeof(digits);
+  unsigned u = (x < 0) ? 0u - (unsigned) x : (unsigned) x;
+  do {
+    *--p = '0' + (u % 10);
+    u /= 10;
+  } while (u);
+  if (x < 0) *--p = '-';
+  put(p, digits + sizeof(digits) - p);
+}
+
+void sink::format(const char* fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(buf + used, cap - used, fmt, args);
+  va_end(args);
+  if (n < 0) {
+    failed = true;
+    return;
+  }
+  if ((size_t) n < cap - used) {
+    used += n;
+    return;
+  }
+
+  /* Didn't fit; make room, or format into a temporary if it never will */
+  if ((size_t) n < cap) {
+    flush();
+    va_start(args, fmt);
+    vsnprintf(buf, cap, fmt, args);
+    va_end(args);
+    used = n;
+    return;
+  }
+  std::vector<char> tmp(n + 1);
+  va_start(args, fmt);
+  vsnprintf(&tmp[0], n + 1, fmt, args);
+  va_end(args);
+  putLong(&tmp[0], n);
+}
+
+void sink::putBlock(const void* data, size_t len)
+{
+  if (len < MIN_BLOCK) {
+    put((const char*) data, len);
+    return;
+  }
+  struct iovec V;
+  if (used > mark) {
+    V.iov_base = buf + mark;
+    V.iov_len = used - mark;
+    queue.push_back(V);
+    mark = used;
+  }
+  V.iov_base = (void*) data;
+  V.iov_len = len;
+  queue.push_back(V);
+  if (queue.size() + 1 >= IOV_MAX) flush();
+}
+
+void sink::flush()
+{
+  if (used > mark) {
+    struct iovec V;
+    V.iov_base = buf + mark;
+    V.iov_len = used - mark;
+    queue.push_back(V);
+  }
+  if (!queue.empty()) writeAll(&queue[0], queue.size());
+  queue.clear();
+  used = 0;
+  mark = 0;
+}
+
+void sink::writeAll(struct iovec* iov, int n)
+{
+  while (n > 0) {
+    if (failed) return;
+    ssize_t got = writev(fd, iov, (n < IOV_MAX) ? n : IOV_MAX);
+    if (got < 0) {
+      if (EINTR == errno) continue;
+      failed = true;
+      return;
+    }
+    /* Skip what was written; a partial write leaves the rest */
+    while ((n > 0) && ((size_t) got >= iov->iov_len)) {
+      got -= iov->iov_len;
+      iov++;
+      n--;
+    }
+    if (n > 0) {
+      iov->iov_base = (char*) iov->iov_base + got;
+      iov->iov_len -= got;
+    }
+  }
+}
@@ -0,0 +1,114 @@
+
+#ifndef SINK_H
+#define SINK_H
+
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+#include <sys/uio.h>
+
+/*
+  Output sink.
+
+  Small pieces of output are copied into one large buffer, which is
+  reused after every flush.  Large blocks that are already in memory
+  are not copied; they are queued between the buffered pieces, and a
+  flush writes everything with a single writev().
+*/
+
+class sink {
+    int fd;
+    bool owned;         /* true: we opened fd, and close it */
+    bool failed;
+
+    char* buf;
+    size_t used;        /* bytes in buf */
+    size_t mark;        /* start of the part of buf not yet queued */
+    size_t cap;
+
+    std::vector<struct iovec> queue;
+
+  public:
+    sink(size_t bufsize = 65536);
+    ~sink();
+
+    /*
+      Create (or truncate) the given file and write to it.
+      Return false on failure (can't create file).
+    */
+    bool open(const char* fname);
+
+    /*
+      Write to an already open descriptor, such as standard output.
+      It is not closed by close().
+    */
+    void use(int _fd);
+
+    /*
+      Flush, and close the file if we opened it.
+      Return false if anything could not be written.
+    */
+    bool close();
+
+    /*
+      Append text, copying it into the buffer.
+    */
+    inline void put(char c) {
+      if (used == cap) spill();
+      buf[used++] = c;
+    }
+    inline void put(const char* text, size_t len) {
+      if (len <= cap - used) {
+        memcpy(buf + used, text, len);
+        used += len;
+        return;
+      }
+      putLong(text, len);
+    }
+    inline void put(const char* text) {
+      put(text, strlen(text));
+    }
+
+    /*
+      Append a number in decimal.
+    */
+    void putInt(int x);
+
+    /*
+      Append printf-style, formatted straight into the buffer.
+    */
+    void format(const char* fmt, ...)
+#ifdef __GNUC__
+      __attribute__((format(printf, 2, 3)))
+#endif
+      ;
+
+    /*
+      Append len bytes at data without copying them.
+      They must stay put until the next flush.
+    */
+    void putBlock(const void* data, size_t len);
+
+    /*
+      Write everything appended so far.
+    */
+    void flush();
+
+    /*
+      A natural break in the output, such as the end of a method.
+      Flush if the buffer is at least half full, so writes are
+      large and rarely split a method.
+    */
+    inline void boundary() {
+      if (2*used >= cap) flush();
+    }
+
+    inline bool ok() const { return !failed; }
+
+  private:
+    void spill();
+    void putLong(const char* text, size_t len);
+    void writeAll(struct iovec* iov, int n);
+};
+
+#endif
@@ -0,0 +1,189 @@
+
+#include "slots.h"
+#include "cfg.h"
+#include "loops.h"
+
+#include <algorithm>
+
+/*
+  Counts for -s, over all methods compiled on this thread
+  since clearStats().
+*/
+static thread_local long slots_before;
+static thread_local long slots_after;
+static thread_local long short_before;
+static thread_local long short_after;
+
+static inline bool is_local(const instr &I)
+{
+  return (OP_LOAD == I.op) || (OP_STORE == I.op) || (OP_IINC == I.op);
+}
+
+static inline char kind_of(const instr &I)
+{
+  return ('F' == I.type) ? 'F' : 'I';
+}
+
+/*
+  Busiest first; ties keep the declaration order.
+*/
+struct by_weight {
+  const std::vector<double> &weight;
+  by_weight(const std::vector<double> &w) : weight(w) { }
+  bool operator()(int x, int y) const {
+    if (weight[x] != weight[y]) return weight[x] > weight[y];
+    return x < y;
+  }
+};
+
+/* ====================================================================== */
+
+void slotalloc::allocate(std::vector<instr> &code, int params)
+{
+  flowgraph G(code);
+  if (!G.ok()) return;
+  G.removeUnreachable();
+  if (!G.ok()) return;
+
+  int n = G.blocks.size();
+  int nslots = params;
+  for (size_t i=0; i<code.size(); i++) {
+    if (!is_local(code[i])) continue;
+    if (code[i].a < 0) return;
+    if (code[i].a + 1 > nslots) nslots = code[i].a + 1;
+  }
+  if (0 == nslots) return;
+
+  /*
+    What each local holds, and how much it is used:
+    a use in a loop nest d deep counts as 8^d.
+  */
+  std::vector<loopnest::loop> loops;
+  loopnest::find(G, loops);
+  std::vector<int> depth(n, 0);
+  for (size_t l=0; l<loops.size(); l++) {
+    for (size_t j=0; j<loops[l].body.size(); j++) depth[loops[l].body[j]]++;
+  }
+  std::vector<char> kind(nslots, 0);
+  std::vector<double> weight(nslots, 0);
+  std::vector<bool> used(nslots, false);
+  for (int b=0; b<n; b++) {
+    const flowgraph::block &B = G.blocks[b];
+    if (!B.live) continue;
+    double w = 1;
+    for (int d=0; d<depth[b] && d<6; d++) w *= 8;
+    for (size_t i=0; i<B.code.size(); i++) {
+      const instr &I = B.code[i];
+      if (!is_local(I)) continue;
+      used[I.a] = true;
+      weight[I.a] += w;
+      if (!kind[I.a]) kind[I.a] = kind_of(I);
+    }
+  }
+
+  std::vector<int> rpo;
+  G.reversePostorder(rpo);
+  G.liveness(nslots);
+
+  /*
+    Two locals interfere if one is stored to while the other
+    is live.  Everything live on entry (the parameters, and any
+    local read before it is stored) is stored to there.
+  */
+  std::vector< std::vector<bool> > clash(nslots, std::vector<bool>(nslots, false));
+  for (size_t r=0; r<rpo.size(); r++) {
+    int b = rpo[r];
+    const flowgraph::block &B = G.blocks[b];
+    std::vector<bool> live = B.live_out;
+    for (size_t i=B.code.size(); i-- > 0; ) {
+      const instr &I = B.code[i];
+      if ((OP_STORE == I.op) || (OP_IINC == I.op)) {
+        for (int k=0; k<nslots; k++) {
+          if (!live[k] || (k == I.a)) continue;
+          clash[I.a][k] = true;
+          clash[k][I.a] = true;
+        }
+      }
+      if (OP_STORE == I.op) live[I.a] = false;
+      if ((OP_LOAD == I.op) || (OP_IINC == I.op)) live[I.a] = true;
+    }
+  }
+  const std::vector<bool> &entry = G.blocks[0].live_in;
+  for (int x=0; x<nslots; x++) {
+    if (!entry[x] && (x >= params)) continue;
+    for (int y=0; y<nslots; y++) {
+      if ((x == y) || (!entry[y] && (y >= params))) continue;
+      clash[x][y] = true;
+    }
+  }
+
+  /*
+    Parameters stay put; then each local, busiest first, takes
+    the lowest slot with the same kind and nothing it clashes with.
+  */
+  std::vector<int> slot(nslots, -1);
+  std::vector< std::vector<int> > holds;
+  std::vector<char> slot_kind;
+  for (int p=0; p<params; p++) {
+    slot[p] = p;
+    holds.push_back(std::vector<int>(1, p));
+    slot_kind.push_back(kind[p]);
+  }
+  std::vector<int> order;
+  for (int x=params; x<nslots; x++) {
+    if (used[x]) order.push_back(x);
+  }
+  std::stable_sort(order.begin(), order.end(), by_weight(weight));
+  for (size_t o=0; o<order.size(); o++) {
+    int x = order[o];
+    size_t s;
+    for (s=0; s<holds.size(); s++) {
+      if (slot_kind[s] && (slot_kind[s] != kind[x])) continue;
+      bool free = true;
+      for (size_t j=0; j<holds[s].size(); j++) {
+        if (clash[x][holds[s][j]]) free = false;
+      }
+      if (free) break;
+    }
+    if (s == holds.size()) {
+      holds.push_back(std::vector<int>());
+      slot_kind.push_back(0);
+    }
+    holds[s].push_back(x);
+    if (!slot_kind[s]) slot_kind[s] = kind[x];
+    slot[x] = s;
+  }
+
+  /*
+    Locals only in code that can't be reached keep slots of their own.
+  */
+  int after = holds.size();
+  for (size_t i=0; i<code.size(); i++) {
+    instr &I = code[i];
+    if (!is_local(I)) continue;
+    if (slot[I.a] < 0) slot[I.a] = after++;
+    bool counts = (OP_IINC != I.op);
+    if (counts && (I.a <= 3)) short_before++;
+    I.a = slot[I.a];
+    if (counts && (I.a <= 3)) short_after++;
+  }
+  slots_before += nslots;
+  slots_after += after;
+}
+
+void slotalloc::showStats(std::ostream &s)
+{
+  s << "Local slots\n";
+  s << "\tslots before: " << slots_before << "\n";
+  s << "\tslots after: " << slots_after << "\n";
+  s << "\tshort loads and stores before: " << short_before << "\n";
+  s << "\tshort loads and stores after: " << short_after << "\n";
+}
+
+void slotalloc::clearStats()
+{
+  slots_before = 0;
+  slots_after = 0;
+  short_before = 0;
+  short_after = 0;
+}
@@ -0,0 +1,45 @@
+
+#ifndef SLOTS_H
+#define SLOTS_H
+
+#include <iostream>
+#include <vector>
+
+#include "instr.h"
+
+/*
+  Local variable slot allocation.
+
+  The front end gives every local its own slot, in the order they
+  are declared, and inlining and the optimizer add more.  Here the
+  slots are handed out again: two locals whose values are never
+  needed at the same time (their live ranges don't overlap) can
+  share a slot.  Locals are placed in order of how often they are
+  used, counting a use inside a loop as several, so the busiest
+  ones get the lowest free slots, where iload_0 to iload_3 and
+  istore_0 to istore_3 take one byte.
+
+  Parameters keep their slots, since that is where the caller
+  puts them; a slot holds only ints or only floats.
+*/
+
+class slotalloc {
+  public:
+    /*
+      Renumber the locals of one method's code in place.
+        @param  params    Number of parameter slots
+    */
+    static void allocate(std::vector<instr> &code, int params);
+
+    /*
+      Show how many slots were saved, for -s.
+    */
+    static void showStats(std::ostream &s);
+
+    /*
+      Start the counts for showStats() over.
+    */
+    static void clearStats();
+};
+
+#endif
@@ -0,0 +1,119 @@
+
+#include "source.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+source_file::source_file()
+{
+  base = 0;
+  length = 0;
+  reserved = 0;
+  mapped = false;
+}
+
+source_file::~source_file()
+{
+  close();
+}
+
+bool source_file::open(const char* fname)
+{
+  close();
+
+  int fd = ::open(fname, O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    ::close(fd);
+    return false;
+  }
+  length = st.st_size;
+
+  /*
+    Reserve room for the file plus the two NULs, then map the
+    file over the front of the reservation.  The tail of the last
+    file page reads as zeroes, and so do the anonymous pages behind it,
+    so the sentinels are there no matter how the size lines up with
+    the page size.
+  */
+  size_t page = sysconf(_SC_PAGESIZE);
+  reserved = ((length + 2 + page - 1) / page) * page;
+
+  if (S_ISREG(st.st_mode)) {
+    void* region = mmap(0, reserved, PROT_READ | PROT_WRITE, 
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED != region) {
+      if (0 == length) {
+        base = (char*) region;
+        mapped = true;
+        ::close(fd);
+        return true;
+      }
+      void* file = mmap(region, length, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_FIXED, fd, 0);
+      if (MAP_FAILED != file) {
+        base = (char*) file;
+        mapped = true;
+        ::close(fd);
+#ifdef MADV_SEQUENTIAL
+        madvise(base, reserved, MADV_SEQUENTIAL);
+#endif
+        return true;
+      }
+      munmap(region, reserved);
+    }
+  }
+
+  /*
+    Not something we can map (a pipe, say); read it instead.
+  */
+  size_t cap = S_ISREG(st.st_mode) ? length + 2 : 65536;
+  base = (char*) malloc(cap);
+  length = 0;
+  for (;;) {
+    if (length + 2 > cap) {
+      cap *= 2;
+      base = (char*) realloc(base, cap);
+    }
+    ssize_t got = read(fd, base + length, cap - length - 2);
+    if (got <= 0) break;
+    length += got;
+  }
+  base[length] = 0;
+  base[length+1] = 0;
+  reserved = cap;
+  mapped = false;
+  ::close(fd);
+  return true;
+}
+
+void source_file::load(const char* text, size_t len)
+{
+  close();
+  base = (char*) malloc(len + 2);
+  memcpy(base, text, len);
+  base[len] = 0;
+  base[len+1] = 0;
+  length = len;
+  reserved = len + 2;
+  mapped = false;
+}
+
+void source_file::close()
+{
+  if (base) {
+    if (mapped) munmap(base, reserved);
+    else        free(base);
+  }
+  base = 0;
+  length = 0;
+  reserved = 0;
+  mapped = false;
+}
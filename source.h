@@ -0,0 +1,62 @@
+
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stddef.h>
+
+/*
+  Source manager.
+
+  Maps an input file into memory once, so the lexer can scan
+  straight out of the mapping instead of copying every byte
+  through stdio and then again into the flex buffer.
+*/
+
+class source_file {
+    char* base;       /* First byte of the input */
+    size_t length;    /* Size of the input, in bytes */
+    size_t reserved;  /* Size of the region at base, in bytes */
+    bool mapped;      /* true: region came from mmap, false: from malloc */
+
+  public:
+    source_file();
+    ~source_file();
+
+    /*
+      Map the given file.  Any previously opened file is released.
+        @param  fname   File to map
+      Return true on success, false on failure (can't open file)
+    */
+    bool open(const char* fname);
+
+    /*
+      Use a copy of text already in memory, len bytes, instead of a file.
+      Any previously opened file is released.
+    */
+    void load(const char* text, size_t len);
+
+    /*
+      Release the mapping.
+    */
+    void close();
+
+    /*
+      The input text.  It is followed by two NUL bytes,
+      which is what flex wants for yy_scan_buffer().
+      Flex writes into the buffer while scanning, so the
+      mapping is private (copy on write) and never touches the file.
+    */
+    inline char* text() const { return base; }
+
+    /*
+      Size of the input, not including the two NUL bytes.
+    */
+    inline size_t size() const { return length; }
+
+    /*
+      Size of the buffer to hand to yy_scan_buffer().
+    */
+    inline size_t scan_size() const { return length + 2; }
+};
+
+#endif
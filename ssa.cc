@@ -0,0 +1,1068 @@
+
+#include "ssa.h"
+
+#include <stdio.h>
+#include <limits.h>
+#include <algorithm>
+
+/*
+  Counts for -s, over all methods compiled on this thread
+  since clearStats().
+*/
+static thread_local long values_made;
+static thread_local long phis_kept;
+static thread_local long constants_folded;
+static thread_local long branches_folded;
+static thread_local long redundant;
+static thread_local long copies_propagated;
+static thread_local long stores_removed;
+
+/*
+  Instructions that must stay where they are: a run of code
+  containing one of these is never replaced.
+*/
+static inline bool is_effect(const instr &I)
+{
+  switch (I.op) {
+    case OP_LINE:
+    case OP_COMMENT:
+    case OP_STORE:
+    case OP_IINC:
+    case OP_PUTSTATIC:
+    case OP_ASTORE:
+    case OP_NEWARRAY:
+    case OP_INVOKESTATIC:
+        return true;
+  }
+  return false;
+}
+
+static inline bool is_arith(int op)
+{
+  return (op >= OP_IADD) && (op <= OP_INEG);
+}
+
+static inline bool commutative(int op)
+{
+  return (OP_IADD == op) || (OP_IMUL == op) || (OP_IOR == op)
+      || (OP_IAND == op) || (OP_IXOR == op);
+}
+
+static inline char kind_of(char type)
+{
+  return ('F' == type) ? 'F' : 'I';
+}
+
+/*
+  Integer arithmetic as the JVM does it.
+  Return false if it can't be done here (division by zero).
+*/
+static bool fold(int op, int x, int y, int &r)
+{
+  unsigned ux = x, uy = y;
+  switch (op) {
+    case OP_IADD:   r = (int) (ux + uy);  return true;
+    case OP_ISUB:   r = (int) (ux - uy);  return true;
+    case OP_IMUL:   r = (int) (ux * uy);  return true;
+    case OP_IOR:    r = x | y;            return true;
+    case OP_IAND:   r = x & y;            return true;
+    case OP_IXOR:   r = x ^ y;            return true;
+    case OP_INEG:   r = (int) (0u - ux);  return true;
+    case OP_IDIV:
+    case OP_IREM:
+        if (0 == y) return false;
+        if ((INT_MIN == x) && (-1 == y)) {
+          r = (OP_IDIV == op) ? INT_MIN : 0;
+          return true;
+        }
+        r = (OP_IDIV == op) ? x / y : x % y;
+        return true;
+  }
+  return false;
+}
+
+/*
+  Outcome of a conditional branch on known operands.
+*/
+static bool branch_taken(int op, int x, int y)
+{
+  switch (op) {
+    case OP_IFEQ:       return x == 0;
+    case OP_IFNE:       return x != 0;
+    case OP_IFLT:       return x < 0;
+    case OP_IFGE:       return x >= 0;
+    case OP_IFGT:       return x > 0;
+    case OP_IFLE:       return x <= 0;
+    case OP_IF_ICMPEQ:  return x == y;
+    case OP_IF_ICMPNE:  return x != y;
+    case OP_IF_ICMPLT:  return x < y;
+    case OP_IF_ICMPGE:  return x >= y;
+    case OP_IF_ICMPGT:  return x > y;
+    case OP_IF_ICMPLE:  return x <= y;
+  }
+  return false;
+}
+
+/* ====================================================================== */
+
+ssa::ssa(const std::vector<instr> &code, int _params) : G(code)
+{
+  params = _params;
+  good = G.ok();
+  if (!good) return;
+  G.removeUnreachable();
+  good = G.ok();
+  if (!good) return;
+
+  /* Edges are only taken or next here; a switch is left alone */
+  for (size_t b=0; b<G.blocks.size(); b++) {
+    if (G.blocks[b].live && (OP_SWITCH == G.blocks[b].exit.op)) good = false;
+  }
+  if (!good) return;
+
+  nlocals = params;
+  for (size_t b=0; b<G.blocks.size(); b++) {
+    const std::vector<instr> &C = G.blocks[b].code;
+    for (size_t i=0; i<C.size(); i++) {
+      if ((OP_LOAD == C[i].op) || (OP_STORE == C[i].op) || (OP_IINC == C[i].op)) {
+        if (C[i].a < 0) good = false;
+        if (C[i].a + 1 > nlocals) nlocals = C[i].a + 1;
+      }
+    }
+  }
+  if (!good) return;
+  slot_type.assign(nlocals, 'I');
+  slot_name.assign(nlocals, 0);
+  for (size_t b=0; b<G.blocks.size(); b++) {
+    const std::vector<instr> &C = G.blocks[b].code;
+    for (size_t i=0; i<C.size(); i++) {
+      if ((OP_LOAD == C[i].op) || (OP_STORE == C[i].op)) {
+        slot_type[C[i].a] = kind_of(C[i].type);
+        slot_name[C[i].a] = C[i].sym;
+      }
+    }
+  }
+
+  order();
+  good = stackHeights();
+  if (!good) return;
+  build();
+}
+
+/*
+  Predecessors of the live blocks, and their reverse postorder.
+*/
+void ssa::order()
+{
+  int n = G.blocks.size();
+  preds.assign(n, std::vector<int>());
+  preds[0].push_back(-1);
+  for (int b=0; b<n; b++) {
+    const flowgraph::block &B = G.blocks[b];
+    if (!B.live) continue;
+    if (B.taken >= 0) preds[B.taken].push_back(b);
+    if (B.next >= 0) preds[B.next].push_back(b);
+  }
+
+  G.reversePostorder(rpo);
+}
+
+bool ssa::stackHeights()
+{
+  int n = G.blocks.size();
+  height.assign(n, -1);
+  height[0] = 0;
+  int maxh = 0;
+  for (size_t r=0; r<rpo.size(); r++) {
+    int b = rpo[r];
+    const flowgraph::block &B = G.blocks[b];
+    int h = height[b];
+    if (h < 0) return false;
+    for (size_t i=0; i<=B.code.size(); i++) {
+      const instr &I = (i < B.code.size()) ? B.code[i] : B.exit;
+      int pops, pushes;
+      stack_effect(I, pops, pushes);
+      if (h < pops) return false;
+      h += pushes - pops;
+      if (h > maxh) maxh = h;
+    }
+    int succ[2] = { B.next, B.taken };
+    for (int s=0; s<2; s++) {
+      if (succ[s] < 0) continue;
+      if (height[succ[s]] < 0) height[succ[s]] = h;
+      if (height[succ[s]] != h) return false;
+    }
+  }
+  memvar = nlocals + maxh;
+  return true;
+}
+
+/* ====================================================================== */
+/*
+  Construction, as in Braun et al., "Simple and efficient construction
+  of static single assignment form": blocks are filled in reverse
+  postorder, and a block is sealed once all its predecessors are
+  filled.  Until then, reading a variable there makes a phi whose
+  arguments are added when it is sealed.
+*/
+
+void ssa::build()
+{
+  int n = G.blocks.size();
+  int nvars = memvar + 1;
+  defs.assign(n, std::vector<int>(nvars, -1));
+  made.assign(n, std::vector<int>());
+  incomplete.assign(n, std::vector<int>());
+  branch_args.assign(n, std::vector<int>());
+  stored.assign(n, std::vector<int>());
+  filled.assign(n, false);
+  sealed.assign(n, false);
+  entries.assign(nvars, -1);
+
+  for (size_t r=0; r<rpo.size(); r++) {
+    int b = rpo[r];
+    if (!sealed[b]) seal(b);
+    fill(b);
+    filled[b] = true;
+    int succ[2] = { G.blocks[b].next, G.blocks[b].taken };
+    for (int s=0; s<2; s++) {
+      if (succ[s] >= 0 && !sealed[succ[s]]) seal(succ[s]);
+    }
+  }
+  removeTrivialPhis();
+
+  for (size_t v=0; v<values.size(); v++) {
+    if ((PHI == values[v].I.op) && (values[v].same < 0)) phis_kept++;
+  }
+}
+
+/*
+  Seal block b if all its predecessors are filled.
+*/
+void ssa::seal(int b)
+{
+  for (size_t p=0; p<preds[b].size(); p++) {
+    if (preds[b][p] >= 0 && !filled[preds[b][p]]) return;
+  }
+  sealed[b] = true;
+  for (size_t i=0; i<incomplete[b].size(); i++) {
+    addPhiArgs(incomplete[b][i]);
+  }
+  incomplete[b].clear();
+}
+
+void ssa::fill(int b)
+{
+  struct entry {
+    int value;
+    int start;      /* where its run starts, or -1 if before the block */
+  };
+  std::vector<entry> stack;
+  for (int k=0; k<height[b]; k++) {
+    entry e = { readVar(nlocals + k, b), -1 };
+    stack.push_back(e);
+  }
+
+  const flowgraph::block &B = G.blocks[b];
+  int last_effect = -1;
+  int n = B.code.size();
+  stored[b].assign(n, -1);
+  for (int i=0; i<=n; i++) {
+    const instr &I = (i < n) ? B.code[i] : B.exit;
+    int pops, pushes;
+    stack_effect(I, pops, pushes);
+    std::vector<entry> in(stack.end() - pops, stack.end());
+    stack.resize(stack.size() - pops);
+
+    if (is_effect(I)) last_effect = i;
+    int start = pops ? in[0].start : i;
+    bool pure = (start >= 0) && (last_effect < start);
+
+    int v = -1;
+    switch (I.op) {
+      case OP_ICONST:
+      case OP_FCONST:
+          v = newValue(I, b, i, (OP_FCONST == I.op) ? 'F' : 'I');
+          break;
+
+      case OP_SCONST:
+      case OP_NEWARRAY:
+          v = newValue(I, b, i, 'A');
+          break;
+
+      case OP_LOAD: {
+          v = readVar(I.a, b);
+          int home = values[find(v)].home;
+          if ((home >= 0) && (home != I.a)) {
+            copy c = { b, i, v, home, readVar(home, b) };
+            copies.push_back(c);
+          }
+          break;
+      }
+
+      case OP_STORE: {
+          defs[b][I.a] = in[0].value;
+          stored[b][i] = in[0].value;
+          int r = find(in[0].value);
+          if (values[r].home < 0) values[r].home = I.a;
+          continue;
+      }
+
+      case OP_IINC: {
+          int old = readVar(I.a, b);
+          int delta = newValue(make_instr(OP_ICONST, I.b), b, -1, 'I');
+          v = newValue(make_instr(OP_IADD), b, -1, 'I');
+          values[v].args.push_back(old);
+          values[v].args.push_back(delta);
+          values[v].home = I.a;
+          defs[b][I.a] = v;
+          stored[b][i] = v;
+          continue;
+      }
+
+      case OP_GETSTATIC:
+          if (I.flags & FLAG_ARRAY) {
+            v = newValue(I, b, i, 'A');
+          } else {
+            v = newValue(I, b, i, kind_of(I.type));
+            int mem = readVar(memvar, b);
+            values[v].args.push_back(mem);
+          }
+          break;
+
+      case OP_ALOAD:
+          v = newValue(I, b, i, kind_of(I.type));
+          values[v].args.push_back(in[0].value);
+          values[v].args.push_back(in[1].value);
+          {
+            int mem = readVar(memvar, b);
+            values[v].args.push_back(mem);
+          }
+          break;
+
+      case OP_PUTSTATIC:
+      case OP_ASTORE:
+      case OP_INVOKESTATIC: {
+          /* The kind of what a call returns; 0 for void */
+          char kind = 0;
+          if ((OP_INVOKESTATIC == I.op) && I.desc) {
+            std::string params;
+            parse_descriptor(atom_table::name(I.desc), params, kind);
+            if ('V' == kind) kind = 0;
+          }
+          v = newValue(I, b, pushes ? i : -1, kind);
+          for (int k=0; k<pops; k++) values[v].args.push_back(in[k].value);
+          {
+            int mem = readVar(memvar, b);
+            values[v].args.push_back(mem);
+          }
+          defs[b][memvar] = v;
+          break;
+      }
+
+      case OP_DUP: {
+          stack.push_back(in[0]);
+          entry e = { in[0].value, i };
+          stack.push_back(e);
+          continue;
+      }
+
+      default:
+          if (is_arith(I.op)) {
+            char k = 'I';
+            for (int j=0; j<pops; j++) {
+              if ('F' == values[find(in[j].value)].kind) k = 'F';
+            }
+            v = newValue(I, b, i, k);
+            for (int j=0; j<pops; j++) values[v].args.push_back(in[j].value);
+            break;
+          }
+          if (I.is_cond_branch()) {
+            for (int j=0; j<pops; j++) branch_args[b].push_back(in[j].value);
+          }
+          continue;
+    }
+
+    if (!pushes) continue;
+    entry e = { v, start };
+    stack.push_back(e);
+    if (pure) {
+      run r = { b, start, i, v };
+      runs.push_back(r);
+    }
+  }
+
+  for (size_t k=0; k<stack.size(); k++) {
+    defs[b][nlocals + k] = stack[k].value;
+  }
+}
+
+int ssa::newValue(const instr &I, int b, int end, char kind)
+{
+  value V;
+  V.I = I;
+  V.block = b;
+  V.end = end;
+  V.home = -1;
+  V.same = -1;
+  V.kind = kind;
+  values.push_back(V);
+  made[b].push_back(values.size()-1);
+  values_made++;
+  return values.size()-1;
+}
+
+int ssa::find(int v)
+{
+  int r = v;
+  while (values[r].same >= 0) r = values[r].same;
+  while (values[v].same >= 0) {
+    int up = values[v].same;
+    values[v].same = r;
+    v = up;
+  }
+  return r;
+}
+
+int ssa::entryValue(int var)
+{
+  if (entries[var] < 0) {
+    char kind = (var < nlocals) ? slot_type[var] : 'I';
+    int v = newValue(make_instr(ENTRY, var), 0, -1, kind);
+    values[v].home = (var < nlocals) ? var : -1;
+    entries[var] = v;
+  }
+  return entries[var];
+}
+
+int ssa::readVar(int var, int b)
+{
+  if (b < 0) return entryValue(var);
+  if (defs[b][var] >= 0) return defs[b][var];
+  return readVarRec(var, b);
+}
+
+int ssa::readVarRec(int var, int b)
+{
+  int v;
+  if (!sealed[b]) {
+    v = newValue(make_instr(PHI, var), b, -1, (var < nlocals) ? slot_type[var] : 0);
+    values[v].home = (var < nlocals) ? var : -1;
+    incomplete[b].push_back(v);
+  } else if (1 == preds[b].size()) {
+    v = readVar(var, preds[b][0]);
+  } else {
+    v = newValue(make_instr(PHI, var), b, -1, (var < nlocals) ? slot_type[var] : 0);
+    values[v].home = (var < nlocals) ? var : -1;
+    defs[b][var] = v;
+    addPhiArgs(v);
+  }
+  defs[b][var] = v;
+  return v;
+}
+
+void ssa::addPhiArgs(int phi)
+{
+  int b = values[phi].block;
+  int var = values[phi].I.a;
+  for (size_t p=0; p<preds[b].size(); p++) {
+    int a = readVar(var, preds[b][p]);
+    values[phi].args.push_back(a);
+    if (0 == values[phi].kind) values[phi].kind = values[find(a)].kind;
+  }
+}
+
+/*
+  A phi whose arguments are all one value (or itself) is that value.
+  Removing one can make others trivial, so repeat until none change.
+*/
+void ssa::removeTrivialPhis()
+{
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t v=0; v<values.size(); v++) {
+      if ((PHI != values[v].I.op) || (values[v].same >= 0)) continue;
+      int only = -1;
+      bool trivial = true;
+      for (size_t j=0; j<values[v].args.size(); j++) {
+        int a = find(values[v].args[j]);
+        if (a == (int) v) continue;
+        if (only < 0) only = a;
+        else if (a != only) {
+          trivial = false;
+          break;
+        }
+      }
+      if (!trivial) continue;
+      if (only < 0) only = entryValue(values[v].I.a);
+      values[v].same = only;
+      changed = true;
+    }
+  }
+}
+
+/* ====================================================================== */
+/*
+  Sparse conditional constant propagation (Wegman and Zadeck).
+  Each value starts unknown and can only move down, to a constant
+  and then to "varies"; a block is looked at only once some edge
+  into it can be taken.  The blocks are swept until nothing changes.
+*/
+
+void ssa::propagate()
+{
+  int n = G.blocks.size();
+  state.assign(values.size(), 0);
+  constant.assign(values.size(), 0);
+  executable.assign(n, false);
+  edge.assign(n, std::vector<bool>());
+  for (int b=0; b<n; b++) edge[b].assign(preds[b].size(), false);
+  executable[0] = true;
+  edge[0][0] = true;
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t r=0; r<rpo.size(); r++) {
+      int b = rpo[r];
+      if (!executable[b]) continue;
+      for (size_t i=0; i<made[b].size(); i++) {
+        int v = made[b][i];
+        if (values[v].same >= 0) continue;
+        int c = 0;
+        int s = evaluate(v, c);
+        if ((1 == s) && (1 == state[v]) && (c != constant[v])) s = 2;
+        if (s <= state[v]) continue;
+        state[v] = s;
+        constant[v] = c;
+        changed = true;
+      }
+      int d = decide(b);
+      if (d & 1) markEdge(b, G.blocks[b].taken, changed);
+      if (d & 2) markEdge(b, G.blocks[b].next, changed);
+    }
+  }
+}
+
+/*
+  Lattice value of v from its arguments; the constant goes in c.
+*/
+int ssa::evaluate(int v, int &c)
+{
+  const value &V = values[v];
+  if (PHI == V.I.op) {
+    int result = 0;
+    for (size_t j=0; j<V.args.size(); j++) {
+      if (!edge[V.block][j]) continue;
+      int a = find(V.args[j]);
+      if (0 == state[a]) continue;
+      if (2 == state[a]) return 2;
+      if (0 == result) {
+        result = 1;
+        c = constant[a];
+      } else if (constant[a] != c) {
+        return 2;
+      }
+    }
+    return result;
+  }
+  if (OP_ICONST == V.I.op) {
+    c = V.I.a;
+    return 1;
+  }
+  if (!is_arith(V.I.op) || ('F' == V.kind)) return 2;
+
+  int x[2] = { 0, 0 };
+  bool unknown = false;
+  for (size_t j=0; j<V.args.size(); j++) {
+    int a = find(V.args[j]);
+    if (2 == state[a]) return 2;
+    if (0 == state[a]) unknown = true;
+    x[j] = constant[a];
+  }
+  if (unknown) return 0;
+  return fold(V.I.op, x[0], x[1], c) ? 1 : 2;
+}
+
+/*
+  Which ways out of block b can be taken: 1 for the branch, 2 for
+  falling through.
+*/
+int ssa::decide(int b)
+{
+  const flowgraph::block &B = G.blocks[b];
+  if (OP_NOP == B.exit.op) return 2;
+  if (OP_GOTO == B.exit.op) return 1;
+  if (!B.exit.is_cond_branch()) return 0;
+
+  int x[2] = { 0, 0 };
+  bool unknown = false;
+  for (size_t j=0; j<branch_args[b].size(); j++) {
+    int a = find(branch_args[b][j]);
+    if (2 == state[a]) return 3;
+    if (0 == state[a]) unknown = true;
+    x[j] = constant[a];
+  }
+  if (unknown) return 0;
+  return branch_taken(B.exit.op, x[0], x[1]) ? 1 : 2;
+}
+
+void ssa::markEdge(int from, int to, bool &changed)
+{
+  for (size_t j=0; j<preds[to].size(); j++) {
+    if (preds[to][j] != from || edge[to][j]) continue;
+    edge[to][j] = true;
+    changed = true;
+  }
+  executable[to] = true;
+}
+
+/* ====================================================================== */
+
+/*
+  Global value numbering.  The dominator tree is walked from the
+  entry with a table of the expressions seen on the way down, so
+  an expression found in the table is computed by a dominating
+  value.  Loads include the memory state in their key, so a store
+  or call in between makes them differ.
+*/
+void ssa::number()
+{
+  G.dominators(idom);
+  int n = G.blocks.size();
+  std::vector< std::vector<int> > children(n);
+  for (size_t r=1; r<rpo.size(); r++) {
+    children[idom[rpo[r]]].push_back(rpo[r]);
+  }
+
+  vn.resize(values.size());
+  for (size_t v=0; v<values.size(); v++) vn[v] = v;
+  leader.assign(values.size(), -1);
+
+  typedef std::map< std::vector<int>, int > table_t;
+  table_t table;
+  std::map<int, int> constants;
+  std::vector<table_t::iterator> added;
+
+  /* Blocks to visit; -1 - mark means leave a block, dropping its entries */
+  std::vector<int> work;
+  work.push_back(0);
+  while (!work.empty()) {
+    int b = work.back();
+    work.pop_back();
+    if (b < 0) {
+      size_t mark = -1 - b;
+      while (added.size() > mark) {
+        table.erase(added.back());
+        added.pop_back();
+      }
+      continue;
+    }
+    work.push_back(-1 - (int) added.size());
+    for (size_t c=0; c<children[b].size(); c++) work.push_back(children[b][c]);
+
+    for (int pass=0; pass<2; pass++) {
+      for (size_t i=0; i<made[b].size(); i++) {
+        int v = made[b][i];
+        const value &V = values[v];
+        if ((PHI == V.I.op) != (0 == pass)) continue;
+        if (V.same >= 0) continue;
+
+        if ((1 == state[v]) && ('I' == V.kind)) {
+          std::map<int,int>::iterator k = constants.find(constant[v]);
+          if (k == constants.end()) constants[constant[v]] = v;
+          else vn[v] = k->second;
+          continue;
+        }
+        if (PHI == V.I.op) {
+          int first = V.args.empty() ? v : vn[find(V.args[0])];
+          bool all = true;
+          for (size_t j=1; j<V.args.size(); j++) {
+            if (vn[find(V.args[j])] != first) all = false;
+          }
+          if (all) vn[v] = first;
+          continue;
+        }
+        if (!is_arith(V.I.op) && (OP_ALOAD != V.I.op) && (OP_GETSTATIC != V.I.op)
+          && (OP_FCONST != V.I.op) && (OP_SCONST != V.I.op)) continue;
+
+        std::vector<int> key;
+        key.push_back(V.I.op);
+        key.push_back(V.I.type);
+        key.push_back(V.I.flags);
+        key.push_back(V.I.a);
+        key.push_back(V.I.b);
+        key.push_back(V.I.sym);
+        for (size_t j=0; j<V.args.size(); j++) key.push_back(vn[find(V.args[j])]);
+        if (commutative(V.I.op) && (key[6] > key[7])) std::swap(key[6], key[7]);
+
+        std::pair<table_t::iterator, bool> ins = table.insert(std::make_pair(key, v));
+        if (ins.second) {
+          added.push_back(ins.first);
+          continue;
+        }
+        int L = ins.first->second;
+        vn[v] = vn[L];
+        if (values[L].end >= 0) leader[v] = L;
+      }
+    }
+  }
+}
+
+/* ====================================================================== */
+
+/*
+  Replace the run start..end of a block with one instruction.
+*/
+enum {
+    USE_CONSTANT,   /* iconst */
+    USE_DUP,        /* dup, right after the leader */
+    USE_HOME,       /* load the local the leader was stored in */
+    USE_TEMP        /* load a new local, stored into after the leader */
+};
+
+struct edit {
+    int start;
+    int end;
+    int how;
+    int constant;
+    int leader;
+};
+
+/*
+  Outermost first.
+*/
+static bool edit_before(const edit &x, const edit &y)
+{
+  if (x.start != y.start) return x.start < y.start;
+  return x.end > y.end;
+}
+
+void ssa::rewrite(std::vector<instr> &code)
+{
+  int n = G.blocks.size();
+  std::vector< std::vector<edit> > edits(n);
+
+  /*
+    Each redundant push saves all but one of its instructions.
+    One right after its leader becomes a dup, and one where the
+    local the leader was stored in still holds it loads that.
+    Any other is a load from a new local, and the leader then
+    costs a dup and a store, so it is only worth it if the
+    savings are more than that.
+  */
+  std::vector<int> gain(values.size(), 0);
+  std::vector<bool> far(values.size(), false);
+  std::vector<char> how(runs.size(), USE_TEMP);
+  for (size_t r=0; r<runs.size(); r++) {
+    const run &R = runs[r];
+    int L = leader[find(R.value)];
+    if (L < 0) continue;
+    gain[L] += R.end - R.start;
+    int x = values[L].home;
+    if (adjacent(L, R.block, R.start)) {
+      how[r] = USE_DUP;
+    } else if ((x >= 0) && (x < nlocals) && (slot_type[x] == values[L].kind)
+            && (valueAt(x, R.block, R.start) == L)) {
+      how[r] = USE_HOME;
+    } else {
+      far[L] = true;
+    }
+  }
+
+  for (size_t r=0; r<runs.size(); r++) {
+    const run &R = runs[r];
+    if (!executable[R.block]) continue;
+    int v = find(R.value);
+    const std::vector<instr> &C = G.blocks[R.block].code;
+    if ((1 == state[v]) && ('I' == values[v].kind)) {
+      if ((R.start == R.end) && (OP_ICONST == C[R.start].op)) continue;
+      edit e = { R.start, R.end, USE_CONSTANT, constant[v], -1 };
+      edits[R.block].push_back(e);
+      continue;
+    }
+    int L = leader[v];
+    if ((L < 0) || ('A' == values[v].kind)) continue;
+    if (gain[L] <= (far[L] ? 2 : 0)) continue;
+    if (R.start == R.end) continue;
+    edit e = { R.start, R.end, how[r], 0, L };
+    edits[R.block].push_back(e);
+  }
+
+  /*
+    Keep the outermost of nested edits, and none that would
+    remove the push of a leader.
+  */
+  std::vector<bool> is_leader(values.size(), false);
+  std::vector< std::vector<int> > leaders_at(n);
+  for (int b=0; b<n; b++) {
+    for (size_t e=0; e<edits[b].size(); e++) {
+      int L = edits[b][e].leader;
+      if (L < 0 || is_leader[L] || (USE_TEMP != edits[b][e].how)) continue;
+      is_leader[L] = true;
+      leaders_at[values[L].block].push_back(values[L].end);
+    }
+  }
+  std::vector<int> temp(values.size(), -1);
+  std::vector<atom_id> temp_name(values.size(), 0);
+  int temps = 0;
+  for (int b=0; b<n; b++) {
+    std::vector<edit> &E = edits[b];
+    std::vector<edit> kept;
+    std::sort(E.begin(), E.end(), edit_before);
+    int covered = -1;
+    for (size_t i=0; i<E.size(); i++) {
+      if (E[i].start <= covered) continue;
+      bool holds_leader = false;
+      for (size_t l=0; l<leaders_at[b].size(); l++) {
+        int p = leaders_at[b][l];
+        if ((p >= E[i].start) && (p <= E[i].end)) holds_leader = true;
+      }
+      if (holds_leader) continue;
+      kept.push_back(E[i]);
+      covered = E[i].end;
+      if (USE_CONSTANT == E[i].how) {
+        constants_folded++;
+        continue;
+      }
+      redundant++;
+      int L = E[i].leader;
+      if ((temp[L] >= 0) || (USE_TEMP != E[i].how)) continue;
+      char name[20];
+      snprintf(name, sizeof(name), "$t%d", temps);
+      temp[L] = nlocals + temps++;
+      temp_name[L] = atom_table::intern(name);
+    }
+    E.swap(kept);
+  }
+
+  /*
+    Loads of copies.
+  */
+  for (size_t c=0; c<copies.size(); c++) {
+    const copy &K = copies[c];
+    if (!executable[K.block]) continue;
+    if (find(K.value) != find(K.there)) continue;
+    instr &I = G.blocks[K.block].code[K.index];
+    if (slot_type[K.from] != slot_type[I.a]) continue;
+    I.a = K.from;
+    I.sym = slot_name[K.from];
+    copies_propagated++;
+  }
+
+  /*
+    Put the new code together, block by block.
+  */
+  bool folded = false;
+  for (int b=0; b<n; b++) {
+    flowgraph::block &B = G.blocks[b];
+    if (!B.live) continue;
+    std::vector<int> store_after(B.code.size(), -1);
+    for (size_t v=0; v<made[b].size(); v++) {
+      int L = made[b][v];
+      if (temp[L] >= 0) store_after[values[L].end] = L;
+    }
+    std::vector<instr> out;
+    out.reserve(B.code.size());
+    size_t e = 0;
+    for (size_t i=0; i<B.code.size(); i++) {
+      if ((e < edits[b].size()) && (edits[b][e].start == (int) i)) {
+        const edit &E = edits[b][e];
+        int L = E.leader;
+        switch (E.how) {
+          case USE_CONSTANT:
+              out.push_back(make_instr(OP_ICONST, E.constant));
+              break;
+          case USE_DUP:
+              out.push_back(make_instr(OP_DUP));
+              break;
+          case USE_HOME: {
+              int x = values[L].home;
+              out.push_back(make_instr(OP_LOAD, x, slot_type[x], slot_name[x]));
+              break;
+          }
+          default:
+              out.push_back(make_instr(OP_LOAD, temp[L], values[L].kind, temp_name[L]));
+        }
+        i = E.end;
+        e++;
+        continue;
+      }
+      out.push_back(B.code[i]);
+      if (store_after[i] >= 0) {
+        int L = store_after[i];
+        out.push_back(make_instr(OP_DUP));
+        out.push_back(make_instr(OP_STORE, temp[L], values[L].kind, temp_name[L]));
+      }
+    }
+
+    /*
+      Branches on constants: pop the operands and go the one way.
+    */
+    if (executable[b] && B.exit.is_cond_branch()) {
+      int d = decide(b);
+      if ((1 == d) || (2 == d)) {
+        for (size_t j=0; j<branch_args[b].size(); j++) out.push_back(make_instr(OP_POP));
+        if (1 == d) {
+          B.exit.op = OP_GOTO;
+          B.next = -1;
+        } else {
+          B.exit = make_instr(OP_NOP);
+          B.taken = -1;
+        }
+        branches_folded++;
+        folded = true;
+      }
+    }
+    B.code.swap(out);
+  }
+
+  deadStores();
+  G.removeUnreachable();
+  G.layout();
+  G.write(code);
+  if (folded) flowgraph::optimize(code);
+}
+
+/*
+  Value of local var just before instruction index of block b,
+  or -1 if that can't be told without a new phi.
+*/
+int ssa::valueAt(int var, int b, int index)
+{
+  const std::vector<instr> &C = G.blocks[b].code;
+  for (int i=index; i-- > 0; ) {
+    if ((stored[b][i] >= 0) && (C[i].a == var)) return find(stored[b][i]);
+  }
+  std::vector<int> memo(G.blocks.size(), -3);
+  return startValue(var, b, memo);
+}
+
+/*
+  Value of var on entry to block b, if all its predecessors agree.
+  memo holds what is known for each block: -3 for nothing yet, -2
+  while it is being worked out (a loop, given up on), -1 for no one value.
+*/
+int ssa::startValue(int var, int b, std::vector<int> &memo)
+{
+  if (memo[b] >= -2) return (memo[b] < 0) ? -1 : memo[b];
+  memo[b] = -2;
+  int v = -1;
+  for (size_t j=0; j<preds[b].size(); j++) {
+    int p = preds[b][j];
+    int w;
+    if (p < 0) {
+      w = (entries[var] >= 0) ? find(entries[var]) : -1;
+    } else if (defs[p][var] >= 0) {
+      w = find(defs[p][var]);
+    } else {
+      w = startValue(var, p, memo);
+    }
+    if ((w < 0) || ((v >= 0) && (w != v))) {
+      v = -1;
+      break;
+    }
+    v = w;
+  }
+  memo[b] = v;
+  return v;
+}
+
+/*
+  True if a push starting at index start of block b comes
+  right after the push of L.
+*/
+bool ssa::adjacent(int L, int b, int start) const
+{
+  return (values[L].block == b) && (values[L].end + 1 == start);
+}
+
+/*
+  Remove stores to locals that are not read before they are
+  stored again or the method returns.
+*/
+void ssa::deadStores()
+{
+  int slots = nlocals;
+  for (size_t b=0; b<G.blocks.size(); b++) {
+    const std::vector<instr> &C = G.blocks[b].code;
+    for (size_t i=0; i<C.size(); i++) {
+      if ((OP_LOAD == C[i].op) || (OP_STORE == C[i].op) || (OP_IINC == C[i].op)) {
+        if (C[i].a + 1 > slots) slots = C[i].a + 1;
+      }
+    }
+  }
+  G.liveness(slots);
+
+  /* Blocks a folded branch no longer goes to are left to removeUnreachable() */
+  std::vector<int> reached;
+  G.reversePostorder(reached);
+  for (size_t r=0; r<reached.size(); r++) {
+    flowgraph::block &B = G.blocks[reached[r]];
+    if (!B.live) continue;
+    std::vector<bool> live = B.live_out;
+    std::vector<bool> dead(B.code.size(), false);
+    bool any = false;
+    for (size_t i=B.code.size(); i-- > 0; ) {
+      const instr &I = B.code[i];
+      if ((OP_STORE == I.op) || (OP_IINC == I.op)) {
+        if (!live[I.a]) {
+          dead[i] = true;
+          any = true;
+          continue;
+        }
+        if (OP_STORE == I.op) live[I.a] = false;
+      }
+      if (OP_LOAD == I.op) live[I.a] = true;
+    }
+    if (!any) continue;
+
+    std::vector<instr> out;
+    for (size_t i=0; i<B.code.size(); i++) {
+      if (!dead[i]) {
+        out.push_back(B.code[i]);
+        continue;
+      }
+      stores_removed++;
+      if (OP_IINC == B.code[i].op) continue;
+      if (!out.empty() && (OP_DUP == out.back().op)) out.pop_back();
+      else out.push_back(make_instr(OP_POP));
+    }
+    B.code.swap(out);
+  }
+}
+
+/* ====================================================================== */
+
+void ssa::optimize(std::vector<instr> &code, int params)
+{
+  ssa S(code, params);
+  if (!S.ok()) return;
+  S.propagate();
+  S.number();
+  S.rewrite(code);
+}
+
+void ssa::showStats(std::ostream &s)
+{
+  s << "SSA\n";
+  s << "\tvalues: " << values_made << "\n";
+  s << "\tphis: " << phis_kept << "\n";
+  s << "\tconstants folded: " << constants_folded << "\n";
+  s << "\tbranches folded: " << branches_folded << "\n";
+  s << "\tredundant expressions: " << redundant << "\n";
+  s << "\tcopies propagated: " << copies_propagated << "\n";
+  s << "\tdead stores removed: " << stores_removed << "\n";
+}
+
+void ssa::clearStats()
+{
+  values_made = 0;
+  phis_kept = 0;
+  constants_folded = 0;
+  branches_folded = 0;
+  redundant = 0;
+  copies_propagated = 0;
+  stores_removed = 0;
+}
@@ -0,0 +1,179 @@
+
+#ifndef SSA_H
+#define SSA_H
+
+#include <iostream>
+#include <vector>
+#include <map>
+
+#include "instr.h"
+#include "cfg.h"
+
+/*
+  SSA form of one method, built over its stack code.
+
+  Every value the code computes (each push onto the operand stack,
+  and each iinc) is numbered.  Locals, operand stack entries that
+  are still there at the end of a block, and memory (fields and
+  array elements, changed by stores and calls) are the variables:
+  a load gets whatever value reaches it, and a phi is made where
+  paths with different values join.
+
+  The form is only used to learn about the code, which is then
+  rewritten in place; phis never become code.  Each push remembers
+  the run of instructions that computed it, so that
+    - a value proved constant (sparse conditional constant
+      propagation) is computed by a single iconst instead,
+      and a branch on constants becomes a goto or nothing;
+    - a value computed again on every path to it (global value
+      numbering over the dominator tree) is loaded from a new
+      local, which the first computation stores into;
+    - a load of a local that only holds a copy of another
+      local loads the original instead;
+  after which stores that are never read are removed.
+*/
+
+class ssa {
+  public:
+    enum {
+      PHI = OP_COUNT,   /* a: variable; one arg per predecessor */
+      ENTRY             /* a: variable; its value when the method starts */
+    };
+
+    struct value {
+        instr I;            /* what computes it */
+        int block;
+        std::vector<int> args;  /* loads have the memory state last */
+        int end;            /* index in the block of the instruction that pushes it, or -1 */
+        int home;           /* variable it was first stored in, or -1 */
+        int same;           /* a phi that turned out to be this value, or -1 */
+        char kind;          /* 'I', 'F', or 'A' for array references */
+    };
+
+    /*
+      One push: instructions start..end of a block leave value on the stack.
+    */
+    struct run {
+        int block;
+        int start;
+        int end;
+        int value;
+    };
+
+    /*
+      A load that might be redirected to another local.
+    */
+    struct copy {
+        int block;
+        int index;
+        int value;
+        int from;           /* the other local */
+        int there;          /* value of that local at the load */
+    };
+
+  public:
+    ssa(const std::vector<instr> &code, int params);
+
+    /*
+      False if the code could not be put in SSA form
+      (see flowgraph::ok; also inconsistent stack heights,
+      a local with no slot, or a switch).
+    */
+    inline bool ok() const { return good; }
+
+    /*
+      Sparse conditional constant propagation.
+    */
+    void propagate();
+
+    /*
+      Value numbering along the dominator tree; constants from
+      propagate() are numbered by value.
+    */
+    void number();
+
+    /*
+      Rewrite the code from what propagate() and number() found,
+      and drop stores that nothing reads.
+    */
+    void rewrite(std::vector<instr> &code);
+
+    /*
+      All of the above, on one method's code in place.
+        @param  params    Number of parameter slots
+    */
+    static void optimize(std::vector<instr> &code, int params);
+
+    /*
+      Show what the passes did, for -s.
+    */
+    static void showStats(std::ostream &s);
+
+    /*
+      Start the counts for showStats() over.
+    */
+    static void clearStats();
+
+  private:
+    bool good;
+    flowgraph G;
+    int params;
+    int nlocals;        /* local slots; then operand stack entries; then memory */
+    int memvar;
+
+    std::vector<value> values;
+    std::vector<run> runs;
+    std::vector<copy> copies;
+
+    /* Per block */
+    std::vector<int> rpo;               /* live blocks, reverse postorder */
+    std::vector< std::vector<int> > preds;  /* -1 is the method entry */
+    std::vector<int> height;            /* operand stack height on entry */
+    std::vector< std::vector<int> > defs;   /* current value of each variable */
+    std::vector< std::vector<int> > made;   /* values made there, phis first */
+    std::vector< std::vector<int> > incomplete;
+    std::vector<bool> filled;
+    std::vector<bool> sealed;
+    std::vector< std::vector<int> > branch_args;
+    std::vector< std::vector<int> > stored;   /* value each store or iinc puts in its local */
+    std::vector<int> idom;
+
+    std::vector<int> entries;           /* ENTRY value of each variable */
+    std::vector<char> slot_type;
+    std::vector<atom_id> slot_name;
+
+    /* From propagate() */
+    std::vector<char> state;            /* 0: unknown yet, 1: constant, 2: varies */
+    std::vector<int> constant;
+    std::vector<bool> executable;
+    std::vector< std::vector<bool> > edge;  /* parallel to preds */
+
+    /* From number() */
+    std::vector<int> vn;
+    std::vector<int> leader;            /* dominating equal value with a push, or -1 */
+
+  private:
+    bool stackHeights();
+    void order();
+    void build();
+    void fill(int b);
+    void seal(int b);
+
+    int newValue(const instr &I, int b, int end, char kind);
+    int find(int v);
+    int entryValue(int var);
+    int readVar(int var, int b);
+    int readVarRec(int var, int b);
+    void addPhiArgs(int phi);
+    void removeTrivialPhis();
+
+    int evaluate(int v, int &c);
+    int decide(int b);
+    void markEdge(int from, int to, bool &changed);
+    bool adjacent(int L, int b, int start) const;
+    int valueAt(int var, int b, int index);
+    int startValue(int var, int b, std::vector<int> &memo);
+    void deadStores();
+};
+
+#endif
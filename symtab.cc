@@ -0,0 +1,98 @@
+
+#include "symtab.h"
+#include "parsehelp.h"
+
+symtab::symtab()
+{
+  slots.resize(64);
+  for (unsigned i=0; i<slots.size(); i++) slots[i].name = 0;
+  count = 0;
+}
+
+void symtab::enter()
+{
+  marks.push_back(log.size());
+}
+
+void symtab::leave()
+{
+  if (marks.empty()) return;
+  unsigned mark = marks.back();
+  marks.pop_back();
+
+  while (log.size() > mark) {
+    const undo &U = log.back();
+    if (U.sym) {
+      slot &S = slots[probe(U.name)];
+      S.sym = U.sym;
+      S.depth = U.depth;
+    } else {
+      remove(U.name);
+    }
+    log.pop_back();
+  }
+}
+
+void symtab::insert(identlist* sym)
+{
+  unsigned i = probe(sym->name);
+  undo U;
+  U.name = sym->name;
+  if (slots[i].name) {
+    U.sym = slots[i].sym;
+    U.depth = slots[i].depth;
+  } else {
+    U.sym = 0;
+    U.depth = 0;
+    slots[i].name = sym->name;
+    count++;
+  }
+  slots[i].sym = sym;
+  slots[i].depth = depth();
+
+  /* Nothing to undo for the outermost scope */
+  if (depth()) log.push_back(U);
+
+  if (2*count > slots.size()) grow();
+}
+
+/*
+  Delete a name, shifting later members of its probe
+  sequence back so that no lookup runs into a hole.
+*/
+void symtab::remove(atom_id name)
+{
+  unsigned mask = slots.size() - 1;
+  unsigned i = probe(name);
+  if (0==slots[i].name) return;
+  count--;
+
+  unsigned j = i;
+  for (;;) {
+    slots[i].name = 0;
+    for (;;) {
+      j = (j+1) & mask;
+      if (0==slots[j].name) return;
+      unsigned home = (slots[j].name * 2654435761u) & mask;
+      /* Can slot j move to the hole at i? Only if home is not in (i, j] */
+      if ( (i <= j) ? ((i < home) && (home <= j)) : ((i < home) || (home <= j)) ) {
+        continue;
+      }
+      break;
+    }
+    slots[i] = slots[j];
+    i = j;
+  }
+}
+
+void symtab::grow()
+{
+  std::vector<slot> old;
+  old.swap(slots);
+  slots.resize(2*old.size());
+  for (unsigned i=0; i<slots.size(); i++) slots[i].name = 0;
+  for (unsigned i=0; i<old.size(); i++) {
+    if (0==old[i].name) continue;
+    slots[probe(old[i].name)] = old[i];
+  }
+}
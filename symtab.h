@@ -0,0 +1,90 @@
+
+#ifndef SYMTAB_H
+#define SYMTAB_H
+
+#include <vector>
+
+#include "atoms.h"
+
+struct identlist;
+
+/*
+  Scoped symbol table.
+
+  Open addressing (linear probing) keyed by atom, so every lookup
+  is a hash and a few integer compares.  Each name maps to its
+  innermost visible declaration.  Declarations that shadow or add
+  a name are recorded in an undo log, and leaving a scope replays
+  the log back to the mark taken when the scope was entered.
+*/
+
+class symtab {
+    struct slot {
+        atom_id name;     /* 0 means empty */
+        identlist* sym;
+        int depth;        /* scope depth of sym */
+    };
+
+    struct undo {
+        atom_id name;
+        identlist* sym;   /* previous declaration, or 0 if none */
+        int depth;
+    };
+
+  private:
+    std::vector<slot> slots;
+    std::vector<undo> log;
+    std::vector<unsigned> marks;  /* log size when each scope was entered */
+    unsigned count;               /* occupied slots */
+
+  public:
+    symtab();
+
+    /*
+      Open a new (nested) scope.
+    */
+    void enter();
+
+    /*
+      Close the innermost scope, forgetting everything declared in it.
+    */
+    void leave();
+
+    /*
+      Current nesting depth; 0 is the outermost scope.
+    */
+    inline int depth() const { return marks.size(); }
+
+    /*
+      Innermost visible declaration of name, or 0.
+    */
+    inline identlist* find(atom_id name) const {
+      const slot &S = slots[probe(name)];
+      return S.name ? S.sym : 0;
+    }
+
+    /*
+      Declaration of name in the innermost scope only, or 0.
+    */
+    inline identlist* findLocal(atom_id name) const {
+      const slot &S = slots[probe(name)];
+      return (S.name && S.depth == depth()) ? S.sym : 0;
+    }
+
+    /*
+      Declare sym (under sym->name) in the innermost scope.
+    */
+    void insert(identlist* sym);
+
+  private:
+    inline unsigned probe(atom_id name) const {
+      unsigned mask = slots.size() - 1;
+      unsigned i = (name * 2654435761u) & mask;
+      while (slots[i].name && slots[i].name != name) i = (i+1) & mask;
+      return i;
+    }
+    void remove(atom_id name);
+    void grow();
+};
+
+#endif
@@ -0,0 +1,27 @@
+/*
+  Type errors, for checking that the messages come out the same
+  whichever thread compiles the file.
+*/
+
+int g;
+float f;
+
+int ok(int x)
+{
+  return x + g;
+}
+
+int bad(int x)
+{
+  int a[4];
+  x = f;
+  x = a;
+  g = x[2];
+  return y;
+}
+
+void also(int x)
+{
+  x = ok(x, 1);
+  return x;
+}
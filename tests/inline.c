@@ -0,0 +1,99 @@
+/*
+  Inlining small functions: arguments in order, the callee's own
+  locals, more than one return, globals, calls inside loops and
+  inside other inlined functions, and recursion, which stays a call.
+*/
+
+int putchar(int c);
+
+int g;
+
+void print(int x)
+{
+  if (x < 0) {
+    putchar(45);
+    x = -x;
+  }
+  if (x >= 10) print(x / 10);
+  putchar(48 + x % 10);
+}
+
+void space()
+{
+  putchar(32);
+}
+
+int sub(int x, int y)
+{
+  return x - y;
+}
+
+int sign(int x)
+{
+  if (x < 0) return -1;
+  if (x > 0) return 1;
+  return 0;
+}
+
+int twice(int x)
+{
+  int t;
+  t = x + x;
+  return t;
+}
+
+int quad(int x)
+{
+  int t;
+  t = twice(x);
+  t = twice(t);
+  return t;
+}
+
+void count()
+{
+  g = g + 1;
+}
+
+int fact(int n)
+{
+  if (n <= 1) return 1;
+  return n * fact(n - 1);
+}
+
+int main()
+{
+  int i;
+  int r;
+  int s;
+  r = sub(10, 3);
+  print(r);
+  space();
+  r = sign(-5);
+  print(r);
+  space();
+  r = sign(0);
+  print(r);
+  space();
+  r = sign(8);
+  print(r);
+  space();
+  r = quad(7);
+  print(r);
+  putchar(10);
+  g = 0;
+  s = 0;
+  for (i = 0; i < 6; i++) {
+    count();
+    r = sub(i, 2);
+    s = s * 2 + r;
+  }
+  print(g);
+  space();
+  print(s);
+  space();
+  r = fact(6);
+  print(r);
+  putchar(10);
+  return 0;
+}
@@ -0,0 +1,322 @@
+/* C code for tests/inline.c, from mycc */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef union { int32_t i; float f; void* p; } value;
+static const value mycc_zero;
+
+static inline int32_t mycc_add(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a + (uint32_t) b); }
+static inline int32_t mycc_sub(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a - (uint32_t) b); }
+static inline int32_t mycc_mul(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a * (uint32_t) b); }
+static inline int32_t mycc_neg(int32_t a) { return (int32_t) (0u - (uint32_t) a); }
+
+static inline void mycc_throw(const char* what)
+{
+  fprintf(stderr, "Exception: %s\n", what);
+  exit(1);
+}
+
+static inline int32_t mycc_div(int32_t a, int32_t b)
+{
+  if (0 == b) mycc_throw("java.lang.ArithmeticException: / by zero");
+  return (-1 == b) ? mycc_neg(a) : a / b;
+}
+
+static inline int32_t mycc_rem(int32_t a, int32_t b)
+{
+  if (0 == b) mycc_throw("java.lang.ArithmeticException: / by zero");
+  return (-1 == b) ? 0 : a % b;
+}
+
+/* Arrays and strings have their length in the word before element 0 */
+static inline void* mycc_newarray(int32_t n, size_t size)
+{
+  if (n < 0) mycc_throw("java.lang.NegativeArraySizeException");
+  int32_t* p = calloc(1, sizeof(int32_t) + (size_t) n * size);
+  if (0 == p) mycc_throw("java.lang.OutOfMemoryError");
+  p[0] = n;
+  return p + 1;
+}
+
+static inline int32_t mycc_index(const void* p, int32_t i)
+{
+  if ((uint32_t) i >= (uint32_t) ((const int32_t*) p)[-1])
+    mycc_throw("java.lang.ArrayIndexOutOfBoundsException");
+  return i;
+}
+
+static int32_t g_g = 0;
+void f_print(value l0);
+void f_space(void);
+value f_sub(value l0, value l1);
+value f_sign(value l0);
+value f_twice(value l0);
+value f_quad(value l0);
+void f_count(void);
+value f_fact(value l0);
+value f_main(void);
+
+void f_print(value l0)
+{
+  value s0;
+  value s1;
+  value s2;
+  s0 = l0;
+  s1.i = 0;
+  if (s0.i >= s1.i) goto L1;
+#line 14 "tests/inline.c"
+  s0.i = 45;
+  s0.i = putchar(s0.i);
+#line 15 "tests/inline.c"
+  s0 = l0;
+  s0.i = mycc_neg(s0.i);
+  l0 = s0;
+ L1:;
+#line 17 "tests/inline.c"
+  s0 = l0;
+  s1.i = 10;
+  if (s0.i < s1.i) goto L2;
+#line 17 "tests/inline.c"
+  s0 = l0;
+  s1.i = 10;
+  s0.i = mycc_div(s0.i, s1.i);
+  f_print(s0);
+ L2:;
+#line 18 "tests/inline.c"
+#line 18 "tests/inline.c"
+  s0.i = 48;
+  s1 = l0;
+  s2.i = 10;
+  s1.i = mycc_rem(s1.i, s2.i);
+  s0.i = mycc_add(s0.i, s1.i);
+  s0.i = putchar(s0.i);
+  return;
+}
+
+void f_space(void)
+{
+  value s0;
+#line 23 "tests/inline.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+  return;
+}
+
+value f_sub(value l0, value l1)
+{
+  value s0;
+  value s1;
+#line 28 "tests/inline.c"
+  s0 = l0;
+  s1 = l1;
+  s0.i = mycc_sub(s0.i, s1.i);
+  return s0;
+}
+
+value f_sign(value l0)
+{
+  value s0;
+  value s1;
+  s0 = l0;
+  s1.i = 0;
+  if (s0.i >= s1.i) goto L1;
+#line 33 "tests/inline.c"
+  s0.i = -1;
+  return s0;
+ L1:;
+#line 34 "tests/inline.c"
+  s0 = l0;
+  s1.i = 0;
+  if (s0.i <= s1.i) goto L2;
+#line 34 "tests/inline.c"
+  s0.i = 1;
+  return s0;
+ L2:;
+#line 35 "tests/inline.c"
+#line 35 "tests/inline.c"
+  s0.i = 0;
+  return s0;
+}
+
+value f_twice(value l0)
+{
+  value s0;
+  value s1;
+#line 41 "tests/inline.c"
+  s0 = l0;
+  s1 = l0;
+  s0.i = mycc_add(s0.i, s1.i);
+  l0 = s0;
+#line 42 "tests/inline.c"
+  s0 = l0;
+  return s0;
+}
+
+value f_quad(value l0)
+{
+  value s0;
+  value s1;
+#line 48 "tests/inline.c"
+  s0 = l0;
+  s1 = l0;
+  s0.i = mycc_add(s0.i, s1.i);
+  l0 = s0;
+#line 49 "tests/inline.c"
+  s0 = l0;
+  s1 = l0;
+  s0.i = mycc_add(s0.i, s1.i);
+  l0 = s0;
+#line 50 "tests/inline.c"
+  s0 = l0;
+  return s0;
+}
+
+void f_count(void)
+{
+  value s0;
+  value s1;
+#line 55 "tests/inline.c"
+  s0.i = g_g;
+  s1.i = 1;
+  s0.i = mycc_add(s0.i, s1.i);
+  s1 = s0;
+  g_g = s1.i;
+  return;
+}
+
+value f_fact(value l0)
+{
+  value s0;
+  value s1;
+  value s2;
+  s0 = l0;
+  s1.i = 1;
+  if (s0.i > s1.i) goto L1;
+#line 60 "tests/inline.c"
+  s0.i = 1;
+  return s0;
+ L1:;
+#line 61 "tests/inline.c"
+#line 61 "tests/inline.c"
+  s0 = l0;
+  s1 = l0;
+  s2.i = 1;
+  s1.i = mycc_sub(s1.i, s2.i);
+  s1 = f_fact(s1);
+  s0.i = mycc_mul(s0.i, s1.i);
+  return s0;
+}
+
+value f_main(void)
+{
+  value l0 = mycc_zero;
+  value l1 = mycc_zero;
+  value l2 = mycc_zero;
+  value s0;
+  value s1;
+#line 69 "tests/inline.c"
+#line 70 "tests/inline.c"
+  s0.i = 7;
+  f_print(s0);
+#line 71 "tests/inline.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 72 "tests/inline.c"
+#line 73 "tests/inline.c"
+  s0.i = -1;
+  f_print(s0);
+#line 74 "tests/inline.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 75 "tests/inline.c"
+#line 76 "tests/inline.c"
+  s0.i = 0;
+  f_print(s0);
+#line 77 "tests/inline.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 78 "tests/inline.c"
+#line 79 "tests/inline.c"
+  s0.i = 1;
+  f_print(s0);
+#line 80 "tests/inline.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 81 "tests/inline.c"
+#line 82 "tests/inline.c"
+  s0.i = 28;
+  f_print(s0);
+#line 83 "tests/inline.c"
+  s0.i = 10;
+  s0.i = putchar(s0.i);
+#line 84 "tests/inline.c"
+  s0.i = 0;
+  s1 = s0;
+  g_g = s1.i;
+#line 85 "tests/inline.c"
+  s0.i = 0;
+  l2 = s0;
+  s0.i = 0;
+  l0 = s0;
+  goto L2;
+ L1:;
+#line 87 "tests/inline.c"
+  s0.i = g_g;
+  s1.i = 1;
+  s0.i = mycc_add(s0.i, s1.i);
+  s1 = s0;
+  g_g = s1.i;
+#line 88 "tests/inline.c"
+  s0 = l0;
+  s1.i = 2;
+  s0.i = mycc_sub(s0.i, s1.i);
+  l1 = s0;
+#line 89 "tests/inline.c"
+  s0 = l2;
+  s1.i = 2;
+  s0.i = mycc_mul(s0.i, s1.i);
+  s1 = l1;
+  s0.i = mycc_add(s0.i, s1.i);
+  l2 = s0;
+  l0.i = mycc_add(l0.i, 1);
+ L2:;
+  s0 = l0;
+  s1.i = 6;
+  if (s0.i < s1.i) goto L1;
+#line 90 "tests/inline.c"
+#line 91 "tests/inline.c"
+  s0.i = g_g;
+  f_print(s0);
+#line 92 "tests/inline.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 93 "tests/inline.c"
+  s0 = l2;
+  f_print(s0);
+#line 94 "tests/inline.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 95 "tests/inline.c"
+  s0.i = 6;
+  s0 = f_fact(s0);
+  l1 = s0;
+#line 96 "tests/inline.c"
+  s0 = l1;
+  f_print(s0);
+#line 97 "tests/inline.c"
+  s0.i = 10;
+  s0.i = putchar(s0.i);
+#line 98 "tests/inline.c"
+  s0.i = 0;
+  return s0;
+}
+
+int main(void)
+{
+  value r = f_main();
+  (void) r;
+  return 0;
+}
@@ -0,0 +1,496 @@
+# x86-64 code for tests/inline.c
+	.file "tests/inline.c"
+	.text
+	.data
+	.p2align 2
+g_g:
+	.long 0
+	.text
+
+	.p2align 4
+	.type f_print, @function
+f_print:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jge .L1_1
+# tests/inline.c 14 expression
+	movl $45, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/inline.c 15 expression
+	movq %rbx, %r8
+	negl %r8d
+	movq %r8, %rbx
+.L1_1:
+# tests/inline.c 17 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	cmpl %r9d, %r8d
+	jl .L1_2
+# tests/inline.c 17 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	movl %r8d, %eax
+	movl %r9d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L1x0
+	negl %eax
+	jmp .L1y0
+.L1x0:
+	cltd
+	idivl %ecx
+.L1y0:
+	movl %eax, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_print
+.L1_2:
+# tests/inline.c 18 expression
+# tests/inline.c 18 expression
+	movl $48, %r8d
+	movq %rbx, %r9
+	movl $10, %r10d
+	movl %r9d, %eax
+	movl %r10d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L1x1
+	xorl %eax, %eax
+	jmp .L1y1
+.L1x1:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L1y1:
+	movl %eax, %r9d
+	addl %r9d, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	jmp .L1_ret
+.L1_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_print, .-f_print
+
+	.p2align 4
+	.type f_space, @function
+f_space:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $16, %rsp
+# tests/inline.c 23 expression
+	movl $32, %r8d
+	movq %r8, -8(%rbp)
+	movq -8(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	jmp .L2_ret
+.L2_ret:
+	leave
+	ret
+	.size f_space, .-f_space
+
+	.p2align 4
+	.type f_sub, @function
+f_sub:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %rdi, %rbx
+	movq %rsi, %r12
+# tests/inline.c 28 return
+	movq %rbx, %r8
+	movq %r12, %r9
+	subl %r9d, %r8d
+	movl %r8d, %eax
+	jmp .L3_ret
+.L3_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	leave
+	ret
+	.size f_sub, .-f_sub
+
+	.p2align 4
+	.type f_sign, @function
+f_sign:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jge .L4_1
+# tests/inline.c 33 return
+	movl $-1, %r8d
+	movl %r8d, %eax
+	jmp .L4_ret
+.L4_1:
+# tests/inline.c 34 expression
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jle .L4_2
+# tests/inline.c 34 return
+	movl $1, %r8d
+	movl %r8d, %eax
+	jmp .L4_ret
+.L4_2:
+# tests/inline.c 35 expression
+# tests/inline.c 35 return
+	movl $0, %r8d
+	movl %r8d, %eax
+	jmp .L4_ret
+.L4_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_sign, .-f_sign
+
+	.p2align 4
+	.type f_twice, @function
+f_twice:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+# tests/inline.c 41 expression
+	movq %rbx, %r8
+	movq %rbx, %r9
+	addl %r9d, %r8d
+	movq %r8, %rbx
+# tests/inline.c 42 return
+	movq %rbx, %r8
+	movl %r8d, %eax
+	jmp .L5_ret
+.L5_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_twice, .-f_twice
+
+	.p2align 4
+	.type f_quad, @function
+f_quad:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+# tests/inline.c 48 expression
+	movq %rbx, %r8
+	movq %rbx, %r9
+	addl %r9d, %r8d
+	movq %r8, %rbx
+# tests/inline.c 49 expression
+	movq %rbx, %r8
+	movq %rbx, %r9
+	addl %r9d, %r8d
+	movq %r8, %rbx
+# tests/inline.c 50 return
+	movq %rbx, %r8
+	movl %r8d, %eax
+	jmp .L6_ret
+.L6_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_quad, .-f_quad
+
+	.p2align 4
+	.type f_count, @function
+f_count:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $16, %rsp
+# tests/inline.c 55 expression
+	movl g_g(%rip), %r8d
+	movl $1, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r9
+	movl %r9d, g_g(%rip)
+	jmp .L7_ret
+.L7_ret:
+	leave
+	ret
+	.size f_count, .-f_count
+
+	.p2align 4
+	.type f_fact, @function
+f_fact:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+	movq %rbx, %r8
+	movl $1, %r9d
+	cmpl %r9d, %r8d
+	jg .L8_1
+# tests/inline.c 60 return
+	movl $1, %r8d
+	movl %r8d, %eax
+	jmp .L8_ret
+.L8_1:
+# tests/inline.c 61 expression
+# tests/inline.c 61 return
+	movq %rbx, %r8
+	movq %rbx, %r9
+	movl $1, %r10d
+	subl %r10d, %r9d
+	movq %r8, -16(%rbp)
+	movq %r9, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_fact
+	movq -16(%rbp), %r8
+	movl %eax, %r9d
+	imull %r9d, %r8d
+	movl %r8d, %eax
+	jmp .L8_ret
+.L8_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_fact, .-f_fact
+
+	.p2align 4
+	.type f_main, @function
+f_main:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+# tests/inline.c 69 expression
+# tests/inline.c 70 expression
+	movl $7, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/inline.c 71 expression
+	movl $32, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/inline.c 72 expression
+# tests/inline.c 73 expression
+	movl $-1, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/inline.c 74 expression
+	movl $32, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/inline.c 75 expression
+# tests/inline.c 76 expression
+	movl $0, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/inline.c 77 expression
+	movl $32, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/inline.c 78 expression
+# tests/inline.c 79 expression
+	movl $1, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/inline.c 80 expression
+	movl $32, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/inline.c 81 expression
+# tests/inline.c 82 expression
+	movl $28, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/inline.c 83 expression
+	movl $10, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/inline.c 84 expression
+	movl $0, %r8d
+	movq %r8, %r9
+	movl %r9d, g_g(%rip)
+# tests/inline.c 85 expression
+	movl $0, %r8d
+	movq %r8, %rbx
+	movl $0, %r8d
+	movq %r8, %r12
+	jmp .L9_2
+.L9_1:
+# tests/inline.c 87 expression
+	movl g_g(%rip), %r8d
+	movl $1, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r9
+	movl %r9d, g_g(%rip)
+# tests/inline.c 88 expression
+	movq %r12, %r8
+	movl $2, %r9d
+	subl %r9d, %r8d
+	movq %r8, %r13
+# tests/inline.c 89 expression
+	movq %rbx, %r8
+	movl $2, %r9d
+	imull %r9d, %r8d
+	movq %r13, %r9
+	addl %r9d, %r8d
+	movq %r8, %rbx
+	addl $1, %r12d
+.L9_2:
+	movq %r12, %r8
+	movl $6, %r9d
+	cmpl %r9d, %r8d
+	jl .L9_1
+# tests/inline.c 90 expression
+# tests/inline.c 91 expression
+	movl g_g(%rip), %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/inline.c 92 expression
+	movl $32, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/inline.c 93 expression
+	movq %rbx, %r8
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/inline.c 94 expression
+	movl $32, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/inline.c 95 expression
+	movl $6, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_fact
+	movl %eax, %r8d
+	movq %r8, %r13
+# tests/inline.c 96 expression
+	movq %r13, %r8
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/inline.c 97 expression
+	movl $10, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/inline.c 98 return
+	movl $0, %r8d
+	movl %r8d, %eax
+	jmp .L9_ret
+.L9_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	leave
+	ret
+	.size f_main, .-f_main
+
+	.globl main
+	.type main, @function
+main:
+	pushq %rbp
+	movq %rsp, %rbp
+	call f_main
+	xorl %eax, %eax
+	popq %rbp
+	ret
+	.size main, .-main
+	.section .rodata
+.Lreturn_code:
+	.string "Return code: %d\n"
+	.text
+
+	.p2align 4
+mycc_newarray:
+	pushq %rbp
+	movq %rsp, %rbp
+	pushq %rbx
+	subq $8, %rsp
+	testl %edi, %edi
+	js .Lnegative
+	movl %edi, %ebx
+	movslq %edi, %rdi
+	movslq %esi, %rsi
+	imulq %rdi, %rsi
+	addq $8, %rsi
+	movl $1, %edi
+	call calloc@PLT
+	testq %rax, %rax
+	je .Lnomemory
+	movl %ebx, 4(%rax)
+	addq $8, %rax
+	movq -8(%rbp), %rbx
+	leave
+	ret
+.Lnegative:
+	leaq .Lnegative_msg(%rip), %rdi
+	jmp mycc_throw
+.Lnomemory:
+	leaq .Lnomemory_msg(%rip), %rdi
+	jmp mycc_throw
+mycc_bounds:
+	leaq .Lbounds_msg(%rip), %rdi
+	jmp mycc_throw
+mycc_divzero:
+	leaq .Ldivzero_msg(%rip), %rdi
+mycc_throw:
+	andq $-16, %rsp
+	movq stderr@GOTPCREL(%rip), %rax
+	movq (%rax), %rsi
+	call fputs@PLT
+	movl $1, %edi
+	call exit@PLT
+	.section .rodata
+.Lnegative_msg:
+	.string "Exception: java.lang.NegativeArraySizeException\n"
+.Lnomemory_msg:
+	.string "Exception: java.lang.OutOfMemoryError\n"
+.Lbounds_msg:
+	.string "Exception: java.lang.ArrayIndexOutOfBoundsException\n"
+.Ldivzero_msg:
+	.string "Exception: java.lang.ArithmeticException: / by zero\n"
+	.section .note.GNU-stack,"",@progbits
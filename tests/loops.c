@@ -0,0 +1,124 @@
+/*
+  Loop-invariant code motion: invariant arithmetic and globals,
+  which move, and globals a call in the loop may change, array
+  elements the loop stores to, and a division that could throw
+  in a loop that never runs, which don't.
+*/
+
+int putchar(int c);
+
+int g;
+int a[10];
+
+void print(int x)
+{
+  if (x < 0) {
+    putchar(45);
+    x = -x;
+  }
+  if (x >= 10) print(x / 10);
+  putchar(48 + x % 10);
+}
+
+void space()
+{
+  putchar(32);
+}
+
+/* Recursive, so never inlined: the loop keeps its call */
+void bump(int n)
+{
+  if (n > 0) bump(n - 1);
+  g = g + 1;
+}
+
+int invariant(int n, int k)
+{
+  int i;
+  int s;
+  s = 0;
+  for (i = 0; i < n; i++) {
+    s = s + (k * k + 3) * g - i;
+  }
+  return s;
+}
+
+int called(int n)
+{
+  int i;
+  int s;
+  s = 0;
+  for (i = 0; i < n; i++) {
+    s = s + g * 2;
+    bump(0);
+  }
+  return s;
+}
+
+int elements(int n)
+{
+  int i;
+  int s;
+  s = 0;
+  for (i = 0; i < n; i++) {
+    s = s + a[2];
+    a[2] = a[2] + i;
+  }
+  return s;
+}
+
+int division(int n, int d)
+{
+  int i;
+  int s;
+  s = 1;
+  i = 0;
+  while (i < n) {
+    s = s + 100 / d;
+    i++;
+  }
+  return s;
+}
+
+int nested(int n)
+{
+  int i;
+  int j;
+  int s;
+  s = 0;
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) {
+      s = s + i * n + j * 2 + n * n;
+    }
+  }
+  return s;
+}
+
+int main()
+{
+  int r;
+  g = 2;
+  r = invariant(5, 3);
+  print(r);
+  space();
+  g = 5;
+  r = called(4);
+  print(r);
+  space();
+  print(g);
+  putchar(10);
+  a[2] = 1;
+  r = elements(5);
+  print(r);
+  space();
+  r = division(3, 7);
+  print(r);
+  space();
+  r = division(0, 0);
+  print(r);
+  space();
+  r = nested(4);
+  print(r);
+  putchar(10);
+  return 0;
+}
@@ -0,0 +1,470 @@
+/* C code for tests/loops.c, from mycc */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef union { int32_t i; float f; void* p; } value;
+static const value mycc_zero;
+
+static inline int32_t mycc_add(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a + (uint32_t) b); }
+static inline int32_t mycc_sub(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a - (uint32_t) b); }
+static inline int32_t mycc_mul(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a * (uint32_t) b); }
+static inline int32_t mycc_neg(int32_t a) { return (int32_t) (0u - (uint32_t) a); }
+
+static inline void mycc_throw(const char* what)
+{
+  fprintf(stderr, "Exception: %s\n", what);
+  exit(1);
+}
+
+static inline int32_t mycc_div(int32_t a, int32_t b)
+{
+  if (0 == b) mycc_throw("java.lang.ArithmeticException: / by zero");
+  return (-1 == b) ? mycc_neg(a) : a / b;
+}
+
+static inline int32_t mycc_rem(int32_t a, int32_t b)
+{
+  if (0 == b) mycc_throw("java.lang.ArithmeticException: / by zero");
+  return (-1 == b) ? 0 : a % b;
+}
+
+/* Arrays and strings have their length in the word before element 0 */
+static inline void* mycc_newarray(int32_t n, size_t size)
+{
+  if (n < 0) mycc_throw("java.lang.NegativeArraySizeException");
+  int32_t* p = calloc(1, sizeof(int32_t) + (size_t) n * size);
+  if (0 == p) mycc_throw("java.lang.OutOfMemoryError");
+  p[0] = n;
+  return p + 1;
+}
+
+static inline int32_t mycc_index(const void* p, int32_t i)
+{
+  if ((uint32_t) i >= (uint32_t) ((const int32_t*) p)[-1])
+    mycc_throw("java.lang.ArrayIndexOutOfBoundsException");
+  return i;
+}
+
+static int32_t g_g = 0;
+static void* g_a;
+void f_print(value l0);
+void f_space(void);
+void f_bump(value l0);
+value f_invariant(value l0, value l1);
+value f_called(value l0);
+value f_elements(value l0);
+value f_division(value l0, value l1);
+value f_nested(value l0);
+value f_main(void);
+void mycc_clinit(void);
+
+void f_print(value l0)
+{
+  value s0;
+  value s1;
+  value s2;
+  s0 = l0;
+  s1.i = 0;
+  if (s0.i >= s1.i) goto L1;
+#line 16 "tests/loops.c"
+  s0.i = 45;
+  s0.i = putchar(s0.i);
+#line 17 "tests/loops.c"
+  s0 = l0;
+  s0.i = mycc_neg(s0.i);
+  l0 = s0;
+ L1:;
+#line 19 "tests/loops.c"
+  s0 = l0;
+  s1.i = 10;
+  if (s0.i < s1.i) goto L2;
+#line 19 "tests/loops.c"
+  s0 = l0;
+  s1.i = 10;
+  s0.i = mycc_div(s0.i, s1.i);
+  f_print(s0);
+ L2:;
+#line 20 "tests/loops.c"
+#line 20 "tests/loops.c"
+  s0.i = 48;
+  s1 = l0;
+  s2.i = 10;
+  s1.i = mycc_rem(s1.i, s2.i);
+  s0.i = mycc_add(s0.i, s1.i);
+  s0.i = putchar(s0.i);
+  return;
+}
+
+void f_space(void)
+{
+  value s0;
+#line 25 "tests/loops.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+  return;
+}
+
+void f_bump(value l0)
+{
+  value s0;
+  value s1;
+  s0 = l0;
+  s1.i = 0;
+  if (s0.i <= s1.i) goto L1;
+#line 31 "tests/loops.c"
+  s0 = l0;
+  s1.i = 1;
+  s0.i = mycc_sub(s0.i, s1.i);
+  f_bump(s0);
+ L1:;
+#line 32 "tests/loops.c"
+#line 32 "tests/loops.c"
+  s0.i = g_g;
+  s1.i = 1;
+  s0.i = mycc_add(s0.i, s1.i);
+  s1 = s0;
+  g_g = s1.i;
+  return;
+}
+
+value f_invariant(value l0, value l1)
+{
+  value l2 = mycc_zero;
+  value l3 = mycc_zero;
+  value s0;
+  value s1;
+#line 39 "tests/loops.c"
+  s0.i = 0;
+  l3 = s0;
+  s0.i = 0;
+  l2 = s0;
+  s0 = l1;
+  s1 = l1;
+  s0.i = mycc_mul(s0.i, s1.i);
+  s1.i = 3;
+  s0.i = mycc_add(s0.i, s1.i);
+  s1.i = g_g;
+  s0.i = mycc_mul(s0.i, s1.i);
+  l1 = s0;
+  goto L2;
+ L1:;
+#line 41 "tests/loops.c"
+  s0 = l3;
+  s1 = l1;
+  s0.i = mycc_add(s0.i, s1.i);
+  s1 = l2;
+  s0.i = mycc_sub(s0.i, s1.i);
+  l3 = s0;
+  l2.i = mycc_add(l2.i, 1);
+ L2:;
+  s0 = l2;
+  s1 = l0;
+  if (s0.i < s1.i) goto L1;
+#line 42 "tests/loops.c"
+#line 43 "tests/loops.c"
+  s0 = l3;
+  return s0;
+}
+
+value f_called(value l0)
+{
+  value l1 = mycc_zero;
+  value l2 = mycc_zero;
+  value s0;
+  value s1;
+  value s2;
+#line 50 "tests/loops.c"
+  s0.i = 0;
+  l1 = s0;
+  s0.i = 0;
+  l2 = s0;
+  goto L2;
+ L1:;
+#line 52 "tests/loops.c"
+  s0 = l1;
+  s1.i = g_g;
+  s2.i = 2;
+  s1.i = mycc_mul(s1.i, s2.i);
+  s0.i = mycc_add(s0.i, s1.i);
+  l1 = s0;
+#line 53 "tests/loops.c"
+  s0.i = 0;
+  f_bump(s0);
+  l2.i = mycc_add(l2.i, 1);
+ L2:;
+  s0 = l2;
+  s1 = l0;
+  if (s0.i < s1.i) goto L1;
+#line 54 "tests/loops.c"
+#line 55 "tests/loops.c"
+  s0 = l1;
+  return s0;
+}
+
+value f_elements(value l0)
+{
+  value l1 = mycc_zero;
+  value l2 = mycc_zero;
+  value s0;
+  value s1;
+  value s2;
+  value s3;
+#line 62 "tests/loops.c"
+  s0.i = 0;
+  l2 = s0;
+  s0.i = 0;
+  l1 = s0;
+  goto L2;
+ L1:;
+#line 64 "tests/loops.c"
+  s0 = l2;
+  s1.p = g_a;
+  s2.i = 2;
+  s1.i = ((int32_t*) s1.p)[mycc_index(s1.p, s2.i)];
+  s0.i = mycc_add(s0.i, s1.i);
+  l2 = s0;
+#line 65 "tests/loops.c"
+  s0.p = g_a;
+  s1.i = 2;
+  s2.p = g_a;
+  s3.i = 2;
+  s2.i = ((int32_t*) s2.p)[mycc_index(s2.p, s3.i)];
+  s3 = l1;
+  s2.i = mycc_add(s2.i, s3.i);
+  ((int32_t*) s0.p)[mycc_index(s0.p, s1.i)] = s2.i;
+  l1.i = mycc_add(l1.i, 1);
+ L2:;
+  s0 = l1;
+  s1 = l0;
+  if (s0.i < s1.i) goto L1;
+#line 66 "tests/loops.c"
+#line 67 "tests/loops.c"
+  s0 = l2;
+  return s0;
+}
+
+value f_division(value l0, value l1)
+{
+  value l2 = mycc_zero;
+  value l3 = mycc_zero;
+  value s0;
+  value s1;
+  value s2;
+#line 74 "tests/loops.c"
+  s0.i = 1;
+  l2 = s0;
+#line 75 "tests/loops.c"
+  s0.i = 0;
+  l3 = s0;
+  goto L2;
+ L1:;
+#line 77 "tests/loops.c"
+  s0 = l2;
+  s1.i = 100;
+  s2 = l1;
+  s1.i = mycc_div(s1.i, s2.i);
+  s0.i = mycc_add(s0.i, s1.i);
+  l2 = s0;
+#line 78 "tests/loops.c"
+  l3.i = mycc_add(l3.i, 1);
+ L2:;
+  s0 = l3;
+  s1 = l0;
+  if (s0.i < s1.i) goto L1;
+#line 79 "tests/loops.c"
+#line 80 "tests/loops.c"
+  s0 = l2;
+  return s0;
+}
+
+value f_nested(value l0)
+{
+  value l1 = mycc_zero;
+  value l2 = mycc_zero;
+  value l3 = mycc_zero;
+  value l4 = mycc_zero;
+  value l5 = mycc_zero;
+  value s0;
+  value s1;
+  value s2;
+#line 88 "tests/loops.c"
+  s0.i = 0;
+  l2 = s0;
+  s0.i = 0;
+  l5 = s0;
+  s0 = l0;
+  s1 = l0;
+  s0.i = mycc_mul(s0.i, s1.i);
+  l4 = s0;
+  goto L4;
+ L1:;
+  s0.i = 0;
+  l1 = s0;
+  s0 = l5;
+  s1 = l0;
+  s0.i = mycc_mul(s0.i, s1.i);
+  l3 = s0;
+  goto L3;
+ L2:;
+#line 91 "tests/loops.c"
+  s0 = l2;
+  s1 = l3;
+  s0.i = mycc_add(s0.i, s1.i);
+  s1 = l1;
+  s2.i = 2;
+  s1.i = mycc_mul(s1.i, s2.i);
+  s0.i = mycc_add(s0.i, s1.i);
+  s1 = l4;
+  s0.i = mycc_add(s0.i, s1.i);
+  l2 = s0;
+  l1.i = mycc_add(l1.i, 1);
+ L3:;
+  s0 = l1;
+  s1 = l0;
+  if (s0.i < s1.i) goto L2;
+#line 92 "tests/loops.c"
+  l5.i = mycc_add(l5.i, 1);
+ L4:;
+  s0 = l5;
+  s1 = l0;
+  if (s0.i < s1.i) goto L1;
+#line 93 "tests/loops.c"
+#line 94 "tests/loops.c"
+  s0 = l2;
+  return s0;
+}
+
+value f_main(void)
+{
+  value l0 = mycc_zero;
+  value l1 = mycc_zero;
+  value s0;
+  value s1;
+  value s2;
+#line 100 "tests/loops.c"
+  s0.i = 2;
+  s1 = s0;
+  g_g = s1.i;
+#line 101 "tests/loops.c"
+  s0.i = 5;
+  s1.i = 3;
+  s0 = f_invariant(s0, s1);
+  l0 = s0;
+#line 102 "tests/loops.c"
+  s0 = l0;
+  f_print(s0);
+#line 103 "tests/loops.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 104 "tests/loops.c"
+  s0.i = 5;
+  s1 = s0;
+  g_g = s1.i;
+#line 105 "tests/loops.c"
+  s0.i = 0;
+  l1 = s0;
+  s0.i = 0;
+  l0 = s0;
+  goto L2;
+ L1:;
+  s0 = l1;
+  s1.i = g_g;
+  s2.i = 2;
+  s1.i = mycc_mul(s1.i, s2.i);
+  s0.i = mycc_add(s0.i, s1.i);
+  l1 = s0;
+  s0.i = 0;
+  f_bump(s0);
+  l0.i = mycc_add(l0.i, 1);
+ L2:;
+  s0 = l0;
+  s1.i = 4;
+  if (s0.i < s1.i) goto L1;
+#line 106 "tests/loops.c"
+  s0 = l1;
+  f_print(s0);
+#line 107 "tests/loops.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 108 "tests/loops.c"
+  s0.i = g_g;
+  f_print(s0);
+#line 109 "tests/loops.c"
+  s0.i = 10;
+  s0.i = putchar(s0.i);
+#line 110 "tests/loops.c"
+  s0.p = g_a;
+  s1.i = 2;
+  s2.i = 1;
+  ((int32_t*) s0.p)[mycc_index(s0.p, s1.i)] = s2.i;
+#line 111 "tests/loops.c"
+  s0.i = 5;
+  s0 = f_elements(s0);
+  l0 = s0;
+#line 112 "tests/loops.c"
+  s0 = l0;
+  f_print(s0);
+#line 113 "tests/loops.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 114 "tests/loops.c"
+  s0.i = 1;
+  l0 = s0;
+  s0.i = 0;
+  l1 = s0;
+  goto L4;
+ L3:;
+  l0.i = mycc_add(l0.i, 14);
+  l1.i = mycc_add(l1.i, 1);
+ L4:;
+  s0 = l1;
+  s1.i = 3;
+  if (s0.i < s1.i) goto L3;
+#line 115 "tests/loops.c"
+  s0 = l0;
+  f_print(s0);
+#line 116 "tests/loops.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 117 "tests/loops.c"
+#line 118 "tests/loops.c"
+  s0.i = 1;
+  f_print(s0);
+#line 119 "tests/loops.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 120 "tests/loops.c"
+  s0.i = 4;
+  s0 = f_nested(s0);
+  l0 = s0;
+#line 121 "tests/loops.c"
+  s0 = l0;
+  f_print(s0);
+#line 122 "tests/loops.c"
+  s0.i = 10;
+  s0.i = putchar(s0.i);
+#line 123 "tests/loops.c"
+  s0.i = 0;
+  return s0;
+}
+
+void mycc_clinit(void)
+{
+  value s0;
+  /* Building array a */
+  s0.i = 10;
+  s0.p = mycc_newarray(s0.i, sizeof(int32_t));
+  g_a = s0.p;
+  return;
+}
+
+int main(void)
+{
+  mycc_clinit();
+  value r = f_main();
+  (void) r;
+  return 0;
+}
@@ -0,0 +1,704 @@
+# x86-64 code for tests/loops.c
+	.file "tests/loops.c"
+	.text
+	.data
+	.p2align 2
+g_g:
+	.long 0
+	.text
+	.data
+	.p2align 3
+g_a:
+	.quad 0
+	.text
+
+	.p2align 4
+	.type f_print, @function
+f_print:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jge .L1_1
+# tests/loops.c 16 expression
+	movl $45, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/loops.c 17 expression
+	movq %rbx, %r8
+	negl %r8d
+	movq %r8, %rbx
+.L1_1:
+# tests/loops.c 19 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	cmpl %r9d, %r8d
+	jl .L1_2
+# tests/loops.c 19 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	movl %r8d, %eax
+	movl %r9d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L1x0
+	negl %eax
+	jmp .L1y0
+.L1x0:
+	cltd
+	idivl %ecx
+.L1y0:
+	movl %eax, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_print
+.L1_2:
+# tests/loops.c 20 expression
+# tests/loops.c 20 expression
+	movl $48, %r8d
+	movq %rbx, %r9
+	movl $10, %r10d
+	movl %r9d, %eax
+	movl %r10d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L1x1
+	xorl %eax, %eax
+	jmp .L1y1
+.L1x1:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L1y1:
+	movl %eax, %r9d
+	addl %r9d, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	jmp .L1_ret
+.L1_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_print, .-f_print
+
+	.p2align 4
+	.type f_space, @function
+f_space:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $16, %rsp
+# tests/loops.c 25 expression
+	movl $32, %r8d
+	movq %r8, -8(%rbp)
+	movq -8(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	jmp .L2_ret
+.L2_ret:
+	leave
+	ret
+	.size f_space, .-f_space
+
+	.p2align 4
+	.type f_bump, @function
+f_bump:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jle .L3_1
+# tests/loops.c 31 expression
+	movq %rbx, %r8
+	movl $1, %r9d
+	subl %r9d, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_bump
+.L3_1:
+# tests/loops.c 32 expression
+# tests/loops.c 32 expression
+	movl g_g(%rip), %r8d
+	movl $1, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r9
+	movl %r9d, g_g(%rip)
+	jmp .L3_ret
+.L3_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_bump, .-f_bump
+
+	.p2align 4
+	.type f_invariant, @function
+f_invariant:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+	movq %r14, -32(%rbp)
+	movq %rdi, %rbx
+	movq %rsi, %r12
+# tests/loops.c 39 expression
+	movl $0, %r8d
+	movq %r8, %r13
+	movl $0, %r8d
+	movq %r8, %r14
+	movq %r12, %r8
+	movq %r12, %r9
+	imull %r9d, %r8d
+	movl $3, %r9d
+	addl %r9d, %r8d
+	movl g_g(%rip), %r9d
+	imull %r9d, %r8d
+	movq %r8, %r12
+	jmp .L4_2
+.L4_1:
+# tests/loops.c 41 expression
+	movq %r13, %r8
+	movq %r12, %r9
+	addl %r9d, %r8d
+	movq %r14, %r9
+	subl %r9d, %r8d
+	movq %r8, %r13
+	addl $1, %r14d
+.L4_2:
+	movq %r14, %r8
+	movq %rbx, %r9
+	cmpl %r9d, %r8d
+	jl .L4_1
+# tests/loops.c 42 expression
+# tests/loops.c 43 return
+	movq %r13, %r8
+	movl %r8d, %eax
+	jmp .L4_ret
+.L4_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	movq -32(%rbp), %r14
+	leave
+	ret
+	.size f_invariant, .-f_invariant
+
+	.p2align 4
+	.type f_called, @function
+f_called:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+	movq %rdi, %rbx
+# tests/loops.c 50 expression
+	movl $0, %r8d
+	movq %r8, %r12
+	movl $0, %r8d
+	movq %r8, %r13
+	jmp .L5_2
+.L5_1:
+# tests/loops.c 52 expression
+	movq %r12, %r8
+	movl g_g(%rip), %r9d
+	movl $2, %r10d
+	imull %r10d, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r12
+# tests/loops.c 53 expression
+	movl $0, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_bump
+	addl $1, %r13d
+.L5_2:
+	movq %r13, %r8
+	movq %rbx, %r9
+	cmpl %r9d, %r8d
+	jl .L5_1
+# tests/loops.c 54 expression
+# tests/loops.c 55 return
+	movq %r12, %r8
+	movl %r8d, %eax
+	jmp .L5_ret
+.L5_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	leave
+	ret
+	.size f_called, .-f_called
+
+	.p2align 4
+	.type f_elements, @function
+f_elements:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $64, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+	movq %rdi, %rbx
+# tests/loops.c 62 expression
+	movl $0, %r8d
+	movq %r8, %r12
+	movl $0, %r8d
+	movq %r8, %r13
+	jmp .L6_2
+.L6_1:
+# tests/loops.c 64 expression
+	movq %r12, %r8
+	movq g_a(%rip), %r9
+	movl $2, %r10d
+	movq %r9, %rcx
+	movslq %r10d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl (%rcx,%rax,4), %r9d
+	addl %r9d, %r8d
+	movq %r8, %r12
+# tests/loops.c 65 expression
+	movq g_a(%rip), %r8
+	movl $2, %r9d
+	movq g_a(%rip), %r10
+	movl $2, %r11d
+	movq %r10, %rcx
+	movslq %r11d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl (%rcx,%rax,4), %r10d
+	movq %r13, %r11
+	addl %r11d, %r10d
+	movq %r8, %rcx
+	movslq %r9d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl %r10d, %edx
+	movl %edx, (%rcx,%rax,4)
+	addl $1, %r13d
+.L6_2:
+	movq %r13, %r8
+	movq %rbx, %r9
+	cmpl %r9d, %r8d
+	jl .L6_1
+# tests/loops.c 66 expression
+# tests/loops.c 67 return
+	movq %r12, %r8
+	movl %r8d, %eax
+	jmp .L6_ret
+.L6_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	leave
+	ret
+	.size f_elements, .-f_elements
+
+	.p2align 4
+	.type f_division, @function
+f_division:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $64, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+	movq %r14, -32(%rbp)
+	movq %rdi, %rbx
+	movq %rsi, %r12
+# tests/loops.c 74 expression
+	movl $1, %r8d
+	movq %r8, %r13
+# tests/loops.c 75 expression
+	movl $0, %r8d
+	movq %r8, %r14
+	jmp .L7_2
+.L7_1:
+# tests/loops.c 77 expression
+	movq %r13, %r8
+	movl $100, %r9d
+	movq %r12, %r10
+	movl %r9d, %eax
+	movl %r10d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L7x0
+	negl %eax
+	jmp .L7y0
+.L7x0:
+	cltd
+	idivl %ecx
+.L7y0:
+	movl %eax, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r13
+# tests/loops.c 78 expression
+	addl $1, %r14d
+.L7_2:
+	movq %r14, %r8
+	movq %rbx, %r9
+	cmpl %r9d, %r8d
+	jl .L7_1
+# tests/loops.c 79 expression
+# tests/loops.c 80 return
+	movq %r13, %r8
+	movl %r8d, %eax
+	jmp .L7_ret
+.L7_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	movq -32(%rbp), %r14
+	leave
+	ret
+	.size f_division, .-f_division
+
+	.p2align 4
+	.type f_nested, @function
+f_nested:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $80, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+	movq %r14, -32(%rbp)
+	movq %r15, -40(%rbp)
+	movq %rdi, %rbx
+# tests/loops.c 88 expression
+	movl $0, %r8d
+	movq %r8, -48(%rbp)
+	movl $0, %r8d
+	movq %r8, %r13
+	movq %rbx, %r8
+	movq %rbx, %r9
+	imull %r9d, %r8d
+	movq %r8, %r14
+	jmp .L8_4
+.L8_1:
+	movl $0, %r8d
+	movq %r8, %r15
+	movq %r13, %r8
+	movq %rbx, %r9
+	imull %r9d, %r8d
+	movq %r8, %r12
+	jmp .L8_3
+.L8_2:
+# tests/loops.c 91 expression
+	movq -48(%rbp), %r8
+	movq %r12, %r9
+	addl %r9d, %r8d
+	movq %r15, %r9
+	movl $2, %r10d
+	imull %r10d, %r9d
+	addl %r9d, %r8d
+	movq %r14, %r9
+	addl %r9d, %r8d
+	movq %r8, -48(%rbp)
+	addl $1, %r15d
+.L8_3:
+	movq %r15, %r8
+	movq %rbx, %r9
+	cmpl %r9d, %r8d
+	jl .L8_2
+# tests/loops.c 92 expression
+	addl $1, %r13d
+.L8_4:
+	movq %r13, %r8
+	movq %rbx, %r9
+	cmpl %r9d, %r8d
+	jl .L8_1
+# tests/loops.c 93 expression
+# tests/loops.c 94 return
+	movq -48(%rbp), %r8
+	movl %r8d, %eax
+	jmp .L8_ret
+.L8_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	movq -32(%rbp), %r14
+	movq -40(%rbp), %r15
+	leave
+	ret
+	.size f_nested, .-f_nested
+
+	.p2align 4
+	.type f_main, @function
+f_main:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+# tests/loops.c 100 expression
+	movl $2, %r8d
+	movq %r8, %r9
+	movl %r9d, g_g(%rip)
+# tests/loops.c 101 expression
+	movl $5, %r8d
+	movl $3, %r9d
+	movq %r8, -24(%rbp)
+	movq %r9, -32(%rbp)
+	movq -24(%rbp), %rdi
+	movq -32(%rbp), %rsi
+	call f_invariant
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/loops.c 102 expression
+	movq %rbx, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/loops.c 103 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/loops.c 104 expression
+	movl $5, %r8d
+	movq %r8, %r9
+	movl %r9d, g_g(%rip)
+# tests/loops.c 105 expression
+	movl $0, %r8d
+	movq %r8, %r12
+	movl $0, %r8d
+	movq %r8, %rbx
+	jmp .L9_2
+.L9_1:
+	movq %r12, %r8
+	movl g_g(%rip), %r9d
+	movl $2, %r10d
+	imull %r10d, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r12
+	movl $0, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_bump
+	addl $1, %ebx
+.L9_2:
+	movq %rbx, %r8
+	movl $4, %r9d
+	cmpl %r9d, %r8d
+	jl .L9_1
+# tests/loops.c 106 expression
+	movq %r12, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/loops.c 107 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/loops.c 108 expression
+	movl g_g(%rip), %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/loops.c 109 expression
+	movl $10, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/loops.c 110 expression
+	movq g_a(%rip), %r8
+	movl $2, %r9d
+	movl $1, %r10d
+	movq %r8, %rcx
+	movslq %r9d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl %r10d, %edx
+	movl %edx, (%rcx,%rax,4)
+# tests/loops.c 111 expression
+	movl $5, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_elements
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/loops.c 112 expression
+	movq %rbx, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/loops.c 113 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/loops.c 114 expression
+	movl $1, %r8d
+	movq %r8, %rbx
+	movl $0, %r8d
+	movq %r8, %r12
+	jmp .L9_4
+.L9_3:
+	addl $14, %ebx
+	addl $1, %r12d
+.L9_4:
+	movq %r12, %r8
+	movl $3, %r9d
+	cmpl %r9d, %r8d
+	jl .L9_3
+# tests/loops.c 115 expression
+	movq %rbx, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/loops.c 116 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/loops.c 117 expression
+# tests/loops.c 118 expression
+	movl $1, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/loops.c 119 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/loops.c 120 expression
+	movl $4, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_nested
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/loops.c 121 expression
+	movq %rbx, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/loops.c 122 expression
+	movl $10, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/loops.c 123 return
+	movl $0, %r8d
+	movl %r8d, %eax
+	jmp .L9_ret
+.L9_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	leave
+	ret
+	.size f_main, .-f_main
+
+	.p2align 4
+	.type mycc_clinit, @function
+mycc_clinit:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $16, %rsp
+# Building array a
+	movl $10, %r8d
+	movq %r8, -8(%rbp)
+	movl -8(%rbp), %edi
+	movl $4, %esi
+	call mycc_newarray
+	movq %rax, %r8
+	movq %r8, g_a(%rip)
+	jmp .L10_ret
+.L10_ret:
+	leave
+	ret
+	.size mycc_clinit, .-mycc_clinit
+
+	.globl main
+	.type main, @function
+main:
+	pushq %rbp
+	movq %rsp, %rbp
+	call mycc_clinit
+	call f_main
+	xorl %eax, %eax
+	popq %rbp
+	ret
+	.size main, .-main
+	.section .rodata
+.Lreturn_code:
+	.string "Return code: %d\n"
+	.text
+
+	.p2align 4
+mycc_newarray:
+	pushq %rbp
+	movq %rsp, %rbp
+	pushq %rbx
+	subq $8, %rsp
+	testl %edi, %edi
+	js .Lnegative
+	movl %edi, %ebx
+	movslq %edi, %rdi
+	movslq %esi, %rsi
+	imulq %rdi, %rsi
+	addq $8, %rsi
+	movl $1, %edi
+	call calloc@PLT
+	testq %rax, %rax
+	je .Lnomemory
+	movl %ebx, 4(%rax)
+	addq $8, %rax
+	movq -8(%rbp), %rbx
+	leave
+	ret
+.Lnegative:
+	leaq .Lnegative_msg(%rip), %rdi
+	jmp mycc_throw
+.Lnomemory:
+	leaq .Lnomemory_msg(%rip), %rdi
+	jmp mycc_throw
+mycc_bounds:
+	leaq .Lbounds_msg(%rip), %rdi
+	jmp mycc_throw
+mycc_divzero:
+	leaq .Ldivzero_msg(%rip), %rdi
+mycc_throw:
+	andq $-16, %rsp
+	movq stderr@GOTPCREL(%rip), %rax
+	movq (%rax), %rsi
+	call fputs@PLT
+	movl $1, %edi
+	call exit@PLT
+	.section .rodata
+.Lnegative_msg:
+	.string "Exception: java.lang.NegativeArraySizeException\n"
+.Lnomemory_msg:
+	.string "Exception: java.lang.OutOfMemoryError\n"
+.Lbounds_msg:
+	.string "Exception: java.lang.ArrayIndexOutOfBoundsException\n"
+.Ldivzero_msg:
+	.string "Exception: java.lang.ArithmeticException: / by zero\n"
+	.section .note.GNU-stack,"",@progbits
@@ -0,0 +1,118 @@
+/*
+  Sharing local slots: locals used one after another, which can
+  share, and ones that must not: a value kept around a loop, one
+  set on both arms of an if and read after it, a parameter read
+  late, and locals that trade values on every trip round a loop.
+*/
+
+int putchar(int c);
+
+void print(int x)
+{
+  if (x < 0) {
+    putchar(45);
+    x = -x;
+  }
+  if (x >= 10) print(x / 10);
+  putchar(48 + x % 10);
+}
+
+void space()
+{
+  putchar(32);
+}
+
+int sequence(int n)
+{
+  int a;
+  int b;
+  int c;
+  int d;
+  int e;
+  a = n * 3;
+  b = a + 1;
+  c = b * b;
+  d = c - n;
+  e = d / 2;
+  return e;
+}
+
+int around(int n)
+{
+  int keep;
+  int i;
+  int t;
+  int s;
+  keep = n * 7;
+  s = 0;
+  for (i = 0; i < n; i++) {
+    t = i * i;
+    s = s + t + keep;
+  }
+  return s;
+}
+
+int branches(int n)
+{
+  int x;
+  int y;
+  int z;
+  if (n > 5) {
+    x = n * 2;
+    y = x + 1;
+  } else {
+    x = n - 1;
+    y = 3;
+  }
+  z = x * 10;
+  return z + y;
+}
+
+int late(int p, int q)
+{
+  int u;
+  int v;
+  u = q * 2;
+  v = u + 5;
+  return v * 100 + p;
+}
+
+int swap(int n)
+{
+  int x;
+  int y;
+  int t;
+  int i;
+  x = n;
+  y = 1;
+  for (i = 0; i < 3; i++) {
+    t = x;
+    x = y * 10;
+    y = t + 1;
+  }
+  return x * 1000 + y;
+}
+
+int main()
+{
+  int r;
+  r = sequence(4);
+  print(r);
+  space();
+  r = around(5);
+  print(r);
+  space();
+  r = branches(9);
+  print(r);
+  space();
+  r = branches(2);
+  print(r);
+  space();
+  r = late(7, 8);
+  print(r);
+  space();
+  r = swap(6);
+  print(r);
+  putchar(10);
+  return 0;
+}
@@ -0,0 +1,362 @@
+/* C code for tests/slots.c, from mycc */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef union { int32_t i; float f; void* p; } value;
+static const value mycc_zero;
+
+static inline int32_t mycc_add(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a + (uint32_t) b); }
+static inline int32_t mycc_sub(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a - (uint32_t) b); }
+static inline int32_t mycc_mul(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a * (uint32_t) b); }
+static inline int32_t mycc_neg(int32_t a) { return (int32_t) (0u - (uint32_t) a); }
+
+static inline void mycc_throw(const char* what)
+{
+  fprintf(stderr, "Exception: %s\n", what);
+  exit(1);
+}
+
+static inline int32_t mycc_div(int32_t a, int32_t b)
+{
+  if (0 == b) mycc_throw("java.lang.ArithmeticException: / by zero");
+  return (-1 == b) ? mycc_neg(a) : a / b;
+}
+
+static inline int32_t mycc_rem(int32_t a, int32_t b)
+{
+  if (0 == b) mycc_throw("java.lang.ArithmeticException: / by zero");
+  return (-1 == b) ? 0 : a % b;
+}
+
+/* Arrays and strings have their length in the word before element 0 */
+static inline void* mycc_newarray(int32_t n, size_t size)
+{
+  if (n < 0) mycc_throw("java.lang.NegativeArraySizeException");
+  int32_t* p = calloc(1, sizeof(int32_t) + (size_t) n * size);
+  if (0 == p) mycc_throw("java.lang.OutOfMemoryError");
+  p[0] = n;
+  return p + 1;
+}
+
+static inline int32_t mycc_index(const void* p, int32_t i)
+{
+  if ((uint32_t) i >= (uint32_t) ((const int32_t*) p)[-1])
+    mycc_throw("java.lang.ArrayIndexOutOfBoundsException");
+  return i;
+}
+
+void f_print(value l0);
+void f_space(void);
+value f_sequence(value l0);
+value f_around(value l0);
+value f_branches(value l0);
+value f_late(value l0, value l1);
+value f_swap(value l0);
+value f_main(void);
+
+void f_print(value l0)
+{
+  value s0;
+  value s1;
+  value s2;
+  s0 = l0;
+  s1.i = 0;
+  if (s0.i >= s1.i) goto L1;
+#line 13 "tests/slots.c"
+  s0.i = 45;
+  s0.i = putchar(s0.i);
+#line 14 "tests/slots.c"
+  s0 = l0;
+  s0.i = mycc_neg(s0.i);
+  l0 = s0;
+ L1:;
+#line 16 "tests/slots.c"
+  s0 = l0;
+  s1.i = 10;
+  if (s0.i < s1.i) goto L2;
+#line 16 "tests/slots.c"
+  s0 = l0;
+  s1.i = 10;
+  s0.i = mycc_div(s0.i, s1.i);
+  f_print(s0);
+ L2:;
+#line 17 "tests/slots.c"
+#line 17 "tests/slots.c"
+  s0.i = 48;
+  s1 = l0;
+  s2.i = 10;
+  s1.i = mycc_rem(s1.i, s2.i);
+  s0.i = mycc_add(s0.i, s1.i);
+  s0.i = putchar(s0.i);
+  return;
+}
+
+void f_space(void)
+{
+  value s0;
+#line 22 "tests/slots.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+  return;
+}
+
+value f_sequence(value l0)
+{
+  value l1 = mycc_zero;
+  value s0;
+  value s1;
+#line 32 "tests/slots.c"
+  s0 = l0;
+  s1.i = 3;
+  s0.i = mycc_mul(s0.i, s1.i);
+  l1 = s0;
+#line 33 "tests/slots.c"
+  s0 = l1;
+  s1.i = 1;
+  s0.i = mycc_add(s0.i, s1.i);
+  l1 = s0;
+#line 34 "tests/slots.c"
+  s0 = l1;
+  s1 = l1;
+  s0.i = mycc_mul(s0.i, s1.i);
+  l1 = s0;
+#line 35 "tests/slots.c"
+  s0 = l1;
+  s1 = l0;
+  s0.i = mycc_sub(s0.i, s1.i);
+  l0 = s0;
+#line 36 "tests/slots.c"
+  s0 = l0;
+  s1.i = 2;
+  s0.i = mycc_div(s0.i, s1.i);
+  l0 = s0;
+#line 37 "tests/slots.c"
+  s0 = l0;
+  return s0;
+}
+
+value f_around(value l0)
+{
+  value l1 = mycc_zero;
+  value l2 = mycc_zero;
+  value l3 = mycc_zero;
+  value l4 = mycc_zero;
+  value s0;
+  value s1;
+#line 46 "tests/slots.c"
+  s0 = l0;
+  s1.i = 7;
+  s0.i = mycc_mul(s0.i, s1.i);
+  l4 = s0;
+#line 47 "tests/slots.c"
+  s0.i = 0;
+  l2 = s0;
+  s0.i = 0;
+  l1 = s0;
+  goto L2;
+ L1:;
+#line 49 "tests/slots.c"
+  s0 = l1;
+  s1 = l1;
+  s0.i = mycc_mul(s0.i, s1.i);
+  l3 = s0;
+#line 50 "tests/slots.c"
+  s0 = l2;
+  s1 = l3;
+  s0.i = mycc_add(s0.i, s1.i);
+  s1 = l4;
+  s0.i = mycc_add(s0.i, s1.i);
+  l2 = s0;
+  l1.i = mycc_add(l1.i, 1);
+ L2:;
+  s0 = l1;
+  s1 = l0;
+  if (s0.i < s1.i) goto L1;
+#line 51 "tests/slots.c"
+#line 52 "tests/slots.c"
+  s0 = l2;
+  return s0;
+}
+
+value f_branches(value l0)
+{
+  value l1 = mycc_zero;
+  value s0;
+  value s1;
+  s0 = l0;
+  s1.i = 5;
+  if (s0.i <= s1.i) goto L1;
+#line 61 "tests/slots.c"
+  s0 = l0;
+  s1.i = 2;
+  s0.i = mycc_mul(s0.i, s1.i);
+  l0 = s0;
+#line 62 "tests/slots.c"
+  s0 = l0;
+  s1.i = 1;
+  s0.i = mycc_add(s0.i, s1.i);
+  l1 = s0;
+  goto L2;
+ L1:;
+#line 64 "tests/slots.c"
+  s0 = l0;
+  s1.i = 1;
+  s0.i = mycc_sub(s0.i, s1.i);
+  l0 = s0;
+#line 65 "tests/slots.c"
+  s0.i = 3;
+  l1 = s0;
+ L2:;
+#line 66 "tests/slots.c"
+#line 67 "tests/slots.c"
+  s0 = l0;
+  s1.i = 10;
+  s0.i = mycc_mul(s0.i, s1.i);
+  l0 = s0;
+#line 68 "tests/slots.c"
+  s0 = l0;
+  s1 = l1;
+  s0.i = mycc_add(s0.i, s1.i);
+  return s0;
+}
+
+value f_late(value l0, value l1)
+{
+  value s0;
+  value s1;
+#line 75 "tests/slots.c"
+  s0 = l1;
+  s1.i = 2;
+  s0.i = mycc_mul(s0.i, s1.i);
+  l1 = s0;
+#line 76 "tests/slots.c"
+  s0 = l1;
+  s1.i = 5;
+  s0.i = mycc_add(s0.i, s1.i);
+  l1 = s0;
+#line 77 "tests/slots.c"
+  s0 = l1;
+  s1.i = 100;
+  s0.i = mycc_mul(s0.i, s1.i);
+  s1 = l0;
+  s0.i = mycc_add(s0.i, s1.i);
+  return s0;
+}
+
+value f_swap(value l0)
+{
+  value l1 = mycc_zero;
+  value l2 = mycc_zero;
+  value l3 = mycc_zero;
+  value s0;
+  value s1;
+#line 86 "tests/slots.c"
+  s0 = l0;
+  l0 = s0;
+#line 87 "tests/slots.c"
+  s0.i = 1;
+  l1 = s0;
+  s0.i = 0;
+  l2 = s0;
+  goto L2;
+ L1:;
+#line 89 "tests/slots.c"
+  s0 = l0;
+  l3 = s0;
+#line 90 "tests/slots.c"
+  s0 = l1;
+  s1.i = 10;
+  s0.i = mycc_mul(s0.i, s1.i);
+  l0 = s0;
+#line 91 "tests/slots.c"
+  s0 = l3;
+  s1.i = 1;
+  s0.i = mycc_add(s0.i, s1.i);
+  l1 = s0;
+  l2.i = mycc_add(l2.i, 1);
+ L2:;
+  s0 = l2;
+  s1.i = 3;
+  if (s0.i < s1.i) goto L1;
+#line 92 "tests/slots.c"
+#line 93 "tests/slots.c"
+  s0 = l0;
+  s1.i = 1000;
+  s0.i = mycc_mul(s0.i, s1.i);
+  s1 = l1;
+  s0.i = mycc_add(s0.i, s1.i);
+  return s0;
+}
+
+value f_main(void)
+{
+  value l0 = mycc_zero;
+  value s0;
+#line 99 "tests/slots.c"
+#line 100 "tests/slots.c"
+  s0.i = 82;
+  f_print(s0);
+#line 101 "tests/slots.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 102 "tests/slots.c"
+  s0.i = 5;
+  s0 = f_around(s0);
+  l0 = s0;
+#line 103 "tests/slots.c"
+  s0 = l0;
+  f_print(s0);
+#line 104 "tests/slots.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 105 "tests/slots.c"
+  s0.i = 9;
+  s0 = f_branches(s0);
+  l0 = s0;
+#line 106 "tests/slots.c"
+  s0 = l0;
+  f_print(s0);
+#line 107 "tests/slots.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 108 "tests/slots.c"
+  s0.i = 2;
+  s0 = f_branches(s0);
+  l0 = s0;
+#line 109 "tests/slots.c"
+  s0 = l0;
+  f_print(s0);
+#line 110 "tests/slots.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 111 "tests/slots.c"
+#line 112 "tests/slots.c"
+  s0.i = 2107;
+  f_print(s0);
+#line 113 "tests/slots.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 114 "tests/slots.c"
+  s0.i = 6;
+  s0 = f_swap(s0);
+  l0 = s0;
+#line 115 "tests/slots.c"
+  s0 = l0;
+  f_print(s0);
+#line 116 "tests/slots.c"
+  s0.i = 10;
+  s0.i = putchar(s0.i);
+#line 117 "tests/slots.c"
+  s0.i = 0;
+  return s0;
+}
+
+int main(void)
+{
+  value r = f_main();
+  (void) r;
+  return 0;
+}
@@ -0,0 +1,539 @@
+# x86-64 code for tests/slots.c
+	.file "tests/slots.c"
+	.text
+
+	.p2align 4
+	.type f_print, @function
+f_print:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jge .L1_1
+# tests/slots.c 13 expression
+	movl $45, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/slots.c 14 expression
+	movq %rbx, %r8
+	negl %r8d
+	movq %r8, %rbx
+.L1_1:
+# tests/slots.c 16 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	cmpl %r9d, %r8d
+	jl .L1_2
+# tests/slots.c 16 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	movl %r8d, %eax
+	movl %r9d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L1x0
+	negl %eax
+	jmp .L1y0
+.L1x0:
+	cltd
+	idivl %ecx
+.L1y0:
+	movl %eax, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_print
+.L1_2:
+# tests/slots.c 17 expression
+# tests/slots.c 17 expression
+	movl $48, %r8d
+	movq %rbx, %r9
+	movl $10, %r10d
+	movl %r9d, %eax
+	movl %r10d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L1x1
+	xorl %eax, %eax
+	jmp .L1y1
+.L1x1:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L1y1:
+	movl %eax, %r9d
+	addl %r9d, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	jmp .L1_ret
+.L1_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_print, .-f_print
+
+	.p2align 4
+	.type f_space, @function
+f_space:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $16, %rsp
+# tests/slots.c 22 expression
+	movl $32, %r8d
+	movq %r8, -8(%rbp)
+	movq -8(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	jmp .L2_ret
+.L2_ret:
+	leave
+	ret
+	.size f_space, .-f_space
+
+	.p2align 4
+	.type f_sequence, @function
+f_sequence:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %rdi, %rbx
+# tests/slots.c 32 expression
+	movq %rbx, %r8
+	movl $3, %r9d
+	imull %r9d, %r8d
+	movq %r8, %r12
+# tests/slots.c 33 expression
+	movq %r12, %r8
+	movl $1, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r12
+# tests/slots.c 34 expression
+	movq %r12, %r8
+	movq %r12, %r9
+	imull %r9d, %r8d
+	movq %r8, %r12
+# tests/slots.c 35 expression
+	movq %r12, %r8
+	movq %rbx, %r9
+	subl %r9d, %r8d
+	movq %r8, %rbx
+# tests/slots.c 36 expression
+	movq %rbx, %r8
+	movl $2, %r9d
+	movl %r8d, %eax
+	movl %r9d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L3x0
+	negl %eax
+	jmp .L3y0
+.L3x0:
+	cltd
+	idivl %ecx
+.L3y0:
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/slots.c 37 return
+	movq %rbx, %r8
+	movl %r8d, %eax
+	jmp .L3_ret
+.L3_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	leave
+	ret
+	.size f_sequence, .-f_sequence
+
+	.p2align 4
+	.type f_around, @function
+f_around:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $64, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+	movq %r14, -32(%rbp)
+	movq %r15, -40(%rbp)
+	movq %rdi, %rbx
+# tests/slots.c 46 expression
+	movq %rbx, %r8
+	movl $7, %r9d
+	imull %r9d, %r8d
+	movq %r8, %r12
+# tests/slots.c 47 expression
+	movl $0, %r8d
+	movq %r8, %r13
+	movl $0, %r8d
+	movq %r8, %r14
+	jmp .L4_2
+.L4_1:
+# tests/slots.c 49 expression
+	movq %r14, %r8
+	movq %r14, %r9
+	imull %r9d, %r8d
+	movq %r8, %r15
+# tests/slots.c 50 expression
+	movq %r13, %r8
+	movq %r15, %r9
+	addl %r9d, %r8d
+	movq %r12, %r9
+	addl %r9d, %r8d
+	movq %r8, %r13
+	addl $1, %r14d
+.L4_2:
+	movq %r14, %r8
+	movq %rbx, %r9
+	cmpl %r9d, %r8d
+	jl .L4_1
+# tests/slots.c 51 expression
+# tests/slots.c 52 return
+	movq %r13, %r8
+	movl %r8d, %eax
+	jmp .L4_ret
+.L4_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	movq -32(%rbp), %r14
+	movq -40(%rbp), %r15
+	leave
+	ret
+	.size f_around, .-f_around
+
+	.p2align 4
+	.type f_branches, @function
+f_branches:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %rdi, %rbx
+	movq %rbx, %r8
+	movl $5, %r9d
+	cmpl %r9d, %r8d
+	jle .L5_1
+# tests/slots.c 61 expression
+	movq %rbx, %r8
+	movl $2, %r9d
+	imull %r9d, %r8d
+	movq %r8, %rbx
+# tests/slots.c 62 expression
+	movq %rbx, %r8
+	movl $1, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r12
+	jmp .L5_2
+.L5_1:
+# tests/slots.c 64 expression
+	movq %rbx, %r8
+	movl $1, %r9d
+	subl %r9d, %r8d
+	movq %r8, %rbx
+# tests/slots.c 65 expression
+	movl $3, %r8d
+	movq %r8, %r12
+.L5_2:
+# tests/slots.c 66 expression
+# tests/slots.c 67 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	imull %r9d, %r8d
+	movq %r8, %rbx
+# tests/slots.c 68 return
+	movq %rbx, %r8
+	movq %r12, %r9
+	addl %r9d, %r8d
+	movl %r8d, %eax
+	jmp .L5_ret
+.L5_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	leave
+	ret
+	.size f_branches, .-f_branches
+
+	.p2align 4
+	.type f_late, @function
+f_late:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %rdi, %rbx
+	movq %rsi, %r12
+# tests/slots.c 75 expression
+	movq %r12, %r8
+	movl $2, %r9d
+	imull %r9d, %r8d
+	movq %r8, %r12
+# tests/slots.c 76 expression
+	movq %r12, %r8
+	movl $5, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r12
+# tests/slots.c 77 return
+	movq %r12, %r8
+	movl $100, %r9d
+	imull %r9d, %r8d
+	movq %rbx, %r9
+	addl %r9d, %r8d
+	movl %r8d, %eax
+	jmp .L6_ret
+.L6_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	leave
+	ret
+	.size f_late, .-f_late
+
+	.p2align 4
+	.type f_swap, @function
+f_swap:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+	movq %r14, -32(%rbp)
+	movq %rdi, %rbx
+# tests/slots.c 86 expression
+	movq %rbx, %r8
+	movq %r8, %rbx
+# tests/slots.c 87 expression
+	movl $1, %r8d
+	movq %r8, %r12
+	movl $0, %r8d
+	movq %r8, %r13
+	jmp .L7_2
+.L7_1:
+# tests/slots.c 89 expression
+	movq %rbx, %r8
+	movq %r8, %r14
+# tests/slots.c 90 expression
+	movq %r12, %r8
+	movl $10, %r9d
+	imull %r9d, %r8d
+	movq %r8, %rbx
+# tests/slots.c 91 expression
+	movq %r14, %r8
+	movl $1, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r12
+	addl $1, %r13d
+.L7_2:
+	movq %r13, %r8
+	movl $3, %r9d
+	cmpl %r9d, %r8d
+	jl .L7_1
+# tests/slots.c 92 expression
+# tests/slots.c 93 return
+	movq %rbx, %r8
+	movl $1000, %r9d
+	imull %r9d, %r8d
+	movq %r12, %r9
+	addl %r9d, %r8d
+	movl %r8d, %eax
+	jmp .L7_ret
+.L7_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	movq -32(%rbp), %r14
+	leave
+	ret
+	.size f_swap, .-f_swap
+
+	.p2align 4
+	.type f_main, @function
+f_main:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $16, %rsp
+	movq %rbx, -8(%rbp)
+# tests/slots.c 99 expression
+# tests/slots.c 100 expression
+	movl $82, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_print
+# tests/slots.c 101 expression
+	movl $32, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/slots.c 102 expression
+	movl $5, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_around
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/slots.c 103 expression
+	movq %rbx, %r8
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_print
+# tests/slots.c 104 expression
+	movl $32, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/slots.c 105 expression
+	movl $9, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_branches
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/slots.c 106 expression
+	movq %rbx, %r8
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_print
+# tests/slots.c 107 expression
+	movl $32, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/slots.c 108 expression
+	movl $2, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_branches
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/slots.c 109 expression
+	movq %rbx, %r8
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_print
+# tests/slots.c 110 expression
+	movl $32, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/slots.c 111 expression
+# tests/slots.c 112 expression
+	movl $2107, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_print
+# tests/slots.c 113 expression
+	movl $32, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/slots.c 114 expression
+	movl $6, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_swap
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/slots.c 115 expression
+	movq %rbx, %r8
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_print
+# tests/slots.c 116 expression
+	movl $10, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/slots.c 117 return
+	movl $0, %r8d
+	movl %r8d, %eax
+	jmp .L8_ret
+.L8_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_main, .-f_main
+
+	.globl main
+	.type main, @function
+main:
+	pushq %rbp
+	movq %rsp, %rbp
+	call f_main
+	xorl %eax, %eax
+	popq %rbp
+	ret
+	.size main, .-main
+	.section .rodata
+.Lreturn_code:
+	.string "Return code: %d\n"
+	.text
+
+	.p2align 4
+mycc_newarray:
+	pushq %rbp
+	movq %rsp, %rbp
+	pushq %rbx
+	subq $8, %rsp
+	testl %edi, %edi
+	js .Lnegative
+	movl %edi, %ebx
+	movslq %edi, %rdi
+	movslq %esi, %rsi
+	imulq %rdi, %rsi
+	addq $8, %rsi
+	movl $1, %edi
+	call calloc@PLT
+	testq %rax, %rax
+	je .Lnomemory
+	movl %ebx, 4(%rax)
+	addq $8, %rax
+	movq -8(%rbp), %rbx
+	leave
+	ret
+.Lnegative:
+	leaq .Lnegative_msg(%rip), %rdi
+	jmp mycc_throw
+.Lnomemory:
+	leaq .Lnomemory_msg(%rip), %rdi
+	jmp mycc_throw
+mycc_bounds:
+	leaq .Lbounds_msg(%rip), %rdi
+	jmp mycc_throw
+mycc_divzero:
+	leaq .Ldivzero_msg(%rip), %rdi
+mycc_throw:
+	andq $-16, %rsp
+	movq stderr@GOTPCREL(%rip), %rax
+	movq (%rax), %rsi
+	call fputs@PLT
+	movl $1, %edi
+	call exit@PLT
+	.section .rodata
+.Lnegative_msg:
+	.string "Exception: java.lang.NegativeArraySizeException\n"
+.Lnomemory_msg:
+	.string "Exception: java.lang.OutOfMemoryError\n"
+.Lbounds_msg:
+	.string "Exception: java.lang.ArrayIndexOutOfBoundsException\n"
+.Ldivzero_msg:
+	.string "Exception: java.lang.ArithmeticException: / by zero\n"
+	.section .note.GNU-stack,"",@progbits
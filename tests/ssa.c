@@ -0,0 +1,155 @@
+/*
+  The SSA pass: branches on constants, loads of globals and array
+  elements that a call or a store comes between (which must be
+  loaded again), index arithmetic written out more than once,
+  copies carried around loops, and stores that are never read.
+*/
+
+int putchar(int c);
+
+int g;
+int a[10];
+
+void print(int x)
+{
+  if (x < 0) {
+    putchar(45);
+    x = -x;
+  }
+  if (x >= 10) print(x / 10);
+  putchar(48 + x % 10);
+}
+
+void space()
+{
+  putchar(32);
+}
+
+/* Recursive, so never inlined: the loads around it must stay */
+void bump(int n)
+{
+  if (n > 0) bump(n - 1);
+  g = g + 1;
+  a[3] = a[3] + 10;
+}
+
+int constants()
+{
+  int k;
+  int r;
+  r = 0;
+  k = 3;
+  if (k > 2) r = r + 1;
+  else r = r + 100;
+  if (k * 2 == 7) r = r + 1000;
+  while (k < 0) {
+    r = r + 10000;
+  }
+  k = k + 4;
+  if (k == 7) r = r + 20;
+  return r;
+}
+
+int across()
+{
+  int i;
+  int j;
+  int x;
+  int y;
+  int z;
+  g = 5;
+  a[3] = 1;
+  i = 3;
+  j = 3;
+  x = g;
+  bump(1);
+  y = g;
+  g = 40;
+  z = g;
+  print(x);
+  space();
+  print(y);
+  space();
+  print(z);
+  space();
+  x = a[i];
+  bump(0);
+  y = a[i];
+  a[j] = 7;
+  z = a[i];
+  print(x);
+  space();
+  print(y);
+  space();
+  print(z);
+  putchar(10);
+  return 0;
+}
+
+int indexing(int i)
+{
+  int s;
+  a[i * 2 + 1] = i;
+  a[i * 2] = a[i * 2 + 1] + a[i * 2 + 1];
+  s = a[i * 2] * 100 + a[i * 2 + 1];
+  return s;
+}
+
+int copies(int n)
+{
+  int x;
+  int y;
+  int t;
+  int k;
+  x = 0;
+  y = 1;
+  for (k = 0; k < n; k++) {
+    t = x;
+    x = y;
+    y = t + y;
+  }
+  return x;
+}
+
+int deadstores(int n)
+{
+  int d;
+  int e;
+  int k;
+  d = 5;
+  d = n + 1;
+  e = 0;
+  for (k = 0; k < n; k++) {
+    e = k * 3;
+    e = k;
+  }
+  return d * 100 + e;
+}
+
+int main()
+{
+  int r;
+  r = constants();
+  print(r);
+  putchar(10);
+  r = across();
+  r = indexing(2);
+  print(r);
+  space();
+  r = indexing(4);
+  print(r);
+  putchar(10);
+  r = copies(10);
+  print(r);
+  space();
+  r = copies(20);
+  print(r);
+  putchar(10);
+  r = deadstores(4);
+  print(r);
+  space();
+  r = deadstores(0);
+  print(r);
+  putchar(10);
+  return 0;
+}
@@ -0,0 +1,799 @@
+# x86-64 code for tests/ssa.c
+	.file "tests/ssa.c"
+	.text
+	.data
+	.p2align 2
+g_g:
+	.long 0
+	.text
+	.data
+	.p2align 3
+g_a:
+	.quad 0
+	.text
+
+	.p2align 4
+	.type f_print, @function
+f_print:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jge .L1_1
+# tests/ssa.c 16 expression
+	movl $45, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 17 expression
+	movq %rbx, %r8
+	negl %r8d
+	movq %r8, %rbx
+.L1_1:
+# tests/ssa.c 19 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	cmpl %r9d, %r8d
+	jl .L1_2
+# tests/ssa.c 19 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	movl %r8d, %eax
+	movl %r9d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L1x0
+	negl %eax
+	jmp .L1y0
+.L1x0:
+	cltd
+	idivl %ecx
+.L1y0:
+	movl %eax, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_print
+.L1_2:
+# tests/ssa.c 20 expression
+# tests/ssa.c 20 expression
+	movl $48, %r8d
+	movq %rbx, %r9
+	movl $10, %r10d
+	movl %r9d, %eax
+	movl %r10d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L1x1
+	xorl %eax, %eax
+	jmp .L1y1
+.L1x1:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L1y1:
+	movl %eax, %r9d
+	addl %r9d, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	jmp .L1_ret
+.L1_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_print, .-f_print
+
+	.p2align 4
+	.type f_space, @function
+f_space:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $16, %rsp
+# tests/ssa.c 25 expression
+	movl $32, %r8d
+	movq %r8, -8(%rbp)
+	movq -8(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	jmp .L2_ret
+.L2_ret:
+	leave
+	ret
+	.size f_space, .-f_space
+
+	.p2align 4
+	.type f_bump, @function
+f_bump:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jle .L3_1
+# tests/ssa.c 31 expression
+	movq %rbx, %r8
+	movl $1, %r9d
+	subl %r9d, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_bump
+.L3_1:
+# tests/ssa.c 32 expression
+# tests/ssa.c 32 expression
+	movl g_g(%rip), %r8d
+	movl $1, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r9
+	movl %r9d, g_g(%rip)
+# tests/ssa.c 33 expression
+	movq g_a(%rip), %r8
+	movl $3, %r9d
+	movq g_a(%rip), %r10
+	movl $3, %r11d
+	movq %r10, %rcx
+	movslq %r11d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl (%rcx,%rax,4), %r10d
+	movl $10, %r11d
+	addl %r11d, %r10d
+	movq %r8, %rcx
+	movslq %r9d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl %r10d, %edx
+	movl %edx, (%rcx,%rax,4)
+	jmp .L3_ret
+.L3_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_bump, .-f_bump
+
+	.p2align 4
+	.type f_constants, @function
+f_constants:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $16, %rsp
+# tests/ssa.c 40 expression
+# tests/ssa.c 41 expression
+# tests/ssa.c 42 expression
+# tests/ssa.c 43 expression
+# tests/ssa.c 47 expression
+# tests/ssa.c 48 expression
+# tests/ssa.c 49 expression
+# tests/ssa.c 50 expression
+# tests/ssa.c 50 return
+	movl $21, %r8d
+	movl %r8d, %eax
+	jmp .L4_ret
+.L4_ret:
+	leave
+	ret
+	.size f_constants, .-f_constants
+
+	.p2align 4
+	.type f_across, @function
+f_across:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+# tests/ssa.c 60 expression
+	movl $5, %r8d
+	movq %r8, %r9
+	movl %r9d, g_g(%rip)
+# tests/ssa.c 61 expression
+	movq g_a(%rip), %r8
+	movl $3, %r9d
+	movl $1, %r10d
+	movq %r8, %rcx
+	movslq %r9d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl %r10d, %edx
+	movl %edx, (%rcx,%rax,4)
+# tests/ssa.c 62 expression
+# tests/ssa.c 63 expression
+# tests/ssa.c 64 expression
+	movl g_g(%rip), %r8d
+	movq %r8, %rbx
+# tests/ssa.c 65 expression
+	movl $1, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_bump
+# tests/ssa.c 66 expression
+	movl g_g(%rip), %r8d
+	movq %r8, %r12
+# tests/ssa.c 67 expression
+	movl $40, %r8d
+	movq %r8, %r9
+	movl %r9d, g_g(%rip)
+# tests/ssa.c 68 expression
+	movl g_g(%rip), %r8d
+	movq %r8, %r13
+# tests/ssa.c 69 expression
+	movq %rbx, %r8
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/ssa.c 70 expression
+	movl $32, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 71 expression
+	movq %r12, %r8
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/ssa.c 72 expression
+	movl $32, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 73 expression
+	movq %r13, %r8
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/ssa.c 74 expression
+	movl $32, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 75 expression
+	movq g_a(%rip), %r8
+	movl $3, %r9d
+	movq %r8, %rcx
+	movslq %r9d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl (%rcx,%rax,4), %r8d
+	movq %r8, %rbx
+# tests/ssa.c 76 expression
+	movl $0, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_bump
+# tests/ssa.c 77 expression
+	movq g_a(%rip), %r8
+	movl $3, %r9d
+	movq %r8, %rcx
+	movslq %r9d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl (%rcx,%rax,4), %r8d
+	movq %r8, %r12
+# tests/ssa.c 78 expression
+	movq g_a(%rip), %r8
+	movl $3, %r9d
+	movl $7, %r10d
+	movq %r8, %rcx
+	movslq %r9d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl %r10d, %edx
+	movl %edx, (%rcx,%rax,4)
+# tests/ssa.c 79 expression
+	movq g_a(%rip), %r8
+	movl $3, %r9d
+	movq %r8, %rcx
+	movslq %r9d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl (%rcx,%rax,4), %r8d
+	movq %r8, %r13
+# tests/ssa.c 80 expression
+	movq %rbx, %r8
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/ssa.c 81 expression
+	movl $32, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 82 expression
+	movq %r12, %r8
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/ssa.c 83 expression
+	movl $32, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 84 expression
+	movq %r13, %r8
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call f_print
+# tests/ssa.c 85 expression
+	movl $10, %r8d
+	movq %r8, -32(%rbp)
+	movq -32(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 86 return
+	movl $0, %r8d
+	movl %r8d, %eax
+	jmp .L5_ret
+.L5_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	leave
+	ret
+	.size f_across, .-f_across
+
+	.p2align 4
+	.type f_indexing, @function
+f_indexing:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $64, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+	movq %rdi, %rbx
+# tests/ssa.c 92 expression
+	movq g_a(%rip), %r8
+	movq %rbx, %r9
+	movl $2, %r10d
+	imull %r10d, %r9d
+	movq %r9, %r10
+	movq %r10, %r12
+	movl $1, %r10d
+	addl %r10d, %r9d
+	movq %r9, %r10
+	movq %r10, %r13
+	movq %rbx, %r10
+	movq %r8, %rcx
+	movslq %r9d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl %r10d, %edx
+	movl %edx, (%rcx,%rax,4)
+# tests/ssa.c 93 expression
+	movq g_a(%rip), %r8
+	movq %r12, %r9
+	movq g_a(%rip), %r10
+	movq %r13, %r11
+	movq %r10, %rcx
+	movslq %r11d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl (%rcx,%rax,4), %r10d
+	movq %r10, %r11
+	addl %r11d, %r10d
+	movq %r8, %rcx
+	movslq %r9d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl %r10d, %edx
+	movl %edx, (%rcx,%rax,4)
+# tests/ssa.c 94 expression
+	movq g_a(%rip), %r8
+	movq %r12, %r9
+	movq %r8, %rcx
+	movslq %r9d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl (%rcx,%rax,4), %r8d
+	movl $100, %r9d
+	imull %r9d, %r8d
+	movq g_a(%rip), %r9
+	movq %r13, %r10
+	movq %r9, %rcx
+	movslq %r10d, %rax
+	cmpl -4(%rcx), %eax
+	jae mycc_bounds
+	movl (%rcx,%rax,4), %r9d
+	addl %r9d, %r8d
+	movq %r8, %rbx
+# tests/ssa.c 95 return
+	movq %rbx, %r8
+	movl %r8d, %eax
+	jmp .L6_ret
+.L6_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	leave
+	ret
+	.size f_indexing, .-f_indexing
+
+	.p2align 4
+	.type f_copies, @function
+f_copies:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $64, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+	movq %r14, -32(%rbp)
+	movq %r15, -40(%rbp)
+	movq %rdi, %rbx
+# tests/ssa.c 104 expression
+	movl $0, %r8d
+	movq %r8, %r12
+# tests/ssa.c 105 expression
+	movl $1, %r8d
+	movq %r8, %r13
+	movl $0, %r8d
+	movq %r8, %r14
+	jmp .L7_2
+.L7_1:
+# tests/ssa.c 107 expression
+	movq %r12, %r8
+	movq %r8, %r15
+# tests/ssa.c 108 expression
+	movq %r13, %r8
+	movq %r8, %r12
+# tests/ssa.c 109 expression
+	movq %r15, %r8
+	movq %r13, %r9
+	addl %r9d, %r8d
+	movq %r8, %r13
+	addl $1, %r14d
+.L7_2:
+	movq %r14, %r8
+	movq %rbx, %r9
+	cmpl %r9d, %r8d
+	jl .L7_1
+# tests/ssa.c 110 expression
+# tests/ssa.c 111 return
+	movq %r12, %r8
+	movl %r8d, %eax
+	jmp .L7_ret
+.L7_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	movq -32(%rbp), %r14
+	movq -40(%rbp), %r15
+	leave
+	ret
+	.size f_copies, .-f_copies
+
+	.p2align 4
+	.type f_deadstores, @function
+f_deadstores:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+	movq %r14, -32(%rbp)
+	movq %rdi, %rbx
+# tests/ssa.c 119 expression
+# tests/ssa.c 120 expression
+	movq %rbx, %r8
+	movl $1, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r12
+# tests/ssa.c 121 expression
+	movl $0, %r8d
+	movq %r8, %r13
+	movl $0, %r8d
+	movq %r8, %r14
+	jmp .L8_2
+.L8_1:
+# tests/ssa.c 123 expression
+	movq %r14, %r8
+	movl $3, %r9d
+	imull %r9d, %r8d
+# tests/ssa.c 124 expression
+	movq %r14, %r8
+	movq %r8, %r13
+	addl $1, %r14d
+.L8_2:
+	movq %r14, %r8
+	movq %rbx, %r9
+	cmpl %r9d, %r8d
+	jl .L8_1
+# tests/ssa.c 125 expression
+# tests/ssa.c 126 return
+	movq %r12, %r8
+	movl $100, %r9d
+	imull %r9d, %r8d
+	movq %r13, %r9
+	addl %r9d, %r8d
+	movl %r8d, %eax
+	jmp .L8_ret
+.L8_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	movq -32(%rbp), %r14
+	leave
+	ret
+	.size f_deadstores, .-f_deadstores
+
+	.p2align 4
+	.type f_main, @function
+f_main:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+	movq %r14, -32(%rbp)
+# tests/ssa.c 132 expression
+# tests/ssa.c 133 expression
+	movl $21, %r8d
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call f_print
+# tests/ssa.c 134 expression
+	movl $10, %r8d
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 135 expression
+	call f_across
+	movl %eax, %r8d
+# tests/ssa.c 136 expression
+	movl $2, %r8d
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call f_indexing
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/ssa.c 137 expression
+	movq %rbx, %r8
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call f_print
+# tests/ssa.c 138 expression
+	movl $32, %r8d
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 139 expression
+	movl $4, %r8d
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call f_indexing
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/ssa.c 140 expression
+	movq %rbx, %r8
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call f_print
+# tests/ssa.c 141 expression
+	movl $10, %r8d
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 142 expression
+	movl $0, %r8d
+	movq %r8, %r12
+	movl $1, %r8d
+	movq %r8, %rbx
+	movl $0, %r8d
+	movq %r8, %r13
+	jmp .L9_2
+.L9_1:
+	movq %r12, %r8
+	movq %r8, %r14
+	movq %rbx, %r8
+	movq %r8, %r12
+	movq %r14, %r8
+	movq %rbx, %r9
+	addl %r9d, %r8d
+	movq %r8, %rbx
+	addl $1, %r13d
+.L9_2:
+	movq %r13, %r8
+	movl $10, %r9d
+	cmpl %r9d, %r8d
+	jl .L9_1
+# tests/ssa.c 143 expression
+	movq %r12, %r8
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call f_print
+# tests/ssa.c 144 expression
+	movl $32, %r8d
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 145 expression
+	movl $0, %r8d
+	movq %r8, %r12
+	movl $1, %r8d
+	movq %r8, %rbx
+	movl $0, %r8d
+	movq %r8, %r13
+	jmp .L9_4
+.L9_3:
+	movq %r12, %r8
+	movq %r8, %r14
+	movq %rbx, %r8
+	movq %r8, %r12
+	movq %r14, %r8
+	movq %rbx, %r9
+	addl %r9d, %r8d
+	movq %r8, %rbx
+	addl $1, %r13d
+.L9_4:
+	movq %r13, %r8
+	movl $20, %r9d
+	cmpl %r9d, %r8d
+	jl .L9_3
+# tests/ssa.c 146 expression
+	movq %r12, %r8
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call f_print
+# tests/ssa.c 147 expression
+	movl $10, %r8d
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 148 expression
+	movl $4, %r8d
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call f_deadstores
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/ssa.c 149 expression
+	movq %rbx, %r8
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call f_print
+# tests/ssa.c 150 expression
+	movl $32, %r8d
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 151 expression
+	movl $0, %r8d
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call f_deadstores
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/ssa.c 152 expression
+	movq %rbx, %r8
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call f_print
+# tests/ssa.c 153 expression
+	movl $10, %r8d
+	movq %r8, -40(%rbp)
+	movq -40(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/ssa.c 154 return
+	movl $0, %r8d
+	movl %r8d, %eax
+	jmp .L9_ret
+.L9_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	movq -32(%rbp), %r14
+	leave
+	ret
+	.size f_main, .-f_main
+
+	.p2align 4
+	.type mycc_clinit, @function
+mycc_clinit:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $16, %rsp
+# Building array a
+	movl $10, %r8d
+	movq %r8, -8(%rbp)
+	movl -8(%rbp), %edi
+	movl $4, %esi
+	call mycc_newarray
+	movq %rax, %r8
+	movq %r8, g_a(%rip)
+	jmp .L10_ret
+.L10_ret:
+	leave
+	ret
+	.size mycc_clinit, .-mycc_clinit
+
+	.globl main
+	.type main, @function
+main:
+	pushq %rbp
+	movq %rsp, %rbp
+	call mycc_clinit
+	call f_main
+	xorl %eax, %eax
+	popq %rbp
+	ret
+	.size main, .-main
+	.section .rodata
+.Lreturn_code:
+	.string "Return code: %d\n"
+	.text
+
+	.p2align 4
+mycc_newarray:
+	pushq %rbp
+	movq %rsp, %rbp
+	pushq %rbx
+	subq $8, %rsp
+	testl %edi, %edi
+	js .Lnegative
+	movl %edi, %ebx
+	movslq %edi, %rdi
+	movslq %esi, %rsi
+	imulq %rdi, %rsi
+	addq $8, %rsi
+	movl $1, %edi
+	call calloc@PLT
+	testq %rax, %rax
+	je .Lnomemory
+	movl %ebx, 4(%rax)
+	addq $8, %rax
+	movq -8(%rbp), %rbx
+	leave
+	ret
+.Lnegative:
+	leaq .Lnegative_msg(%rip), %rdi
+	jmp mycc_throw
+.Lnomemory:
+	leaq .Lnomemory_msg(%rip), %rdi
+	jmp mycc_throw
+mycc_bounds:
+	leaq .Lbounds_msg(%rip), %rdi
+	jmp mycc_throw
+mycc_divzero:
+	leaq .Ldivzero_msg(%rip), %rdi
+mycc_throw:
+	andq $-16, %rsp
+	movq stderr@GOTPCREL(%rip), %rax
+	movq (%rax), %rsi
+	call fputs@PLT
+	movl $1, %edi
+	call exit@PLT
+	.section .rodata
+.Lnegative_msg:
+	.string "Exception: java.lang.NegativeArraySizeException\n"
+.Lnomemory_msg:
+	.string "Exception: java.lang.OutOfMemoryError\n"
+.Lbounds_msg:
+	.string "Exception: java.lang.ArrayIndexOutOfBoundsException\n"
+.Ldivzero_msg:
+	.string "Exception: java.lang.ArithmeticException: / by zero\n"
+	.section .note.GNU-stack,"",@progbits
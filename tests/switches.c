@@ -0,0 +1,111 @@
+/*
+  Switch statements: a dense one (tableswitch) with fall through
+  and shared cases, a sparse one (lookupswitch), nested switches,
+  and break and continue inside loops.
+*/
+
+int putchar(int c);
+
+void print(int x)
+{
+  if (x < 0) {
+    putchar(45);
+    x = -x;
+  }
+  if (x >= 10) print(x / 10);
+  putchar(48 + x % 10);
+}
+
+int dense(int x)
+{
+  int r;
+  r = 0;
+  switch (x) {
+    case 0: r = 10; break;
+    case 1: r = 11;
+    case 2: r = r + 12; break;
+    case 3:
+    case 4: r = 34; break;
+    case 5: r = 5;
+    case 6: r = r + 6;
+    default: r = r + 7;
+  }
+  return r;
+}
+
+int sparse(int x)
+{
+  switch (x * 2) {
+    case 1000: return 1;
+    case -2000: return 2;
+    case 20: return 3;
+    case 'a' + 'a': return 4;
+  }
+  return 5;
+}
+
+int nested(int a, int b)
+{
+  switch (a) {
+    case 1:
+      switch (b) { case 1: return 11; case 2: return 12; }
+      return 10;
+    case 2: return 20;
+  }
+  switch (a) { }
+  switch (a) { default: return -1; }
+  return 0;
+}
+
+int loops(int n)
+{
+  int i;
+  int s;
+  s = 0;
+  for (i = 0; i < n; i++) {
+    if (i == 3) continue;
+    switch (i % 4) {
+      case 0: s = s + 1; continue;
+      case 1: s = s + 10; break;
+      default: s = s + 100;
+    }
+    if (i > 20) break;
+    s = s + 1000;
+  }
+  return s;
+}
+
+int main()
+{
+  int i;
+  int d;
+  print(loops(30));
+  putchar(10);
+  for (i = -2; i < 9; i++) {
+    d = dense(i);
+    print(d);
+    putchar(32);
+  }
+  putchar(10);
+  for (i = -1000; i <= 1000; i = i + 1) {
+    d = sparse(i);
+    if (d != 5) {
+      print(i);
+      putchar(58);
+      print(d);
+      putchar(32);
+    }
+  }
+  putchar(10);
+  print(nested(1, 1));
+  putchar(32);
+  print(nested(1, 2));
+  putchar(32);
+  print(nested(1, 3));
+  putchar(32);
+  print(nested(2, 0));
+  putchar(32);
+  print(nested(3, 0));
+  putchar(10);
+  return 0;
+}
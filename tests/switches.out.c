@@ -0,0 +1,577 @@
+/* C code for tests/switches.c, from mycc */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef union { int32_t i; float f; void* p; } value;
+static const value mycc_zero;
+
+static inline int32_t mycc_add(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a + (uint32_t) b); }
+static inline int32_t mycc_sub(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a - (uint32_t) b); }
+static inline int32_t mycc_mul(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a * (uint32_t) b); }
+static inline int32_t mycc_neg(int32_t a) { return (int32_t) (0u - (uint32_t) a); }
+
+static inline void mycc_throw(const char* what)
+{
+  fprintf(stderr, "Exception: %s\n", what);
+  exit(1);
+}
+
+static inline int32_t mycc_div(int32_t a, int32_t b)
+{
+  if (0 == b) mycc_throw("java.lang.ArithmeticException: / by zero");
+  return (-1 == b) ? mycc_neg(a) : a / b;
+}
+
+static inline int32_t mycc_rem(int32_t a, int32_t b)
+{
+  if (0 == b) mycc_throw("java.lang.ArithmeticException: / by zero");
+  return (-1 == b) ? 0 : a % b;
+}
+
+/* Arrays and strings have their length in the word before element 0 */
+static inline void* mycc_newarray(int32_t n, size_t size)
+{
+  if (n < 0) mycc_throw("java.lang.NegativeArraySizeException");
+  int32_t* p = calloc(1, sizeof(int32_t) + (size_t) n * size);
+  if (0 == p) mycc_throw("java.lang.OutOfMemoryError");
+  p[0] = n;
+  return p + 1;
+}
+
+static inline int32_t mycc_index(const void* p, int32_t i)
+{
+  if ((uint32_t) i >= (uint32_t) ((const int32_t*) p)[-1])
+    mycc_throw("java.lang.ArrayIndexOutOfBoundsException");
+  return i;
+}
+
+void f_print(value l0);
+value f_dense(value l0);
+value f_sparse(value l0);
+value f_nested(value l0, value l1);
+value f_loops(value l0);
+value f_main(void);
+
+void f_print(value l0)
+{
+  value s0;
+  value s1;
+  value s2;
+  s0 = l0;
+  s1.i = 0;
+  if (s0.i >= s1.i) goto L1;
+#line 12 "tests/switches.c"
+  s0.i = 45;
+  s0.i = putchar(s0.i);
+#line 13 "tests/switches.c"
+  s0 = l0;
+  s0.i = mycc_neg(s0.i);
+  l0 = s0;
+ L1:;
+#line 15 "tests/switches.c"
+  s0 = l0;
+  s1.i = 10;
+  if (s0.i < s1.i) goto L2;
+#line 15 "tests/switches.c"
+  s0 = l0;
+  s1.i = 10;
+  s0.i = mycc_div(s0.i, s1.i);
+  f_print(s0);
+ L2:;
+#line 16 "tests/switches.c"
+#line 16 "tests/switches.c"
+  s0.i = 48;
+  s1 = l0;
+  s2.i = 10;
+  s1.i = mycc_rem(s1.i, s2.i);
+  s0.i = mycc_add(s0.i, s1.i);
+  s0.i = putchar(s0.i);
+  return;
+}
+
+value f_dense(value l0)
+{
+  value l1 = mycc_zero;
+  value s0;
+#line 22 "tests/switches.c"
+  s0.i = 0;
+  l1 = s0;
+#line 23 "tests/switches.c"
+  s0 = l0;
+  switch (s0.i) {
+    case 0: goto L1;
+    case 1: goto L2;
+    case 2: goto L3;
+    case 3: goto L4;
+    case 4: goto L4;
+    case 5: goto L5;
+    case 6: goto L6;
+    default: goto L7;
+  }
+ L1:;
+#line 24 "tests/switches.c"
+  s0.i = 10;
+  l1 = s0;
+  goto L8;
+ L2:;
+#line 25 "tests/switches.c"
+  s0.i = 11;
+  l1 = s0;
+ L3:;
+#line 26 "tests/switches.c"
+  l1.i = mycc_add(l1.i, 12);
+  goto L8;
+ L4:;
+#line 28 "tests/switches.c"
+  s0.i = 34;
+  l1 = s0;
+  goto L8;
+ L5:;
+#line 29 "tests/switches.c"
+  s0.i = 5;
+  l1 = s0;
+ L6:;
+#line 30 "tests/switches.c"
+  l1.i = mycc_add(l1.i, 6);
+ L7:;
+#line 31 "tests/switches.c"
+  l1.i = mycc_add(l1.i, 7);
+ L8:;
+#line 33 "tests/switches.c"
+  s0 = l1;
+  return s0;
+}
+
+value f_sparse(value l0)
+{
+  value s0;
+  value s1;
+#line 38 "tests/switches.c"
+  s0 = l0;
+  s1.i = 2;
+  s0.i = mycc_mul(s0.i, s1.i);
+  switch (s0.i) {
+    case -2000: goto L2;
+    case 20: goto L3;
+    case 194: goto L4;
+    case 1000: goto L1;
+    default: goto L5;
+  }
+ L1:;
+#line 39 "tests/switches.c"
+  s0.i = 1;
+  return s0;
+ L2:;
+#line 40 "tests/switches.c"
+  s0.i = 2;
+  return s0;
+ L3:;
+#line 41 "tests/switches.c"
+  s0.i = 3;
+  return s0;
+ L4:;
+#line 42 "tests/switches.c"
+  s0.i = 4;
+  return s0;
+ L5:;
+#line 44 "tests/switches.c"
+  s0.i = 5;
+  return s0;
+}
+
+value f_nested(value l0, value l1)
+{
+  value s0;
+#line 49 "tests/switches.c"
+  s0 = l0;
+  switch (s0.i) {
+    case 1: goto L1;
+    case 2: goto L5;
+    default: goto L6;
+  }
+ L1:;
+#line 51 "tests/switches.c"
+  s0 = l1;
+  switch (s0.i) {
+    case 1: goto L2;
+    case 2: goto L3;
+    default: goto L4;
+  }
+ L2:;
+#line 51 "tests/switches.c"
+  s0.i = 11;
+  return s0;
+ L3:;
+#line 51 "tests/switches.c"
+  s0.i = 12;
+  return s0;
+ L4:;
+#line 52 "tests/switches.c"
+  s0.i = 10;
+  return s0;
+ L5:;
+#line 53 "tests/switches.c"
+  s0.i = 20;
+  return s0;
+ L6:;
+#line 55 "tests/switches.c"
+#line 56 "tests/switches.c"
+#line 56 "tests/switches.c"
+  s0.i = -1;
+  return s0;
+}
+
+value f_loops(value l0)
+{
+  value l1 = mycc_zero;
+  value l2 = mycc_zero;
+  value s0;
+  value s1;
+#line 64 "tests/switches.c"
+  s0.i = 0;
+  l1 = s0;
+  s0.i = 0;
+  l2 = s0;
+  goto L7;
+ L1:;
+  s0 = l2;
+  s1.i = 3;
+  if (s0.i == s1.i) goto L6;
+#line 67 "tests/switches.c"
+#line 67 "tests/switches.c"
+  s0 = l2;
+  s1.i = 4;
+  s0.i = mycc_rem(s0.i, s1.i);
+  switch (s0.i) {
+    case 0: goto L2;
+    case 1: goto L3;
+    default: goto L4;
+  }
+ L2:;
+#line 68 "tests/switches.c"
+  l1.i = mycc_add(l1.i, 1);
+  goto L6;
+ L3:;
+#line 69 "tests/switches.c"
+  l1.i = mycc_add(l1.i, 10);
+  goto L5;
+ L4:;
+#line 70 "tests/switches.c"
+  l1.i = mycc_add(l1.i, 100);
+ L5:;
+  s0 = l2;
+  s1.i = 20;
+  if (s0.i > s1.i) goto L8;
+#line 73 "tests/switches.c"
+#line 73 "tests/switches.c"
+  s0 = l1;
+  s1.i = 1000;
+  s0.i = mycc_add(s0.i, s1.i);
+  l1 = s0;
+ L6:;
+  l2.i = mycc_add(l2.i, 1);
+ L7:;
+  s0 = l2;
+  s1 = l0;
+  if (s0.i < s1.i) goto L1;
+ L8:;
+#line 74 "tests/switches.c"
+#line 75 "tests/switches.c"
+  s0 = l1;
+  return s0;
+}
+
+value f_main(void)
+{
+  value l0 = mycc_zero;
+  value l1 = mycc_zero;
+  value s0;
+  value s1;
+#line 82 "tests/switches.c"
+  s0.i = 30;
+  s0 = f_loops(s0);
+  f_print(s0);
+#line 83 "tests/switches.c"
+  s0.i = 10;
+  s0.i = putchar(s0.i);
+  s0.i = -2;
+  l0 = s0;
+  goto L2;
+ L1:;
+#line 85 "tests/switches.c"
+  s0 = l0;
+  s0 = f_dense(s0);
+  l1 = s0;
+#line 86 "tests/switches.c"
+  s0 = l1;
+  f_print(s0);
+#line 87 "tests/switches.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+  l0.i = mycc_add(l0.i, 1);
+ L2:;
+  s0 = l0;
+  s1.i = 9;
+  if (s0.i < s1.i) goto L1;
+#line 88 "tests/switches.c"
+#line 89 "tests/switches.c"
+  s0.i = 10;
+  s0.i = putchar(s0.i);
+  s0.i = -1000;
+  l0 = s0;
+  goto L11;
+ L3:;
+#line 91 "tests/switches.c"
+  s0 = l0;
+  s1 = s0;
+  l1 = s1;
+  s1.i = 2;
+  s0.i = mycc_mul(s0.i, s1.i);
+  switch (s0.i) {
+    case -2000: goto L5;
+    case 20: goto L6;
+    case 194: goto L7;
+    case 1000: goto L4;
+    default: goto L8;
+  }
+ L4:;
+  s0.i = 1;
+  goto L9;
+ L5:;
+  s0.i = 2;
+  goto L9;
+ L6:;
+  s0.i = 3;
+  goto L9;
+ L7:;
+  s0.i = 4;
+  goto L9;
+ L8:;
+  s0.i = 5;
+ L9:;
+  s1 = s0;
+  l1 = s1;
+  s1.i = 5;
+  if (s0.i == s1.i) goto L10;
+#line 93 "tests/switches.c"
+  s0 = l0;
+  f_print(s0);
+#line 94 "tests/switches.c"
+  s0.i = 58;
+  s0.i = putchar(s0.i);
+#line 95 "tests/switches.c"
+  s0 = l1;
+  f_print(s0);
+#line 96 "tests/switches.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+ L10:;
+#line 98 "tests/switches.c"
+  l0.i = mycc_add(l0.i, 1);
+ L11:;
+  s0 = l0;
+  s1.i = 1000;
+  if (s0.i <= s1.i) goto L3;
+#line 98 "tests/switches.c"
+#line 99 "tests/switches.c"
+  s0.i = 10;
+  s0.i = putchar(s0.i);
+#line 100 "tests/switches.c"
+  s0.i = 1;
+  s1.i = 1;
+  l0 = s1;
+  s1 = s0;
+  l1 = s1;
+  switch (s0.i) {
+    case 1: goto L12;
+    case 2: goto L16;
+    default: goto L17;
+  }
+ L12:;
+  s0 = l0;
+  switch (s0.i) {
+    case 1: goto L13;
+    case 2: goto L14;
+    default: goto L15;
+  }
+ L13:;
+  s0.i = 11;
+  goto L18;
+ L14:;
+  s0.i = 12;
+  goto L18;
+ L15:;
+  s0.i = 10;
+  goto L18;
+ L16:;
+  s0.i = 20;
+  goto L18;
+ L17:;
+  s0.i = -1;
+ L18:;
+  f_print(s0);
+#line 101 "tests/switches.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 102 "tests/switches.c"
+  s0.i = 1;
+  s1.i = 2;
+  l0 = s1;
+  s1 = s0;
+  l1 = s1;
+  switch (s0.i) {
+    case 1: goto L19;
+    case 2: goto L23;
+    default: goto L24;
+  }
+ L19:;
+  s0 = l0;
+  switch (s0.i) {
+    case 1: goto L20;
+    case 2: goto L21;
+    default: goto L22;
+  }
+ L20:;
+  s0.i = 11;
+  goto L25;
+ L21:;
+  s0.i = 12;
+  goto L25;
+ L22:;
+  s0.i = 10;
+  goto L25;
+ L23:;
+  s0.i = 20;
+  goto L25;
+ L24:;
+  s0.i = -1;
+ L25:;
+  f_print(s0);
+#line 103 "tests/switches.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 104 "tests/switches.c"
+  s0.i = 1;
+  s1.i = 3;
+  l0 = s1;
+  s1 = s0;
+  l1 = s1;
+  switch (s0.i) {
+    case 1: goto L26;
+    case 2: goto L30;
+    default: goto L31;
+  }
+ L26:;
+  s0 = l0;
+  switch (s0.i) {
+    case 1: goto L27;
+    case 2: goto L28;
+    default: goto L29;
+  }
+ L27:;
+  s0.i = 11;
+  goto L32;
+ L28:;
+  s0.i = 12;
+  goto L32;
+ L29:;
+  s0.i = 10;
+  goto L32;
+ L30:;
+  s0.i = 20;
+  goto L32;
+ L31:;
+  s0.i = -1;
+ L32:;
+  f_print(s0);
+#line 105 "tests/switches.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 106 "tests/switches.c"
+  s0.i = 2;
+  s1.i = 0;
+  l0 = s1;
+  s1 = s0;
+  l1 = s1;
+  switch (s0.i) {
+    case 1: goto L33;
+    case 2: goto L37;
+    default: goto L38;
+  }
+ L33:;
+  s0 = l0;
+  switch (s0.i) {
+    case 1: goto L34;
+    case 2: goto L35;
+    default: goto L36;
+  }
+ L34:;
+  s0.i = 11;
+  goto L39;
+ L35:;
+  s0.i = 12;
+  goto L39;
+ L36:;
+  s0.i = 10;
+  goto L39;
+ L37:;
+  s0.i = 20;
+  goto L39;
+ L38:;
+  s0.i = -1;
+ L39:;
+  f_print(s0);
+#line 107 "tests/switches.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 108 "tests/switches.c"
+  s0.i = 3;
+  s1.i = 0;
+  l0 = s1;
+  s1 = s0;
+  l1 = s1;
+  switch (s0.i) {
+    case 1: goto L40;
+    case 2: goto L44;
+    default: goto L45;
+  }
+ L40:;
+  s0 = l0;
+  switch (s0.i) {
+    case 1: goto L41;
+    case 2: goto L42;
+    default: goto L43;
+  }
+ L41:;
+  s0.i = 11;
+  goto L46;
+ L42:;
+  s0.i = 12;
+  goto L46;
+ L43:;
+  s0.i = 10;
+  goto L46;
+ L44:;
+  s0.i = 20;
+  goto L46;
+ L45:;
+  s0.i = -1;
+ L46:;
+  f_print(s0);
+#line 109 "tests/switches.c"
+  s0.i = 10;
+  s0.i = putchar(s0.i);
+#line 110 "tests/switches.c"
+  s0.i = 0;
+  return s0;
+}
+
+int main(void)
+{
+  value r = f_main();
+  (void) r;
+  return 0;
+}
@@ -0,0 +1,795 @@
+# x86-64 code for tests/switches.c
+	.file "tests/switches.c"
+	.text
+
+	.p2align 4
+	.type f_print, @function
+f_print:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jge .L1_1
+# tests/switches.c 12 expression
+	movl $45, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/switches.c 13 expression
+	movq %rbx, %r8
+	negl %r8d
+	movq %r8, %rbx
+.L1_1:
+# tests/switches.c 15 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	cmpl %r9d, %r8d
+	jl .L1_2
+# tests/switches.c 15 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	movl %r8d, %eax
+	movl %r9d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L1x0
+	negl %eax
+	jmp .L1y0
+.L1x0:
+	cltd
+	idivl %ecx
+.L1y0:
+	movl %eax, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_print
+.L1_2:
+# tests/switches.c 16 expression
+# tests/switches.c 16 expression
+	movl $48, %r8d
+	movq %rbx, %r9
+	movl $10, %r10d
+	movl %r9d, %eax
+	movl %r10d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L1x1
+	xorl %eax, %eax
+	jmp .L1y1
+.L1x1:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L1y1:
+	movl %eax, %r9d
+	addl %r9d, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	jmp .L1_ret
+.L1_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_print, .-f_print
+
+	.p2align 4
+	.type f_dense, @function
+f_dense:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %rdi, %rbx
+# tests/switches.c 22 expression
+	movl $0, %r8d
+	movq %r8, %r12
+# tests/switches.c 23 expression
+	movq %rbx, %r8
+	movl %r8d, %eax
+	subl $0, %eax
+	cmpl $6, %eax
+	ja .L2_7
+	leaq .L2t0(%rip), %rcx
+	movslq (%rcx,%rax,4), %rax
+	addq %rcx, %rax
+	jmp *%rax
+	.section .rodata
+	.p2align 2
+.L2t0:
+	.long .L2_1-.L2t0
+	.long .L2_2-.L2t0
+	.long .L2_3-.L2t0
+	.long .L2_4-.L2t0
+	.long .L2_4-.L2t0
+	.long .L2_5-.L2t0
+	.long .L2_6-.L2t0
+	.text
+.L2_1:
+# tests/switches.c 24 expression
+	movl $10, %r8d
+	movq %r8, %r12
+	jmp .L2_8
+.L2_2:
+# tests/switches.c 25 expression
+	movl $11, %r8d
+	movq %r8, %r12
+.L2_3:
+# tests/switches.c 26 expression
+	addl $12, %r12d
+	jmp .L2_8
+.L2_4:
+# tests/switches.c 28 expression
+	movl $34, %r8d
+	movq %r8, %r12
+	jmp .L2_8
+.L2_5:
+# tests/switches.c 29 expression
+	movl $5, %r8d
+	movq %r8, %r12
+.L2_6:
+# tests/switches.c 30 expression
+	addl $6, %r12d
+.L2_7:
+# tests/switches.c 31 expression
+	addl $7, %r12d
+.L2_8:
+# tests/switches.c 33 return
+	movq %r12, %r8
+	movl %r8d, %eax
+	jmp .L2_ret
+.L2_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	leave
+	ret
+	.size f_dense, .-f_dense
+
+	.p2align 4
+	.type f_sparse, @function
+f_sparse:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+# tests/switches.c 38 expression
+	movq %rbx, %r8
+	movl $2, %r9d
+	imull %r9d, %r8d
+	movl %r8d, %eax
+	cmpl $194, %eax
+	je .L3_4
+	jg .L3h0
+	cmpl $-2000, %eax
+	je .L3_2
+	cmpl $20, %eax
+	je .L3_3
+	jmp .L3_5
+.L3h0:
+	cmpl $1000, %eax
+	je .L3_1
+	jmp .L3_5
+.L3_1:
+# tests/switches.c 39 return
+	movl $1, %r8d
+	movl %r8d, %eax
+	jmp .L3_ret
+.L3_2:
+# tests/switches.c 40 return
+	movl $2, %r8d
+	movl %r8d, %eax
+	jmp .L3_ret
+.L3_3:
+# tests/switches.c 41 return
+	movl $3, %r8d
+	movl %r8d, %eax
+	jmp .L3_ret
+.L3_4:
+# tests/switches.c 42 return
+	movl $4, %r8d
+	movl %r8d, %eax
+	jmp .L3_ret
+.L3_5:
+# tests/switches.c 44 return
+	movl $5, %r8d
+	movl %r8d, %eax
+	jmp .L3_ret
+.L3_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_sparse, .-f_sparse
+
+	.p2align 4
+	.type f_nested, @function
+f_nested:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %rdi, %rbx
+	movq %rsi, %r12
+# tests/switches.c 49 expression
+	movq %rbx, %r8
+	movl %r8d, %eax
+	cmpl $1, %eax
+	je .L4_1
+	cmpl $2, %eax
+	je .L4_5
+	jmp .L4_6
+.L4_1:
+# tests/switches.c 51 expression
+	movq %r12, %r8
+	movl %r8d, %eax
+	cmpl $1, %eax
+	je .L4_2
+	cmpl $2, %eax
+	je .L4_3
+	jmp .L4_4
+.L4_2:
+# tests/switches.c 51 return
+	movl $11, %r8d
+	movl %r8d, %eax
+	jmp .L4_ret
+.L4_3:
+# tests/switches.c 51 return
+	movl $12, %r8d
+	movl %r8d, %eax
+	jmp .L4_ret
+.L4_4:
+# tests/switches.c 52 return
+	movl $10, %r8d
+	movl %r8d, %eax
+	jmp .L4_ret
+.L4_5:
+# tests/switches.c 53 return
+	movl $20, %r8d
+	movl %r8d, %eax
+	jmp .L4_ret
+.L4_6:
+# tests/switches.c 55 expression
+# tests/switches.c 56 expression
+# tests/switches.c 56 return
+	movl $-1, %r8d
+	movl %r8d, %eax
+	jmp .L4_ret
+.L4_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	leave
+	ret
+	.size f_nested, .-f_nested
+
+	.p2align 4
+	.type f_loops, @function
+f_loops:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %r13, -24(%rbp)
+	movq %rdi, %rbx
+# tests/switches.c 64 expression
+	movl $0, %r8d
+	movq %r8, %r12
+	movl $0, %r8d
+	movq %r8, %r13
+	jmp .L5_7
+.L5_1:
+	movq %r13, %r8
+	movl $3, %r9d
+	cmpl %r9d, %r8d
+	je .L5_6
+# tests/switches.c 67 expression
+# tests/switches.c 67 expression
+	movq %r13, %r8
+	movl $4, %r9d
+	movl %r8d, %eax
+	movl %r9d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L5x0
+	xorl %eax, %eax
+	jmp .L5y0
+.L5x0:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L5y0:
+	movl %eax, %r8d
+	movl %r8d, %eax
+	cmpl $0, %eax
+	je .L5_2
+	cmpl $1, %eax
+	je .L5_3
+	jmp .L5_4
+.L5_2:
+# tests/switches.c 68 expression
+	addl $1, %r12d
+	jmp .L5_6
+.L5_3:
+# tests/switches.c 69 expression
+	addl $10, %r12d
+	jmp .L5_5
+.L5_4:
+# tests/switches.c 70 expression
+	addl $100, %r12d
+.L5_5:
+	movq %r13, %r8
+	movl $20, %r9d
+	cmpl %r9d, %r8d
+	jg .L5_8
+# tests/switches.c 73 expression
+# tests/switches.c 73 expression
+	movq %r12, %r8
+	movl $1000, %r9d
+	addl %r9d, %r8d
+	movq %r8, %r12
+.L5_6:
+	addl $1, %r13d
+.L5_7:
+	movq %r13, %r8
+	movq %rbx, %r9
+	cmpl %r9d, %r8d
+	jl .L5_1
+.L5_8:
+# tests/switches.c 74 expression
+# tests/switches.c 75 return
+	movq %r12, %r8
+	movl %r8d, %eax
+	jmp .L5_ret
+.L5_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	movq -24(%rbp), %r13
+	leave
+	ret
+	.size f_loops, .-f_loops
+
+	.p2align 4
+	.type f_main, @function
+f_main:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+# tests/switches.c 82 expression
+	movl $30, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_loops
+	movl %eax, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/switches.c 83 expression
+	movl $10, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	movl $-2, %r8d
+	movq %r8, %rbx
+	jmp .L6_2
+.L6_1:
+# tests/switches.c 85 expression
+	movq %rbx, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_dense
+	movl %eax, %r8d
+	movq %r8, %r12
+# tests/switches.c 86 expression
+	movq %r12, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/switches.c 87 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	addl $1, %ebx
+.L6_2:
+	movq %rbx, %r8
+	movl $9, %r9d
+	cmpl %r9d, %r8d
+	jl .L6_1
+# tests/switches.c 88 expression
+# tests/switches.c 89 expression
+	movl $10, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	movl $-1000, %r8d
+	movq %r8, %rbx
+	jmp .L6_11
+.L6_3:
+# tests/switches.c 91 expression
+	movq %rbx, %r8
+	movq %r8, %r9
+	movq %r9, %r12
+	movl $2, %r9d
+	imull %r9d, %r8d
+	movl %r8d, %eax
+	cmpl $194, %eax
+	je .L6_7
+	jg .L6h0
+	cmpl $-2000, %eax
+	je .L6_5
+	cmpl $20, %eax
+	je .L6_6
+	jmp .L6_8
+.L6h0:
+	cmpl $1000, %eax
+	je .L6_4
+	jmp .L6_8
+.L6_4:
+	movl $1, %r8d
+	jmp .L6_9
+.L6_5:
+	movl $2, %r8d
+	jmp .L6_9
+.L6_6:
+	movl $3, %r8d
+	jmp .L6_9
+.L6_7:
+	movl $4, %r8d
+	jmp .L6_9
+.L6_8:
+	movl $5, %r8d
+.L6_9:
+	movq %r8, %r9
+	movq %r9, %r12
+	movl $5, %r9d
+	cmpl %r9d, %r8d
+	je .L6_10
+# tests/switches.c 93 expression
+	movq %rbx, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/switches.c 94 expression
+	movl $58, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/switches.c 95 expression
+	movq %r12, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/switches.c 96 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+.L6_10:
+# tests/switches.c 98 expression
+	addl $1, %ebx
+.L6_11:
+	movq %rbx, %r8
+	movl $1000, %r9d
+	cmpl %r9d, %r8d
+	jle .L6_3
+# tests/switches.c 98 expression
+# tests/switches.c 99 expression
+	movl $10, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/switches.c 100 expression
+	movl $1, %r8d
+	movl $1, %r9d
+	movq %r9, %rbx
+	movq %r8, %r9
+	movq %r9, %r12
+	movl %r8d, %eax
+	cmpl $1, %eax
+	je .L6_12
+	cmpl $2, %eax
+	je .L6_16
+	jmp .L6_17
+.L6_12:
+	movq %rbx, %r8
+	movl %r8d, %eax
+	cmpl $1, %eax
+	je .L6_13
+	cmpl $2, %eax
+	je .L6_14
+	jmp .L6_15
+.L6_13:
+	movl $11, %r8d
+	jmp .L6_18
+.L6_14:
+	movl $12, %r8d
+	jmp .L6_18
+.L6_15:
+	movl $10, %r8d
+	jmp .L6_18
+.L6_16:
+	movl $20, %r8d
+	jmp .L6_18
+.L6_17:
+	movl $-1, %r8d
+.L6_18:
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/switches.c 101 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/switches.c 102 expression
+	movl $1, %r8d
+	movl $2, %r9d
+	movq %r9, %rbx
+	movq %r8, %r9
+	movq %r9, %r12
+	movl %r8d, %eax
+	cmpl $1, %eax
+	je .L6_19
+	cmpl $2, %eax
+	je .L6_23
+	jmp .L6_24
+.L6_19:
+	movq %rbx, %r8
+	movl %r8d, %eax
+	cmpl $1, %eax
+	je .L6_20
+	cmpl $2, %eax
+	je .L6_21
+	jmp .L6_22
+.L6_20:
+	movl $11, %r8d
+	jmp .L6_25
+.L6_21:
+	movl $12, %r8d
+	jmp .L6_25
+.L6_22:
+	movl $10, %r8d
+	jmp .L6_25
+.L6_23:
+	movl $20, %r8d
+	jmp .L6_25
+.L6_24:
+	movl $-1, %r8d
+.L6_25:
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/switches.c 103 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/switches.c 104 expression
+	movl $1, %r8d
+	movl $3, %r9d
+	movq %r9, %rbx
+	movq %r8, %r9
+	movq %r9, %r12
+	movl %r8d, %eax
+	cmpl $1, %eax
+	je .L6_26
+	cmpl $2, %eax
+	je .L6_30
+	jmp .L6_31
+.L6_26:
+	movq %rbx, %r8
+	movl %r8d, %eax
+	cmpl $1, %eax
+	je .L6_27
+	cmpl $2, %eax
+	je .L6_28
+	jmp .L6_29
+.L6_27:
+	movl $11, %r8d
+	jmp .L6_32
+.L6_28:
+	movl $12, %r8d
+	jmp .L6_32
+.L6_29:
+	movl $10, %r8d
+	jmp .L6_32
+.L6_30:
+	movl $20, %r8d
+	jmp .L6_32
+.L6_31:
+	movl $-1, %r8d
+.L6_32:
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/switches.c 105 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/switches.c 106 expression
+	movl $2, %r8d
+	movl $0, %r9d
+	movq %r9, %rbx
+	movq %r8, %r9
+	movq %r9, %r12
+	movl %r8d, %eax
+	cmpl $1, %eax
+	je .L6_33
+	cmpl $2, %eax
+	je .L6_37
+	jmp .L6_38
+.L6_33:
+	movq %rbx, %r8
+	movl %r8d, %eax
+	cmpl $1, %eax
+	je .L6_34
+	cmpl $2, %eax
+	je .L6_35
+	jmp .L6_36
+.L6_34:
+	movl $11, %r8d
+	jmp .L6_39
+.L6_35:
+	movl $12, %r8d
+	jmp .L6_39
+.L6_36:
+	movl $10, %r8d
+	jmp .L6_39
+.L6_37:
+	movl $20, %r8d
+	jmp .L6_39
+.L6_38:
+	movl $-1, %r8d
+.L6_39:
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/switches.c 107 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/switches.c 108 expression
+	movl $3, %r8d
+	movl $0, %r9d
+	movq %r9, %rbx
+	movq %r8, %r9
+	movq %r9, %r12
+	movl %r8d, %eax
+	cmpl $1, %eax
+	je .L6_40
+	cmpl $2, %eax
+	je .L6_44
+	jmp .L6_45
+.L6_40:
+	movq %rbx, %r8
+	movl %r8d, %eax
+	cmpl $1, %eax
+	je .L6_41
+	cmpl $2, %eax
+	je .L6_42
+	jmp .L6_43
+.L6_41:
+	movl $11, %r8d
+	jmp .L6_46
+.L6_42:
+	movl $12, %r8d
+	jmp .L6_46
+.L6_43:
+	movl $10, %r8d
+	jmp .L6_46
+.L6_44:
+	movl $20, %r8d
+	jmp .L6_46
+.L6_45:
+	movl $-1, %r8d
+.L6_46:
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/switches.c 109 expression
+	movl $10, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/switches.c 110 return
+	movl $0, %r8d
+	movl %r8d, %eax
+	jmp .L6_ret
+.L6_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	leave
+	ret
+	.size f_main, .-f_main
+
+	.globl main
+	.type main, @function
+main:
+	pushq %rbp
+	movq %rsp, %rbp
+	call f_main
+	xorl %eax, %eax
+	popq %rbp
+	ret
+	.size main, .-main
+	.section .rodata
+.Lreturn_code:
+	.string "Return code: %d\n"
+	.text
+
+	.p2align 4
+mycc_newarray:
+	pushq %rbp
+	movq %rsp, %rbp
+	pushq %rbx
+	subq $8, %rsp
+	testl %edi, %edi
+	js .Lnegative
+	movl %edi, %ebx
+	movslq %edi, %rdi
+	movslq %esi, %rsi
+	imulq %rdi, %rsi
+	addq $8, %rsi
+	movl $1, %edi
+	call calloc@PLT
+	testq %rax, %rax
+	je .Lnomemory
+	movl %ebx, 4(%rax)
+	addq $8, %rax
+	movq -8(%rbp), %rbx
+	leave
+	ret
+.Lnegative:
+	leaq .Lnegative_msg(%rip), %rdi
+	jmp mycc_throw
+.Lnomemory:
+	leaq .Lnomemory_msg(%rip), %rdi
+	jmp mycc_throw
+mycc_bounds:
+	leaq .Lbounds_msg(%rip), %rdi
+	jmp mycc_throw
+mycc_divzero:
+	leaq .Ldivzero_msg(%rip), %rdi
+mycc_throw:
+	andq $-16, %rsp
+	movq stderr@GOTPCREL(%rip), %rax
+	movq (%rax), %rsi
+	call fputs@PLT
+	movl $1, %edi
+	call exit@PLT
+	.section .rodata
+.Lnegative_msg:
+	.string "Exception: java.lang.NegativeArraySizeException\n"
+.Lnomemory_msg:
+	.string "Exception: java.lang.OutOfMemoryError\n"
+.Lbounds_msg:
+	.string "Exception: java.lang.ArrayIndexOutOfBoundsException\n"
+.Ldivzero_msg:
+	.string "Exception: java.lang.ArithmeticException: / by zero\n"
+	.section .note.GNU-stack,"",@progbits
@@ -0,0 +1,67 @@
+/*
+  Self tail calls become jumps: arguments that read each other's
+  old values, an accumulator deep enough to need the jump, a void
+  function, and a call that is not in tail position.
+*/
+
+int putchar(int c);
+
+void print(int x)
+{
+  if (x < 0) {
+    putchar(45);
+    x = -x;
+  }
+  if (x >= 10) print(x / 10);
+  putchar(48 + x % 10);
+}
+
+void space()
+{
+  putchar(32);
+}
+
+int gcd(int a, int b)
+{
+  if (b == 0) return a;
+  return gcd(b, a % b);
+}
+
+int sum(int n, int acc)
+{
+  if (n == 0) return acc;
+  return sum(n - 1, acc + n % 7);
+}
+
+void digits(int x, int n)
+{
+  if (n == 0) return;
+  putchar(48 + x % 10);
+  digits(x / 10, n - 1);
+}
+
+int fib(int n)
+{
+  if (n < 2) return n;
+  return fib(n - 1) + fib(n - 2);
+}
+
+int main()
+{
+  int r;
+  r = gcd(1071, 462);
+  print(r);
+  space();
+  r = gcd(17, 5);
+  print(r);
+  space();
+  r = sum(100000, 0);
+  print(r);
+  space();
+  digits(12345, 5);
+  space();
+  r = fib(15);
+  print(r);
+  putchar(10);
+  return 0;
+}
@@ -0,0 +1,342 @@
+/* C code for tests/tailcall.c, from mycc */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef union { int32_t i; float f; void* p; } value;
+static const value mycc_zero;
+
+static inline int32_t mycc_add(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a + (uint32_t) b); }
+static inline int32_t mycc_sub(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a - (uint32_t) b); }
+static inline int32_t mycc_mul(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a * (uint32_t) b); }
+static inline int32_t mycc_neg(int32_t a) { return (int32_t) (0u - (uint32_t) a); }
+
+static inline void mycc_throw(const char* what)
+{
+  fprintf(stderr, "Exception: %s\n", what);
+  exit(1);
+}
+
+static inline int32_t mycc_div(int32_t a, int32_t b)
+{
+  if (0 == b) mycc_throw("java.lang.ArithmeticException: / by zero");
+  return (-1 == b) ? mycc_neg(a) : a / b;
+}
+
+static inline int32_t mycc_rem(int32_t a, int32_t b)
+{
+  if (0 == b) mycc_throw("java.lang.ArithmeticException: / by zero");
+  return (-1 == b) ? 0 : a % b;
+}
+
+/* Arrays and strings have their length in the word before element 0 */
+static inline void* mycc_newarray(int32_t n, size_t size)
+{
+  if (n < 0) mycc_throw("java.lang.NegativeArraySizeException");
+  int32_t* p = calloc(1, sizeof(int32_t) + (size_t) n * size);
+  if (0 == p) mycc_throw("java.lang.OutOfMemoryError");
+  p[0] = n;
+  return p + 1;
+}
+
+static inline int32_t mycc_index(const void* p, int32_t i)
+{
+  if ((uint32_t) i >= (uint32_t) ((const int32_t*) p)[-1])
+    mycc_throw("java.lang.ArrayIndexOutOfBoundsException");
+  return i;
+}
+
+void f_print(value l0);
+void f_space(void);
+value f_gcd(value l0, value l1);
+value f_sum(value l0, value l1);
+void f_digits(value l0, value l1);
+value f_fib(value l0);
+value f_main(void);
+
+void f_print(value l0)
+{
+  value s0;
+  value s1;
+  value s2;
+  s0 = l0;
+  s1.i = 0;
+  if (s0.i >= s1.i) goto L1;
+#line 12 "tests/tailcall.c"
+  s0.i = 45;
+  s0.i = putchar(s0.i);
+#line 13 "tests/tailcall.c"
+  s0 = l0;
+  s0.i = mycc_neg(s0.i);
+  l0 = s0;
+ L1:;
+#line 15 "tests/tailcall.c"
+  s0 = l0;
+  s1.i = 10;
+  if (s0.i < s1.i) goto L2;
+#line 15 "tests/tailcall.c"
+  s0 = l0;
+  s1.i = 10;
+  s0.i = mycc_div(s0.i, s1.i);
+  f_print(s0);
+ L2:;
+#line 16 "tests/tailcall.c"
+#line 16 "tests/tailcall.c"
+  s0.i = 48;
+  s1 = l0;
+  s2.i = 10;
+  s1.i = mycc_rem(s1.i, s2.i);
+  s0.i = mycc_add(s0.i, s1.i);
+  s0.i = putchar(s0.i);
+  return;
+}
+
+void f_space(void)
+{
+  value s0;
+#line 21 "tests/tailcall.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+  return;
+}
+
+value f_gcd(value l0, value l1)
+{
+  value s0;
+  value s1;
+  value s2;
+ L1:;
+  s0 = l1;
+  s1.i = 0;
+  if (s0.i != s1.i) goto L2;
+#line 26 "tests/tailcall.c"
+  s0 = l0;
+  return s0;
+ L2:;
+#line 27 "tests/tailcall.c"
+#line 27 "tests/tailcall.c"
+  s0 = l1;
+  s1 = l0;
+  s2 = l1;
+  s1.i = mycc_rem(s1.i, s2.i);
+  l1 = s1;
+  l0 = s0;
+  goto L1;
+}
+
+value f_sum(value l0, value l1)
+{
+  value s0;
+  value s1;
+  value s2;
+  value s3;
+ L1:;
+  s0 = l0;
+  s1.i = 0;
+  if (s0.i != s1.i) goto L2;
+#line 32 "tests/tailcall.c"
+  s0 = l1;
+  return s0;
+ L2:;
+#line 33 "tests/tailcall.c"
+#line 33 "tests/tailcall.c"
+  s0 = l0;
+  s1.i = 1;
+  s0.i = mycc_sub(s0.i, s1.i);
+  s1 = l1;
+  s2 = l0;
+  s3.i = 7;
+  s2.i = mycc_rem(s2.i, s3.i);
+  s1.i = mycc_add(s1.i, s2.i);
+  l1 = s1;
+  l0 = s0;
+  goto L1;
+}
+
+void f_digits(value l0, value l1)
+{
+  value s0;
+  value s1;
+  value s2;
+ L1:;
+  s0 = l1;
+  s1.i = 0;
+  if (s0.i != s1.i) goto L2;
+#line 38 "tests/tailcall.c"
+  return;
+ L2:;
+#line 39 "tests/tailcall.c"
+#line 39 "tests/tailcall.c"
+  s0.i = 48;
+  s1 = l0;
+  s2.i = 10;
+  s1.i = mycc_rem(s1.i, s2.i);
+  s0.i = mycc_add(s0.i, s1.i);
+  s0.i = putchar(s0.i);
+#line 40 "tests/tailcall.c"
+  s0 = l0;
+  s1.i = 10;
+  s0.i = mycc_div(s0.i, s1.i);
+  l1.i = mycc_add(l1.i, -1);
+  l0 = s0;
+  goto L1;
+}
+
+value f_fib(value l0)
+{
+  value s0;
+  value s1;
+  value s2;
+  s0 = l0;
+  s1.i = 2;
+  if (s0.i >= s1.i) goto L1;
+#line 45 "tests/tailcall.c"
+  s0 = l0;
+  return s0;
+ L1:;
+#line 46 "tests/tailcall.c"
+#line 46 "tests/tailcall.c"
+  s0 = l0;
+  s1.i = 1;
+  s0.i = mycc_sub(s0.i, s1.i);
+  s0 = f_fib(s0);
+  s1 = l0;
+  s2.i = 2;
+  s1.i = mycc_sub(s1.i, s2.i);
+  s1 = f_fib(s1);
+  s0.i = mycc_add(s0.i, s1.i);
+  return s0;
+}
+
+value f_main(void)
+{
+  value l0 = mycc_zero;
+  value l1 = mycc_zero;
+  value s0;
+  value s1;
+  value s2;
+  value s3;
+#line 52 "tests/tailcall.c"
+  s0.i = 1071;
+  s1.i = 462;
+  l0 = s1;
+  l1 = s0;
+ L1:;
+  s0 = l0;
+  s1.i = 0;
+  if (s0.i != s1.i) goto L2;
+#line 53 "tests/tailcall.c"
+  s0 = l1;
+  f_print(s0);
+#line 54 "tests/tailcall.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 55 "tests/tailcall.c"
+  s0.i = 17;
+  s1.i = 5;
+  l0 = s1;
+  l1 = s0;
+  goto L3;
+ L2:;
+  s0 = l0;
+  s1 = l1;
+  s2 = l0;
+  s1.i = mycc_rem(s1.i, s2.i);
+  l0 = s1;
+  l1 = s0;
+  goto L1;
+ L3:;
+  s0 = l0;
+  s1.i = 0;
+  if (s0.i != s1.i) goto L4;
+#line 56 "tests/tailcall.c"
+  s0 = l1;
+  f_print(s0);
+#line 57 "tests/tailcall.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 58 "tests/tailcall.c"
+  s0.i = 100000;
+  s1.i = 0;
+  l0 = s1;
+  l1 = s0;
+  goto L5;
+ L4:;
+  s0 = l0;
+  s1 = l1;
+  s2 = l0;
+  s1.i = mycc_rem(s1.i, s2.i);
+  l0 = s1;
+  l1 = s0;
+  goto L3;
+ L5:;
+  s0 = l1;
+  s1.i = 0;
+  if (s0.i != s1.i) goto L6;
+#line 59 "tests/tailcall.c"
+  s0 = l0;
+  f_print(s0);
+#line 60 "tests/tailcall.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 61 "tests/tailcall.c"
+  s0.i = 12345;
+  s1.i = 5;
+  l0 = s1;
+  l1 = s0;
+  goto L7;
+ L6:;
+  s0 = l1;
+  s1.i = 1;
+  s0.i = mycc_sub(s0.i, s1.i);
+  s1 = l0;
+  s2 = l1;
+  s3.i = 7;
+  s2.i = mycc_rem(s2.i, s3.i);
+  s1.i = mycc_add(s1.i, s2.i);
+  l0 = s1;
+  l1 = s0;
+  goto L5;
+ L7:;
+  s0 = l0;
+  s1.i = 0;
+  if (s0.i != s1.i) goto L8;
+#line 62 "tests/tailcall.c"
+  s0.i = 32;
+  s0.i = putchar(s0.i);
+#line 63 "tests/tailcall.c"
+  s0.i = 15;
+  s0 = f_fib(s0);
+  l0 = s0;
+#line 64 "tests/tailcall.c"
+  s0 = l0;
+  f_print(s0);
+#line 65 "tests/tailcall.c"
+  s0.i = 10;
+  s0.i = putchar(s0.i);
+#line 66 "tests/tailcall.c"
+  s0.i = 0;
+  return s0;
+ L8:;
+  s0.i = 48;
+  s1 = l1;
+  s2.i = 10;
+  s1.i = mycc_rem(s1.i, s2.i);
+  s0.i = mycc_add(s0.i, s1.i);
+  s0.i = putchar(s0.i);
+  s0 = l1;
+  s1.i = 10;
+  s0.i = mycc_div(s0.i, s1.i);
+  l0.i = mycc_add(l0.i, -1);
+  l1 = s0;
+  goto L7;
+}
+
+int main(void)
+{
+  value r = f_main();
+  (void) r;
+  return 0;
+}
@@ -0,0 +1,607 @@
+# x86-64 code for tests/tailcall.c
+	.file "tests/tailcall.c"
+	.text
+
+	.p2align 4
+	.type f_print, @function
+f_print:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jge .L1_1
+# tests/tailcall.c 12 expression
+	movl $45, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/tailcall.c 13 expression
+	movq %rbx, %r8
+	negl %r8d
+	movq %r8, %rbx
+.L1_1:
+# tests/tailcall.c 15 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	cmpl %r9d, %r8d
+	jl .L1_2
+# tests/tailcall.c 15 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	movl %r8d, %eax
+	movl %r9d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L1x0
+	negl %eax
+	jmp .L1y0
+.L1x0:
+	cltd
+	idivl %ecx
+.L1y0:
+	movl %eax, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_print
+.L1_2:
+# tests/tailcall.c 16 expression
+# tests/tailcall.c 16 expression
+	movl $48, %r8d
+	movq %rbx, %r9
+	movl $10, %r10d
+	movl %r9d, %eax
+	movl %r10d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L1x1
+	xorl %eax, %eax
+	jmp .L1y1
+.L1x1:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L1y1:
+	movl %eax, %r9d
+	addl %r9d, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	jmp .L1_ret
+.L1_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_print, .-f_print
+
+	.p2align 4
+	.type f_space, @function
+f_space:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $16, %rsp
+# tests/tailcall.c 21 expression
+	movl $32, %r8d
+	movq %r8, -8(%rbp)
+	movq -8(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	jmp .L2_ret
+.L2_ret:
+	leave
+	ret
+	.size f_space, .-f_space
+
+	.p2align 4
+	.type f_gcd, @function
+f_gcd:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %rdi, %rbx
+	movq %rsi, %r12
+.L3_1:
+	movq %r12, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jne .L3_2
+# tests/tailcall.c 26 return
+	movq %rbx, %r8
+	movl %r8d, %eax
+	jmp .L3_ret
+.L3_2:
+# tests/tailcall.c 27 expression
+# tests/tailcall.c 27 return
+	movq %r12, %r8
+	movq %rbx, %r9
+	movq %r12, %r10
+	movl %r9d, %eax
+	movl %r10d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L3x0
+	xorl %eax, %eax
+	jmp .L3y0
+.L3x0:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L3y0:
+	movl %eax, %r9d
+	movq %r9, %r12
+	movq %r8, %rbx
+	jmp .L3_1
+.L3_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	leave
+	ret
+	.size f_gcd, .-f_gcd
+
+	.p2align 4
+	.type f_sum, @function
+f_sum:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %rdi, %rbx
+	movq %rsi, %r12
+.L4_1:
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jne .L4_2
+# tests/tailcall.c 32 return
+	movq %r12, %r8
+	movl %r8d, %eax
+	jmp .L4_ret
+.L4_2:
+# tests/tailcall.c 33 expression
+# tests/tailcall.c 33 return
+	movq %rbx, %r8
+	movl $1, %r9d
+	subl %r9d, %r8d
+	movq %r12, %r9
+	movq %rbx, %r10
+	movl $7, %r11d
+	movl %r10d, %eax
+	movl %r11d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L4x0
+	xorl %eax, %eax
+	jmp .L4y0
+.L4x0:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L4y0:
+	movl %eax, %r10d
+	addl %r10d, %r9d
+	movq %r9, %r12
+	movq %r8, %rbx
+	jmp .L4_1
+.L4_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	leave
+	ret
+	.size f_sum, .-f_sum
+
+	.p2align 4
+	.type f_digits, @function
+f_digits:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+	movq %rdi, %rbx
+	movq %rsi, %r12
+.L5_1:
+	movq %r12, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jne .L5_2
+# tests/tailcall.c 38 return
+	jmp .L5_ret
+.L5_2:
+# tests/tailcall.c 39 expression
+# tests/tailcall.c 39 expression
+	movl $48, %r8d
+	movq %rbx, %r9
+	movl $10, %r10d
+	movl %r9d, %eax
+	movl %r10d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L5x0
+	xorl %eax, %eax
+	jmp .L5y0
+.L5x0:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L5y0:
+	movl %eax, %r9d
+	addl %r9d, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/tailcall.c 40 expression
+	movq %rbx, %r8
+	movl $10, %r9d
+	movl %r8d, %eax
+	movl %r9d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L5x1
+	negl %eax
+	jmp .L5y1
+.L5x1:
+	cltd
+	idivl %ecx
+.L5y1:
+	movl %eax, %r8d
+	addl $-1, %r12d
+	movq %r8, %rbx
+	jmp .L5_1
+.L5_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	leave
+	ret
+	.size f_digits, .-f_digits
+
+	.p2align 4
+	.type f_fib, @function
+f_fib:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $32, %rsp
+	movq %rbx, -8(%rbp)
+	movq %rdi, %rbx
+	movq %rbx, %r8
+	movl $2, %r9d
+	cmpl %r9d, %r8d
+	jge .L6_1
+# tests/tailcall.c 45 return
+	movq %rbx, %r8
+	movl %r8d, %eax
+	jmp .L6_ret
+.L6_1:
+# tests/tailcall.c 46 expression
+# tests/tailcall.c 46 return
+	movq %rbx, %r8
+	movl $1, %r9d
+	subl %r9d, %r8d
+	movq %r8, -16(%rbp)
+	movq -16(%rbp), %rdi
+	call f_fib
+	movl %eax, %r8d
+	movq %rbx, %r9
+	movl $2, %r10d
+	subl %r10d, %r9d
+	movq %r8, -16(%rbp)
+	movq %r9, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_fib
+	movq -16(%rbp), %r8
+	movl %eax, %r9d
+	addl %r9d, %r8d
+	movl %r8d, %eax
+	jmp .L6_ret
+.L6_ret:
+	movq -8(%rbp), %rbx
+	leave
+	ret
+	.size f_fib, .-f_fib
+
+	.p2align 4
+	.type f_main, @function
+f_main:
+	pushq %rbp
+	movq %rsp, %rbp
+	subq $48, %rsp
+	movq %rbx, -8(%rbp)
+	movq %r12, -16(%rbp)
+# tests/tailcall.c 52 expression
+	movl $1071, %r8d
+	movl $462, %r9d
+	movq %r9, %rbx
+	movq %r8, %r12
+.L7_1:
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jne .L7_2
+# tests/tailcall.c 53 expression
+	movq %r12, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/tailcall.c 54 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/tailcall.c 55 expression
+	movl $17, %r8d
+	movl $5, %r9d
+	movq %r9, %rbx
+	movq %r8, %r12
+	jmp .L7_3
+.L7_2:
+	movq %rbx, %r8
+	movq %r12, %r9
+	movq %rbx, %r10
+	movl %r9d, %eax
+	movl %r10d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L7x0
+	xorl %eax, %eax
+	jmp .L7y0
+.L7x0:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L7y0:
+	movl %eax, %r9d
+	movq %r9, %rbx
+	movq %r8, %r12
+	jmp .L7_1
+.L7_3:
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jne .L7_4
+# tests/tailcall.c 56 expression
+	movq %r12, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/tailcall.c 57 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/tailcall.c 58 expression
+	movl $100000, %r8d
+	movl $0, %r9d
+	movq %r9, %rbx
+	movq %r8, %r12
+	jmp .L7_5
+.L7_4:
+	movq %rbx, %r8
+	movq %r12, %r9
+	movq %rbx, %r10
+	movl %r9d, %eax
+	movl %r10d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L7x1
+	xorl %eax, %eax
+	jmp .L7y1
+.L7x1:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L7y1:
+	movl %eax, %r9d
+	movq %r9, %rbx
+	movq %r8, %r12
+	jmp .L7_3
+.L7_5:
+	movq %r12, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jne .L7_6
+# tests/tailcall.c 59 expression
+	movq %rbx, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/tailcall.c 60 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/tailcall.c 61 expression
+	movl $12345, %r8d
+	movl $5, %r9d
+	movq %r9, %rbx
+	movq %r8, %r12
+	jmp .L7_7
+.L7_6:
+	movq %r12, %r8
+	movl $1, %r9d
+	subl %r9d, %r8d
+	movq %rbx, %r9
+	movq %r12, %r10
+	movl $7, %r11d
+	movl %r10d, %eax
+	movl %r11d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L7x2
+	xorl %eax, %eax
+	jmp .L7y2
+.L7x2:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L7y2:
+	movl %eax, %r10d
+	addl %r10d, %r9d
+	movq %r9, %rbx
+	movq %r8, %r12
+	jmp .L7_5
+.L7_7:
+	movq %rbx, %r8
+	movl $0, %r9d
+	cmpl %r9d, %r8d
+	jne .L7_8
+# tests/tailcall.c 62 expression
+	movl $32, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/tailcall.c 63 expression
+	movl $15, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_fib
+	movl %eax, %r8d
+	movq %r8, %rbx
+# tests/tailcall.c 64 expression
+	movq %rbx, %r8
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call f_print
+# tests/tailcall.c 65 expression
+	movl $10, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+# tests/tailcall.c 66 return
+	movl $0, %r8d
+	movl %r8d, %eax
+	jmp .L7_ret
+.L7_8:
+	movl $48, %r8d
+	movq %r12, %r9
+	movl $10, %r10d
+	movl %r9d, %eax
+	movl %r10d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L7x3
+	xorl %eax, %eax
+	jmp .L7y3
+.L7x3:
+	cltd
+	idivl %ecx
+	movl %edx, %eax
+.L7y3:
+	movl %eax, %r9d
+	addl %r9d, %r8d
+	movq %r8, -24(%rbp)
+	movq -24(%rbp), %rdi
+	call putchar@PLT
+	movl %eax, %r8d
+	movq %r12, %r8
+	movl $10, %r9d
+	movl %r8d, %eax
+	movl %r9d, %ecx
+	testl %ecx, %ecx
+	je mycc_divzero
+	cmpl $-1, %ecx
+	jne .L7x4
+	negl %eax
+	jmp .L7y4
+.L7x4:
+	cltd
+	idivl %ecx
+.L7y4:
+	movl %eax, %r8d
+	addl $-1, %ebx
+	movq %r8, %r12
+	jmp .L7_7
+.L7_ret:
+	movq -8(%rbp), %rbx
+	movq -16(%rbp), %r12
+	leave
+	ret
+	.size f_main, .-f_main
+
+	.globl main
+	.type main, @function
+main:
+	pushq %rbp
+	movq %rsp, %rbp
+	call f_main
+	xorl %eax, %eax
+	popq %rbp
+	ret
+	.size main, .-main
+	.section .rodata
+.Lreturn_code:
+	.string "Return code: %d\n"
+	.text
+
+	.p2align 4
+mycc_newarray:
+	pushq %rbp
+	movq %rsp, %rbp
+	pushq %rbx
+	subq $8, %rsp
+	testl %edi, %edi
+	js .Lnegative
+	movl %edi, %ebx
+	movslq %edi, %rdi
+	movslq %esi, %rsi
+	imulq %rdi, %rsi
+	addq $8, %rsi
+	movl $1, %edi
+	call calloc@PLT
+	testq %rax, %rax
+	je .Lnomemory
+	movl %ebx, 4(%rax)
+	addq $8, %rax
+	movq -8(%rbp), %rbx
+	leave
+	ret
+.Lnegative:
+	leaq .Lnegative_msg(%rip), %rdi
+	jmp mycc_throw
+.Lnomemory:
+	leaq .Lnomemory_msg(%rip), %rdi
+	jmp mycc_throw
+mycc_bounds:
+	leaq .Lbounds_msg(%rip), %rdi
+	jmp mycc_throw
+mycc_divzero:
+	leaq .Ldivzero_msg(%rip), %rdi
+mycc_throw:
+	andq $-16, %rsp
+	movq stderr@GOTPCREL(%rip), %rax
+	movq (%rax), %rsi
+	call fputs@PLT
+	movl $1, %edi
+	call exit@PLT
+	.section .rodata
+.Lnegative_msg:
+	.string "Exception: java.lang.NegativeArraySizeException\n"
+.Lnomemory_msg:
+	.string "Exception: java.lang.OutOfMemoryError\n"
+.Lbounds_msg:
+	.string "Exception: java.lang.ArrayIndexOutOfBoundsException\n"
+.Ldivzero_msg:
+	.string "Exception: java.lang.ArithmeticException: / by zero\n"
+	.section .note.GNU-stack,"",@progbits
@@ -12,23 +12,16 @@
 #include "grammar.tab.h"  /* tokens defined here */
 
 /*
-  Just get tokens (mode 1)?
+  The scanner is reentrant: its state, and ours (yyextra,
+  which knows whether we just want tokens, for mode 1, and
+  where a comment started, for unclosed comment errors),
+  belong to one compilation.
 */
-extern char tokens_only;
-extern int loop;
-extern int if_flag;
-
-/*
-  Keep track of when a comment starts
-  so we can give an error on unclosed comments
-*/
-int start_comment;
-
-extern const char* filename;
-extern const char* jvm_file;
 %}
 
-%option yylineno
+%option reentrant bison-bridge
+%option extra-type="lexer_state*"
+%option yylineno noyywrap nounput noinput
 
 %x COMMENT
 
@@ -53,12 +46,12 @@ ident         {letter}{alphanum}*
 
 %%
 
-"/*"                  { start_comment = yylineno; BEGIN(COMMENT); }
+"/*"                  { yyextra->start_comment = yylineno; BEGIN(COMMENT); }
 <COMMENT>"*/"         { BEGIN(INITIAL); }
 <COMMENT>[^*\n]*      { /* Inside C comment */ }
 <COMMENT>.            { /* Inside C comment */ }
 <COMMENT>\n           { /* Inside C comment */ }
-<COMMENT><<EOF>>      { return unclosedComment(start_comment); }
+<COMMENT><<EOF>>      { return unclosedComment(yyextra->start_comment); }
 "//"{notendl}*        { /* C++ comment, ignored */ }
 \n                    { /* Ignored */ }
 {white}               { /* Ignored */ }
@@ -71,32 +64,35 @@ ident         {letter}{alphanum}*
 "#else"                       { ignoringDirective("#else"); }
 "#endif"                      { ignoringDirective("#endif"); }
 
-"void"                { yylval.type.set('V'); yylval.type.setBytecode(strdup(yytext));  return TYPE; }
-"int"                 { yylval.type.set('I'); yylval.type.setBytecode(strdup(yytext));  return TYPE; }
-"char"                { yylval.type.set('C'); yylval.type.setBytecode(strdup(yytext));  return TYPE; }
-"float"               { yylval.type.set('F'); yylval.type.setBytecode(strdup(yytext));  return TYPE; }
+"void"                { yylval->type.set('V'); yylval->type.setBytecode(yytext, yyleng);  return TYPE; }
+"int"                 { yylval->type.set('I'); yylval->type.setBytecode(yytext, yyleng);  return TYPE; }
+"char"                { yylval->type.set('C'); yylval->type.setBytecode(yytext, yyleng);  return TYPE; }
+"float"               { yylval->type.set('F'); yylval->type.setBytecode(yytext, yyleng);  return TYPE; }
 
 "const"               { return CONST; }
 "struct"              { return STRUCT; }
 
 "for"                 { return FOR; }
-"while"               { loop = 1; return WHILE; }
+"while"               { return WHILE; }
 "do"                  { return DO; }
-"if"                  { if_flag = 1; return IF; }
+"if"                  { return IF; }
 "else"                { return ELSE; }
 "break"               { return BREAK; }
 "continue"            { return CONTINUE; }
 "return"              { return RETURN; }
-
-{digit}+              { yylval.type.set('I', false); yylval.type.setBytecode(strdup(yytext)); return INTCONST; }
-{digit}+{dec}?{exp}?  { yylval.type.set('F', false); yylval.type.setBytecode(strdup(yytext)); return REALCONST; }
-{dec}{exp}?           { yylval.type.set('F', false); yylval.type.setBytecode(strdup(yytext)); return REALCONST; }
-{ident}               { if (!tokens_only) { yylval.name = strdup(yytext); }
+"switch"              { return SWITCH; }
+"case"                { return CASE; }
+"default"             { return DEFAULT; }
+
+{digit}+              { yylval->type.set('I', false); yylval->type.setBytecode(yytext, yyleng); return INTCONST; }
+{digit}+{dec}?{exp}?  { yylval->type.set('F', false); yylval->type.setBytecode(yytext, yyleng); return REALCONST; }
+{dec}{exp}?           { yylval->type.set('F', false); yylval->type.setBytecode(yytext, yyleng); return REALCONST; }
+{ident}               { if (!yyextra->tokens_only) { yylval->name = atom_table::intern(yytext, yyleng); }
                         return IDENT; 
                       }
-{qstring}             { yylval.type.set('C', true); yylval.type.setBytecode(strdup(yytext)); return STRCONST; }
-{qchar}               { yylval.type.set('C', false); yylval.type.setBytecode(strdup(yytext)); return CHARCONST; }
-{qspecial}            { yylval.type.set('C', false); yylval.type.setBytecode(strdup(yytext)); return CHARCONST; }
+{qstring}             { yylval->type.set('C', true); yylval->type.setBytecode(yytext, yyleng); return STRCONST; }
+{qchar}               { yylval->type.set('C', false); yylval->type.setBytecode(yytext, yyleng); return CHARCONST; }
+{qspecial}            { yylval->type.set('C', false); yylval->type.setBytecode(yytext, yyleng); return CHARCONST; }
 
 "("                   { return LPAR; }
 ")"                   { return RPAR; }
@@ -111,15 +107,15 @@ ident         {letter}{alphanum}*
 "?"                   { return QUEST; }
 ":"                   { return COLON; }
 
-"+"                   { yylval.type.setBytecode("plus"); return PLUS; }
-"-"                   { yylval.type.setBytecode("sub"); return MINUS; }
-"*"                   { yylval.type.setBytecode("mul"); return STAR; }
-"/"                   { yylval.type.setBytecode("div"); return SLASH; }
-"%"                   { yylval.type.setBytecode("rem"); return MOD; }
+"+"                   { yylval->type.setOpcode("plus"); return PLUS; }
+"-"                   { yylval->type.setOpcode("sub"); return MINUS; }
+"*"                   { yylval->type.setOpcode("mul"); return STAR; }
+"/"                   { yylval->type.setOpcode("div"); return SLASH; }
+"%"                   { yylval->type.setOpcode("rem"); return MOD; }
 "~"                   { return TILDE; }
 
-"|"                   { yylval.type.setBytecode("or"); return PIPE; }
-"&"                   { yylval.type.setBytecode("and"); return AMP; }
+"|"                   { yylval->type.setOpcode("or"); return PIPE; }
+"&"                   { yylval->type.setOpcode("and"); return AMP; }
 "!"                   { return BANG; }
 "||"                  { return DPIPE; }
 "&&"                  { return DAMP; }
@@ -132,12 +128,12 @@ ident         {letter}{alphanum}*
 "++"                  { return INCR; }
 "--"                  { return DECR; }
 
-"=="                  { yylval.type.setBytecode("if_icmpeq"); return EQUALS; }
-"!="                  { yylval.type.setBytecode("if_icmpne"); return NEQUAL; }
-">"                   { yylval.type.setBytecode("if_icmpge"); return GT; }
-">="                  { yylval.type.setBytecode("if_icmpge"); return GE; }
-"<"                   { yylval.type.setBytecode("if_icmplt"); return LT; }
-"<="                  { yylval.type.setBytecode("if_icmple"); return LE; }
+"=="                  { yylval->type.setOpcode("if_icmpeq"); return EQUALS; }
+"!="                  { yylval->type.setOpcode("if_icmpne"); return NEQUAL; }
+">"                   { yylval->type.setOpcode("if_icmpge"); return GT; }
+">="                  { yylval->type.setOpcode("if_icmpge"); return GE; }
+"<"                   { yylval->type.setOpcode("if_icmplt"); return LT; }
+"<="                  { yylval->type.setOpcode("if_icmple"); return LE; }
 
 .                     { badToken(yytext); }
 
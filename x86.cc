@@ -0,0 +1,811 @@
+
+#include "x86.h"
+#include "lexer.h"
+
+#include <algorithm>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  Registers, in the order of their encodings.
+*/
+enum {
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15
+};
+
+static const char* REG64[16] = {
+  "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+  "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15"
+};
+static const char* REG32[16] = {
+  "eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi",
+  "r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d"
+};
+static const char* REG16[16] = {
+  "ax", "cx", "dx", "bx", "sp", "bp", "si", "di",
+  "r8w", "r9w", "r10w", "r11w", "r12w", "r13w", "r14w", "r15w"
+};
+
+/*
+  rax, rcx and rdx are scratch, for division and for moves
+  between two memory operands.  The operand stack uses registers
+  that calls clobber anyway, and saves them around calls; locals
+  get registers that calls preserve.
+*/
+static const int STACK_REGS[] = { R8, R9, R10, R11, RSI, RDI };
+static const int NSTACK_REGS = sizeof(STACK_REGS) / sizeof(STACK_REGS[0]);
+static const int LOCAL_REGS[] = { RBX, R12, R13, R14, R15 };
+static const int NLOCAL_REGS = sizeof(LOCAL_REGS) / sizeof(LOCAL_REGS[0]);
+static const int INT_ARGS[] = { RDI, RSI, RDX, RCX, R8, R9 };
+static const int NINT_ARGS = 6;
+static const int NFLOAT_ARGS = 8;
+
+/*
+  Counts for -s, over all methods compiled on this thread
+  since clearStats().
+*/
+static thread_local long locals_in_registers;
+static thread_local long locals_spilled;
+
+static inline bool is_local(const instr &I)
+{
+  return (OP_LOAD == I.op) || (OP_STORE == I.op) || (OP_IINC == I.op);
+}
+
+static inline unsigned float_bits(const char* text)
+{
+  float f = strtof(text, 0);
+  unsigned bits;
+  memcpy(&bits, &f, sizeof(bits));
+  return bits;
+}
+
+static const char* jump(int op)
+{
+  switch (op) {
+    case OP_IFEQ: case OP_IF_ICMPEQ:    return "je";
+    case OP_IFNE: case OP_IF_ICMPNE:    return "jne";
+    case OP_IFLT: case OP_IF_ICMPLT:    return "jl";
+    case OP_IFGE: case OP_IF_ICMPGE:    return "jge";
+    case OP_IFGT: case OP_IF_ICMPGT:    return "jg";
+    case OP_IFLE: case OP_IF_ICMPLE:    return "jle";
+  }
+  return "jmp";
+}
+
+/* ====================================================================== */
+
+x86_backend::x86_backend(sink* S, const std::string &classname, const char* src)
+{
+  out = S;
+  owner = classname;
+  srcname = src;
+  failed = false;
+  has_clinit = false;
+  methods = 0;
+  strings = 0;
+  labels = 0;
+
+  out->format("# x86-64 code for %s\n", srcname);
+  out->format("\t.file \"%s\"\n", srcname);
+  out->put("\t.text\n");
+}
+
+x86_backend::~x86_backend()
+{
+  delete out;
+}
+
+void x86_backend::field(atom_id name, char type, bool is_array, const instr* init)
+{
+  unsigned value = 0;
+  if (init && (OP_FCONST == init->op)) value = float_bits(atom_table::name(init->sym));
+  else if (init)                       value = init->a;
+  if ('C' == type) value &= 0xffff;
+
+  out->put("\t.data\n");
+  out->format("\t.p2align %d\n", is_array ? 3 : 2);
+  out->format("g_%s:\n", atom_table::name(name));
+  if (is_array) out->put("\t.quad 0\n");
+  else          out->format("\t.long %u\n", value);
+  out->put("\t.text\n");
+}
+
+std::string x86_backend::operand(const location &L, int width) const
+{
+  char buf[32];
+  if (L.reg >= 0) {
+    const char* const* names = (64 == width) ? REG64 : (32 == width) ? REG32 : REG16;
+    snprintf(buf, sizeof(buf), "%%%s", names[L.reg]);
+  } else {
+    snprintf(buf, sizeof(buf), "%d(%%rbp)", L.offset);
+  }
+  return buf;
+}
+
+std::string x86_backend::label(int L) const
+{
+  char buf[32];
+  snprintf(buf, sizeof(buf), ".L%d_%d", methods, L);
+  return buf;
+}
+
+/*
+  Copy all 64 bits, through rax if both are in memory.
+*/
+void x86_backend::move(const location &to, const location &from)
+{
+  if ((to.reg == from.reg) && ((to.reg >= 0) || (to.offset == from.offset))) return;
+  if ((to.reg < 0) && (from.reg < 0)) {
+    out->format("\tmovq %s, %%rax\n", operand(from, 64).c_str());
+    out->format("\tmovq %%rax, %s\n", operand(to, 64).c_str());
+    return;
+  }
+  out->format("\tmovq %s, %s\n", operand(from, 64).c_str(), operand(to, 64).c_str());
+}
+
+/*
+  Keep the bottom n operand stack entries in memory across a call,
+  and bring them back.
+*/
+void x86_backend::spillStack(int n)
+{
+  for (int k=0; k<n; k++) {
+    if (stack_loc[k].reg < 0) continue;
+    out->format("\tmovq %%%s, %d(%%rbp)\n", REG64[stack_loc[k].reg], stack_home[k]);
+  }
+}
+
+void x86_backend::reloadStack(int n)
+{
+  for (int k=0; k<n; k++) {
+    if (stack_loc[k].reg < 0) continue;
+    out->format("\tmovq %d(%%rbp), %%%s\n", stack_home[k], REG64[stack_loc[k].reg]);
+  }
+}
+
+/* ====================================================================== */
+
+/*
+  Linear scan register allocation of the locals.
+
+  Each local is live over one interval of the code, from its first
+  to its last use; where a branch goes back into or over an interval,
+  the interval grows to take in the whole loop, since the value can
+  go round it.  Intervals are taken in order of their start, each
+  gets a free register if there is one, and otherwise whichever of
+  it and the intervals holding registers ends last goes to memory.
+  Fills in local_loc, and the registers to save in saved;
+  returns how many frame slots that takes.
+*/
+int x86_backend::allocate(const std::vector<instr> &code, int nlocals, int params,
+                          std::vector<int> &saved)
+{
+  std::vector<int> start(nlocals, INT_MAX);
+  std::vector<int> end(nlocals, -1);
+  for (int p=0; p<params && p<nlocals; p++) start[p] = -1;
+
+  std::vector<int> where;
+  for (size_t i=0; i<code.size(); i++) {
+    const instr &I = code[i];
+    if (I.is_label()) {
+      if ((size_t) I.a >= where.size()) where.resize(I.a+1, -1);
+      where[I.a] = i;
+    }
+    if (!is_local(I) || (I.a < 0) || (I.a >= nlocals)) continue;
+    if ((int) i < start[I.a]) start[I.a] = i;
+    if ((int) i > end[I.a])   end[I.a] = i;
+  }
+
+  std::vector< std::pair<int,int> > back;
+  for (size_t i=0; i<code.size(); i++) {
+    if (!code[i].has_target()) continue;
+    int L = code[i].a;
+    if (((size_t) L >= where.size()) || (where[L] < 0) || (where[L] > (int) i)) continue;
+    back.push_back(std::make_pair(where[L], (int) i));
+  }
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t e=0; e<back.size(); e++) {
+      int top = back[e].first, bottom = back[e].second;
+      for (int x=0; x<nlocals; x++) {
+        if ((end[x] < 0) || (start[x] > bottom) || (end[x] < top)) continue;
+        if ((start[x] <= top) && (end[x] >= bottom)) continue;
+        start[x] = std::min(start[x], top);
+        end[x] = std::max(end[x], bottom);
+        changed = true;
+      }
+    }
+  }
+
+  std::vector< std::pair<int,int> > order;
+  for (int x=0; x<nlocals; x++) {
+    if (end[x] >= 0) order.push_back(std::make_pair(start[x], x));
+  }
+  std::sort(order.begin(), order.end());
+
+  std::vector<int> reg(nlocals, -1);
+  std::vector<bool> in_use(NLOCAL_REGS, false);
+  std::vector<bool> used(NLOCAL_REGS, false);
+  std::vector<int> active;
+  for (size_t o=0; o<order.size(); o++) {
+    int x = order[o].second;
+    for (size_t j=0; j<active.size(); ) {
+      if (end[active[j]] >= start[x]) {
+        j++;
+        continue;
+      }
+      in_use[reg[active[j]]] = false;
+      active.erase(active.begin() + j);
+    }
+    int r = 0;
+    while ((r < NLOCAL_REGS) && in_use[r]) r++;
+    if (r == NLOCAL_REGS) {
+      size_t last = 0;
+      for (size_t j=1; j<active.size(); j++) {
+        if (end[active[j]] > end[active[last]]) last = j;
+      }
+      if (active.empty() || (end[active[last]] <= end[x])) continue;
+      r = reg[active[last]];
+      reg[active[last]] = -1;
+      active.erase(active.begin() + last);
+    }
+    reg[x] = r;
+    in_use[r] = true;
+    used[r] = true;
+    active.push_back(x);
+  }
+
+  saved.clear();
+  for (int r=0; r<NLOCAL_REGS; r++) {
+    if (used[r]) saved.push_back(LOCAL_REGS[r]);
+  }
+  int slots = saved.size();
+  local_loc.assign(nlocals, location());
+  for (int x=0; x<nlocals; x++) {
+    local_loc[x].reg = -1;
+    local_loc[x].offset = 0;
+    if (end[x] < 0) continue;
+    if (reg[x] >= 0) {
+      local_loc[x].reg = LOCAL_REGS[reg[x]];
+      locals_in_registers++;
+    } else {
+      local_loc[x].offset = -8 * ++slots;
+      locals_spilled++;
+    }
+  }
+  return slots;
+}
+
+/* ====================================================================== */
+
+void x86_backend::method(const char* name, const char* desc,
+                         const std::vector<instr> &code, const frame_info &frame)
+{
+  if (frame.bad >= 0) {
+    diagnostics() << "Error, can't write native code for " << name << ": " << frame.problem << "\n";
+    failed = true;
+    return;
+  }
+  bool clinit = (0==strcmp(name, "<clinit>"));
+  if (clinit) has_clinit = true;
+  methods++;
+  labels = 0;
+  std::string fn = clinit ? "mycc_clinit" : (std::string("f_") + name);
+
+  std::string params;
+  char result;
+  parse_descriptor(desc, params, result);
+
+  /*
+    Frame, below the saved rbp: the callee-saved registers we use,
+    the locals that didn't get registers, and a home for each
+    operand stack entry, kept 16-byte aligned for calls.
+  */
+  std::vector<int> saved;
+  int slots = allocate(code, frame.max_locals, params.size(), saved);
+  stack_loc.resize(frame.max_stack);
+  stack_home.resize(frame.max_stack);
+  for (int k=0; k<frame.max_stack; k++) {
+    stack_home[k] = -8 * ++slots;
+    stack_loc[k].reg = (k < NSTACK_REGS) ? STACK_REGS[k] : -1;
+    stack_loc[k].offset = stack_home[k];
+  }
+  int size = (8*slots + 15) & ~15;
+
+  out->format("\n\t.p2align 4\n\t.type %s, @function\n%s:\n", fn.c_str(), fn.c_str());
+  out->put("\tpushq %rbp\n");
+  out->put("\tmovq %rsp, %rbp\n");
+  if (size) out->format("\tsubq $%d, %%rsp\n", size);
+  for (size_t s=0; s<saved.size(); s++) {
+    out->format("\tmovq %%%s, %d(%%rbp)\n", REG64[saved[s]], -8 * (int) (s+1));
+  }
+
+  /* Parameters, from where the caller put them */
+  int ints = 0, floats = 0, memory = 0;
+  for (size_t p=0; p<params.size(); p++) {
+    location from;
+    from.reg = -1;
+    bool is_float = ('F' == params[p]);
+    if (is_float && (floats < NFLOAT_ARGS)) {
+      if (p < local_loc.size() && ((local_loc[p].reg >= 0) || local_loc[p].offset)) {
+        out->format("\tmovd %%xmm%d, %s\n", floats, operand(local_loc[p], 32).c_str());
+      }
+      floats++;
+      continue;
+    }
+    if (!is_float && (ints < NINT_ARGS)) {
+      from.reg = INT_ARGS[ints++];
+    } else {
+      from.offset = 16 + 8 * memory++;
+    }
+    if (p < local_loc.size() && ((local_loc[p].reg >= 0) || local_loc[p].offset)) {
+      move(local_loc[p], from);
+    }
+  }
+
+  for (size_t i=0; i<code.size(); i++) {
+    instruction(code, i, frame.height[i]);
+    if (OP_SWITCH == code[i].op) i += code[i].b;
+  }
+
+  out->format(".L%d_ret:\n", methods);
+  for (size_t s=0; s<saved.size(); s++) {
+    out->format("\tmovq %d(%%rbp), %%%s\n", -8 * (int) (s+1), REG64[saved[s]]);
+  }
+  out->put("\tleave\n");
+  out->put("\tret\n");
+  out->format("\t.size %s, .-%s\n", fn.c_str(), fn.c_str());
+  out->boundary();
+}
+
+/*
+  One instruction, with h entries on the operand stack before it.
+*/
+void x86_backend::instruction(const std::vector<instr> &code, size_t i, int h)
+{
+  const instr &I = code[i];
+  const char* name = I.sym ? atom_table::name(I.sym) : "";
+
+  if (OP_LABEL == I.op) {
+    out->format("%s:\n", label(I.a).c_str());
+    return;
+  }
+  if (OP_LINE == I.op) {
+    out->format("# %s %d %s\n", srcname, I.a, name);
+    return;
+  }
+  if (OP_COMMENT == I.op) {
+    out->format("# %s\n", name);
+    return;
+  }
+  /* Not reached */
+  if (h < 0) return;
+  if (is_local(I) && ((I.a < 0) || ((size_t) I.a >= local_loc.size()))) {
+    diagnostics() << "Error, can't write native code for local " << I.a << " (" << name << ")\n";
+    failed = true;
+    return;
+  }
+
+  const location* S = stack_loc.empty() ? 0 : &stack_loc[0];
+  switch (I.op) {
+    case OP_NOP:
+    case OP_CASE:
+        return;
+
+    case OP_ICONST:
+        out->format("\tmovl $%d, %s\n", I.a, operand(S[h], 32).c_str());
+        return;
+
+    case OP_FCONST:
+        out->format("\tmovl $%u, %s\n", float_bits(name), operand(S[h], 32).c_str());
+        return;
+
+    case OP_SCONST: {
+        /* As a Java string: 16-bit chars, after the length */
+        std::string text = unquote(name);
+        int n = strings++;
+        out->put("\t.section .rodata\n\t.p2align 2\n");
+        out->format("\t.long %d\n", (int) text.size());
+        out->format(".LS%d:\n", n);
+        for (size_t c=0; c<text.size(); c++) {
+          out->put((c % 16) ? "," : "\t.value ");
+          out->putInt((unsigned char) text[c]);
+          if ((c % 16 == 15) || (c+1 == text.size())) out->put('\n');
+        }
+        out->put("\t.text\n");
+        if (S[h].reg >= 0) {
+          out->format("\tleaq .LS%d(%%rip), %s\n", n, operand(S[h], 64).c_str());
+        } else {
+          out->format("\tleaq .LS%d(%%rip), %%rax\n", n);
+          out->format("\tmovq %%rax, %s\n", operand(S[h], 64).c_str());
+        }
+        return;
+    }
+
+    case OP_LOAD:
+        move(S[h], local_loc[I.a]);
+        return;
+
+    case OP_STORE:
+        move(local_loc[I.a], S[h-1]);
+        return;
+
+    case OP_IINC:
+        out->format("\taddl $%d, %s\n", I.b, operand(local_loc[I.a], 32).c_str());
+        return;
+
+    case OP_GETSTATIC: {
+        location to = S[h];
+        if (to.reg < 0) to.reg = RAX;
+        if (I.flags & FLAG_ARRAY) {
+          out->format("\tmovq g_%s(%%rip), %s\n", name, operand(to, 64).c_str());
+        } else if ('C' == I.type) {
+          out->format("\tmovzwl g_%s(%%rip), %s\n", name, operand(to, 32).c_str());
+        } else {
+          out->format("\tmovl g_%s(%%rip), %s\n", name, operand(to, 32).c_str());
+        }
+        if (S[h].reg < 0) out->format("\tmovq %%rax, %s\n", operand(S[h], 64).c_str());
+        return;
+    }
+
+    case OP_PUTSTATIC: {
+        location from = S[h-1];
+        if (from.reg < 0) {
+          out->format("\tmovq %s, %%rax\n", operand(from, 64).c_str());
+          from.reg = RAX;
+        }
+        if (I.flags & FLAG_ARRAY) {
+          out->format("\tmovq %s, g_%s(%%rip)\n", operand(from, 64).c_str(), name);
+        } else if ('C' == I.type) {
+          out->format("\tmovw %s, g_%s(%%rip)\n", operand(from, 16).c_str(), name);
+        } else {
+          out->format("\tmovl %s, g_%s(%%rip)\n", operand(from, 32).c_str(), name);
+        }
+        return;
+    }
+
+    case OP_NEWARRAY:
+        spillStack(h);
+        out->format("\tmovl %d(%%rbp), %%edi\n", stack_home[h-1]);
+        out->format("\tmovl $%d, %%esi\n", ('C' == I.type) ? 2 : 4);
+        out->put("\tcall mycc_newarray\n");
+        reloadStack(h-1);
+        out->format("\tmovq %%rax, %s\n", operand(S[h-1], 64).c_str());
+        return;
+
+    case OP_ALOAD:
+    case OP_INVOKEVIRTUAL: {
+        /* array (or string), index */
+        if (OP_INVOKEVIRTUAL == I.op && strcmp(name, "charAt")) {
+          diagnostics() << "Error, no native code for String." << name << "\n";
+          failed = true;
+          return;
+        }
+        out->format("\tmovq %s, %%rcx\n", operand(S[h-2], 64).c_str());
+        out->format("\tmovslq %s, %%rax\n", operand(S[h-1], 32).c_str());
+        out->put("\tcmpl -4(%rcx), %eax\n");
+        out->put("\tjae mycc_bounds\n");
+        location to = S[h-2];
+        if (to.reg < 0) to.reg = RDX;
+        if ((OP_INVOKEVIRTUAL == I.op) || ('C' == I.type)) {
+          out->format("\tmovzwl (%%rcx,%%rax,2), %s\n", operand(to, 32).c_str());
+        } else {
+          out->format("\tmovl (%%rcx,%%rax,4), %s\n", operand(to, 32).c_str());
+        }
+        if (S[h-2].reg < 0) out->format("\tmovq %%rdx, %s\n", operand(S[h-2], 64).c_str());
+        return;
+    }
+
+    case OP_ASTORE:
+        /* array, index, value */
+        out->format("\tmovq %s, %%rcx\n", operand(S[h-3], 64).c_str());
+        out->format("\tmovslq %s, %%rax\n", operand(S[h-2], 32).c_str());
+        out->put("\tcmpl -4(%rcx), %eax\n");
+        out->put("\tjae mycc_bounds\n");
+        out->format("\tmovl %s, %%edx\n", operand(S[h-1], 32).c_str());
+        if ('C' == I.type) out->put("\tmovw %dx, (%rcx,%rax,2)\n");
+        else               out->put("\tmovl %edx, (%rcx,%rax,4)\n");
+        return;
+
+    case OP_IADD:
+    case OP_ISUB:
+    case OP_IMUL:
+    case OP_IOR:
+    case OP_IAND:
+    case OP_IXOR: {
+        const char* op = "addl";
+        switch (I.op) {
+          case OP_ISUB:   op = "subl";    break;
+          case OP_IMUL:   op = "imull";   break;
+          case OP_IOR:    op = "orl";     break;
+          case OP_IAND:   op = "andl";    break;
+          case OP_IXOR:   op = "xorl";    break;
+        }
+        const location &a = S[h-2];
+        const location &b = S[h-1];
+        if ((a.reg >= 0) || ((b.reg >= 0) && (OP_IMUL != I.op))) {
+          out->format("\t%s %s, %s\n", op, operand(b, 32).c_str(), operand(a, 32).c_str());
+        } else {
+          out->format("\tmovl %s, %%eax\n", operand(a, 32).c_str());
+          out->format("\t%s %s, %%eax\n", op, operand(b, 32).c_str());
+          out->format("\tmovl %%eax, %s\n", operand(a, 32).c_str());
+        }
+        return;
+    }
+
+    case OP_IDIV:
+    case OP_IREM: {
+        /* The JVM throws on division by zero, and MIN_VALUE / -1 is MIN_VALUE */
+        bool rem = (OP_IREM == I.op);
+        int k = labels++;
+        out->format("\tmovl %s, %%eax\n", operand(S[h-2], 32).c_str());
+        out->format("\tmovl %s, %%ecx\n", operand(S[h-1], 32).c_str());
+        out->put("\ttestl %ecx, %ecx\n");
+        out->put("\tje mycc_divzero\n");
+        out->put("\tcmpl $-1, %ecx\n");
+        out->format("\tjne .L%dx%d\n", methods, k);
+        out->put(rem ? "\txorl %eax, %eax\n" : "\tnegl %eax\n");
+        out->format("\tjmp .L%dy%d\n", methods, k);
+        out->format(".L%dx%d:\n", methods, k);
+        out->put("\tcltd\n");
+        out->put("\tidivl %ecx\n");
+        if (rem) out->put("\tmovl %edx, %eax\n");
+        out->format(".L%dy%d:\n", methods, k);
+        out->format("\tmovl %%eax, %s\n", operand(S[h-2], 32).c_str());
+        return;
+    }
+
+    case OP_INEG:
+        out->format("\tnegl %s\n", operand(S[h-1], 32).c_str());
+        return;
+
+    case OP_DUP:
+        move(S[h], S[h-1]);
+        return;
+
+    case OP_POP:
+        return;
+
+    case OP_GOTO:
+        out->format("\tjmp %s\n", label(I.a).c_str());
+        return;
+
+    case OP_SWITCH: {
+        const instr* cases = &code[i+1];
+        int n = I.b;
+        out->format("\tmovl %s, %%eax\n", operand(S[h-1], 32).c_str());
+        if (!dense_switch(cases, n)) {
+          search(cases, n, I.a);
+          return;
+        }
+        /* A table of offsets from the table, so the code is position independent */
+        int k = labels++;
+        unsigned range = (unsigned) cases[n-1].b - (unsigned) cases[0].b;
+        out->format("\tsubl $%d, %%eax\n", cases[0].b);
+        out->format("\tcmpl $%u, %%eax\n", range);
+        out->format("\tja %s\n", label(I.a).c_str());
+        out->format("\tleaq .L%dt%d(%%rip), %%rcx\n", methods, k);
+        out->put("\tmovslq (%rcx,%rax,4), %rax\n");
+        out->put("\taddq %rcx, %rax\n");
+        out->put("\tjmp *%rax\n");
+        out->put("\t.section .rodata\n\t.p2align 2\n");
+        out->format(".L%dt%d:\n", methods, k);
+        int c = 0;
+        for (unsigned v = 0; ; v++) {
+          int L = ((unsigned) cases[c].b - (unsigned) cases[0].b == v) ? cases[c++].a : I.a;
+          out->format("\t.long %s-.L%dt%d\n", label(L).c_str(), methods, k);
+          if (v == range) break;
+        }
+        out->put("\t.text\n");
+        return;
+    }
+
+    case OP_INVOKESTATIC: {
+        std::string target = (I.flags & FLAG_LIBC) ? (std::string(name) + "@PLT")
+                                                   : (std::string("f_") + name);
+        call(target.c_str(), I.desc ? atom_table::name(I.desc) : "()V", h);
+        return;
+    }
+
+    case OP_RETURN:
+        out->format("\tjmp .L%d_ret\n", methods);
+        return;
+
+    case OP_VRETURN:
+        out->format("\tmovl %s, %%eax\n", operand(S[h-1], 32).c_str());
+        if ('F' == I.type) out->put("\tmovd %eax, %xmm0\n");
+        out->format("\tjmp .L%d_ret\n", methods);
+        return;
+  }
+
+  if (I.is_cond_branch() && (I.op < OP_IF_ICMPEQ)) {
+    out->format("\tcmpl $0, %s\n", operand(S[h-1], 32).c_str());
+    out->format("\t%s %s\n", jump(I.op), label(I.a).c_str());
+    return;
+  }
+  if (I.is_cond_branch()) {
+    const location &a = S[h-2];
+    const location &b = S[h-1];
+    if ((a.reg >= 0) || (b.reg >= 0)) {
+      out->format("\tcmpl %s, %s\n", operand(b, 32).c_str(), operand(a, 32).c_str());
+    } else {
+      out->format("\tmovl %s, %%eax\n", operand(a, 32).c_str());
+      out->format("\tcmpl %s, %%eax\n", operand(b, 32).c_str());
+    }
+    out->format("\t%s %s\n", jump(I.op), label(I.a).c_str());
+    return;
+  }
+
+  diagnostics() << "Error, can't write native code for instruction " << opname(I.op) << "\n";
+  failed = true;
+}
+
+/*
+  A call, with its arguments on top of the h operand stack entries.
+  Everything on the stack goes to its home first, so the arguments
+  can be loaded from there in any order.
+*/
+void x86_backend::call(const char* target, const char* desc, int h)
+{
+  std::string params;
+  char result;
+  parse_descriptor(desc, params, result);
+  int base = h - params.size();
+
+  spillStack(h);
+  std::vector<int> memory;
+  int ints = 0, floats = 0;
+  for (size_t p=0; p<params.size(); p++) {
+    if ('F' == params[p]) {
+      if (floats < NFLOAT_ARGS) floats++;
+      else                      memory.push_back(base + p);
+    } else {
+      if (ints < NINT_ARGS) ints++;
+      else                  memory.push_back(base + p);
+    }
+  }
+  int pad = (memory.size() % 2) ? 8 : 0;
+  if (pad) out->put("\tsubq $8, %rsp\n");
+  for (size_t m=memory.size(); m-- > 0; ) {
+    out->format("\tpushq %d(%%rbp)\n", stack_home[memory[m]]);
+  }
+  ints = floats = 0;
+  for (size_t p=0; p<params.size(); p++) {
+    int home = stack_home[base + p];
+    if (('F' == params[p]) && (floats < NFLOAT_ARGS)) {
+      out->format("\tmovd %d(%%rbp), %%xmm%d\n", home, floats++);
+    } else if (('F' != params[p]) && (ints < NINT_ARGS)) {
+      out->format("\tmovq %d(%%rbp), %%%s\n", home, REG64[INT_ARGS[ints++]]);
+    }
+  }
+  out->format("\tcall %s\n", target);
+  int popped = 8 * memory.size() + pad;
+  if (popped) out->format("\taddq $%d, %%rsp\n", popped);
+
+  if ('F' == result) out->put("\tmovd %xmm0, %eax\n");
+  reloadStack(base);
+  if ('V' != result) out->format("\tmovl %%eax, %s\n", operand(stack_loc[base], 32).c_str());
+}
+
+/*
+  A lookupswitch on eax: a binary search of the sorted cases.
+*/
+void x86_backend::search(const instr* cases, int n, int deflabel)
+{
+  if (n <= 3) {
+    for (int c=0; c<n; c++) {
+      out->format("\tcmpl $%d, %%eax\n", cases[c].b);
+      out->format("\tje %s\n", label(cases[c].a).c_str());
+    }
+    out->format("\tjmp %s\n", label(deflabel).c_str());
+    return;
+  }
+  int m = n / 2;
+  int k = labels++;
+  out->format("\tcmpl $%d, %%eax\n", cases[m].b);
+  out->format("\tje %s\n", label(cases[m].a).c_str());
+  out->format("\tjg .L%dh%d\n", methods, k);
+  search(cases, m, deflabel);
+  out->format(".L%dh%d:\n", methods, k);
+  search(cases + m + 1, n - m - 1, deflabel);
+}
+
+/* ====================================================================== */
+
+void x86_backend::entry(bool show_result)
+{
+  out->put("\n\t.globl main\n\t.type main, @function\nmain:\n");
+  out->put("\tpushq %rbp\n");
+  out->put("\tmovq %rsp, %rbp\n");
+  if (has_clinit) out->put("\tcall mycc_clinit\n");
+  out->put("\tcall f_main\n");
+  if (show_result) {
+    out->put("\tmovl %eax, %esi\n");
+    out->put("\tleaq .Lreturn_code(%rip), %rdi\n");
+    out->put("\txorl %eax, %eax\n");
+    out->put("\tcall printf@PLT\n");
+  }
+  out->put("\txorl %eax, %eax\n");
+  out->put("\tpopq %rbp\n");
+  out->put("\tret\n");
+  out->put("\t.size main, .-main\n");
+  out->put("\t.section .rodata\n");
+  out->put(".Lreturn_code:\n\t.string \"Return code: %d\\n\"\n");
+  out->put("\t.text\n");
+}
+
+bool x86_backend::finish()
+{
+  /*
+    An array of edi elements of esi bytes.  Its length is kept in
+    the word before element 0 (strings have one there too), and
+    the elements start 8 bytes into the block.
+
+    What the JVM would throw, reported on stderr before exiting
+    with status 1, as an uncaught exception does.
+  */
+  out->put("\n\t.p2align 4\nmycc_newarray:\n");
+  out->put("\tpushq %rbp\n");
+  out->put("\tmovq %rsp, %rbp\n");
+  out->put("\tpushq %rbx\n");
+  out->put("\tsubq $8, %rsp\n");
+  out->put("\ttestl %edi, %edi\n");
+  out->put("\tjs .Lnegative\n");
+  out->put("\tmovl %edi, %ebx\n");
+  out->put("\tmovslq %edi, %rdi\n");
+  out->put("\tmovslq %esi, %rsi\n");
+  out->put("\timulq %rdi, %rsi\n");
+  out->put("\taddq $8, %rsi\n");
+  out->put("\tmovl $1, %edi\n");
+  out->put("\tcall calloc@PLT\n");
+  out->put("\ttestq %rax, %rax\n");
+  out->put("\tje .Lnomemory\n");
+  out->put("\tmovl %ebx, 4(%rax)\n");
+  out->put("\taddq $8, %rax\n");
+  out->put("\tmovq -8(%rbp), %rbx\n");
+  out->put("\tleave\n");
+  out->put("\tret\n");
+  out->put(".Lnegative:\n");
+  out->put("\tleaq .Lnegative_msg(%rip), %rdi\n");
+  out->put("\tjmp mycc_throw\n");
+  out->put(".Lnomemory:\n");
+  out->put("\tleaq .Lnomemory_msg(%rip), %rdi\n");
+  out->put("\tjmp mycc_throw\n");
+  out->put("mycc_bounds:\n");
+  out->put("\tleaq .Lbounds_msg(%rip), %rdi\n");
+  out->put("\tjmp mycc_throw\n");
+  out->put("mycc_divzero:\n");
+  out->put("\tleaq .Ldivzero_msg(%rip), %rdi\n");
+  out->put("mycc_throw:\n");
+  out->put("\tandq $-16, %rsp\n");
+  out->put("\tmovq stderr@GOTPCREL(%rip), %rax\n");
+  out->put("\tmovq (%rax), %rsi\n");
+  out->put("\tcall fputs@PLT\n");
+  out->put("\tmovl $1, %edi\n");
+  out->put("\tcall exit@PLT\n");
+  out->put("\t.section .rodata\n");
+  out->put(".Lnegative_msg:\n\t.string \"Exception: java.lang.NegativeArraySizeException\\n\"\n");
+  out->put(".Lnomemory_msg:\n\t.string \"Exception: java.lang.OutOfMemoryError\\n\"\n");
+  out->put(".Lbounds_msg:\n\t.string \"Exception: java.lang.ArrayIndexOutOfBoundsException\\n\"\n");
+  out->put(".Ldivzero_msg:\n\t.string \"Exception: java.lang.ArithmeticException: / by zero\\n\"\n");
+  out->put("\t.section .note.GNU-stack,\"\",@progbits\n");
+  bool ok = out->close();
+  return ok && !failed;
+}
+
+void x86_backend::showStats(std::ostream &s)
+{
+  s << "Registers\n";
+  s << "\tlocals in registers: " << locals_in_registers << "\n";
+  s << "\tlocals spilled: " << locals_spilled << "\n";
+}
+
+void x86_backend::clearStats()
+{
+  locals_in_registers = 0;
+  locals_spilled = 0;
+}
@@ -0,0 +1,84 @@
+
+#ifndef X86_H
+#define X86_H
+
+#include <iostream>
+
+#include "backend.h"
+
+/*
+  x86-64 assembler text for the GNU assembler, the .s file.
+
+  Each method becomes a function with the System V calling
+  convention, and main() calls them as the JVM entry point would,
+  so the file links against libc (for putchar and getchar) with
+  the system compiler:  cc -o prog prog.s
+
+  Values are 32 bits wide, with JVM semantics; array and string
+  references are 64-bit pointers, and char arrays (like Java's)
+  hold 16-bit elements.  Arrays and strings have their length in
+  the 32 bits before element 0, and every index is checked against
+  it.  Locals are given registers by linear scan;
+  the operand stack lives in a fixed set of scratch registers,
+  with memory for entries deeper than those.
+*/
+class x86_backend : public backend {
+    /*
+      Where a value lives: a register, or memory at offset(%rbp).
+    */
+    struct location {
+        int reg;          /* register number, or -1 */
+        int offset;
+    };
+
+  private:
+    sink* out;
+    std::string owner;
+    const char* srcname;
+    bool failed;
+    bool has_clinit;
+    int methods;          /* numbers the local labels of each method */
+    int strings;          /* numbers the string constants */
+
+    /* The method being written */
+    std::vector<location> local_loc;
+    std::vector<location> stack_loc;
+    std::vector<int> stack_home;
+    int labels;           /* local labels made up for this method */
+
+  public:
+    /* We own (and delete) the sink */
+    x86_backend(sink* S, const std::string &classname, const char* src);
+    virtual ~x86_backend();
+
+    virtual void field(atom_id name, char type, bool is_array, const instr* init);
+    virtual void method(const char* name, const char* desc,
+                        const std::vector<instr> &code, const frame_info &frame);
+    virtual void entry(bool show_result);
+    virtual bool finish();
+
+    /*
+      Display how many locals got registers, over all methods.
+    */
+    static void showStats(std::ostream &s);
+
+    /*
+      Start the counts for showStats() over.
+    */
+    static void clearStats();
+
+  private:
+    int allocate(const std::vector<instr> &code, int nlocals, int params,
+                 std::vector<int> &saved);
+    void instruction(const std::vector<instr> &code, size_t i, int h);
+    void call(const char* target, const char* desc, int h);
+    void search(const instr* cases, int n, int deflabel);
+
+    std::string operand(const location &L, int width) const;
+    void move(const location &to, const location &from);
+    void spillStack(int n);
+    void reloadStack(int n);
+    std::string label(int L) const;
+};
+
+#endif